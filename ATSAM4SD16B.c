@@ -12,6 +12,7 @@
 #include "./C_Library/Driver_UART_V100.h" 
 #include "./C_Library/Driver_TCM8230.h" 
 #include "./C_Library/Driver_USART_V100.h"  
+#include "./C_Library/Driver_TC_V100.h"
 
 
 #include "User_Task.h" 
@@ -29,14 +30,18 @@ int main(void)
 	SAM4S_Init();				// Custom initialization of the ATSAM4S chip.
 	OSInit();                   // Custom initialization: Initialize the RTOS.
 	gnTaskCount = 0; 			// Initialize task counter.
+	TCTimerInit();				// Microsecond timer service on TC0.
 
 	// Initialize core OS processes.
 	OSCreateTask(&gstrcTaskContext[gnTaskCount], OSProce1);					// Start blinking LED process.
 
 	// Initialize library processes.
 	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_I2C0_Driver);		// I2C0 driver.
+	//OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_I2C1_Driver);	// I2C1 driver, PB4/PB5.
 	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_UART_Driver);		// UART0 driver.
 	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_USART_Driver);		// USART0 driver.
+	//OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_UART1_Driver);	// UART1 driver, PB2/PB3.
+	//OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_USART1_Driver);	// USART1 driver, PA21/PA22.
 	
 	// Initialize user processes (example tasks are shown here).
 	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_TCM8230_Driver);		// CMOS camera driver.
@@ -47,52 +52,22 @@ int main(void)
 
 	while (1)
 	{
-		// --- Check SysTick until time is up, then update each process's timer ---
-		if ((SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) > 0)		// Check if SysTick counts to 0 since the last read.
-		{
-			//PIOA->PIO_ODSR |= PIO_ODSR_P19;
-			PIOB->PIO_ODSR |= PIO_ODSR_P1;			// Set PB1
-			OSEnterCritical();
-
-			if (gnRunTask == 1)						// If task overflow occur trap the controller
-			{										// indefinitely and turn on indicator LED1.
-				while (1)
-				{
-					ClearWatchDog();				// Clear the Watch Dog Timer.
-					PIN_OSPROCE1_SET; 				// Turn on indicator LED1.
-				}
-			}
-
-			gnRunTask = 1;							// Assert gnRunTask.
-			gunClockTick++; 						// Increment RTOS clock tick counter.
-			for (ni = 0; ni < gnTaskCount; ni++)		// Using for-loop produce more efficient
-				// assembly codes.
-			{
-				if (gstrcTaskContext[ni].nTimer > 0) // Only decrement timer if it is greater than zero.
-				{
-					--(gstrcTaskContext[ni].nTimer); // Decrement timer for each process.
-				}
-			}
-
-			OSExitCritical();
-			//PIOA->PIO_ODSR &= ~PIO_ODSR_P19;	
-			PIOB->PIO_ODSR &= ~PIO_ODSR_P1;			// Clear PB1
-		}
-
 		// --- Run processes ---
+		// Note: 16 Oct 2026, the task timers are now updated by the SysTick exception handler
+		// SysTick_Handler() in "os_SAM4S_APIs.c", which also asserts gnRunTask when at least
+		// one task is due.  Thus we no longer need to poll the COUNTFLAG bit of SysTick.
 		ClearWatchDog();		// Clear the Watch Dog Timer.
 		if (gnRunTask > 0) 		// Only execute tasks/processes when gnRunTask is not 0.
 		{
-			for (ni = 0; ni < gnTaskCount; ni++)
+			// Note: 16 Oct 2026, only the tasks which are due are flagged in the ready bitmap,
+			// these are executed in ascending order of index.
+			while ((ni = OSGetReadyTask()) >= 0)
 			{
-				// Only execute a process/task if it's timer = 0.
-				if (gstrcTaskContext[ni].nTimer == 0)
-				{
-					// Execute user task by dereferencing the function pointer.
-					(*((TASK_POINTER)gfptrTask[ni]))(&gstrcTaskContext[ni]);
-				}
+				OSRunTask(ni);	// Execute user task by dereferencing the function pointer.
 			}
 			gnRunTask = 0; 		// Reset gnRunTask.        
+			gnTickDispatch = 0;	// The tasks due at the last tick have been executed.
 		}
+		OSIdle();				// Put the core to sleep until the next task is due.
 	}
 }
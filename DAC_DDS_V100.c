@@ -0,0 +1,474 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	USER ROUTINES DECLARATION (PROCESSOR INDEPENDENT)
+//
+//  (c) Copyright 2026, Fabian Kung Wai Lee, Selangor, MALAYSIA
+//  All Rights Reserved
+//
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File				: DAC_DDS_V100.c
+// Author(s)		: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Toolsuites		: Atmel Studio 7.0 or later
+//					  GCC C-Compiler
+#include "osmain.h"
+#include "DAC_DDS_V100.h"
+
+
+// NOTE: Public function prototypes are declared in the corresponding *.h file.
+
+
+//
+// --- PUBLIC VARIABLES ---
+//
+DDS_CHANNEL gstrcDDS[__DDS_CHANNEL];	// The channels, see DDSSetWave().
+unsigned int gunDDSRateHz;				// Samples per second of each channel.
+
+//
+// --- PRIVATE VARIABLES ---
+//
+int gnDDSStream;						// Channel of DACCStreamStart(), 0, 1 or __DACC_STREAM_BOTH.
+uint16_t gunDDSBuf[2][__DDS_BLOCK];
+OS_CLOCK_CLIENT gstrcDDSClock = {DDSClockChange, 0};	// Notification of master clock change.
+
+// One period of sine, Q15, with the first sample repeated at the end for the interpolation.
+const int16_t gnDDSSine[257] =
+{
+	0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+	6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+	12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+	18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+	23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+	27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+	30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+	32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+	32767, 32757, 32728, 32678, 32609, 32521, 32412, 32285,
+	32137, 31971, 31785, 31580, 31356, 31113, 30852, 30571,
+	30273, 29956, 29621, 29268, 28898, 28510, 28105, 27683,
+	27245, 26790, 26319, 25832, 25329, 24811, 24279, 23731,
+	23170, 22594, 22005, 21403, 20787, 20159, 19519, 18868,
+	18204, 17530, 16846, 16151, 15446, 14732, 14010, 13279,
+	12539, 11793, 11039, 10278, 9512, 8739, 7962, 7179,
+	6393, 5602, 4808, 4011, 3212, 2410, 1608, 804,
+	0, -804, -1608, -2410, -3212, -4011, -4808, -5602,
+	-6393, -7179, -7962, -8739, -9512, -10278, -11039, -11793,
+	-12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530,
+	-18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+	-23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+	-27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+	-30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971,
+	-32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+	-32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285,
+	-32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+	-30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+	-27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+	-23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868,
+	-18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+	-12539, -11793, -11039, -10278, -9512, -8739, -7962, -7179,
+	-6393, -5602, -4808, -4011, -3212, -2410, -1608, -804,
+	0
+};
+
+static uint64_t DDSStep(unsigned int);
+static void DDSSteps(DDS_CHANNEL *);
+static void DDSBlock(DDS_CHANNEL *, uint16_t *, unsigned int, unsigned int, uint16_t);
+static unsigned int DDSRefill(uint16_t *, unsigned int, void *);
+
+// Function name	: DDSStep
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Phase increment per sample of a frequency, with 16 bits fraction, i.e.
+//                    f x 2^48 / gunDDSRateHz.  The frequency is limited to half the rate.
+// Arguments		: unMilliHz = frequency in mHz.
+// Return			: The phase increment.
+static uint64_t DDSStep(unsigned int unMilliHz)
+{
+	uint32_t unDiv = gunDDSRateHz * 1000;		// Max. 10^9.
+	uint64_t ullNum;
+
+	if (unMilliHz > gunDDSRateHz * 500)
+	{
+		unMilliHz = gunDDSRateHz * 500;
+	}
+	ullNum = (uint64_t) unMilliHz << 24;		// In two steps of 24 bits, without overflow.
+	return ((ullNum / unDiv) << 24) + (((ullNum % unDiv) << 24) / unDiv);
+}
+
+// Function name	: DDSSteps
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Phase increment and sweep of a channel from strcParam.  The phase is kept.
+// Arguments		: ptrCh = the channel.
+// Return			: None.
+static void DDSSteps(DDS_CHANNEL *ptrCh)
+{
+	DDS_PARAM *ptrParam = &ptrCh->strcParam;
+
+	ptrCh->ullStepStart = DDSStep(ptrParam->unStartmHz);
+	ptrCh->ullStep = ptrCh->ullStepStart;
+	ptrCh->unSweepCount = 0;
+	ptrCh->llSweep = 0;
+	ptrCh->unSweepLength = 0;
+	if ((ptrParam->unSweepMs > 0) && (ptrParam->unStopmHz != ptrParam->unStartmHz))
+	{
+		ptrCh->unSweepLength = (unsigned int)((uint64_t) gunDDSRateHz * ptrParam->unSweepMs / 1000);
+		if (ptrCh->unSweepLength == 0)
+		{
+			ptrCh->unSweepLength = 1;
+		}
+		ptrCh->llSweep = ((int64_t) DDSStep(ptrParam->unStopmHz) - (int64_t) ptrCh->ullStepStart) /
+						 (int64_t) ptrCh->unSweepLength;
+	}
+}
+
+// Function name	: DDSBlock
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Compute a block of samples of a channel.  The settings given since the
+//                    previous block are taken first, the phase is kept so the waveform has no
+//                    step.  The sine is interpolated between the samples of gnDDSSine[] with
+//                    the 16 bits below the index, the triangle and sawtooth are the phase.
+// Arguments		: ptrCh = the channel.
+//                    ptrBuf = first sample.
+//                    unCount = no. of samples.
+//                    unStride = distance between two samples of the channel in ptrBuf.
+//                    unTag = channel no. in bits 12-13 of the samples, 0 if not used.
+// Return			: None.
+static void DDSBlock(DDS_CHANNEL *ptrCh, uint16_t *ptrBuf, unsigned int unCount, unsigned int unStride, uint16_t unTag)
+{
+	DDS_PARAM *ptrParam = &ptrCh->strcParam;
+	uint32_t unPhase;
+	uint64_t ullStep;
+	int32_t nY;
+	int32_t nCode;
+	unsigned int unIndex;
+
+	if (ptrCh->bytUpdate == 1)
+	{
+		if ((ptrCh->strcNew.unStartmHz != ptrParam->unStartmHz) || (ptrCh->strcNew.unStopmHz != ptrParam->unStopmHz) ||
+			(ptrCh->strcNew.unSweepMs != ptrParam->unSweepMs))
+		{
+			*ptrParam = ptrCh->strcNew;
+			DDSSteps(ptrCh);
+		}
+		else
+		{
+			*ptrParam = ptrCh->strcNew;
+		}
+		ptrCh->bytUpdate = 0;
+	}
+	unPhase = ptrCh->unPhase;
+	ullStep = ptrCh->ullStep;
+	while (unCount > 0)
+	{
+		switch (ptrParam->bytWave)
+		{
+			case __DDS_WAVE_SINE:
+				unIndex = unPhase >> 24;
+				nY = gnDDSSine[unIndex];
+				nY += ((gnDDSSine[unIndex + 1] - nY) * (int32_t)((unPhase >> 8) & 0xFFFF)) >> 16;
+			break;
+
+			case __DDS_WAVE_TRIANGLE:
+				nY = (int32_t)(unPhase >> 15);			// 0 to 131071.
+				nY = (nY < 65536) ? nY - 32768 : 98303 - nY;
+			break;
+
+			case __DDS_WAVE_SAWTOOTH:
+				nY = (int32_t)(unPhase >> 16) - 32768;
+			break;
+
+			default:
+				nY = 0;
+			break;
+		}
+		nCode = (int32_t) ptrParam->unOffset + ((nY * (int32_t) ptrParam->unAmplitude + 16384) >> 15);
+		nCode = (nCode < 0) ? 0 : ((nCode > 4095) ? 4095 : nCode);
+		*ptrBuf = (uint16_t) nCode | unTag;
+		ptrBuf += unStride;
+		unPhase += (uint32_t)(ullStep >> 16);
+		if (ptrCh->llSweep != 0)				// Chirp.
+		{
+			ullStep += ptrCh->llSweep;
+			if (++ptrCh->unSweepCount == ptrCh->unSweepLength)
+			{
+				ullStep = ptrCh->ullStepStart;
+				ptrCh->unSweepCount = 0;
+			}
+		}
+		unCount--;
+	}
+	ptrCh->unPhase = unPhase;
+	ptrCh->ullStep = ullStep;
+}
+
+// Function name	: DDSRefill
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Refill routine of the DACC waveform, called by DACC_Handler().  With both
+//                    channels the samples of DAC0 and DAC1 are interleaved.
+// Arguments		: ptrBuf = the buffer.
+//                    unLength = no. of samples of the buffer.
+//                    ptrArg = not used.
+// Return			: unLength.
+static unsigned int DDSRefill(uint16_t *ptrBuf, unsigned int unLength, void *ptrArg)
+{
+	if (gnDDSStream == __DACC_STREAM_BOTH)
+	{
+		DDSBlock(&gstrcDDS[0], ptrBuf, unLength / 2, 2, 0);
+		DDSBlock(&gstrcDDS[1], ptrBuf + 1, unLength / 2, 2, 1 << 12);
+	}
+	else
+	{
+		DDSBlock(&gstrcDDS[gnDDSStream], ptrBuf, unLength, 1, 0);
+	}
+	return unLength;
+}
+
+///
+/// Function name	: DDSSetWave
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Set the waveform of a channel, see DDSStart().  The output is
+///                   unOffset + unAmplitude x wave, the wave being from -1 to +1.
+///
+/// Arguments		: nChannel = 0 (DAC0) or 1 (DAC1).
+///                   nWave = __DDS_WAVE_OFF, __DDS_WAVE_SINE, __DDS_WAVE_TRIANGLE or
+///                   __DDS_WAVE_SAWTOOTH.
+///                   unAmplitude = peak in DAC codes, 0 to 2048.
+///                   unOffset = centre in DAC codes, 0 to 4095.  The output is clipped to 0
+///                   and 4095.
+///
+/// Return			: 0 if success, 1 if an argument is wrong.
+///
+int DDSSetWave(int nChannel, int nWave, unsigned int unAmplitude, unsigned int unOffset)
+{
+	DDS_CHANNEL *ptrCh;
+
+	if ((nChannel < 0) || (nChannel >= __DDS_CHANNEL) || (nWave < __DDS_WAVE_OFF) || (nWave > __DDS_WAVE_SAWTOOTH) ||
+		(unAmplitude > 2048) || (unOffset > 4095))
+	{
+		return 1;
+	}
+	ptrCh = &gstrcDDS[nChannel];
+	ptrCh->bytUpdate = 0;					// DDSBlock() does not read strcNew while it is written.
+	ptrCh->strcNew.bytWave = nWave;
+	ptrCh->strcNew.unAmplitude = unAmplitude;
+	ptrCh->strcNew.unOffset = unOffset;
+	ptrCh->bytUpdate = 1;
+	return 0;
+}
+
+///
+/// Function name	: DDSSetFrequency
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Set a fixed frequency, the sweep of DDSSetChirp() is stopped.  The
+///                   frequency is limited to half of gunDDSRateHz.
+///
+/// Arguments		: nChannel = 0 (DAC0) or 1 (DAC1).
+///                   unMilliHz = frequency in mHz.
+///
+/// Return			: 0 if success, 1 if an argument is wrong.
+///
+int DDSSetFrequency(int nChannel, unsigned int unMilliHz)
+{
+	return DDSSetChirp(nChannel, unMilliHz, unMilliHz, 0);
+}
+
+///
+/// Function name	: DDSSetChirp
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Sweep the frequency linearly from unStartmHz to unStopmHz, then again
+///                   from unStartmHz.
+///
+/// Arguments		: nChannel = 0 (DAC0) or 1 (DAC1).
+///                   unStartmHz, unStopmHz = frequencies in mHz, the sweep can go down.
+///                   unSweepMs = duration of the sweep in msec, 0 for a fixed frequency
+///                   unStartmHz.
+///
+/// Return			: 0 if success, 1 if an argument is wrong.
+///
+int DDSSetChirp(int nChannel, unsigned int unStartmHz, unsigned int unStopmHz, unsigned int unSweepMs)
+{
+	DDS_CHANNEL *ptrCh;
+
+	if ((nChannel < 0) || (nChannel >= __DDS_CHANNEL))
+	{
+		return 1;
+	}
+	ptrCh = &gstrcDDS[nChannel];
+	ptrCh->bytUpdate = 0;
+	ptrCh->strcNew.unStartmHz = unStartmHz;
+	ptrCh->strcNew.unStopmHz = (unSweepMs > 0) ? unStopmHz : unStartmHz;
+	ptrCh->strcNew.unSweepMs = unSweepMs;
+	ptrCh->bytUpdate = 1;
+	return 0;
+}
+
+///
+/// Function name	: DDSStart
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Start the DDS engine on the channels with a waveform, i.e. not
+///                   __DDS_WAVE_OFF.  Proce_DACC_Driver() must be initialized.
+///
+/// Arguments		: unRateHz = conversion rate of the DACC, shared by the two channels when
+///                   both are used.
+///
+/// Return			: 0 if success, 1 if there is no waveform or the rate is not possible.
+///
+/// Description	:
+/// Direct digital synthesis of sine, triangle and sawtooth waves on DAC0 and DAC1, each with
+/// its own frequency, amplitude and offset.  Each channel has a 32 bits phase accumulator, one
+/// period being 2^32, and a phase increment per sample f x 2^32 / gunDDSRateHz, kept with 16
+/// more bits of fraction, so the frequency resolution is below 1 mHz.  The sine is a table of
+/// 256 samples in flash, linearly interpolated.  The error against the exact sine is below
+/// 0.7 LSB at an amplitude of 2000, as measured in the host simulation, most of it being the
+/// rounding to the DAC code.  Only integer arithmetic is used, the SAM4S has no FPU.
+///
+/// The samples are computed a block at a time, by DDSRefill() called in DACC_Handler() when a
+/// buffer of the DACC waveform is converted, see DACCStreamStart().  With both channels the
+/// samples are interleaved, each channel then has half the rate.  The settings, e.g. a new
+/// frequency, are taken at the start of the next block computed, so they reach the output
+/// after at most two blocks, 2 x __DDS_BLOCK / unRateHz.  The phase is kept, there is no step
+/// in the waveform.  A chirp sweeps the phase increment linearly, sample by sample.
+///
+/// Note: 16 Oct 2026, the rate generated by the DACC trigger timer may change with the master
+/// clock, see OSSetClock(), the phase increments are then recomputed by DDSClockChange().
+///
+/// Example of usage : 1 kHz sine on DAC0, and a triangle sweeping from 10 Hz to 20 kHz in
+/// 100 msec on DAC1, at 250 ksps each.
+///			DDSSetWave(0, __DDS_WAVE_SINE, 2000, 2048);
+///			DDSSetFrequency(0, 1000000);						// 1 kHz in mHz.
+///			DDSSetWave(1, __DDS_WAVE_TRIANGLE, 1000, 2048);
+///			DDSSetChirp(1, 10000, 20000000, 100);
+///			DDSStart(500000);
+///			...
+///			DDSSetFrequency(0, 1234567);						// Now 1.234567 kHz.
+///
+int DDSStart(unsigned int unRateHz)
+{
+	unsigned int unActualHz = DACCStreamRate(unRateHz);
+	int ni;
+
+	if ((unActualHz == 0) || ((gstrcDDS[0].strcNew.bytWave == __DDS_WAVE_OFF) &&
+		(gstrcDDS[1].strcNew.bytWave == __DDS_WAVE_OFF)))
+	{
+		return 1;
+	}
+	DDSStop();
+	OSClockRegister(&gstrcDDSClock);
+	if ((gstrcDDS[0].strcNew.bytWave != __DDS_WAVE_OFF) && (gstrcDDS[1].strcNew.bytWave != __DDS_WAVE_OFF))
+	{
+		gnDDSStream = __DACC_STREAM_BOTH;
+		gunDDSRateHz = unActualHz / 2;
+	}
+	else
+	{
+		gnDDSStream = (gstrcDDS[0].strcNew.bytWave != __DDS_WAVE_OFF) ? 0 : 1;
+		gunDDSRateHz = unActualHz;
+	}
+	for (ni = 0; ni < __DDS_CHANNEL; ni++)
+	{
+		gstrcDDS[ni].strcParam = gstrcDDS[ni].strcNew;
+		gstrcDDS[ni].bytUpdate = 0;
+		gstrcDDS[ni].unPhase = 0;
+		DDSSteps(&gstrcDDS[ni]);
+	}
+	DDSRefill(gunDDSBuf[0], __DDS_BLOCK, 0);
+	DDSRefill(gunDDSBuf[1], __DDS_BLOCK, 0);
+	return DACCStreamStart(gnDDSStream, unRateHz, gunDDSBuf[0], gunDDSBuf[1], __DDS_BLOCK, DDSRefill, 0);
+}
+
+///
+/// Function name	: DDSStop
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Stop the DDS engine, see DACCStreamStop().
+///
+/// Arguments		: None.
+///
+/// Return			: None.
+///
+void DDSStop(void)
+{
+	if (gstrcDACCStream.bytActive == 1)
+	{
+		DACCStreamStop();
+	}
+}
+
+///
+/// Function name	: DDSClockChange
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Called by OSSetClock().  After the master clock is changed gunDDSRateHz
+///                   is set to the rate now generated by the DACC trigger timer, and the phase
+///                   increments and sweeps of the channels are recomputed, so the frequencies
+///                   stay as set.  The phase, and the position in the sweep, are kept.  The
+///                   new rate is computed here rather than read from gstrcDACCStream, as
+///                   DACCClockChange() may be called after this routine.
+///
+/// Arguments		: unMCKHz = new master clock frequency in Hz.
+///                   nPhase = __OS_CLOCK_CHECK, __OS_CLOCK_PRE or __OS_CLOCK_POST.
+///
+/// Return			: 0, the clock is never refused here, see DACCClockChange().
+///
+int DDSClockChange(unsigned int unMCKHz, int nPhase)
+{
+	DDS_CHANNEL *ptrCh;
+	unsigned int unActualHz;
+	unsigned int unCount;
+	unsigned int unLength;
+	int ni;
+
+	if ((nPhase != __OS_CLOCK_POST) || (gstrcDACCStream.bytActive == 0) || (gstrcDACCStream.fptrRefill != DDSRefill))
+	{
+		return 0;
+	}
+	unActualHz = DACCStreamRate(gstrcDACCStream.unRateHz);		// gunMCKHz is already unMCKHz.
+	unActualHz = (gnDDSStream == __DACC_STREAM_BOTH) ? unActualHz / 2 : unActualHz;
+	if ((unActualHz == 0) || (unActualHz == gunDDSRateHz))
+	{
+		return 0;
+	}
+	gunDDSRateHz = unActualHz;
+	for (ni = 0; ni < __DDS_CHANNEL; ni++)
+	{
+		ptrCh = &gstrcDDS[ni];
+		unCount = ptrCh->unSweepCount;
+		unLength = ptrCh->unSweepLength;
+		DDSSteps(ptrCh);
+		if ((ptrCh->unSweepLength > 0) && (unLength > 0))
+		{
+			ptrCh->unSweepCount = (unsigned int)((uint64_t) unCount * ptrCh->unSweepLength / unLength);
+			if (ptrCh->unSweepCount >= ptrCh->unSweepLength)
+			{
+				ptrCh->unSweepCount = 0;
+			}
+			ptrCh->ullStep = ptrCh->ullStepStart + ptrCh->llSweep * (int64_t) ptrCh->unSweepCount;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,65 @@
+// Author			: Fabian Kung
+// Date				: 16 Oct 2026
+// Filename			: DAC_DDS_V100.h
+
+#ifndef _DAC_DDS_H
+#define _DAC_DDS_H
+
+// Include common header to all drivers and sources.  Here absolute path is used.
+// To edit if one change folder
+#include "osmain.h"
+#include "driver_dacc_v100.h"
+
+//
+// --- PUBLIC CONSTANTS ---
+//
+#define __DDS_CHANNEL			2				// DAC0 and DAC1.
+#define __DDS_BLOCK				256				// Samples per buffer, both channels interleaved.
+#define __DDS_WAVE_OFF			0				// Output held at the offset.
+#define __DDS_WAVE_SINE			1
+#define __DDS_WAVE_TRIANGLE		2
+#define __DDS_WAVE_SAWTOOTH		3
+
+//
+// --- PUBLIC DATATYPES ---
+//
+// Type cast for the settings of a channel, as given by the user routines.
+typedef struct StructDDSParam
+{
+	uint8_t bytWave;					// __DDS_WAVE_OFF, __DDS_WAVE_SINE...
+	unsigned int unAmplitude;			// Peak, in DAC codes, max. 2048.
+	unsigned int unOffset;				// Centre, in DAC codes, max. 4095.
+	unsigned int unStartmHz;			// Frequency in mHz, or start of the sweep.
+	unsigned int unStopmHz;				// End of the sweep, equal to unStartmHz for a fixed
+										// frequency.
+	unsigned int unSweepMs;				// Duration of the sweep, 0 for a fixed frequency.
+} DDS_PARAM;
+
+// Type cast for a channel of the DDS engine.
+typedef struct StructDDSChannel
+{
+	DDS_PARAM strcParam;				// In use by the refill routine.
+	DDS_PARAM strcNew;					// Written by the user routines.
+	volatile uint8_t bytUpdate;			// 1 when strcNew is to be used from the next block.
+	uint32_t unPhase;					// Phase accumulator, 2^32 = one period.
+	uint64_t ullStep;					// Phase increment per sample, with 16 bits fraction.
+	uint64_t ullStepStart;				// ullStep at the start of the sweep.
+	int64_t llSweep;					// Change of ullStep per sample, 0 for a fixed frequency.
+	unsigned int unSweepLength;			// Samples per sweep.
+	unsigned int unSweepCount;			// Samples since the start of the sweep.
+} DDS_CHANNEL;
+
+extern  DDS_CHANNEL gstrcDDS[__DDS_CHANNEL];
+extern  unsigned int gunDDSRateHz;		// Samples per second of each channel.
+
+//
+// --- PUBLIC FUNCTION PROTOTYPE ---
+//
+int DDSSetWave(int, int, unsigned int, unsigned int);
+int DDSSetFrequency(int, unsigned int);
+int DDSSetChirp(int, unsigned int, unsigned int, unsigned int);
+int DDSStart(unsigned int);
+void DDSStop(void);
+int DDSClockChange(unsigned int, int);
+
+#endif
@@ -0,0 +1,465 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	USER DRIVER ROUTINES DECLARATION (PROCESSOR DEPENDENT)
+//
+//  (c) Copyright 2026, Fabian Kung Wai Lee, Selangor, MALAYSIA
+//  All Rights Reserved
+//
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File				: Driver_ADC_V100.c
+// Author(s)		: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Toolsuites		: Atmel Studio 7.0 or later
+//					  GCC C-Compiler
+#include "osmain.h"
+#include "Driver_ADC_V100.h"
+
+
+// NOTE: Public function prototypes are declared in the corresponding *.h file.
+
+
+//
+// --- PUBLIC VARIABLES ---
+//
+ADC_ACQ gstrcADC;						// The acquisition, see ADCStart().
+ADC_BLOCK gstrcADCBlock[__ADC_BLOCK_COUNT];	// Circular buffer.
+int         gnADCTask;                  // Handle of the driver task.
+
+//
+// --- PRIVATE VARIABLES ---
+//
+OS_CLOCK_CLIENT gstrcADCClock = {ADCClockChange, 0};	// Notification of master clock change.
+
+//
+// --- Process Level Constants Definition ---
+//
+#define	_ADC_TRGSEL_TC2		3			// Trigger = TIOA output of TC0 channel 2.
+#define	_ADC_INT_PDC		(ADC_IDR_ENDRX | ADC_IDR_RXBUFF)
+
+static uint32_t ADCMode(unsigned int);
+static unsigned int ADCTimer(unsigned int, unsigned int);
+static void ADCArm(void);
+
+///
+/// Function name	: Proce_ADC_Driver
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Code Version	: 1.00
+///
+/// Processor		: ARM Cortex-M4 family
+///
+/// Processor/System Resource
+/// PINS		: The analog inputs AD0 to AD15 enabled by ADCStart(), the pin is taken from
+///               the PIO when the channel is enabled.
+///
+/// MODULES		: 1. ADC (Internal), with interrupt and PDC.
+///               2. TC0 channel 2 (Internal), trigger of the conversions.
+///
+/// RTOS		: Ver 1 or above, round-robin scheduling.
+///
+/// Global Variables    : gstrcADC, gstrcADCBlock[], gnADCTask.
+
+#ifdef __OS_VER			// Check RTOS version compatibility.
+	#if __OS_VER < 1
+		#error "Proce_ADC_Driver: Incompatible OS version"
+	#endif
+#else
+	#error "Proce_ADC_Driver: An RTOS is required with this function"
+#endif
+
+///
+/// Description	:
+/// Acquisition of a set of analog inputs at a fixed rate.  Each rising edge of TIOA of TC0
+/// channel 2 starts a scan, the ADC converts the enabled channels one after the other, lowest
+/// channel first, and the PDC moves the results into the circular buffer gstrcADCBlock[].
+/// The rate is thus set by the timer only, without jitter, and the CPU only works once per
+/// block: on ENDRX the PDC has moved to the next block, ADC_Handler() stamps the block full
+/// and gives a free block to the PDC as the next one, then wakes up the driver task.  The
+/// driver task calls the consumer routine with each full block in turn, then frees it.
+///
+/// A block holds unScanCount scans, it is stamped with its no. unSeq, and the no. of its first
+/// scan unScan, which gives the time of the trigger exactly, and with gunClockTick and
+/// __OS_CYCLE_COUNT() when it is full.  When the consumer is too slow and no block is free,
+/// the block just filled is reused and counted in unOverrun, so the blocks given to the
+/// consumer are never overwritten, and a gap in unSeq shows the blocks lost.  If ADC_Handler()
+/// is delayed by a whole block, the PDC runs out of buffers and the results meanwhile are lost,
+/// counted in unLost, unScan is then no longer exact.
+///
+/// Note: 16 Oct 2026, SAM4S_Init() disables the clock of the ADC with the other peripherals,
+/// the driver enables it.  The ADC clock is MCK / ((PRESCAL + 1) x 2), up to
+/// __ADC_CLOCK_MAX_HZ, i.e. 20 MHz at 120 MHz, and a conversion takes about
+/// __ADC_CONVERSION_CLOCK ADC clocks, so the scans x channels per second are limited to about
+/// 1 MHz.  PRESCAL and the start-up time are computed from the master clock, again when the
+/// master clock is changed, as the period of the trigger timer.
+///
+/// Example of usage : Three inputs at 100 ksps each, blocks of 3 msec.
+///			void Consumer(const ADC_BLOCK *ptrBlock, void *ptrArg)	// Called by the driver task.
+///			{
+///				if (ptrBlock->unSeq != gunLastSeq + 1)	// Blocks lost.
+///				...
+///				for (ni = 0; ni < 300; ni++)			// AD0, AD1 and AD4 of each scan.
+///				{
+///					nSum += ptrBlock->unData[3*ni] - ptrBlock->unData[3*ni + 1];
+///				}
+///			}
+///
+///			OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_ADC_Driver);	// In main().
+///			ADCStart(0x13, 100000, 300, Consumer, 0);		// Once the driver is initialized.
+///
+void Proce_ADC_Driver(TASK_ATTRIBUTE *ptrTask)
+{
+	ADC_BLOCK *ptrBlock;
+	int nIndex;
+	int nOldest;
+
+	switch (ptrTask->nState)
+	{
+		case 0: // State 0 - Initialization.
+			PMC->PMC_PCER0 |= PMC_PCER0_PID29;		// Enable peripheral clock to ADC (ID29).
+			ADC->ADC_CR = ADC_CR_SWRST;
+			ADC->ADC_MR = ADCMode(gunMCKHz);		// Software trigger, all channels off.
+			ADC->ADC_IDR = 0xFFFFFFFF;
+			gstrcADC.bytActive = 0;
+			gnADCTask = ptrTask->nID;
+			OSClockRegister(&gstrcADCClock);
+			NVIC_ClearPendingIRQ(ADC_IRQn);
+			NVIC_EnableIRQ(ADC_IRQn);
+			OSSetTaskContext(ptrTask, 1, 1);		// Next state = 1, timer = 1.
+			break;
+
+		case 1: // State 1 - Give the full blocks to the consumer, oldest first, then sleep.
+			OSGetEvent(ptrTask, __ADC_EVENT_BLOCK);
+			while (1)
+			{
+				nOldest = -1;
+				for (nIndex = 0; nIndex < __ADC_BLOCK_COUNT; nIndex++)
+				{
+					ptrBlock = &gstrcADCBlock[nIndex];
+					if ((ptrBlock->bytState == __ADC_BLOCK_READY) &&
+						((nOldest < 0) || ((int)(ptrBlock->unSeq - gstrcADCBlock[nOldest].unSeq) < 0)))
+					{
+						nOldest = nIndex;
+					}
+				}
+				if (nOldest < 0)
+				{
+					break;
+				}
+				if (gstrcADC.fptrBlock != 0)
+				{
+					gstrcADC.fptrBlock(&gstrcADCBlock[nOldest], gstrcADC.ptrArg);
+				}
+				gstrcADC.unBlock++;
+				gstrcADCBlock[nOldest].bytState = __ADC_BLOCK_FREE;
+			}
+			OSWaitEvent(ptrTask, 1, __ADC_EVENT_BLOCK, 0);	// Woken up by ADC_Handler().
+			break;
+
+		default:
+			OSSetTaskContext(ptrTask, 0, 1);		// Back to state = 0, timer = 1.
+			break;
+	}
+}
+
+// Function name	: ADCMode
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: ADC_MR for a master clock, software trigger.  The start-up time is 0, 8,
+//                    16, 24, 64, 80, 96, 112 ADC clocks, then 512 + 64 x (STARTUP - 8) ADC
+//                    clocks.
+// Arguments		: unMCKHz = master clock frequency in Hz.
+// Return			: The value of ADC_MR.
+static uint32_t ADCMode(unsigned int unMCKHz)
+{
+	unsigned int unPrescal = (unMCKHz + 2 * __ADC_CLOCK_MAX_HZ - 1) / (2 * __ADC_CLOCK_MAX_HZ);
+	unsigned int unClocks;
+	unsigned int unStartup = 0;
+	unsigned int unPeriod = 0;
+
+	unPrescal = (unPrescal > 0) ? unPrescal - 1 : 0;
+	unClocks = (unMCKHz / (2 * (unPrescal + 1)) / 1000) * __ADC_STARTUP_US / 1000;
+	while ((unPeriod < unClocks) && (unStartup < 15))
+	{
+		unStartup++;
+		unPeriod = (unStartup < 4) ? 8 * unStartup : ((unStartup < 8) ? 64 + 16 * (unStartup - 4) :
+				   512 + 64 * (unStartup - 8));
+	}
+	return ADC_MR_PRESCAL(unPrescal) | ADC_MR_STARTUP(unStartup) | ADC_MR_SETTLING(3) | ADC_MR_TRACKTIM(0) |
+		   ADC_MR_TRANSFER(1);
+}
+
+// Function name	: ADCTimer
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Set TC0 channel 2 to trigger the ADC at a rate.  The counter counts from
+//                    0 to RC, TIOA is set on RA and cleared on RC, the rising edge of TIOA
+//                    starting a scan.  The fastest clock with RC below 65536 is used.
+// Arguments		: unMCKHz = master clock frequency in Hz.
+//                    unRateHz = scans per second.
+// Return			: The rate generated, 0 if the rate is too high.
+static unsigned int ADCTimer(unsigned int unMCKHz, unsigned int unRateHz)
+{
+	static const unsigned int unDiv[4] = {2, 8, 32, 128};	// TIMER_CLOCK1 to TIMER_CLOCK4.
+	unsigned int unClock = 0;
+	unsigned int unCount = 0;
+
+	while (unClock < 4)
+	{
+		unCount = (unMCKHz / unDiv[unClock] + unRateHz / 2) / unRateHz;
+		if (unCount <= 65536)
+		{
+			break;
+		}
+		unClock++;
+	}
+	if ((unClock == 4) || (unCount < 3))
+	{
+		return 0;
+	}
+	TC0->TC_CHANNEL[2].TC_CMR = (TC_CMR_TCCLKS_TIMER_CLOCK1 + unClock) | TC_CMR_WAVE | TC_CMR_WAVSEL_UP_RC |
+								TC_CMR_ACPA_SET | TC_CMR_ACPC_CLEAR;
+	TC0->TC_CHANNEL[2].TC_RC = unCount - 1;
+	TC0->TC_CHANNEL[2].TC_RA = unCount / 2;
+	return unMCKHz / unDiv[unClock] / unCount;
+}
+
+// Function name	: ADCArm
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Give the blocks in state __ADC_BLOCK_FILL and __ADC_BLOCK_NEXT to the PDC.
+// Arguments		: None.
+// Return			: None.
+static void ADCArm(void)
+{
+	unsigned int unLength = gstrcADC.unScanCount * gstrcADC.unChannelCount;
+
+	PDC_ADC->PERIPH_RPR = (uint32_t)(uintptr_t) gstrcADCBlock[gstrcADC.bytFill].unData;
+	PDC_ADC->PERIPH_RCR = unLength;
+	PDC_ADC->PERIPH_RNPR = (uint32_t)(uintptr_t) gstrcADCBlock[gstrcADC.bytNext].unData;
+	PDC_ADC->PERIPH_RNCR = unLength;
+}
+
+///
+/// Function name	: ADCStart
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Start the acquisition, see Proce_ADC_Driver().  The driver task must be
+///                   initialized.  A running acquisition is stopped first.
+///
+/// Arguments		: unChannel = channels, bit n = ADn.
+///                   unRateHz = scans per second, scans x channels max. about 1 MHz.
+///                   unScanCount = scans per block, scans x channels max. __ADC_BLOCK_SAMPLES.
+///                   fptrBlock = consumer, called by the driver task with each full block and
+///                   ptrArg, 0 if none.
+///                   ptrArg = argument of fptrBlock.
+///
+/// Return			: 0 if success, 1 if an argument is wrong.
+///
+int ADCStart(uint32_t unChannel, unsigned int unRateHz, unsigned int unScanCount,
+			 void (*fptrBlock)(const ADC_BLOCK *, void *), void *ptrArg)
+{
+	ADC_ACQ *ptrAcq = &gstrcADC;
+	uint32_t unMode = ADCMode(gunMCKHz);
+	unsigned int unCount = 0;
+	int nIndex;
+
+	for (nIndex = 0; nIndex < 16; nIndex++)
+	{
+		unCount += (unChannel >> nIndex) & 1;
+	}
+	if ((unCount == 0) || (unChannel > 0xFFFF) || (unRateHz == 0) || (unScanCount == 0) ||
+		(unScanCount * unCount > __ADC_BLOCK_SAMPLES) ||
+		((unsigned long long) unRateHz * unCount * __ADC_CONVERSION_CLOCK * 2 *
+		 (((unMode & ADC_MR_PRESCAL_Msk) >> 8) + 1) > gunMCKHz))
+	{
+		return 1;
+	}
+	ADCStop();
+	ptrAcq->unChannel = unChannel;
+	ptrAcq->unChannelCount = unCount;
+	ptrAcq->unScanCount = unScanCount;
+	ptrAcq->unRateHz = unRateHz;
+	ptrAcq->fptrBlock = fptrBlock;
+	ptrAcq->ptrArg = ptrArg;
+	ptrAcq->unSeq = 0;
+	ptrAcq->unBlock = 0;
+	ptrAcq->unOverrun = 0;
+	ptrAcq->unLost = 0;
+	for (nIndex = 0; nIndex < __ADC_BLOCK_COUNT; nIndex++)
+	{
+		gstrcADCBlock[nIndex].bytState = __ADC_BLOCK_FREE;
+	}
+	ptrAcq->bytFill = 0;
+	ptrAcq->bytNext = 1;
+	gstrcADCBlock[0].bytState = __ADC_BLOCK_FILL;
+	gstrcADCBlock[1].bytState = __ADC_BLOCK_NEXT;
+
+	PMC->PMC_PCER0 |= PMC_PCER0_PID25;		// Enable peripheral clock to TC0 channel 2 (ID25).
+	TC0->TC_CHANNEL[2].TC_CCR = TC_CCR_CLKDIS;
+	TC0->TC_CHANNEL[2].TC_IDR = 0xFFFFFFFF;
+	ptrAcq->unActualHz = ADCTimer(gunMCKHz, unRateHz);
+	if (ptrAcq->unActualHz == 0)
+	{
+		return 1;
+	}
+	ADC->ADC_CHDR = 0xFFFF;
+	ADC->ADC_CHER = unChannel;
+	ADC->ADC_MR = unMode | ADC_MR_TRGEN_EN | ADC_MR_TRGSEL(_ADC_TRGSEL_TC2);
+	ADCArm();
+	ptrAcq->bytActive = 1;
+	ADC->ADC_IER = _ADC_INT_PDC;
+	PDC_ADC->PERIPH_PTCR = PERIPH_PTCR_RXTEN;
+	TC0->TC_CHANNEL[2].TC_CCR = TC_CCR_CLKEN | TC_CCR_SWTRG;	// Start the scans.
+	return 0;
+}
+
+///
+/// Function name	: ADCStop
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Stop the acquisition.  The scans of the block being filled are dropped,
+///                   the full blocks are still given to the consumer.
+///
+/// Arguments		: None.
+///
+/// Return			: None.
+///
+void ADCStop(void)
+{
+	int nIndex;
+
+	TC0->TC_CHANNEL[2].TC_CCR = TC_CCR_CLKDIS;
+	ADC->ADC_IDR = _ADC_INT_PDC;
+	PDC_ADC->PERIPH_PTCR = PERIPH_PTCR_RXTDIS;
+	if (gstrcADC.bytActive == 1)
+	{
+		ADC->ADC_MR = ADCMode(gunMCKHz);
+		ADC->ADC_CHDR = 0xFFFF;
+		for (nIndex = 0; nIndex < __ADC_BLOCK_COUNT; nIndex++)
+		{
+			if (gstrcADCBlock[nIndex].bytState != __ADC_BLOCK_READY)
+			{
+				gstrcADCBlock[nIndex].bytState = __ADC_BLOCK_FREE;
+			}
+		}
+	}
+	gstrcADC.bytActive = 0;
+}
+
+///
+/// Function name	: ADCClockChange
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Called by OSSetClock(), the ADC clock and the divisor of the trigger
+///                   timer are recomputed after the master clock is changed.  A clock too
+///                   slow for the rate of the acquisition is refused.
+///
+/// Arguments		: unMCKHz = new master clock frequency in Hz.
+///                   nPhase = __OS_CLOCK_CHECK, __OS_CLOCK_PRE or __OS_CLOCK_POST.
+///
+/// Return			: 1 to refuse the new clock, 0 otherwise.
+///
+int ADCClockChange(unsigned int unMCKHz, int nPhase)
+{
+	ADC_ACQ *ptrAcq = &gstrcADC;
+	uint32_t unMode = ADCMode(unMCKHz);
+
+	if (nPhase == __OS_CLOCK_CHECK)
+	{
+		return ((ptrAcq->bytActive == 1) &&
+				((unsigned long long) ptrAcq->unRateHz * ptrAcq->unChannelCount * __ADC_CONVERSION_CLOCK * 2 *
+				 (((unMode & ADC_MR_PRESCAL_Msk) >> 8) + 1) > unMCKHz)) ? 1 : 0;
+	}
+	if (nPhase == __OS_CLOCK_POST)
+	{
+		ADC->ADC_MR = (ADC->ADC_MR & ~(ADC_MR_PRESCAL_Msk | ADC_MR_STARTUP_Msk)) | unMode;
+		if (ptrAcq->bytActive == 1)
+		{
+			ptrAcq->unActualHz = ADCTimer(unMCKHz, ptrAcq->unRateHz);
+			TC0->TC_CHANNEL[2].TC_CCR = TC_CCR_SWTRG;	// Restart the period with the new divisor.
+		}
+	}
+	return 0;
+}
+
+///
+/// Function name	: ADC_Handler
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: ADC interrupt service routine.  On ENDRX the PDC has moved to the next
+///                   block, the block filled is stamped and a free block is given to the PDC
+///                   as the next one.  If there is none the block filled is given again and
+///                   counted as overrun.  On RXBUFF the PDC has no buffer left, both blocks
+///                   are given again.
+///
+/// Arguments		: None.
+///
+/// Return			: None.
+///
+void ADC_Handler(void)
+{
+	ADC_ACQ *ptrAcq = &gstrcADC;
+	ADC_BLOCK *ptrBlock;
+	uint32_t unStatus;
+	int nFree;
+
+	__OS_TRACE_EVENT(__TRACE_ISR_ENTER, ADC_IRQn + 16, 0);
+	unStatus = ADC->ADC_ISR & ADC->ADC_IMR;
+	if (unStatus & ADC_ISR_RXBUFF)
+	{
+		ptrAcq->unLost++;
+		ptrAcq->unSeq += 2;						// The two blocks are lost.
+		ADCArm();
+	}
+	else if (unStatus & ADC_ISR_ENDRX)
+	{
+		ptrBlock = &gstrcADCBlock[ptrAcq->bytFill];
+		ptrBlock->unSeq = ++ptrAcq->unSeq;
+		ptrBlock->unScan = (ptrAcq->unSeq - 1) * ptrAcq->unScanCount;
+		ptrBlock->unTick = gunClockTick;
+		ptrBlock->unCycle = __OS_CYCLE_COUNT();
+		for (nFree = 0; nFree < __ADC_BLOCK_COUNT; nFree++)
+		{
+			if (gstrcADCBlock[nFree].bytState == __ADC_BLOCK_FREE)
+			{
+				break;
+			}
+		}
+		if (nFree == __ADC_BLOCK_COUNT)
+		{
+			ptrAcq->unOverrun++;				// Fill the same block again.
+			nFree = ptrAcq->bytFill;
+		}
+		else
+		{
+			ptrBlock->bytState = __ADC_BLOCK_READY;
+		}
+		gstrcADCBlock[ptrAcq->bytNext].bytState = __ADC_BLOCK_FILL;
+		gstrcADCBlock[nFree].bytState = __ADC_BLOCK_NEXT;
+		ptrAcq->bytFill = ptrAcq->bytNext;
+		ptrAcq->bytNext = nFree;
+		PDC_ADC->PERIPH_RNPR = (uint32_t)(uintptr_t) gstrcADCBlock[nFree].unData;
+		PDC_ADC->PERIPH_RNCR = ptrAcq->unScanCount * ptrAcq->unChannelCount;
+		if (nFree != ptrBlock - gstrcADCBlock)
+		{
+			OSSignalEvent(gnADCTask, __ADC_EVENT_BLOCK);
+		}
+	}
+	__OS_TRACE_EVENT(__TRACE_ISR_EXIT, ADC_IRQn + 16, 0);
+}
@@ -0,0 +1,74 @@
+// Author			: Fabian Kung
+// Date				: 16 Oct 2026
+// Filename			: Driver_ADC_V100.h
+
+#ifndef _DRIVER_ADC_SAM4S_H
+#define _DRIVER_ADC_SAM4S_H
+
+// Include common header to all drivers and sources.  Here absolute path is used.
+// To edit if one change folder
+#include "osmain.h"
+
+//
+// --- PUBLIC CONSTANTS ---
+//
+#define __ADC_CLOCK_MAX_HZ		20000000		// ADC clock used, max. 22 MHz on the SAM4S.
+#define __ADC_CONVERSION_CLOCK	20				// ADC clocks per conversion.
+#define __ADC_STARTUP_US		20				// Start-up time of the ADC, in usec.
+#define __ADC_BLOCK_COUNT		4				// Blocks of the circular buffer.
+#define __ADC_BLOCK_SAMPLES		1024			// Max. samples per block.
+#define __ADC_EVENT_BLOCK		0x00000001		// Event flag of the driver task, a block is full.
+
+#define __ADC_BLOCK_FREE		0				// States of a block.
+#define __ADC_BLOCK_FILL		1				// Being filled by the PDC.
+#define __ADC_BLOCK_NEXT		2				// Given to the PDC as the next buffer.
+#define __ADC_BLOCK_READY		3				// Full, waiting for the driver task.
+
+//
+// --- PUBLIC DATATYPES ---
+//
+// Type cast for a block of the circular buffer, a whole no. of scans of the channels.
+typedef struct StructADCBlock
+{
+	unsigned int unSeq;					// No. of the block since ADCStart(), from 1.
+	unsigned int unScan;				// No. of the first scan since ADCStart(), its trigger is
+										// at unScan / unActualHz seconds after the start.
+	unsigned int unTick;				// gunClockTick when the block is full.
+	uint32_t unCycle;					// __OS_CYCLE_COUNT() when the block is full.
+	volatile uint8_t bytState;			// __ADC_BLOCK_FREE, __ADC_BLOCK_FILL...
+	uint16_t unData[__ADC_BLOCK_SAMPLES];	// Results, the lowest channel first in each scan.
+} ADC_BLOCK;
+
+// Type cast for the acquisition, see ADCStart().
+typedef struct StructADCAcq
+{
+	uint32_t unChannel;					// Channels converted, bit n = ADn.
+	unsigned int unChannelCount;		// No. of channels.
+	unsigned int unScanCount;			// Scans per block.
+	unsigned int unRateHz;				// Scans per second requested.
+	unsigned int unActualHz;			// Scans per second generated by the timer.
+	void (*fptrBlock)(const ADC_BLOCK *, void *);	// Consumer, called by the driver task.
+	void *ptrArg;						// Argument of fptrBlock().
+	volatile uint8_t bytActive;			// 1 while the acquisition runs.
+	uint8_t bytFill;					// Block being filled by the PDC.
+	uint8_t bytNext;					// Block given to the PDC as the next one.
+	unsigned int unSeq;					// No. of blocks filled.
+	unsigned int unBlock;				// No. of blocks given to the consumer.
+	unsigned int unOverrun;				// No. of blocks lost, the consumer is too slow.
+	unsigned int unLost;				// No. of times the PDC ran out of buffers.
+} ADC_ACQ;
+
+extern  ADC_ACQ gstrcADC;
+extern  ADC_BLOCK gstrcADCBlock[__ADC_BLOCK_COUNT];
+extern  int         gnADCTask;                  // Handle of the driver task.
+
+//
+// --- PUBLIC FUNCTION PROTOTYPE ---
+//
+void Proce_ADC_Driver(TASK_ATTRIBUTE *);
+int ADCStart(uint32_t, unsigned int, unsigned int, void (*)(const ADC_BLOCK *, void *), void *);
+void ADCStop(void);
+int ADCClockChange(unsigned int, int);
+void ADC_Handler(void);
+
+#endif
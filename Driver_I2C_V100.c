@@ -9,11 +9,12 @@
 //
 // File				: Drivers_I2C_V100.c
 // Author(s)		: Fabian Kung
-// Last modified	: 25 Nov 2015
+// Last modified	: 16 Oct 2026
 // Toolsuites		: Atmel Studio 6.2 or later
 //                    GCC C-Compiler
 
 #include "osmain.h"
+#include "Driver_I2C_V100.h"
 
 // NOTE: Public function prototypes are declared in the corresponding *.h file.
 
@@ -23,45 +24,85 @@
 //
 
 // Data buffer and address pointers for wired serial communications.
-#define     __MAX_I2C_DATA_BYTE               16     // Number of bytes for I2C receive and transmit buffer.
-#define     __I2C_TIMEOUT_COUNT               25    // No. of system ticks before the I2C routine timeout during
-                                                    // read data stage.
-#define     __I2C_BAUD_RATE_MHZ               0.2   // 200 kHz
-
-I2C_STATUS  gI2CStat;                   // I2C status.
-uint8_t     gbytI2CSlaveAdd;            // Slave address (7 bit, from bit0-bit6).
-uint8_t     gbytI2CRegAdd;              // Slave register address.
-uint8_t     gbytI2CByteCount;           // No. of bytes to read or write to Slave.
+#define     __I2C_TIMEOUT_COUNT               25    // No. of system ticks before a read or write transaction
+                                                    // is aborted, including the time the Slaves stretch SCL.
+#define     __I2C_BAUD_RATE_HZ                100000   // SCL clock frequency of TWI0, 100 kHz.
+#define     __I2C1_BAUD_RATE_HZ               400000   // SCL clock frequency of TWI1, 400 kHz.
+#define     __I2C_POLL_TICK                   __NUM_SYSTEMTICK_MSEC   // Max. no. of system ticks before the
+                                                    // idle driver checks gI2CStat.bSend/bRead.
+#define     __I2C_RECOVER_CLOCK               9     // Max. no. of SCL pulses to free SDA, see I2CBusRecover().
+#define     __I2C_INT_ALL                     (TWI_IDR_TXCOMP | TWI_IDR_RXRDY | TWI_IDR_TXRDY | TWI_IDR_NACK | \
+                                               TWI_IDR_ENDRX | TWI_IDR_ENDTX)
+                                                    // Interrupts used by I2CHandler().
+// Phases of a transfer, see I2CHandler().
+#define     __I2C_PHASE_IDLE                  0
+#define     __I2C_PHASE_ENDRX                 1     // PDC receiving the data except the last 2 bytes.
+#define     __I2C_PHASE_PENULT                2     // Receiving the second last byte.
+#define     __I2C_PHASE_LASTRX                3     // Receiving the last byte.
+#define     __I2C_PHASE_ENDTX                 4     // PDC sending the data except the last byte.
+#define     __I2C_PHASE_LASTTX                5     // Sending the last byte.
+#define     __I2C_PHASE_COMP                  6     // Waiting for the STOP condition.
+
 uint8_t     gbytI2CRXbuf[__MAX_I2C_DATA_BYTE];                // Data read from Slave register.
 uint8_t     gbytI2CTXbuf[__MAX_I2C_DATA_BYTE];               // Data to write to Slave register.
+I2C_TRANSACTION gstrcI2CQueueBuf[__I2C_QUEUE_LENGTH];         // Storage of the transaction queue.
+OS_QUEUE    gstrcI2CQueue = {0, 0, __I2C_QUEUE_LENGTH-1, sizeof(I2C_TRANSACTION), (uint8_t *) gstrcI2CQueueBuf};
+                                        // Queue of transactions.
+uint8_t     gbytI2CRXbuf1[__MAX_I2C_DATA_BYTE];               // Same for TWI1.
+uint8_t     gbytI2CTXbuf1[__MAX_I2C_DATA_BYTE];
+I2C_TRANSACTION gstrcI2CQueueBuf1[__I2C_QUEUE_LENGTH];
+OS_QUEUE    gstrcI2CQueue1 = {0, 0, __I2C_QUEUE_LENGTH-1, sizeof(I2C_TRANSACTION), (uint8_t *) gstrcI2CQueueBuf1};
+
+// Descriptors of the ports, PA3 = TWD0, PA4 = TWCK0, PB4 = TWD1, PB5 = TWCK1, all in peripheral A.
+// PB4 and PB5 are the JTAG TDI and TDO pins after reset, given to the PIO with CCFG_SYSIO.
+const I2C_CONFIG gstrcI2C0Config = {
+	TWI0, PDC_TWI0, PIOA, PIO_PDR_P3, PIO_PDR_P4, 0, TWI0_IRQn, ID_TWI0, 0,
+	gbytI2CRXbuf, gbytI2CTXbuf, &gstrcI2CQueue};
+const I2C_CONFIG gstrcI2C1Config = {
+	TWI1, PDC_TWI1, PIOB, PIO_PDR_P4, PIO_PDR_P5, CCFG_SYSIO_SYSIO4 | CCFG_SYSIO_SYSIO5, TWI1_IRQn, ID_TWI1, 1,
+	gbytI2CRXbuf1, gbytI2CTXbuf1, &gstrcI2CQueue1};
+I2C_PORT gstrcI2C0 = {&gstrcI2C0Config, __I2C_BAUD_RATE_HZ};
+I2C_PORT gstrcI2C1 = {&gstrcI2C1Config, __I2C1_BAUD_RATE_HZ};
+
+I2C_PORT *gptrI2CPort[__I2C_PORTS];			// Ports initialized, see I2CClockChange().
+OS_CLOCK_CLIENT gstrcI2CClock = {I2CClockChange, 0};        // Notification of master clock change.
+
+static void I2CNext(TASK_ATTRIBUTE *, I2C_PORT *);
+static void I2CStart(I2C_PORT *, uint8_t, uint32_t, int, uint8_t *, uint8_t, int);
+static void I2CEnd(TASK_ATTRIBUTE *, I2C_PORT *);
+static void I2CReset(I2C_PORT *);
+static int I2CBusRecover(const I2C_CONFIG *);
+static uint32_t I2CWaveform(unsigned int, unsigned int);
 
 ///
-/// Function name	: Proce_I2C_Driver
+/// Function name	: I2CDriver
 ///
 /// Author			: Fabian Kung
 ///
-/// Last modified	: 25 Nov 2015
+/// Last modified	: 16 Oct 2026
 ///
 /// Code Version	: 0.80
 ///
 /// Processor		: ARM Cortex-M4 family
 ///
 /// Processor/System Resource
-/// PINS		: 1. Pin PA4 = TWCK0, peripheral A, output.
-///               2. Pin PA3 = TWD0, peripheralA, input/output.
+/// PINS		: Given by the descriptor of each port (I2C_CONFIG):
+///               1. TWI0: Pin PA4 = TWCK0, Pin PA3 = TWD0, peripheral A.
+///               2. TWI1: Pin PB5 = TWCK1, Pin PB4 = TWD1, peripheral A.
 ///
-/// MODULES		: 1. TWI0 (Internal) on Peripheral A.
+/// MODULES		: 1. TWI0 and TWI1 (Internal) on Peripheral A, with interrupt and PDC.
 ///
 /// RTOS		: Ver 1 or above, round-robin scheduling.
 ///
-/// Global Variables    :
+/// Global Variables    : gstrcI2C0, gstrcI2C1, gptrI2CPort[], gbytI2CRXbuf[], gbytI2CTXbuf[],
+///                       gstrcI2CQueue, gbytI2CRXbuf1[], gbytI2CTXbuf1[], gstrcI2CQueue1.
 
 #ifdef __OS_VER			// Check RTOS version compatibility.
 	#if __OS_VER < 1
-		#error "Proce_I2C0_Driver: Incompatible OS version"
+		#error "I2CDriver: Incompatible OS version"
 	#endif
 #else
-	#error "Proce_I2C0_Driver: An RTOS is required with this function"
+	#error "I2CDriver: An RTOS is required with this function"
 #endif
 
 ///
@@ -70,9 +111,16 @@ uint8_t     gbytI2CTXbuf[__MAX_I2C_DATA_BYTE];               // Data to write to
 /// This driver handles the low-level transmit and receive
 /// operations. It assumes a single Master (i.e. this processor) and multiple slaves
 /// environment.
+///
+/// Note: 16 Oct 2026, the same codes now drive TWI0 and TWI1, each port is given by a constant
+/// descriptor (I2C_CONFIG) and its variables are kept in an I2C_PORT, as for the serial ports
+/// (see "Driver_SCI_V100.c").  Proce_I2C0_Driver() and Proce_I2C1_Driver() with TWI0_Handler()
+/// and TWI1_Handler() only call I2CDriver() and I2CHandler() with the port, so both buses
+/// run concurrently.  The globals gI2CStat, gbytI2CSlaveAdd, gbytI2CRegAdd, gbytI2CByteCount and
+/// gnI2C0Task are kept for TWI0, see "Driver_I2C_V100.h".
 
 /// I2C bus properties:
-/// Baud rate = 100 kHz.
+/// Baud rate = 100 kHz (TWI0) and 400 kHz (TWI1), changed with I2CSetBaud().
 /// Mode: Single Master.
 ///
 /// --- Example of usage: Transmit operation ---
@@ -108,7 +156,8 @@ uint8_t     gbytI2CTXbuf[__MAX_I2C_DATA_BYTE];               // Data to write to
 /// }
 /// The user routine can monitor the flag gI2CStat.bI2CBusy or gI2CStat.bRead.  Once the
 /// transmission is completed, both flags will be cleared by the driver.  The received
-/// data will be stored in gbytI2CRXbuf[0].
+/// data will be stored in gbytI2CRXbuf[0].  Up to __MAX_I2C_DATA_BYTE bytes can be read from
+/// consecutive registers.
 /// if (gI2CStat.bRead == 0)       // Check if Read operation is completed.
 /// {                              // Read operation complete, check received data.
 ///     User codes here
@@ -116,39 +165,109 @@ uint8_t     gbytI2CTXbuf[__MAX_I2C_DATA_BYTE];               // Data to write to
 /// else if (gI2CStat.bCommError == 1)  // Check for I2C bus error.
 /// {
 /// }
+///
+/// --- Example of usage: Queued transmit operation ---
+/// Note: 16 Oct 2026, write transactions can also be passed to the driver through the
+/// queue gstrcI2CQueue.  The producer does not need to wait for the bus, the
+/// driver starts the next transaction in the queue as soon as the current one ends.  The 
+/// transactions set with gI2CStat.bSend and gI2CStat.bRead are served first.  The same 
+/// transaction as the transmit example above:
+/// I2C_TRANSACTION strcTrans = {0};  // Unused fields must be 0.
+///
+/// strcTrans.bytSlaveAdd = 0x1E;
+/// strcTrans.bytRegAdd = 0x20;
+/// strcTrans.bytByteCount = 2;
+/// strcTrans.bytData[0] = 0xFA;
+/// strcTrans.bytData[1] = 0xCD;
+/// strcTrans.nTaskNotify = ptrTask->nID;  // Optional, 0 if not needed.
+/// if (I2C0PutTransaction(&strcTrans) == 1)
+/// {                              // Queue is full, try again later.
+/// }
+/// OSWaitEvent(ptrTask, 2, __I2C_EVENT_DONE, 0); // Optional, suspend until the transaction ends.
+///
+/// --- Example of usage: Queued read operation ---
+/// Note: 16 Oct 2026, any task can put transactions into the queue (but not an interrupt
+/// service routine, as tasks do not preempt each other), so several clients share the bus
+/// without waiting for gI2CStat.bI2CBusy.  The transactions are served back-to-back, the next
+/// one is started by the driver task as soon as TWI0_Handler() signals the end of the current
+/// one.  A transaction can also read from the Slave, after writing the register address and up
+/// to __I2C_MAX_WRITE_READ bytes, with a repeated START in between.  E.g. reading 6 bytes from
+/// register 0x28 of Slave 0x1E into bytAccel[], then calling SensorDone():
+/// void SensorDone(I2C_TRANSACTION *ptrTrans, int nError)
+/// {                              // Called by the driver task.
+///     User codes here, ptrTrans->ptrArg is strcTrans.ptrArg.
+/// }
+///
+/// I2C_TRANSACTION strcTrans = {0};
+///
+/// strcTrans.bytSlaveAdd = 0x1E;
+/// strcTrans.bytRegAdd = 0x28;
+/// strcTrans.bytReadCount = 6;
+/// strcTrans.ptrbytRead = bytAccel; // Or 0, then the data is in ptrTrans->bytData[] of the callback.
+/// strcTrans.fptrDone = SensorDone;  // Or nTaskNotify, or both.
+/// I2C0PutTransaction(&strcTrans);
+///
+/// Note: 16 Oct 2026, the read and the write are done by I2CHandler(), the driver task starts
+/// the transfer with I2CStart() and sleeps until it ends.  The register address is sent from
+/// TWI_IADR and the data bytes by the PDC, so a transaction takes the bus time only, e.g. about
+/// 0.9 msec to read 16 bytes at 200 kHz.  A transaction not completed within 
+/// __I2C_TIMEOUT_COUNT system ticks is aborted and gI2CStat.bCommError is set, as when the
+/// Slave does not acknowledge.
+///
+/// Note: 16 Oct 2026, the driver task is suspended while it is idle, I2C0PutTransaction() 
+/// wakes it up.  When gI2CStat.bSend is set the transaction starts within __I2C_POLL_TICK
+/// system ticks, or at once if the user routine also calls 
+/// OSSignalEvent(gnI2C0Task, __I2C_EVENT_REQUEST).
+///
+/// Note: 16 Oct 2026, the SCL frequency is set per port with I2CSetBaud(), up to 1 MHz, and the
+/// clock waveform is computed from the master clock by I2CWaveform(), again when the master
+/// clock is changed.  In Fast mode (above 100 kHz) the low period is stretched to the minimum
+/// of the I2C specification, 1.3 usec, or 0.5 usec in Fast mode Plus (above 400 kHz).  Note
+/// that the TWI of the SAM4S is only specified up to 400 kHz, 1 MHz needs strong pull-up
+/// resistors and a short bus.  A Slave may hold SCL low (clock stretching), the TWI waits
+/// for SCL to be released, up to __I2C_TIMEOUT_COUNT system ticks for the whole transaction.
+/// After a timeout, and at initialization, the bus is recovered by I2CBusRecover(): a Slave
+/// holding SDA low, e.g. after a reset of the Master in the middle of a read, is clocked out
+/// then a STOP condition is generated.
+///
+/// Example of usage : Two sensors on TWI1 at 400 kHz, each queueing its own reads.
+///          OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_I2C1_Driver);	// In main().
+///          strcTrans.bytSlaveAdd = 0x68; strcTrans.bytRegAdd = 0x3B; strcTrans.bytReadCount = 14;
+///          I2C1PutTransaction(&strcTrans);
 
-void Proce_I2C0_Driver(TASK_ATTRIBUTE *ptrTask)
+void I2CDriver(TASK_ATTRIBUTE *ptrTask, I2C_PORT *ptrPort)
 {
-    static int nIndex = 0;
-    //static int nTimeOut = 0;
-    static int nCount = 0;
+	const I2C_CONFIG *ptrConfig = ptrPort->ptrConfig;
+	Pio *ptrPio = ptrConfig->ptrPio;
+	uint32_t unPins = ptrConfig->unPinSda | ptrConfig->unPinScl;
 
     if (ptrTask->nTimer == 0)
     {
 		switch (ptrTask->nState)
 		{
-            case 0: // State 0 - Initialization of I2C2 module and set as Master mode.
-                gI2CStat.bCommError = 0;                // Clear error flag.
-                gI2CStat.bI2CBusy = 1;                  // Initially indicate I2C module is busy.
-                gbytI2CRXbuf[0] = 0;					// After a short delay we will clear the busy flag.
-                gbytI2CRegAdd = 0;
-                gI2CStat.bSend = 0;
-                gI2CStat.bRead = 0;
+            case 0: // State 0 - Initialization of TWI module and set as Master mode.
+                ptrPort->strcStatus.bCommError = 0;     // Clear error flag.
+                ptrPort->strcStatus.bI2CBusy = 1;       // Initially indicate I2C module is busy.
+                ptrConfig->ptrRXbuf[0] = 0;				// After a short delay we will clear the busy flag.
+                ptrPort->bytRegAdd = 0;
+                ptrPort->strcStatus.bSend = 0;
+                ptrPort->strcStatus.bRead = 0;
 																// 24 Nov 2015: To enable a peripheral, we need to:
 																// 1. Assign the IO pins to the peripheral.
 																// 2. Select the correct peripheral block (A, B, C or D).
-				PIOA->PIO_PDR = (PIOA->PIO_PDR) | PIO_PDR_P3;	// Set PA3 and PA4 to be controlled by Peripheral.
-				PIOA->PIO_PDR = (PIOA->PIO_PDR) | PIO_PDR_P4;	// TWI0 (Two-wire Interface 0) resides in
-																// in Peripheral block A, with PA3 = SDA and
-																// PA4 = SCL. 
-				
-				PIOA->PIO_ABCDSR[0] = (PIOA->PIO_ABCDSR[0]) & ~PIO_ABCDSR_P3;	// Select peripheral block A for
-				PIOA->PIO_ABCDSR[1] = (PIOA->PIO_ABCDSR[1]) & ~PIO_ABCDSR_P3;	// PA3.
-				PIOA->PIO_ABCDSR[0] = (PIOA->PIO_ABCDSR[0]) & ~PIO_ABCDSR_P4;	// Select peripheral block A for
-				PIOA->PIO_ABCDSR[1] = (PIOA->PIO_ABCDSR[1]) & ~PIO_ABCDSR_P4;	// PA4.	
-							
-				TWI0->TWI_MMR = TWI_MMR_DADR(gbytI2CSlaveAdd);	// Set Slave device address (7-bits).
-				
+				if (ptrConfig->unSysIO != 0)					// JTAG pins used as PIO.
+				{
+					MATRIX->CCFG_SYSIO |= ptrConfig->unSysIO;
+				}
+				ptrPio->PIO_ABCDSR[0] = (ptrPio->PIO_ABCDSR[0]) & ~unPins;	// Select peripheral block A.
+				ptrPio->PIO_ABCDSR[1] = (ptrPio->PIO_ABCDSR[1]) & ~unPins;
+				ptrPort->unRecover += I2CBusRecover(ptrConfig);	// Free SDA, then set the pins to be
+																// controlled by the Peripheral.
+
+				// Note: 16 Oct 2026, the peripheral clock is enabled before the TWI registers are
+				// written, the registers of a peripheral without clock ignore the writes.
+				PMC->PMC_PCER0 = 1u << ptrConfig->bytID;		// Enable peripheral clock to TWI.
+
 				// 23 Nov 2015: Set clock waveform.
 				// Here we are setting the clock to 100 kHz.  Thus tLow = 5 usec, tHigh = 5 usec.
 				// Where
@@ -161,233 +280,711 @@ void Proce_I2C0_Driver(TASK_ATTRIBUTE *ptrTask)
 				// 100 kHz clock.
 				// CLDIV = CHDIV = 149
 				// CKDIV = 2
-				TWI0->TWI_CWGR = (TWI0->TWI_CWGR) | TWI_CWGR_CLDIV(149) | TWI_CWGR_CHDIV(149);
-				TWI0->TWI_CWGR = (TWI0->TWI_CWGR) | TWI_CWGR_CKDIV(2);
-				TWI0->TWI_CR = (TWI0->TWI_CR) | TWI_CR_SVDIS;	// Disable Slave mode.
-				TWI0->TWI_CR = (TWI0->TWI_CR) | TWI_CR_MSEN;	// Enable the Master mode. 
-				PMC->PMC_PCER0 |= PMC_PCER0_PID19;		// Enable peripheral clock to TWI0 (ID19)
-				OSSetTaskContext(ptrTask, 49, 30*__NUM_SYSTEMTICK_MSEC);     // Next state = 49, timer = 30 msec.
-				//OSSetTaskContext(ptrTask, 45, 5000);     // Next state = 45, timer = 5000.
+				// Note: 16 Oct 2026, the divisors are now computed by I2CWaveform() from the master
+				// clock and ptrPort->unHz, see I2CSetBaud().
+				if (I2CWaveform(gunMCKHz, ptrPort->unHz) == 0)
+				{
+					ptrPort->unHz = 100000;						// Not possible at this clock.
+				}
+				I2CReset(ptrPort);								// Disable Slave mode, enable Master mode.
+				ptrConfig->ptrTwi->TWI_MMR = TWI_MMR_DADR(ptrPort->bytSlaveAdd);	// Set Slave device address (7-bits).
+				gptrI2CPort[ptrConfig->bytIndex] = ptrPort;
+				OSClockRegister(&gstrcI2CClock);				// Recomputed by I2CClockChange().
+				NVIC_ClearPendingIRQ(ptrConfig->nIRQ);
+				NVIC_EnableIRQ(ptrConfig->nIRQ);
+				ptrPort->nTask = ptrTask->nID;
+				OSSetTaskContext(ptrTask, 1, 30*__NUM_SYSTEMTICK_MSEC);     // Next state = 1, timer = 30 msec.
             break;
 
             case 1: // State 1 - Dispatcher.
-                if (gI2CStat.bRead == 1)                  // Reading data from Slave.
-                {
-                    gI2CStat.bI2CBusy = 1;                // Indicate I2C module is occupied.
-                    OSSetTaskContext(ptrTask, 30, 1);     // Next state = 30, timer = 1.
-                }
-                else if (gI2CStat.bSend == 1)             // Transmission of data to Slave.
-                {
-                    gI2CStat.bI2CBusy = 1;                // Indicate I2C module is occupied.
-                    OSSetTaskContext(ptrTask, 45, 1);     // Next state = 45, timer = 1.
-                }
-                else
-                {
-                    OSSetTaskContext(ptrTask, 1, 1);     // Next state = 1, timer = 1.
-                }
+                I2CNext(ptrTask, ptrPort);
                 break;
-/*
-            // --- Multi-byte read ---
-            case 30: // State 30 - Assert Start condition.
-                I2C2CONbits.SEN = 1;                      // Assert Start condiction on I2C bus.
-                nCount = 0;                              // Reset counter.
-                OSSetTaskContext(ptrTask, 31, 1);        // Back to state = 31, timer = 1.
-            break;
 
-           case 31: // State 31 - Tx slave device address, write mode.
-                I2C2TRN = gbytI2CSlaveAdd<<1;              // Data = Slave address with R/W bit = 0 (Master is writing to the Slave).
-                OSSetTaskContext(ptrTask, 32, 1);        // Back to state = 32, timer = 1.
-           break;
+            // --- Multi-byte master read ---
+            case 42: // State 42 - Tidy up, the read ends or timeout.
+                I2CEnd(ptrTask, ptrPort);
+                ptrPort->strcStatus.bRead = 0;
+                I2CNext(ptrTask, ptrPort);                          // Start the next transaction at once.
+                break;
 
-           case 32: // State 32 - Check status of transmission.
-                if (I2C2STATbits.TRSTAT == 1)           // Check if Master transmission is still in progress.
+            // --- Multi-byte master write and queued transactions ---
+            case 49: // State 49 - Tidy up, the transaction ends or timeout.
+                I2CEnd(ptrTask, ptrPort);
+                if (ptrPort->ptrTrans != 0)							// Release the transaction from the queue.
                 {
-                    OSSetTaskContext(ptrTask, 32, 1);    // Back to state = 32, timer = 1.
-                }
-                else                                    // Transmission end, check acknowledgment from Slave.
-                {
-                    if (I2C2STATbits.ACKSTAT == 0)      // ACK received from Slave, continue.
+                    if (ptrPort->ptrTrans->fptrDone != 0)
                     {
-                        gI2CStat.bCommError = 0;
-                        OSSetTaskContext(ptrTask, 33, 1);    // Next state = 33, timer = 1.
+                        ptrPort->ptrTrans->fptrDone(ptrPort->ptrTrans, ptrPort->strcStatus.bCommError);
                     }
-                    else                                // NAK received from Slave, end.
+                    if (ptrPort->ptrTrans->nTaskNotify != 0)
                     {
-                        gI2CStat.bCommError = 1;        // Set communication error flag.
-                        OSSetTaskContext(ptrTask, 41, 1);    // Next state = 41, timer = 1.
-                    }    
-                }
-                break;
-
-           case 33: // State 33 - TX start register to read.
-                I2C2TRN = gbytI2CRegAdd;                 // Send register address to read.
-                OSSetTaskContext(ptrTask, 34, 1);        // Next state = 34, timer = 1.
-                break;
-
-           case 34: // State 34 - Check status of transmission.
-                if (I2C2STATbits.TRSTAT == 1)           // Check if Master transmission is still in progress.
-                {
-                    OSSetTaskContext(ptrTask, 34, 1);   // Back to state = 34, timer = 1.
+                        OSSignalEvent(ptrPort->ptrTrans->nTaskNotify, __I2C_EVENT_DONE);
+                    }
+                    OSQueueRemove(ptrConfig->ptrQueue);
+                    ptrPort->ptrTrans = 0;
                 }
-                else                                    // Transmission end, check acknowledge from Slave.
+                else
                 {
-                    if (I2C2STATbits.ACKSTAT == 0)      // ACK received from Slave, continue.
-                    {
-                        gI2CStat.bCommError = 0;
-                        OSSetTaskContext(ptrTask, 35, 1);    // Next state = 35, timer = 1.
-                    }
-                    else                                // NAK received from Slave, end.
-                    {
-                        gI2CStat.bCommError = 1;        // Set communication error flag.
-                        OSSetTaskContext(ptrTask, 41, 1);    // Next state = 41, timer = 1.
-                    }                   
+                    ptrPort->strcStatus.bSend = 0;
                 }
+                I2CNext(ptrTask, ptrPort);                          // Start the next transaction at once.
                 break;
 
-            case 35: // State 35 - Initiate Restart condition.
-                I2C2CONbits.RSEN = 1;                   // Assert repeat start condition on I2C bus.
-                OSSetTaskContext(ptrTask, 36, 1);        // Next state = 36, timer = 1.
-                break;
+            default:
+		OSSetTaskContext(ptrTask, 0, 1); // Back to state = 0, timer = 1.
+            break;
+        }
+    }
+}
 
-           case 36: // State 36 - Tx slave device address, read mode.
-                I2C2TRN = (gbytI2CSlaveAdd<<1) | 0x01;     // Data = Slave address with R/W bit = 1 (Master is reading from the Slave).
-                OSSetTaskContext(ptrTask, 37, 1);        //  Next state = 37, timer = 1.
-                break;
+///
+/// Function name	: Proce_I2C0_Driver
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Driver for TWI0, see I2CDriver().
+///
+/// Arguments		: ptrTask = the task.
+///
+/// Return			: None.
+///
+void Proce_I2C0_Driver(TASK_ATTRIBUTE *ptrTask)
+{
+	I2CDriver(ptrTask, &gstrcI2C0);
+}
 
-           case 37: // State 37 - Check status of transmission.
-                if (I2C2STATbits.TRSTAT == 1)           // Check if Master transmission is still in progress.
-                {
-                    OSSetTaskContext(ptrTask, 37, 1);    // Back to state = 37, timer = 1.
-                }
-                else                                    // Transmission end, check acknowledge from Slave.
-                {
-                    if (I2C2STATbits.ACKSTAT == 0)      // ACK received from Slave, continue.
-                    {
-                        gI2CStat.bCommError = 0;
-                        OSSetTaskContext(ptrTask, 38, 1);    // Next state = 38, timer = 1.
-                    }
-                    else                                // NAK received from Slave, end.
-                    {
-                        gI2CStat.bCommError = 1;        // Set communication error flag.
-                        OSSetTaskContext(ptrTask, 41, 1);    // Next state = 41, timer = 1.
-                    }
-                    
-                }
-                break;
+///
+/// Function name	: Proce_I2C1_Driver
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Driver for TWI1, see I2CDriver().
+///
+/// Arguments		: ptrTask = the task.
+///
+/// Return			: None.
+///
+void Proce_I2C1_Driver(TASK_ATTRIBUTE *ptrTask)
+{
+	I2CDriver(ptrTask, &gstrcI2C1);
+}
 
-           case 38: // State 38 - Enable receive.
-               I2C2CONbits.RCEN = 1;                    // Enable receive operation.
-               nTimeOut = 0;                            // Reset timeout timer.
-               OSSetTaskContext(ptrTask, 39, 1);        // Next state = 39, timer = 1.
-               break;
+///
+/// Function name	: TWI0_Handler
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: TWI0 interrupt service routine, see I2CHandler().
+///
+/// Arguments		: None.
+///
+/// Return			: None.
+///
+void TWI0_Handler(void)
+{
+	I2CHandler(&gstrcI2C0);
+}
 
-           case 39: // State 39 - Check for receive buffer full status.
-                if (I2C2STATbits.RBF == 1)              // Check if all bits are received.
-                {
-                    gbytI2CRXbuf[nCount] = I2C2RCV;      // Get received data.
-                    OSSetTaskContext(ptrTask, 40, 1);   // Next state = 40, timer = 1.
-                }
-                else
-                {
-                    nTimeOut++;
-                    if (nTimeOut > __I2C_TIMEOUT_COUNT)  // Check for timeout.
-                    {
-                        gI2CStat.bCommError = 1;        // Set communication error flag.
-                        OSSetTaskContext(ptrTask, 40, 1);   // Next state = 40, timer = 1.
-                    }
-                    else
-                    {
-                        OSSetTaskContext(ptrTask, 39, 1);   // Next state = 39, timer = 1.
-                    }
-                }
-                break;
+///
+/// Function name	: TWI1_Handler
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: TWI1 interrupt service routine, see I2CHandler().
+///
+/// Arguments		: None.
+///
+/// Return			: None.
+///
+void TWI1_Handler(void)
+{
+	I2CHandler(&gstrcI2C1);
+}
 
-            case 40: // State 40 - Master generates acknowledgment.
-                gbytI2CByteCount--;
-                nCount++;
-                // Check of end of data to read, or the I2C receive buffer is full.
-                if ((gbytI2CByteCount == 0) || (nCount == __MAX_I2C_DATA_BYTE))
-                {
-                    I2C2CONbits.ACKDT = 1;                   // Set NAK when receive data.
-                    I2C2CONbits.ACKEN = 1;                   // Enable acknowledgement sequence.
-                    OSSetTaskContext(ptrTask, 41, 1);        // Next state = 41, timer = 1.
-                }
-                else                                         // Still in reading mode.
-                {
-                    I2C2CONbits.ACKDT = 0;                   // Set ACK when receive data.
-                    I2C2CONbits.ACKEN = 1;                   // Enable acknowledgement sequence.
-                    OSSetTaskContext(ptrTask, 38, 1);        // Next state = 38, timer = 1.
-                }
-               break;
+///
+/// Function name	: I2CNext
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Start the next transaction, the one set with bRead or bSend of the port
+///                   status first, then the oldest one in the queue.  A queued transaction with
+///                   bytReadCount > 0 is a write of the register address and up to
+///                   __I2C_MAX_WRITE_READ bytes of bytData[] from TWI_IADR, followed by a read
+///                   with a repeated START.  The driver task is suspended until the transaction
+///                   ends, or until a new request if there is none.
+///
+/// Arguments		: ptrTask = the driver task.
+///                   ptrPort = the port.
+///
+/// Return			: None.
+///
+static void I2CNext(TASK_ATTRIBUTE *ptrTask, I2C_PORT *ptrPort)
+{
+	const I2C_CONFIG *ptrConfig = ptrPort->ptrConfig;
+	I2C_TRANSACTION *ptrTrans;
+	uint32_t unIadr;
+	int nSize;
+	int ni;
 
-            case 41: // State 41 - End, initiate Stop condition on I2C bus.
-                I2C2CONbits.PEN = 1;                    // Initiate Stop condition.
-                OSSetTaskContext(ptrTask, 42, 1);        // Next state = 42, timer = 1.
-                break;
+	OSGetEvent(ptrTask, __I2C_EVENT_REQUEST);				// Clear the request flag.
+	if (ptrPort->strcStatus.bRead == 1)						// Reading data from Slave.
+	{
+		ptrPort->strcStatus.bI2CBusy = 1;					// Indicate I2C module is occupied.
+		I2CStart(ptrPort, ptrPort->bytSlaveAdd, ptrPort->bytRegAdd, 1, ptrConfig->ptrRXbuf, ptrPort->bytByteCount, 1);
+		OSWaitEvent(ptrTask, 42, __I2C_EVENT_COMPLETE, __I2C_TIMEOUT_COUNT);
+	}
+	else if (ptrPort->strcStatus.bSend == 1)				// Transmission of data to Slave.
+	{
+		ptrPort->strcStatus.bI2CBusy = 1;
+		I2CStart(ptrPort, ptrPort->bytSlaveAdd, ptrPort->bytRegAdd, 1, ptrConfig->ptrTXbuf, ptrPort->bytByteCount, 0);
+		OSWaitEvent(ptrTask, 49, __I2C_EVENT_COMPLETE, __I2C_TIMEOUT_COUNT);
+	}
+	else if ((ptrTrans = (I2C_TRANSACTION *) OSQueuePeek(ptrConfig->ptrQueue)) != 0)
+	{														// The transaction stays in the queue
+		ptrPort->ptrTrans = ptrTrans;						// until it ends.
+		ptrPort->strcStatus.bI2CBusy = 1;
+		if (ptrTrans->bytReadCount > 0)						// Write then read.
+		{
+			nSize = (ptrTrans->bytByteCount < __I2C_MAX_WRITE_READ) ? ptrTrans->bytByteCount : __I2C_MAX_WRITE_READ;
+			unIadr = ptrTrans->bytRegAdd;					// The TWI sends the most significant
+			for (ni = 0; ni < nSize; ni++)					// byte of IADR first.
+			{
+				unIadr = (unIadr << 8) | ptrTrans->bytData[ni];
+			}
+			I2CStart(ptrPort, ptrTrans->bytSlaveAdd, unIadr, nSize + 1,
+					 (ptrTrans->ptrbytRead != 0) ? ptrTrans->ptrbytRead : ptrTrans->bytData,
+					 ptrTrans->bytReadCount, 1);
+		}
+		else
+		{
+			I2CStart(ptrPort, ptrTrans->bytSlaveAdd, ptrTrans->bytRegAdd, 1, ptrTrans->bytData,
+					 ptrTrans->bytByteCount, 0);
+		}
+		OSWaitEvent(ptrTask, 49, __I2C_EVENT_COMPLETE, __I2C_TIMEOUT_COUNT);
+	}
+	else
+	{														// Nothing to do, suspend until a request.
+		ptrPort->strcStatus.bI2CBusy = 0;					// I2C module is idle.
+		OSWaitEvent(ptrTask, 1, __I2C_EVENT_REQUEST, __I2C_POLL_TICK);
+	}
+}
 
-            case 42: // State 42 - Tidy up.
-                gI2CStat.bI2CBusy = 0;                  // I2C module is idle.
-                gI2CStat.bRead = 0;
-                OSSetTaskContext(ptrTask, 1, 1);        // Next state = 1, timer = 1.
-                break;
-*/
-            // --- Multi-byte master write ---
-            case 45: // State 45 - Reset the TWI module to Master write mode, and load Slave address.
-                nCount = 0;											// Reset pointer.
-				//TWI0->TWI_MMR = TWI_MMR_DADR(gbytI2CSlaveAdd<<1);	// Load Slave device address (7-bits).
-				TWI0->TWI_MMR = TWI_MMR_DADR(gbytI2CSlaveAdd);		// Load Slave device address (7-bits).
-                TWI0->TWI_MMR = TWI0->TWI_MMR & ~TWI_MMR_MREAD;		// Clear MREAD, TX mode.
-                OSSetTaskContext(ptrTask, 46, 1);					// Next state = 46, timer = 1.
-                break;
+///
+/// Function name	: I2CStart
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Start a read or write transaction on the TWI of the port, the rest of the
+///                   transaction is done by I2CHandler(), which signals __I2C_EVENT_COMPLETE to
+///                   the driver task when the STOP condition is sent.  The register address is
+///                   sent by the TWI from TWI_IADR, and a read uses a repeated START.  Except the
+///                   last 2 bytes of a read and the last byte of a write, the data is moved by
+///                   the PDC.  A write of 0 byte only sends the register address.
+///
+/// Arguments		: ptrPort = the port.
+///                   bytSlaveAdd = Slave address (7 bit).
+///                   unIadr = Slave register address, followed by the bytes written before a
+///                   read.
+///                   nIadrSize = no. of bytes of unIadr, 1 to 3, only 1 for a write.
+///                   ptrbytData = data to write, or buffer for the data read.
+///                   bytCount = no. of bytes, limited to __MAX_I2C_DATA_BYTE.
+///                   bRead = 1 to read, 0 to write.
+///
+/// Return			: None.
+///
+static void I2CStart(I2C_PORT *ptrPort, uint8_t bytSlaveAdd, uint32_t unIadr, int nIadrSize, uint8_t *ptrbytData,
+					 uint8_t bytCount, int bRead)
+{
+	Twi *ptrTwi = ptrPort->ptrConfig->ptrTwi;
+	Pdc *ptrPdc = ptrPort->ptrConfig->ptrPdc;
 
-           case 46: // State 46 - TX start register to write to.  Note: Before sending the first byte,
-					// a START condition will be asserted by the TWI Master.
-                TWI0->TWI_THR = gbytI2CRegAdd;						// Send register address to update.
-                OSSetTaskContext(ptrTask, 47, 1);					// Next state = 47, timer = 1.
-           break;
+	if (bytCount > __MAX_I2C_DATA_BYTE)
+	{
+		bytCount = __MAX_I2C_DATA_BYTE;
+	}
+	if ((bRead == 1) && (bytCount == 0))
+	{
+		bytCount = 1;										// The TWI reads at least 1 byte.
+	}
+	ptrPort->ptrbytData = ptrbytData;
+	ptrPort->bytCount = bytCount;
+	ptrPort->bytNack = 0;
+	ptrTwi->TWI_IDR = __I2C_INT_ALL;
+	ptrPdc->PERIPH_PTCR = PERIPH_PTCR_RXTDIS | PERIPH_PTCR_TXTDIS;
+	(void) ptrTwi->TWI_SR;									// Clear the NACK flag.
+	if (bRead == 1)
+	{
+		ptrTwi->TWI_MMR = TWI_MMR_DADR(bytSlaveAdd) | (((uint32_t) nIadrSize << TWI_MMR_IADRSZ_Pos) & TWI_MMR_IADRSZ_Msk) |
+						  TWI_MMR_MREAD;
+		ptrTwi->TWI_IADR = TWI_IADR_IADR(unIadr);
+		if (bytCount == 1)									// START and STOP together for a single
+		{													// byte.
+			ptrPort->bytPhase = __I2C_PHASE_LASTRX;
+			ptrTwi->TWI_CR = TWI_CR_START | TWI_CR_STOP;
+			ptrTwi->TWI_IER = TWI_IER_RXRDY | TWI_IER_NACK;
+		}
+		else if (bytCount == 2)
+		{
+			ptrPort->bytPhase = __I2C_PHASE_PENULT;
+			ptrTwi->TWI_CR = TWI_CR_START;
+			ptrTwi->TWI_IER = TWI_IER_RXRDY | TWI_IER_NACK;
+		}
+		else
+		{
+			ptrPdc->PERIPH_RPR = (uint32_t)(uintptr_t) ptrbytData;
+			ptrPdc->PERIPH_RCR = bytCount - 2;				// The STOP is set by I2CHandler() before
+			ptrPdc->PERIPH_RNCR = 0;						// the last byte.
+			ptrPdc->PERIPH_PTCR = PERIPH_PTCR_RXTEN;
+			ptrPort->bytPhase = __I2C_PHASE_ENDRX;
+			ptrTwi->TWI_CR = TWI_CR_START;
+			ptrTwi->TWI_IER = TWI_IER_ENDRX | TWI_IER_NACK;
+		}
+	}
+	else if (bytCount == 0)
+	{
+		ptrTwi->TWI_MMR = TWI_MMR_DADR(bytSlaveAdd);		// The register address is the only byte.
+		ptrPort->bytPhase = __I2C_PHASE_COMP;
+		ptrTwi->TWI_THR = (uint8_t) unIadr;					// Writing THR asserts the START condition.
+		ptrTwi->TWI_CR = TWI_CR_STOP;
+		ptrTwi->TWI_IER = TWI_IER_TXCOMP | TWI_IER_NACK;
+	}
+	else
+	{
+		ptrTwi->TWI_MMR = TWI_MMR_DADR(bytSlaveAdd) | TWI_MMR_IADRSZ_1_BYTE;
+		ptrTwi->TWI_IADR = TWI_IADR_IADR(unIadr);
+		if (bytCount == 1)
+		{
+			ptrPort->bytPhase = __I2C_PHASE_COMP;
+			ptrTwi->TWI_THR = ptrbytData[0];
+			ptrTwi->TWI_CR = TWI_CR_STOP;
+			ptrTwi->TWI_IER = TWI_IER_TXCOMP | TWI_IER_NACK;
+		}
+		else
+		{
+			ptrPdc->PERIPH_TPR = (uint32_t)(uintptr_t) ptrbytData;
+			ptrPdc->PERIPH_TCR = bytCount - 1;
+			ptrPdc->PERIPH_TNCR = 0;
+			ptrPort->bytPhase = __I2C_PHASE_ENDTX;
+			ptrTwi->TWI_IER = TWI_IER_ENDTX | TWI_IER_NACK;
+			ptrPdc->PERIPH_PTCR = PERIPH_PTCR_TXTEN;		// The first byte asserts the START condition.
+		}
+	}
+}
 
-           case 47: // State 47 - TX data.
-				if ((TWI0->TWI_SR & TWI_SR_TXRDY) == 0)				// Check if data is still in holding register (TWI_THR).
-                {
-                    OSSetTaskContext(ptrTask, 47, 1);				// Next state = 47, timer = 1.
-                }
-				else  
-				{													// Data-to-send is transferred to internal register.
-					if (gbytI2CByteCount > nCount)					// Check if there is another data byte to transmit.
-					{
-						TWI0->TWI_THR = gbytI2CTXbuf[nCount];		// Send data.
-						nCount++;									// Increment pointer.
-						OSSetTaskContext(ptrTask, 47, 1);			// Next state = 47, timer = 1.
-					}
-					else
-					{
-						TWI0->TWI_CR = TWI0->TWI_CR | TWI_CR_STOP;	// Assert STOP condition.
-						OSSetTaskContext(ptrTask, 48, 1);			// Next state = 48, timer = 1.
-					}
-					
-				}	
-                break;
+///
+/// Function name	: I2CEnd
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Called by the driver task once the transaction ends or after
+///                   __I2C_TIMEOUT_COUNT system ticks.  On timeout the bus is recovered, and the
+///                   TWI is reset and initialized again.  bCommError of the port status is set on
+///                   timeout or when the Slave does not acknowledge.
+///
+/// Arguments		: ptrTask = the driver task.
+///                   ptrPort = the port.
+///
+/// Return			: None.
+///
+static void I2CEnd(TASK_ATTRIBUTE *ptrTask, I2C_PORT *ptrPort)
+{
+	if (OSGetEvent(ptrTask, __I2C_EVENT_COMPLETE) == 0)		// Timeout.
+	{
+		ptrPort->ptrConfig->ptrTwi->TWI_IDR = __I2C_INT_ALL;
+		ptrPort->ptrConfig->ptrPdc->PERIPH_PTCR = PERIPH_PTCR_RXTDIS | PERIPH_PTCR_TXTDIS;
+		ptrPort->bytPhase = __I2C_PHASE_IDLE;
+		ptrPort->unTimeout++;
+		ptrPort->ptrConfig->ptrTwi->TWI_CR = TWI_CR_SWRST;	// Release the pins before the recovery.
+		ptrPort->unRecover += I2CBusRecover(ptrPort->ptrConfig);
+		I2CReset(ptrPort);
+		OSGetEvent(ptrTask, __I2C_EVENT_COMPLETE);			// Signalled before the interrupt is disabled.
+		ptrPort->strcStatus.bCommError = 1;
+	}
+	else
+	{
+		ptrPort->strcStatus.bCommError = ptrPort->bytNack;
+	}
+}
+
+///
+/// Function name	: I2CHandler
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Interrupt service routine of a TWI, moves a transaction started by
+///                   I2CStart() through its phases:
+///                   1. Read: at the end of the PDC receive the interrupt on RXRDY is enabled.
+///                      When the second last byte is received the STOP command is set before
+///                      RHR is read, so that the TWI does not acknowledge the last byte.
+///                   2. Write: at the end of the PDC transmit the last byte is written to THR
+///                      when TXRDY is set, followed by the STOP command.
+///                   3. Once TXCOMP is set, or when the Slave does not acknowledge, the
+///                      interrupts are disabled and the driver task is signalled.
+///
+/// Arguments		: ptrPort = the port.
+///
+/// Return			: None.
+///
+void I2CHandler(I2C_PORT *ptrPort)
+{
+	const I2C_CONFIG *ptrConfig = ptrPort->ptrConfig;
+	Twi *ptrTwi = ptrConfig->ptrTwi;
+	uint32_t unStatus;
 
-           case 48: // State 48 - Check TXCOMP flag.
-				if ((TWI0->TWI_SR & TWI_SR_TXCOMP) == 0)			// Check if Master transmission is still in progress.
+	__OS_TRACE_EVENT(__TRACE_ISR_ENTER, ptrConfig->nIRQ + 16, 0);
+	unStatus = ptrTwi->TWI_SR & ptrTwi->TWI_IMR;			// NACK is cleared on read.
+	if (unStatus & TWI_SR_NACK)								// No acknowledge from Slave, the TWI ends
+	{														// the transaction.
+		ptrTwi->TWI_IDR = __I2C_INT_ALL;
+		ptrConfig->ptrPdc->PERIPH_PTCR = PERIPH_PTCR_RXTDIS | PERIPH_PTCR_TXTDIS;
+		ptrPort->bytNack = 1;
+		ptrPort->bytPhase = __I2C_PHASE_IDLE;
+		OSSignalEvent(ptrPort->nTask, __I2C_EVENT_COMPLETE);
+	}
+	else
+	{
+		switch (ptrPort->bytPhase)
+		{
+			case __I2C_PHASE_ENDRX:
+				if (unStatus & TWI_SR_ENDRX)
 				{
-					OSSetTaskContext(ptrTask, 48, 1);				// Next state = 48, timer = 1.
+					ptrConfig->ptrPdc->PERIPH_PTCR = PERIPH_PTCR_RXTDIS;
+					ptrTwi->TWI_IDR = TWI_IDR_ENDRX;
+					ptrTwi->TWI_IER = TWI_IER_RXRDY;
+					ptrPort->bytPhase = __I2C_PHASE_PENULT;
 				}
-				else
-				{													// Master transmission ends.
-					OSSetTaskContext(ptrTask, 49, 1);				// Next state = 49, timer = 1.
+				break;
+
+			case __I2C_PHASE_PENULT:
+				if (unStatus & TWI_SR_RXRDY)
+				{
+					ptrTwi->TWI_CR = TWI_CR_STOP;
+					ptrPort->ptrbytData[ptrPort->bytCount-2] = ptrTwi->TWI_RHR;
+					ptrPort->bytPhase = __I2C_PHASE_LASTRX;
 				}
-				break;  
+				break;
 
-            case 49: // State 49 - Tidy up.
-                gI2CStat.bI2CBusy = 0;								// I2C module is idle.
-                gI2CStat.bSend = 0;
-                OSSetTaskContext(ptrTask, 1, 1);					// Next state = 1, timer = 1.
-                break;
-				
-            default:
-		OSSetTaskContext(ptrTask, 0, 1); // Back to state = 0, timer = 1.
-            break;
-        }
-    }
-}
\ No newline at end of file
+			case __I2C_PHASE_LASTRX:
+				if (unStatus & TWI_SR_RXRDY)
+				{
+					ptrPort->ptrbytData[ptrPort->bytCount-1] = ptrTwi->TWI_RHR;
+					ptrTwi->TWI_IDR = TWI_IDR_RXRDY;
+					ptrTwi->TWI_IER = TWI_IER_TXCOMP;
+					ptrPort->bytPhase = __I2C_PHASE_COMP;
+				}
+				break;
+
+			case __I2C_PHASE_ENDTX:
+				if (unStatus & TWI_SR_ENDTX)
+				{
+					ptrConfig->ptrPdc->PERIPH_PTCR = PERIPH_PTCR_TXTDIS;
+					ptrTwi->TWI_IDR = TWI_IDR_ENDTX;
+					ptrTwi->TWI_IER = TWI_IER_TXRDY;
+					ptrPort->bytPhase = __I2C_PHASE_LASTTX;
+				}
+				break;
+
+			case __I2C_PHASE_LASTTX:
+				if (unStatus & TWI_SR_TXRDY)
+				{
+					ptrTwi->TWI_THR = ptrPort->ptrbytData[ptrPort->bytCount-1];
+					ptrTwi->TWI_CR = TWI_CR_STOP;
+					ptrTwi->TWI_IDR = TWI_IDR_TXRDY;
+					ptrTwi->TWI_IER = TWI_IER_TXCOMP;
+					ptrPort->bytPhase = __I2C_PHASE_COMP;
+				}
+				break;
+
+			case __I2C_PHASE_COMP:
+				if (unStatus & TWI_SR_TXCOMP)
+				{
+					ptrTwi->TWI_IDR = __I2C_INT_ALL;
+					ptrPort->bytPhase = __I2C_PHASE_IDLE;
+					OSSignalEvent(ptrPort->nTask, __I2C_EVENT_COMPLETE);
+				}
+				break;
+
+			default:
+				ptrTwi->TWI_IDR = __I2C_INT_ALL;
+				break;
+		}
+	}
+	__OS_TRACE_EVENT(__TRACE_ISR_EXIT, ptrConfig->nIRQ + 16, 0);
+}
+
+///
+/// Function name	: I2CReset
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Reset the TWI of the port, then set the clock waveform and the Master mode.
+///                   All the interrupts are disabled, they are enabled by I2CStart().
+///
+/// Arguments		: ptrPort = the port.
+///
+/// Return			: None.
+///
+static void I2CReset(I2C_PORT *ptrPort)
+{
+	Twi *ptrTwi = ptrPort->ptrConfig->ptrTwi;
+
+	ptrTwi->TWI_CR = TWI_CR_SWRST;
+	ptrTwi->TWI_IDR = __I2C_INT_ALL;
+	ptrTwi->TWI_CWGR = I2CWaveform(gunMCKHz, ptrPort->unHz);
+	ptrTwi->TWI_CR = TWI_CR_SVDIS;							// Disable Slave mode.
+	ptrTwi->TWI_CR = TWI_CR_MSEN;							// Enable the Master mode.
+	ptrPort->bytPhase = __I2C_PHASE_IDLE;
+}
+
+///
+/// Function name	: I2CBusRecover
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Free the bus from a Slave holding SDA low, as in the I2C specification: SDA
+///                   and SCL are driven as open-drain PIO pins, SCL is pulsed until the Slave
+///                   releases SDA (max. __I2C_RECOVER_CLOCK pulses), then a STOP condition is
+///                   generated.  The pins are given back to the TWI at the end.  The SCL period
+///                   is at least 10 usec, each access to the PIO taking at least 1 cycle of MCK.
+///
+/// Arguments		: ptrConfig = descriptor of the port.
+///
+/// Return			: 0 if SDA is high, 1 if it is still held low.
+///
+static int I2CBusRecover(const I2C_CONFIG *ptrConfig)
+{
+	Pio *ptrPio = ptrConfig->ptrPio;
+	uint32_t unSda = ptrConfig->unPinSda;
+	uint32_t unScl = ptrConfig->unPinScl;
+	unsigned int unHalf = gunMCKHz / 200000;				// Half SCL period of 5 usec, in accesses.
+	unsigned int unCount;
+	int nClock;
+	int nResult;
+
+	ptrPio->PIO_MDER = unSda | unScl;						// Open drain.
+	ptrPio->PIO_SODR = unSda | unScl;						// Released.
+	ptrPio->PIO_OER = unSda | unScl;
+	ptrPio->PIO_PER = unSda | unScl;						// Controlled by PIO.
+	for (nClock = 0; (nClock < __I2C_RECOVER_CLOCK) && ((ptrPio->PIO_PDSR & unSda) == 0); nClock++)
+	{
+		ptrPio->PIO_CODR = unScl;
+		for (unCount = 0; unCount < unHalf; unCount++)
+		{
+			(void) ptrPio->PIO_PDSR;
+		}
+		ptrPio->PIO_SODR = unScl;
+		for (unCount = 0; unCount < unHalf; unCount++)
+		{
+			(void) ptrPio->PIO_PDSR;
+		}
+	}
+	nResult = ((ptrPio->PIO_PDSR & unSda) == 0);
+	if (nClock > 0)											// STOP condition: SDA rising while SCL
+	{														// is high.
+		ptrPio->PIO_CODR = unScl;
+		ptrPio->PIO_CODR = unSda;
+		for (unCount = 0; unCount < unHalf; unCount++)
+		{
+			(void) ptrPio->PIO_PDSR;
+		}
+		ptrPio->PIO_SODR = unScl;
+		for (unCount = 0; unCount < unHalf; unCount++)
+		{
+			(void) ptrPio->PIO_PDSR;
+		}
+		ptrPio->PIO_SODR = unSda;
+	}
+	ptrPio->PIO_PDR = unSda | unScl;						// Controlled by peripheral.
+	return nResult;
+}
+
+///
+/// Function name	: I2CWaveform
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Compute the TWI clock waveform generator register for a SCL frequency.
+///                   tLow = ((CLDIV x 2^CKDIV) + 4) x tMCK and tHigh = ((CHDIV x 2^CKDIV) + 4) x tMCK.
+///                   In Standard mode (up to 100 kHz) tLow = tHigh.  In Fast mode tLow is at
+///                   least 1.3 usec, and 0.5 usec in Fast mode Plus (above 400 kHz), tHigh is the
+///                   rest of the period.  The divisors are rounded up and the smallest CKDIV is
+///                   chosen, so the SCL frequency never exceeds the requested value.
+///
+/// Arguments		: unMCKHz = master clock frequency in Hz.
+///                   unHz = SCL frequency in Hz, max. 1 MHz.
+///
+/// Return			: Value of TWI_CWGR, 0 if the frequency cannot be generated.
+///
+static uint32_t I2CWaveform(unsigned int unMCKHz, unsigned int unHz)
+{
+	unsigned int unPeriod;
+	unsigned int unLow;
+	unsigned int unLowMin;
+	unsigned int unHigh;
+	unsigned int unCkdiv;
+
+	if ((unHz == 0) || (unHz > 1000000))
+	{
+		return 0;
+	}
+	unPeriod = (unMCKHz + unHz - 1) / unHz;					// In MCK cycles.
+	unLow = (unPeriod + 1) / 2;
+	if (unHz > 400000)
+	{
+		unLowMin = (unMCKHz / 1000 * 500 + 999999) / 1000000;	// 0.5 usec.
+	}
+	else if (unHz > 100000)
+	{
+		unLowMin = (unMCKHz / 1000 * 1300 + 999999) / 1000000;	// 1.3 usec.
+	}
+	else
+	{
+		unLowMin = 0;
+	}
+	if (unLow < unLowMin)
+	{
+		unLow = unLowMin;
+	}
+	unHigh = (unPeriod > unLow) ? unPeriod - unLow : 0;
+	if ((unLow < 5) || (unHigh < 5))						// Divisor of at least 1.
+	{
+		return 0;
+	}
+	unLow -= 4;
+	unHigh -= 4;
+	for (unCkdiv = 0; unCkdiv < 7; unCkdiv++)
+	{
+		if (((unLow + (1u << unCkdiv) - 1) >> unCkdiv) <= 255)
+		{
+			break;
+		}
+	}
+	unLow = (unLow + (1u << unCkdiv) - 1) >> unCkdiv;
+	unHigh = (unHigh + (1u << unCkdiv) - 1) >> unCkdiv;
+	if ((unLow > 255) || (unHigh > 255))
+	{
+		return 0;
+	}
+	return TWI_CWGR_CLDIV(unLow) | TWI_CWGR_CHDIV(unHigh) | TWI_CWGR_CKDIV(unCkdiv);
+}
+
+///
+/// Function name	: I2CPutTransaction
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Put a transaction into the queue of a port and wake up its driver task.
+///                   This routine can be called by any task, but not by an interrupt service
+///                   routine.
+///
+/// Arguments		: ptrPort = the port.
+///                   ptrTrans = pointer to the transaction, which is copied into the queue.
+///
+/// Return			: 0 if success, 1 if the queue is full.
+///
+int I2CPutTransaction(I2C_PORT *ptrPort, I2C_TRANSACTION *ptrTrans)
+{
+	if (OSQueuePut(ptrPort->ptrConfig->ptrQueue, ptrTrans) == 1)
+	{
+		return 1;
+	}
+	OSSignalEvent(ptrPort->nTask, __I2C_EVENT_REQUEST);
+	return 0;
+}
+
+///
+/// Function name	: I2CSetBaud
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Change the SCL frequency of a port, e.g. 100000, 400000 or 1000000.  A
+///                   transaction in progress continues at the new frequency.  The frequency is
+///                   kept when the master clock is changed.
+///
+/// Arguments		: ptrPort = the port.
+///                   unHz = SCL frequency in Hz.
+///
+/// Return			: 0 if success, 1 if the frequency cannot be generated from the master clock.
+///
+int I2CSetBaud(I2C_PORT *ptrPort, unsigned int unHz)
+{
+	uint32_t unCWGR = I2CWaveform(gunMCKHz, unHz);
+
+	if (unCWGR == 0)
+	{
+		return 1;
+	}
+	ptrPort->unHz = unHz;
+	if (PMC->PMC_PCSR0 & (1u << ptrPort->ptrConfig->bytID))	// Else set by I2CDriver().
+	{
+		ptrPort->ptrConfig->ptrTwi->TWI_CWGR = unCWGR;
+	}
+	return 0;
+}
+
+///
+/// Function name	: I2CClockChange
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Called by OSSetClock() for all the ports initialized.  The TWI clock
+///                   divisors are recomputed after the master clock is changed.  As the Master
+///                   drives SCL, a transfer in progress simply continues at the new clock.  A
+///                   clock too slow for the SCL frequency of a port is refused.
+///
+/// Arguments		: unMCKHz = new master clock frequency in Hz.
+///                   nPhase = __OS_CLOCK_CHECK, __OS_CLOCK_PRE or __OS_CLOCK_POST.
+///
+/// Return			: 1 to refuse the new clock, 0 otherwise.
+///
+int I2CClockChange(unsigned int unMCKHz, int nPhase)
+{
+	I2C_PORT *ptrPort;
+	int nIndex;
+
+	for (nIndex = 0; nIndex < __I2C_PORTS; nIndex++)
+	{
+		ptrPort = gptrI2CPort[nIndex];
+		if (ptrPort == 0)
+		{
+			continue;
+		}
+		if ((nPhase == __OS_CLOCK_CHECK) && (I2CWaveform(unMCKHz, ptrPort->unHz) == 0))
+		{
+			return 1;
+		}
+		if (nPhase == __OS_CLOCK_POST)
+		{
+			ptrPort->ptrConfig->ptrTwi->TWI_CWGR = I2CWaveform(unMCKHz, ptrPort->unHz);
+		}
+	}
+	return 0;
+}
@@ -15,19 +15,106 @@
 //
 				
 // Data buffer and address pointers for wired serial communications.
-#define     __MAX_I2C_DATA_BYTE               16
+#define     __MAX_I2C_DATA_BYTE               16    // Number of bytes for I2C receive and transmit buffer.
+#define     __I2C_QUEUE_LENGTH                8     // No. of transactions in the I2C queue, must be a power of 2.
+#define     __I2C_EVENT_REQUEST               0x00000001  // Event flag of the driver task, new transaction.
+#define     __I2C_EVENT_COMPLETE              0x00000002  // Event flag of the driver task, signalled by
+                                                          // I2CHandler() when the transfer ends.
+#define     __I2C_EVENT_DONE                  0x80000000  // Event flag signalled to the client task when
+                                                          // its queued transaction ends.
 
-extern  I2C_STATUS  gI2CStat;                   // I2C status.
-extern  uint8_t     gbytI2CSlaveAdd;           // Slave address (7 bit, from bit0-bit6).
-extern  uint8_t     gbytI2CRegAdd;              // Slave register address.
-extern  uint8_t     gbytI2CByteCount;           // No. of bytes to read or write to Slave.
+#define     __I2C_MAX_WRITE_READ              2     // Max. no. of bytes written after the register address
+                                                    // in a write then read transaction.
+
+// Type cast for a structure defining a transaction in the I2C queue.  With bytReadCount = 0 this
+// is a write of bytByteCount bytes from the register bytRegAdd.  Otherwise the register address
+// and bytByteCount bytes of bytData[] (max. __I2C_MAX_WRITE_READ) are written, then
+// bytReadCount bytes are read after a repeated START.
+typedef struct StructI2CTransaction
+{
+	uint8_t bytSlaveAdd;						// Slave address (7 bit, from bit0-bit6).
+	uint8_t bytRegAdd;							// Slave register address.
+	uint8_t bytByteCount;						// No. of bytes to write to Slave.
+	uint8_t bytData[__MAX_I2C_DATA_BYTE];		// Data to write to Slave register.
+	int nTaskNotify;							// Handle of the task to signal with __I2C_EVENT_DONE
+												// when the transaction ends, 0 for none.
+	uint8_t bytReadCount;						// No. of bytes to read, max. __MAX_I2C_DATA_BYTE, 0 for
+												// a write.
+	uint8_t *ptrbytRead;						// Buffer for the data read, 0 to read into bytData[].
+	void (*fptrDone)(struct StructI2CTransaction *, int);	// Called by the driver task when the
+												// transaction ends, with the transaction in the queue
+												// and 1 on error (gI2CStat.bCommError), 0 for none.
+	void *ptrArg;								// For the use of fptrDone().
+} I2C_TRANSACTION;
+
+#define     __I2C_PORTS                       2     // TWI0 and TWI1.
+
+// Type cast for the descriptor of an I2C port, constant.
+typedef struct StructI2CConfig
+{
+	Twi *ptrTwi;
+	Pdc *ptrPdc;
+	Pio *ptrPio;						// PIO controller of the pins, all in peripheral A.
+	uint32_t unPinSda;
+	uint32_t unPinScl;
+	uint32_t unSysIO;					// CCFG_SYSIO bits to give the pins to the PIO, 0 if none.
+	IRQn_Type nIRQ;
+	uint8_t bytID;						// Peripheral ID, below 32.
+	uint8_t bytIndex;					// 0 to __I2C_PORTS-1.
+	uint8_t *ptrRXbuf;					// Data read from Slave register, see bRead.
+	uint8_t *ptrTXbuf;					// Data to write to Slave register, see bSend.
+	OS_QUEUE *ptrQueue;					// Queue of transactions.
+} I2C_CONFIG;
+
+// Type cast for the variables of an I2C port.
+typedef struct StructI2CPort
+{
+	const I2C_CONFIG *ptrConfig;
+	unsigned int unHz;					// SCL frequency, see I2CSetBaud().
+	I2C_STATUS strcStatus;
+	uint8_t bytSlaveAdd;				// Slave address (7 bit, from bit0-bit6), see bSend and bRead.
+	uint8_t bytRegAdd;					// Slave register address.
+	uint8_t bytByteCount;				// No. of bytes to read or write to Slave.
+	int nTask;							// Handle of the driver task.
+	I2C_TRANSACTION *ptrTrans;			// Transaction from the queue being served, 0 if none.
+	volatile uint8_t bytPhase;			// Phase of the transfer, see I2CHandler().
+	volatile uint8_t bytNack;			// Set by I2CHandler() when the Slave does not acknowledge.
+	uint8_t *ptrbytData;				// Data of the transfer in progress.
+	uint8_t bytCount;					// No. of data bytes of the transfer in progress.
+	unsigned int unRecover;				// No. of times SDA was still held low after a recovery.
+	unsigned int unTimeout;				// No. of transactions aborted on timeout.
+} I2C_PORT;
+
+extern  I2C_PORT    gstrcI2C0;                  // TWI0.
+extern  I2C_PORT    gstrcI2C1;                  // TWI1.
 extern  uint8_t     gbytI2CRXbuf[__MAX_I2C_DATA_BYTE];                // Data read from Slave register.
 extern  uint8_t     gbytI2CTXbuf[__MAX_I2C_DATA_BYTE];               // Data to write to Slave register.
+extern  OS_QUEUE    gstrcI2CQueue;              // Queue of transactions.
+extern  uint8_t     gbytI2CRXbuf1[__MAX_I2C_DATA_BYTE];               // Same for TWI1.
+extern  uint8_t     gbytI2CTXbuf1[__MAX_I2C_DATA_BYTE];
+extern  OS_QUEUE    gstrcI2CQueue1;
+
+// Variables of TWI0 under their former names.
+#define     gI2CStat                          (gstrcI2C0.strcStatus)      // I2C status.
+#define     gbytI2CSlaveAdd                   (gstrcI2C0.bytSlaveAdd)
+#define     gbytI2CRegAdd                     (gstrcI2C0.bytRegAdd)
+#define     gbytI2CByteCount                  (gstrcI2C0.bytByteCount)
+#define     gnI2C0Task                        (gstrcI2C0.nTask)
+#define     I2C0PutTransaction(ptrTrans)      I2CPutTransaction(&gstrcI2C0, (ptrTrans))
+#define     I2C1PutTransaction(ptrTrans)      I2CPutTransaction(&gstrcI2C1, (ptrTrans))
 
 
 //
 // --- PUBLIC FUNCTION PROTOTYPE ---
 //
+void I2CDriver(TASK_ATTRIBUTE *, I2C_PORT *);
+void I2CHandler(I2C_PORT *);
+int I2CPutTransaction(I2C_PORT *, I2C_TRANSACTION *);
+int I2CSetBaud(I2C_PORT *, unsigned int);
+int I2CClockChange(unsigned int, int);
 void Proce_I2C0_Driver(TASK_ATTRIBUTE *);
+void Proce_I2C1_Driver(TASK_ATTRIBUTE *);
+void TWI0_Handler(void);
+void TWI1_Handler(void);
 
 #endif
@@ -0,0 +1,1050 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	USER DRIVER ROUTINES DECLARATION (PROCESSOR DEPENDENT)
+//
+//  (c) Copyright 2026, Fabian Kung Wai Lee, Selangor, MALAYSIA
+//  All Rights Reserved
+//
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File				: Driver_SCI_V100.c
+// Author(s)		: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Toolsuites		: Atmel Studio 7.0 or later
+//					  GCC C-Compiler
+#include "osmain.h"
+#include "Driver_SCI_V100.h"
+
+
+// NOTE: Public function prototypes are declared in the corresponding *.h file.
+
+
+//
+// --- PRIVATE VARIABLES ---
+//
+SCI_PORT *gptrSCIPort[__SCI_PORTS];				// Ports initialized, see SCIClockChange().
+OS_CLOCK_CLIENT gstrcSCIClock = {SCIClockChange, 0};	// Notification of master clock change.
+
+//
+// --- PRIVATE FUNCTION PROTOTYPES ---
+//
+static void SCIRxArm(SCI_PORT *);
+static unsigned int SCIRxHead(SCI_PORT *);
+static void SCITxStart(SCI_PORT *);
+static void SCITxFeed(SCI_PORT *);
+static void SCIFrameStart(SCI_PORT *);
+static void SCIFrameDone(void *);
+static void SCIFrameFlush(SCI_PORT *);
+#if defined(__OS_TRACE) || defined(__OS_LOG)
+static void SCITraceStart(SCI_PORT *);
+#endif
+static uint32_t SCIDivisor(const SCI_CONFIG *, unsigned int, unsigned int);
+
+//
+// --- Process Level Constants Definition ---
+//
+#define	_SCI_RX_TIMEOUT		20		// Receiver time-out of the USART, in bit periods (2 characters).
+
+
+///
+/// Process name	: SCIDriver
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Code version	: 1.00
+///
+/// Processor		: ARM Cortex-M4 family
+///
+/// Processor/System Resource
+/// PINS		: Given by the descriptor of each port (SCI_CONFIG), see "Driver_UART_V100.c"
+///               and "Driver_USART_V100.c".
+///               PIN_ILED2 = indicator LED2.
+///
+/// MODULES		: 1. UART0, UART1, USART0 and USART1 (Internal).
+///               2. PDC (Peripheral DMA Controller) (Internal).
+///
+/// RTOS		: Ver 1 or above, round-robin scheduling.
+///
+/// Global variable	: gptrSCIPort[]
+///
+
+#ifdef 				  __OS_VER		// Check RTOS version compatibility.
+	#if 			  __OS_VER < 1
+		#error "SCIDriver: Incompatible OS version"
+	#endif
+#else
+	#error "SCIDriver: An RTOS is required with this function"
+#endif
+
+///
+/// Description		: Serial Communication Interface driver, one instance per port.  The UART and
+///                   USART ports share this code, each port is given by a constant descriptor
+///                   (SCI_CONFIG) with its registers, PDC, pins and buffers, and its variables
+///                   are kept in a SCI_PORT.  The process of each port, e.g. Proce_UART_Driver(),
+///                   and its interrupt service routine, e.g. UART0_Handler(), only call SCIDriver()
+///                   and SCIHandler() with the port, so all the ports can run concurrently.
+///                   1. Transmit buffer manager.
+///                      Data will be taken from the transmit buffer of the port in FIFO basis
+///                      once bTXRDY is set, with or without the assistance of the PDC (bTXDMAEN).
+///                   2. Receive buffer manager.
+///                      The received data are first stored by the PDC in the receive ring of
+///                      the port, in blocks of __SCI_RXRING_BLOCK bytes with the next block
+///                      always queued in RNPR/RNCR, so the processor does not handle each byte.
+///                      The ring is moved to the receive buffer on every tick as far as there is
+///                      space, the data wait in the ring otherwise, and the flag bRXRDY is set.
+///                      Alternatively a task reads the ring directly with SCIRxCount() and
+///                      SCIRxRead(), or in place with SCIRxPeek() and SCIRxSkip(), after calling
+///                      SCIRxOpen(), and can be signalled when a block is full or the line is
+///                      idle.  A USART detects the idle line with the receiver time-out after
+///                      _SCI_RX_TIMEOUT bit periods, a UART on the tick.
+///                   3. Transmit queue.
+///                      Data can also be passed to the driver through the single-producer byte
+///                      queue of the port, sent by the interrupt service routine.  The queue is
+///                      only served while there is no data pending in the transmit buffer.
+///                   4. Scatter-gather transmit.
+///                      A chain of blocks in the caller's memory (SCI_TX_DESC) can be sent with
+///                      SCITxSend() without copying.  The blocks are given to the PDC through
+///                      TPR/TNPR on the end of transmit interrupt, so they follow each other
+///                      without a gap, and a callback is executed once the last block is sent.
+///                   5. Frame queues.
+///                      Any task or interrupt service routine can submit frames (SCI_FRAME) with
+///                      SCIFrameSend(), at __SCI_PRIORITY_HIGH or __SCI_PRIORITY_LOW.  The frames
+///                      are sent in place as chains of one block, the high priority queue first,
+///                      and the owner can be signalled once its frame is sent.
+///                   6. Baud rate and handshaking.
+///                      The baud rate is changed with SCISetBaud() and recomputed when the master
+///                      clock is changed with OSSetClock().  A USART uses the fractional part FP
+///                      of the divisor, so rates of several Mbps are accurate.  SCISetHandshake()
+///                      enables the RTS/CTS flow control of a USART.
+///                   7. Execution trace.
+///                      When __OS_TRACE is defined the records of the Kernel execution trace are
+///                      sent by the PDC of the port with bytTrace = 1 whenever it is idle, see
+///                      OSTraceChunk().  When __OS_LOG is defined the records of the tokenized
+///                      log follow in the same way, after the trace, see OSLogChunk().
+///
+/// Example of usage : The codes example below illustrates how a task reads the receive ring of
+///          UART1, waiting for data with the event flag.  SCIRxOpen(&gstrcUART1, ptrTask->nID)
+///          is called once.
+///          OSGetEvent(ptrTask, __UART1_EVENT_RX);						// Clear the event flag.
+///          nCount = SCIRxRead(&gstrcUART1, bytFrame, sizeof(bytFrame));	// Get up to 64 bytes.
+///          OSWaitEvent(ptrTask, 1, __UART1_EVENT_RX, 0);				// Sleep until more data arrive.
+///
+/// Example of usage : The codes example below illustrates how to send a frame on USART1 at
+///          low priority, the owner is signalled with __USART1_EVENT_TX once it is sent.
+///          strcFrame.ptrData = bytData; strcFrame.unLength = 100; strcFrame.nTask = ptrTask->nID;
+///          nResult = SCIFrameSend(&gstrcUSART1, &strcFrame, __SCI_PRIORITY_LOW);
+
+void SCIDriver(TASK_ATTRIBUTE *ptrTask, SCI_PORT *ptrPort)
+{
+	const SCI_CONFIG *ptrConfig = ptrPort->ptrConfig;
+	Uart *ptrUart = ptrConfig->ptrUart;
+	Pdc *ptrPdc = ptrConfig->ptrPdc;
+	Pio *ptrPio = ptrConfig->ptrPio;
+	uint32_t unPins = ptrConfig->unPinRx | ptrConfig->unPinTx;
+	unsigned int unCount;
+	unsigned int unHead;
+
+	if (ptrTask->nTimer == 0)
+	{
+		switch (ptrTask->nState)
+		{
+			case 0: // State 0 - Initialization.
+				// Setup the RX pin as input with pull-up, then give the RX and TX pins to
+				// peripheral block A.
+				ptrPio->PIO_PPDDR = ptrConfig->unPinRx;			// Disable internal pull-down.
+				ptrPio->PIO_PUER = ptrConfig->unPinRx;			// Enable internal pull-up.
+				ptrPio->PIO_ODR = ptrConfig->unPinRx;			// Disable output write.
+ 				ptrPio->PIO_ABCDSR[0] = (ptrPio->PIO_ABCDSR[0]) & ~unPins;	// Select peripheral block A.
+ 				ptrPio->PIO_ABCDSR[1] = (ptrPio->PIO_ABCDSR[1]) & ~unPins;
+ 				ptrPio->PIO_PDR = unPins;						// Controlled by peripheral.
+
+				PMC->PMC_PCER0 = 1u << ptrConfig->bytID;		// Enable peripheral clock, before the
+				ptrUart->UART_IDR = 0xFFFFFFFF;					// registers are used.  Disable all
+																// interrupts, the transmit ready
+																// interrupt is only enabled while the
+																// transmit queue is being sent.
+
+				// Setup the operation mode and the baud rate generator:
+				// 1. Channel mode = Normal.
+				// 2. 8 bits data, no parity, 1 stop bit.
+				// 3. USART: Normal mode, 8x oversampling (Over = 1),
+				//    Baudrate = (Peripheral clock)/(8(CD + FP/8)).
+				//    UART: Baudrate = (Peripheral clock)/(16 x CD).
+				if (ptrConfig->ptrUsart != 0)
+				{
+					ptrConfig->ptrUsart->US_MR = US_MR_OVER | US_MR_USART_MODE_NORMAL | US_MR_CHRL_8_BIT |
+												 US_MR_PAR_NO | US_MR_ONEBIT;
+				}
+				else
+				{
+					ptrUart->UART_MR = UART_MR_PAR_NO | UART_MR_CHMODE_NORMAL;
+				}
+				ptrUart->UART_BRGR = SCIDivisor(ptrConfig, gunMCKHz, ptrPort->unBps);
+				gptrSCIPort[ptrConfig->bytIndex] = ptrPort;
+				OSClockRegister(&gstrcSCIClock);				// Recomputed by SCIClockChange().
+				ptrUart->UART_CR = UART_CR_TXEN | UART_CR_RXEN;	// Enable both transmitter and receiver.
+
+				ptrPort->bytTXbuflen = 0;						// Initialize all relevant variables and flags.
+				ptrPort->bytTXbufptr = 0;
+				ptrPort->bytRXbufptr = 0;
+				ptrPort->strcStatus.bRXRDY = 0;
+				ptrPort->strcStatus.bTXRDY = 0;
+				ptrPort->strcStatus.bRXOVF = 0;
+#ifdef __OS_TRACE
+				ptrPort->bytTraceChunk = 0;
+#endif
+#ifdef __OS_LOG
+				ptrPort->bytLogChunk = 0;
+#endif
+				ptrPdc->PERIPH_PTCR = PERIPH_PTCR_TXTDIS;		// No transmit chain, see SCITxSend().
+				ptrPort->bytTxChain = 0;
+				ptrPort->ptrTxDesc = 0;
+				SCIFrameFlush(ptrPort);							// Give the frames back to their owners.
+                PIN_LED2_CLEAR;									// Off indicator LED2.
+
+				// Start the PDC receive into the ring, the end of receive interrupt queues the
+				// next block, see SCIRxArm().
+				ptrPdc->PERIPH_PTCR = PERIPH_PTCR_RXTDIS;
+				ptrPdc->PERIPH_RCR = 0;
+				ptrPdc->PERIPH_RNCR = 0;
+				ptrPort->unRxTail = 0;
+				ptrPort->unRxArm = 0;
+				ptrPort->unRxIdle = 0;
+				ptrPort->unRxNotify = 0;
+				ptrPort->unRXerror = 0;
+				SCIRxArm(ptrPort);
+				ptrPdc->PERIPH_PTCR = PERIPH_PTCR_RXTEN;
+				if (ptrConfig->ptrUsart != 0)					// The receiver time-out counter starts
+				{												// after the next character received.
+					ptrConfig->ptrUsart->US_RTOR = US_RTOR_TO(_SCI_RX_TIMEOUT);
+					ptrConfig->ptrUsart->US_CR = US_CR_STTTO;
+					ptrConfig->ptrUsart->US_IER = US_IER_TIMEOUT;
+				}
+				NVIC_ClearPendingIRQ(ptrConfig->nIRQ);
+				NVIC_EnableIRQ(ptrConfig->nIRQ);
+				OSSetTaskContext(ptrTask, 1, 100);				// Next state = 1, timer = 100.
+			break;
+
+			case 1: // State 1 - Transmit and receive buffer manager.
+				// Check for data to send.
+				// Note that the transmit buffer is only 2-level deep in ARM Cortex-M4 micro-controllers.
+#ifdef __OS_TRACE
+				if (ptrPort->bytTraceChunk > 0)					// Trace chunk being sent by the PDC.
+				{
+					if ((ptrUart->UART_SR & UART_SR_TXBUFE) > 0)	// Check if both PDC transmit buffers are empty.
+					{
+						OSTraceRelease(ptrPort->bytTraceChunk);
+						ptrPort->bytTraceChunk = 0;
+						PIN_LED2_CLEAR;							// Off indicator LED2.
+					}
+				}
+				else
+#endif
+#ifdef __OS_LOG
+				if (ptrPort->bytLogChunk > 0)					// Log chunk being sent by the PDC.
+				{
+					if ((ptrUart->UART_SR & UART_SR_TXBUFE) > 0)
+					{
+						OSLogRelease(ptrPort->bytLogChunk);
+						ptrPort->bytLogChunk = 0;
+						PIN_LED2_CLEAR;							// Off indicator LED2.
+					}
+				}
+				else
+#endif
+				if (ptrPort->bytTxChain == 2)					// Chain being sent by SCIHandler(),
+				{												// nothing else is sent meanwhile.
+				}
+				else if (ptrPort->strcStatus.bTXRDY == 1)		// Check if valid data in transmit buffer.
+				{
+					ptrUart->UART_IDR = UART_IDR_TXRDY;			// Pause the transmit queue.
+					if (ptrPort->strcStatus.bTXDMAEN == 0)		// Transmit without DMA.
+					{
+						while ((ptrUart->UART_SR & UART_SR_TXRDY) > 0)	// Check if transmit holding buffer is not full.
+						{
+							PIN_LED2_SET;						// On indicator LED2.
+							if (ptrPort->bytTXbufptr < ptrPort->bytTXbuflen)	// Make sure we haven't reach end of valid data.
+							{
+								ptrUart->UART_THR = ptrConfig->ptrTXbuffer[ptrPort->bytTXbufptr];
+								ptrPort->bytTXbufptr++;			// Pointer to next byte in TX buffer.
+							}
+							else								// End of data to transmit.
+							{
+								ptrPort->bytTXbufptr = 0;		// Reset TX buffer pointer.
+								ptrPort->bytTXbuflen = 0;		// Reset TX buffer length.
+								ptrPort->strcStatus.bTXRDY = 0;	// Reset transmit flag.
+								PIN_LED2_CLEAR;					// Off indicator LED2.
+								break;
+							}
+						}
+                    }
+					else if ((ptrUart->UART_SR & UART_SR_ENDTX) > 0)	// Transmit with DMA, check if completed.
+					{
+						ptrPort->strcStatus.bTXRDY = 0;			// Reset transmit flag.
+						PIN_LED2_CLEAR;							// Off indicator LED2.
+					}
+				}
+				else if (ptrPort->bytTxChain == 1)				// Check for a chain of blocks to send.
+				{
+					OSEnterCritical();
+					SCITxStart(ptrPort);
+					OSExitCritical();
+				}
+				else if ((OSQueueCount(&ptrConfig->ptrTXframe[__SCI_PRIORITY_HIGH]) > 0) ||
+						 (OSQueueCount(&ptrConfig->ptrTXframe[__SCI_PRIORITY_LOW]) > 0))	// Check for frames to send.
+				{
+					OSEnterCritical();
+					SCIFrameStart(ptrPort);
+					if (ptrPort->bytTxChain == 1)
+					{
+						SCITxStart(ptrPort);
+					}
+					OSExitCritical();
+				}
+				else if (OSQueueCount(ptrConfig->ptrTXqueue) > 0)	// Check for data in transmit queue.
+				{
+					PIN_LED2_SET;								// On indicator LED2.
+					ptrUart->UART_IER = UART_IER_TXRDY;			// SCIHandler() sends the data in the queue.
+				}
+#if defined(__OS_TRACE) || defined(__OS_LOG)
+				else if ((ptrConfig->bytTrace == 1) && ((ptrUart->UART_IMR & UART_IMR_TXRDY) == 0))
+				{												// Queue idle, send the trace records,
+					SCITraceStart(ptrPort);						// then the log records.
+				}
+#endif
+
+				// Check for data received.
+				// The data are received into the ring by the PDC, a hardware overrun only occurs
+				// when the ring is full.  Here we ignore Parity error.  If overflow or framing
+				// error is detected, we need to write a 1 to the bit RSTSTA to clear the error flags.
+				if ((ptrUart->UART_SR & (UART_SR_OVRE | UART_SR_FRAME)) > 0)
+				{
+					ptrUart->UART_CR = UART_CR_RSTSTA;			// Clear overrun and framing error flags.
+					ptrPort->unRXerror++;
+					ptrPort->strcStatus.bRXOVF = 1;				// Set receive data overflow flag.
+				}
+				if (ptrPort->bytRxOpen == 0)					// Move the data to the receive buffer.
+				{
+					unCount = SCIRxCount(ptrPort);
+					if (unCount > (unsigned int)(ptrConfig->bytRXbufsize - ptrPort->bytRXbufptr))
+					{
+						unCount = (unsigned int)(ptrConfig->bytRXbufsize - ptrPort->bytRXbufptr);	// The rest stays in the ring.
+					}
+					if (unCount > 0)
+					{
+						PIN_LED2_SET;							// On indicator LED2.
+						ptrPort->bytRXbufptr += SCIRxRead(ptrPort, &ptrConfig->ptrRXbuffer[ptrPort->bytRXbufptr], unCount);
+						ptrPort->strcStatus.bRXRDY = 1;			// Set valid data flag.
+					}
+				}
+				else if ((ptrPort->nRxTask != 0) && (ptrConfig->ptrUsart == 0))	// Idle line detection, the
+				{												// UART has no receiver time-out.
+					unHead = SCIRxHead(ptrPort);
+					if ((unHead == ptrPort->unRxIdle) && (unHead != ptrPort->unRxNotify))
+					{
+						ptrPort->unRxNotify = unHead;			// No data in the last tick.
+						OSSignalEvent(ptrPort->nRxTask, ptrConfig->unEventRx);
+					}
+					ptrPort->unRxIdle = unHead;
+				}
+
+				OSSetTaskContext(ptrTask, 1, 1);				// Next state = 1, timer = 1.
+			break;
+
+			default:
+				OSSetTaskContext(ptrTask, 0, 1);				// Back to state = 0, timer = 1.
+			break;
+		}
+	}
+}
+
+// Function name	: SCIHandler
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Interrupt service routine of a port, called by UART0_Handler() etc.
+//                    1. End of transmit: the next block of the transmit chain is given to the
+//                       PDC, see SCITxSend().  Once both PDC buffers are empty the chain is
+//                       done and its callback executed.
+//                    2. End of receive: the next block of the receive ring is given to the PDC,
+//                       and the reader is signalled, as on the receiver time-out of a USART.
+//                    3. Transmit ready: bytes are loaded from the transmit queue into the
+//                       transmit holding register until the queue is empty, then the interrupt
+//                       is disabled again.  It is enabled by SCIDriver() when there is data in
+//                       the queue.
+// Arguments		: ptrPort = the port.
+// Return			: None.
+void SCIHandler(SCI_PORT *ptrPort)
+{
+	const SCI_CONFIG *ptrConfig = ptrPort->ptrConfig;
+	Uart *ptrUart = ptrConfig->ptrUart;
+	uint32_t unStatus;
+	uint8_t bytData;
+
+	__OS_TRACE_EVENT(__TRACE_ISR_ENTER, ptrConfig->nIRQ + 16, 0);
+	unStatus = ptrUart->UART_SR & ptrUart->UART_IMR;
+	if (unStatus & UART_SR_ENDTX)
+	{
+		SCITxFeed(ptrPort);							// A block of the chain is sent.
+	}
+	if ((ptrUart->UART_IMR & UART_IMR_TXBUFE) && (ptrUart->UART_SR & UART_SR_TXBUFE))
+	{
+		ptrUart->UART_IDR = UART_IDR_TXBUFE;		// The chain is sent.
+		ptrConfig->ptrPdc->PERIPH_PTCR = PERIPH_PTCR_TXTDIS;
+		PIN_LED2_CLEAR;								// Off indicator LED2.
+		ptrPort->bytTxChain = 0;
+		if (ptrPort->fptrTxDone != 0)
+		{
+			ptrPort->fptrTxDone(ptrPort->ptrTxArg);
+		}
+		if (ptrPort->bytTxChain == 1)				// Next chain submitted by the callback.
+		{
+			SCITxStart(ptrPort);
+		}
+	}
+	if (unStatus & UART_SR_ENDRX)					// A block of the receive ring is full.
+	{
+		SCIRxArm(ptrPort);
+	}
+	if (unStatus & US_CSR_TIMEOUT)					// USART line idle after a character.
+	{
+		ptrConfig->ptrUsart->US_CR = US_CR_STTTO;	// Wait for the next character.
+	}
+	if ((unStatus & (UART_SR_ENDRX | US_CSR_TIMEOUT)) && (ptrPort->nRxTask != 0))
+	{
+		OSSignalEvent(ptrPort->nRxTask, ptrConfig->unEventRx);
+	}
+	while ((ptrUart->UART_IMR & UART_IMR_TXRDY) && (ptrUart->UART_SR & UART_SR_TXRDY))	// Check if transmit
+	{												// holding buffer is not full.
+		if (OSQueueGet(ptrConfig->ptrTXqueue, &bytData) == 1)
+		{
+			ptrUart->UART_IDR = UART_IDR_TXRDY;		// Queue is empty, stop the interrupt.
+			PIN_LED2_CLEAR;							// Off indicator LED2.
+			break;
+		}
+		ptrUart->UART_THR = bytData;				// Load 1 byte data to transmit holding buffer.
+	}
+	__OS_TRACE_EVENT(__TRACE_ISR_EXIT, ptrConfig->nIRQ + 16, 0);
+}
+
+// Function name	: SCIClockChange
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Called by OSSetClock() for all the ports initialized, whose peripheral 
+//                    clock is on.  A clock where the baud rate of a port cannot be generated 
+//                    within __BAUD_ERROR_MAX is refused.  Before the change the PDC transmit
+//                    and the transmit queue are paused, and the __OS_CLOCK_PRE phase is
+//                    called with interrupts enabled until the character being sent is
+//                    finished.  A chain submitted meanwhile is left to SCIDriver().  After the
+//                    change the baud rate divisor is recomputed and the transmitter resumed,
+//                    with interrupts disabled.
+// Arguments		: unMCKHz = new master clock frequency in Hz.
+//                    nPhase = __OS_CLOCK_CHECK, __OS_CLOCK_PRE or __OS_CLOCK_POST.
+// Return			: 1 to refuse the new clock, or when a transmitter is not empty yet in the
+//                    __OS_CLOCK_PRE phase, 0 otherwise.
+int SCIClockChange(unsigned int unMCKHz, int nPhase)
+{
+	SCI_PORT *ptrPort;
+	Uart *ptrUart;
+	Pdc *ptrPdc;
+	int nIndex;
+	int nResult = 0;
+
+	for (nIndex = 0; nIndex < __SCI_PORTS; nIndex++)
+	{
+		ptrPort = gptrSCIPort[nIndex];
+		if ((ptrPort == 0) || ((PMC->PMC_PCSR0 & (1u << ptrPort->ptrConfig->bytID)) == 0))
+		{
+			continue;								// Port not used, or its clock is off.
+		}
+		ptrUart = ptrPort->ptrConfig->ptrUart;
+		ptrPdc = ptrPort->ptrConfig->ptrPdc;
+		if (nPhase == __OS_CLOCK_CHECK)
+		{
+			if (SCIDivisor(ptrPort->ptrConfig, unMCKHz, ptrPort->unBps) == 0)
+			{
+				return 1;
+			}
+		}
+		else if (nPhase == __OS_CLOCK_PRE)
+		{
+			if (ptrPort->bytTxHold == 0)				// First call, pause the transmitter.
+			{
+				OSEnterCritical();
+				ptrPort->bytTxHold = 1;					// SCITxStart() leaves a new chain waiting.
+				ptrPort->bytPdcTx = 0;
+				ptrPort->bytTxRdy = 0;
+				if (ptrPdc->PERIPH_PTSR & PERIPH_PTSR_TXTEN)
+				{
+					ptrPdc->PERIPH_PTCR = PERIPH_PTCR_TXTDIS;	// Pause the PDC transmit.
+					ptrPort->bytPdcTx = 1;
+				}
+				if (ptrUart->UART_IMR & UART_IMR_TXRDY)
+				{
+					ptrUart->UART_IDR = UART_IDR_TXRDY;	// Pause the transmit queue.
+					ptrPort->bytTxRdy = 1;
+				}
+				OSExitCritical();
+			}
+			if ((ptrUart->UART_SR & UART_SR_TXEMPTY) == 0)
+			{
+				nResult = 1;							// The last character is being sent.
+			}
+		}
+		else
+		{
+			ptrUart->UART_BRGR = SCIDivisor(ptrPort->ptrConfig, unMCKHz, ptrPort->unBps);
+			if (ptrPort->bytPdcTx == 1)
+			{
+				ptrPdc->PERIPH_PTCR = PERIPH_PTCR_TXTEN;	// Resume the PDC transmit.
+			}
+			if (ptrPort->bytTxRdy == 1)
+			{
+				ptrUart->UART_IER = UART_IER_TXRDY;		// Resume the transmit queue.
+			}
+			ptrPort->bytTxHold = 0;
+		}
+	}
+	return nResult;
+}
+
+// Function name	: SCIDivisor
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Compute the baud rate generator register, with the fractional part for
+//                    a USART.
+// Arguments		: ptrConfig = descriptor of the port.
+//                    unMCKHz = master clock frequency in Hz.
+//                    unBps = baud rate.
+// Return			: Value of BRGR, 0 if the baud rate cannot be generated within
+//                    __BAUD_ERROR_MAX.
+static uint32_t SCIDivisor(const SCI_CONFIG *ptrConfig, unsigned int unMCKHz, unsigned int unBps)
+{
+	unsigned int unDiv;
+
+	if (unBps == 0)
+	{
+		return 0;
+	}
+	if (ptrConfig->ptrUsart == 0)
+	{
+		unDiv = __UART_CD(unMCKHz, unBps);
+		if ((unDiv < 1) || (unDiv > 65535) ||
+			(__BAUD_ERROR_PERMILLE(unMCKHz / (16 * unDiv), unBps) > __BAUD_ERROR_MAX))
+		{
+			return 0;
+		}
+		return UART_BRGR_CD(unDiv);
+	}
+	unDiv = __USART_DIV(unMCKHz, unBps);			// 8 x CD + FP.
+	if ((unDiv < 8) || ((unDiv >> 3) > 65535) ||
+		(__BAUD_ERROR_PERMILLE(unMCKHz / unDiv, unBps) > __BAUD_ERROR_MAX))
+	{
+		return 0;
+	}
+	return US_BRGR_CD(unDiv >> 3) | US_BRGR_FP(unDiv & 7);
+}
+
+// Function name	: SCISetBaud
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Change the baud rate of a port.  The new rate is also used after a master
+//                    clock change and after the port is initialized again.  Should be called
+//                    while the line is idle, a character being sent or received is corrupted.
+// Arguments		: ptrPort = the port.
+//                    unBps = baud rate, up to MCK/16 for a UART and MCK/8 for a USART.
+// Return			: 0 if success, 1 if the baud rate cannot be generated from the master clock.
+int SCISetBaud(SCI_PORT *ptrPort, unsigned int unBps)
+{
+	uint32_t unBRGR = SCIDivisor(ptrPort->ptrConfig, gunMCKHz, unBps);
+
+	if (unBRGR == 0)
+	{
+		return 1;
+	}
+	ptrPort->unBps = unBps;
+	ptrPort->ptrConfig->ptrUart->UART_BRGR = unBRGR;
+	return 0;
+}
+
+// Function name	: SCISetHandshake
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Enable or disable the hardware handshaking (RTS/CTS flow control) of a
+//                    USART.  The RTS and CTS pins are given to the USART, or back to the PIO.
+//                    CTS must be connected when enabled, otherwise the transmitter stops.  RTS
+//                    is driven high when both PDC receive buffers are full, i.e. when the
+//                    receive ring is full, so the peer stops sending instead of overrunning
+//                    the receiver.
+// Arguments		: ptrPort = the port.
+//                    bEnable = 1 to enable, 0 to disable.
+// Return			: 0 if success, 1 if the port has no handshaking.
+int SCISetHandshake(SCI_PORT *ptrPort, int bEnable)
+{
+	const SCI_CONFIG *ptrConfig = ptrPort->ptrConfig;
+	Pio *ptrPio = ptrConfig->ptrPio;
+	uint32_t unPins = ptrConfig->unPinRts | ptrConfig->unPinCts;
+	Usart *ptrUsart = ptrConfig->ptrUsart;
+
+	if ((ptrUsart == 0) || (unPins == 0))
+	{
+		return 1;
+	}
+	if (bEnable == 1)
+	{
+		ptrPio->PIO_PUER = ptrConfig->unPinCts;		// CTS is pulled high if not driven.
+		ptrPio->PIO_ABCDSR[0] = (ptrPio->PIO_ABCDSR[0]) & ~unPins;	// Peripheral A.
+		ptrPio->PIO_ABCDSR[1] = (ptrPio->PIO_ABCDSR[1]) & ~unPins;
+		ptrPio->PIO_PDR = unPins;
+		ptrUsart->US_MR = (ptrUsart->US_MR & ~US_MR_USART_MODE_Msk) | US_MR_USART_MODE_HW_HANDSHAKING;
+	}
+	else
+	{
+		ptrUsart->US_MR = (ptrUsart->US_MR & ~US_MR_USART_MODE_Msk) | US_MR_USART_MODE_NORMAL;
+		ptrPio->PIO_PER = unPins;					// Back to PIO, as inputs.
+	}
+	return 0;
+}
+
+// Function name	: SCIRxArm
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Give the PDC the next blocks of the receive ring, so that one block is
+//                    being filled and the next one is queued in RNPR/RNCR.  A block is only
+//                    given once the reader has freed it, the write position stays less than
+//                    the ring length ahead of the read position.  If the ring is full the end
+//                    of receive interrupt is disabled, the PDC stops at the end of the block
+//                    being filled and SCIRxRead() calls this routine again.  Must be called
+//                    with interrupts disabled or from SCIHandler().
+// Arguments		: ptrPort = the port.
+// Return			: None.
+static void SCIRxArm(SCI_PORT *ptrPort)
+{
+	const SCI_CONFIG *ptrConfig = ptrPort->ptrConfig;
+	Pdc *ptrPdc = ptrConfig->ptrPdc;
+	uint32_t unAddress;
+
+	while ((ptrPdc->PERIPH_RNCR == 0) && (ptrPort->unRxArm + __SCI_RXRING_BLOCK - ptrPort->unRxTail < ptrConfig->unRingLength))
+	{
+		unAddress = (uint32_t)(uintptr_t) &ptrConfig->ptrRing[ptrPort->unRxArm & (ptrConfig->unRingLength - 1)];
+		if (ptrPdc->PERIPH_RCR == 0)				// Both blocks are full, restart the PDC.
+		{
+			ptrPdc->PERIPH_RPR = unAddress;
+			ptrPdc->PERIPH_RCR = __SCI_RXRING_BLOCK;
+		}
+		else
+		{
+			ptrPdc->PERIPH_RNPR = unAddress;
+			ptrPdc->PERIPH_RNCR = __SCI_RXRING_BLOCK;
+		}
+		ptrPort->unRxArm += __SCI_RXRING_BLOCK;
+	}
+	if (ptrPdc->PERIPH_RNCR == 0)
+	{
+		ptrConfig->ptrUart->UART_IDR = UART_IDR_ENDRX;	// Ring is full.
+		ptrPort->bytRxStall = 1;
+	}
+	else
+	{
+		ptrConfig->ptrUart->UART_IER = UART_IER_ENDRX;
+		ptrPort->bytRxStall = 0;
+	}
+}
+
+// Function name	: SCIRxHead
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Get the write position of the PDC in the receive ring.
+// Arguments		: ptrPort = the port.
+// Return			: Offset of the next byte to be received in the ring.
+static unsigned int SCIRxHead(SCI_PORT *ptrPort)
+{
+	const SCI_CONFIG *ptrConfig = ptrPort->ptrConfig;
+
+	return (ptrConfig->ptrPdc->PERIPH_RPR - (uint32_t)(uintptr_t) ptrConfig->ptrRing) & (ptrConfig->unRingLength - 1);
+}
+
+// Function name	: SCIRxOpen
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Take over the receive ring from SCIDriver(), which then stops moving the
+//                    received data to the receive buffer.  Only one task may read the ring.
+// Arguments		: ptrPort = the port.
+//                    nHandle = handle of the task to signal with the receive event flag of the
+//                    port when a block of the ring is full or when the line is idle after
+//                    receiving data, 0 for none.
+// Return			: None.
+void SCIRxOpen(SCI_PORT *ptrPort, int nHandle)
+{
+	ptrPort->nRxTask = nHandle;
+	ptrPort->bytRxOpen = 1;
+}
+
+// Function name	: SCIRxCount
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Get the no. of bytes in the receive ring.
+// Arguments		: ptrPort = the port.
+// Return			: No. of bytes which can be read with SCIRxRead().
+unsigned int SCIRxCount(SCI_PORT *ptrPort)
+{
+	return (SCIRxHead(ptrPort) - ptrPort->unRxTail) & (ptrPort->ptrConfig->unRingLength - 1);
+}
+
+// Function name	: SCIRxRead
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Get and remove data from the receive ring.  If the PDC has stopped
+//                    because the ring was full, it is restarted.
+// Arguments		: ptrPort = the port.
+//                    ptrData = storage for the data.
+//                    unMax = max. no. of bytes to get.
+// Return			: No. of bytes copied to ptrData.
+unsigned int SCIRxRead(SCI_PORT *ptrPort, uint8_t *ptrData, unsigned int unMax)
+{
+	const SCI_CONFIG *ptrConfig = ptrPort->ptrConfig;
+	unsigned int unCount = SCIRxCount(ptrPort);
+	unsigned int unTail = ptrPort->unRxTail;
+	unsigned int ni;
+
+	if (unCount > unMax)
+	{
+		unCount = unMax;
+	}
+	for (ni = 0; ni < unCount; ni++)
+	{
+		ptrData[ni] = ptrConfig->ptrRing[(unTail + ni) & (ptrConfig->unRingLength - 1)];
+	}
+	__OS_MEMORY_BARRIER();							// Data are copied before their space is released.
+	ptrPort->unRxTail = unTail + unCount;
+	if (ptrPort->bytRxStall == 1)
+	{
+		OSEnterCritical();
+		SCIRxArm(ptrPort);
+		OSExitCritical();
+	}
+	return unCount;
+}
+
+// Function name	: SCIRxPeek
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Get the data at the read position of the receive ring without copying
+//                    them, e.g. to decode them in place.  The data stay in the ring until
+//                    SCIRxSkip() is called.  At the end of the ring only the bytes up to the
+//                    end are given, the rest is given by the next call.
+// Arguments		: ptrPort = the port.
+//                    pptrData = storage for the pointer to the data.
+// Return			: No. of contiguous bytes at *pptrData.
+unsigned int SCIRxPeek(SCI_PORT *ptrPort, uint8_t **pptrData)
+{
+	const SCI_CONFIG *ptrConfig = ptrPort->ptrConfig;
+	unsigned int unCount = SCIRxCount(ptrPort);
+	unsigned int unTail = ptrPort->unRxTail & (ptrConfig->unRingLength - 1);
+
+	if (unCount > ptrConfig->unRingLength - unTail)
+	{
+		unCount = ptrConfig->unRingLength - unTail;
+	}
+	*pptrData = &ptrConfig->ptrRing[unTail];
+	return unCount;
+}
+
+// Function name	: SCIRxSkip
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Remove data from the receive ring after SCIRxPeek().  If the PDC has
+//                    stopped because the ring was full, it is restarted.
+// Arguments		: ptrPort = the port.
+//                    unCount = no. of bytes to remove, not more than given by SCIRxPeek().
+// Return			: None.
+void SCIRxSkip(SCI_PORT *ptrPort, unsigned int unCount)
+{
+	__OS_MEMORY_BARRIER();							// Data are used before their space is released.
+	ptrPort->unRxTail += unCount;
+	if (ptrPort->bytRxStall == 1)
+	{
+		OSEnterCritical();
+		SCIRxArm(ptrPort);
+		OSExitCritical();
+	}
+}
+
+// Function name	: SCITxSend
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Submit a chain of blocks to be sent in place by the PDC.  The chain is
+//                    started by SCIDriver() when the transmit buffer is idle, or straight
+//                    away if submitted from the callback of the previous chain.
+// Arguments		: ptrPort = the port.
+//                    ptrDesc = first block of the chain.  The blocks and the descriptors must
+//                    not be changed until the chain is sent.
+//                    fptrDone = routine called by SCIHandler() once the last byte has been
+//                    passed to the port, 0 for none.  It is executed in the interrupt context
+//                    and must be short.
+//                    ptrArg = argument of fptrDone.
+// Return			: 0 if the chain is accepted, 1 if another chain is waiting or being sent.
+int SCITxSend(SCI_PORT *ptrPort, SCI_TX_DESC *ptrDesc, void (*fptrDone)(void *), void *ptrArg)
+{
+	OSEnterCritical();
+	if (ptrPort->bytTxChain != 0)
+	{
+		OSExitCritical();
+		return 1;
+	}
+	ptrPort->ptrTxDesc = ptrDesc;
+	ptrPort->fptrTxDone = fptrDone;
+	ptrPort->ptrTxArg = ptrArg;
+	ptrPort->bytTxChain = 1;
+	OSExitCritical();
+	return 0;
+}
+
+// Function name	: SCITxBusy
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Check if a chain submitted with SCITxSend() is not sent yet.
+// Arguments		: ptrPort = the port.
+// Return			: 1 if a chain is waiting or being sent, 0 otherwise.
+int SCITxBusy(SCI_PORT *ptrPort)
+{
+	return (ptrPort->bytTxChain != 0);
+}
+
+// Function name	: SCITxStart
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Start the PDC transmit of the chain submitted with SCITxSend().  Must be
+//                    called with interrupts disabled or from SCIHandler().  During a clock change
+//                    the chain is left waiting, and started by SCIDriver() afterwards.
+// Arguments		: ptrPort = the port.
+// Return			: None.
+static void SCITxStart(SCI_PORT *ptrPort)
+{
+	Pdc *ptrPdc = ptrPort->ptrConfig->ptrPdc;
+
+	if (ptrPort->bytTxHold == 1)
+	{
+		return;
+	}
+	ptrPort->bytTxChain = 2;
+	PIN_LED2_SET;									// On indicator LED2.
+	ptrPort->ptrConfig->ptrUart->UART_IDR = UART_IDR_TXRDY;	// Pause the transmit queue.
+	ptrPdc->PERIPH_TCR = 0;
+	ptrPdc->PERIPH_TNCR = 0;
+	SCITxFeed(ptrPort);
+	ptrPdc->PERIPH_PTCR = PERIPH_PTCR_TXTEN;		// Enable transmitter transfer.
+}
+
+// Function name	: SCITxFeed
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Give the PDC the next blocks of the transmit chain, so that one block is
+//                    being sent and the next one is queued in TNPR/TNCR.  Once all the blocks
+//                    are given, SCIHandler() waits for both PDC buffers to be empty.  Must be
+//                    called with interrupts disabled or from SCIHandler().
+// Arguments		: ptrPort = the port.
+// Return			: None.
+static void SCITxFeed(SCI_PORT *ptrPort)
+{
+	Pdc *ptrPdc = ptrPort->ptrConfig->ptrPdc;
+	SCI_TX_DESC *ptrDesc = ptrPort->ptrTxDesc;
+
+	while ((ptrPdc->PERIPH_TNCR == 0) && (ptrDesc != 0))
+	{
+		if (ptrDesc->unLength > 0)					// Skip the empty blocks.
+		{
+			if (ptrPdc->PERIPH_TCR == 0)
+			{
+				ptrPdc->PERIPH_TPR = (uint32_t)(uintptr_t) ptrDesc->ptrData;
+				ptrPdc->PERIPH_TCR = ptrDesc->unLength;
+			}
+			else
+			{
+				ptrPdc->PERIPH_TNPR = (uint32_t)(uintptr_t) ptrDesc->ptrData;
+				ptrPdc->PERIPH_TNCR = ptrDesc->unLength;
+			}
+		}
+		ptrDesc = ptrDesc->ptrNext;
+	}
+	ptrPort->ptrTxDesc = ptrDesc;
+	if (ptrDesc == 0)
+	{
+		ptrPort->ptrConfig->ptrUart->UART_IDR = UART_IDR_ENDTX;	// Last block given to the PDC.
+		ptrPort->ptrConfig->ptrUart->UART_IER = UART_IER_TXBUFE;
+	}
+	else
+	{
+		ptrPort->ptrConfig->ptrUart->UART_IER = UART_IER_ENDTX;
+	}
+}
+
+// Function name	: SCIFrameSend
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Submit a frame to be sent by the PDC, see SCIDriver().  Can be called by
+//                    any task or interrupt service routine.  SCITxSend() is refused while
+//                    frames are sent.
+// Arguments		: ptrPort = the port.
+//                    ptrFrame = the frame, the data, length and task handle must be set.  The
+//                    frame and its data must not be changed until bytStatus = __SCI_FRAME_DONE.
+//                    nPriority = __SCI_PRIORITY_HIGH or __SCI_PRIORITY_LOW.
+// Return			: 0 if the frame is queued, 1 if the queue is full, 2 if the frame is not
+//                    valid.
+int SCIFrameSend(SCI_PORT *ptrPort, SCI_FRAME *ptrFrame, int nPriority)
+{
+	int nResult;
+
+	if ((ptrFrame->unLength == 0) || (ptrFrame->unLength > 65535) ||
+		(nPriority < 0) || (nPriority >= __SCI_PRIORITY_LEVELS))
+	{
+		return 2;
+	}
+	ptrFrame->bytStatus = __SCI_FRAME_QUEUED;
+	OSEnterCritical();								// The queue has many producers.
+	nResult = OSQueuePut(&ptrPort->ptrConfig->ptrTXframe[nPriority], &ptrFrame);
+	OSExitCritical();
+	if (nResult != 0)
+	{
+		ptrFrame->bytStatus = __SCI_FRAME_DONE;
+	}
+	return nResult;
+}
+
+// Function name	: SCIFrameStart
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Submit the next frame of the queues as a chain of one block, unless a
+//                    chain is waiting or being sent.  Must be called with interrupts disabled
+//                    or from SCIHandler().
+// Arguments		: ptrPort = the port.
+// Return			: None.
+static void SCIFrameStart(SCI_PORT *ptrPort)
+{
+	SCI_FRAME *ptrFrame;
+	int nIndex;
+
+	if (ptrPort->bytTxChain != 0)					// A chain was submitted meanwhile.
+	{
+		return;
+	}
+	for (nIndex = 0; nIndex < __SCI_PRIORITY_LEVELS; nIndex++)
+	{
+		if (OSQueueGet(&ptrPort->ptrConfig->ptrTXframe[nIndex], &ptrFrame) == 0)
+		{
+			ptrFrame->bytStatus = __SCI_FRAME_SENDING;
+			ptrPort->strcFrameDesc.ptrData = ptrFrame->ptrData;
+			ptrPort->strcFrameDesc.unLength = ptrFrame->unLength;
+			ptrPort->strcFrameDesc.ptrNext = 0;
+			ptrPort->ptrFrame = ptrFrame;
+			SCITxSend(ptrPort, &ptrPort->strcFrameDesc, SCIFrameDone, ptrPort);
+			return;
+		}
+	}
+}
+
+// Function name	: SCIFrameDone
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Called by SCIHandler() when a frame is sent, starts the next frame.
+// Arguments		: ptrArg = the port.
+// Return			: None.
+static void SCIFrameDone(void *ptrArg)
+{
+	SCI_PORT *ptrPort = (SCI_PORT *) ptrArg;
+	SCI_FRAME *ptrFrame = ptrPort->ptrFrame;
+	int nTask = ptrFrame->nTask;
+
+	ptrFrame->bytStatus = __SCI_FRAME_DONE;			// The owner may reuse the frame from now.
+	if (nTask != 0)
+	{
+		OSSignalEvent(nTask, ptrPort->ptrConfig->unEventTx);
+	}
+	SCIFrameStart(ptrPort);
+}
+
+// Function name	: SCIFrameFlush
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Drop the frame being sent and the frames of the queues when the port is
+//                    initialized again.  Each frame is set to __SCI_FRAME_DONE and its owner
+//                    signalled as if it was sent, so a task waiting for the frame does not
+//                    hang.  The PDC transmit must be stopped.
+// Arguments		: ptrPort = the port.
+// Return			: None.
+static void SCIFrameFlush(SCI_PORT *ptrPort)
+{
+	SCI_FRAME *ptrFrame = ptrPort->ptrFrame;
+	int nIndex;
+
+	OSEnterCritical();								// The queues have many producers.
+	if ((ptrFrame != 0) && (ptrFrame->bytStatus == __SCI_FRAME_SENDING))
+	{
+		ptrFrame->bytStatus = __SCI_FRAME_DONE;
+		if (ptrFrame->nTask != 0)
+		{
+			OSSignalEvent(ptrFrame->nTask, ptrPort->ptrConfig->unEventTx);
+		}
+	}
+	ptrPort->ptrFrame = 0;
+	for (nIndex = 0; nIndex < __SCI_PRIORITY_LEVELS; nIndex++)
+	{
+		while (OSQueueGet(&ptrPort->ptrConfig->ptrTXframe[nIndex], &ptrFrame) == 0)
+		{
+			ptrFrame->bytStatus = __SCI_FRAME_DONE;
+			if (ptrFrame->nTask != 0)
+			{
+				OSSignalEvent(ptrFrame->nTask, ptrPort->ptrConfig->unEventTx);
+			}
+		}
+	}
+	OSExitCritical();
+}
+
+#if defined(__OS_TRACE) || defined(__OS_LOG)
+// Function name	: SCITraceStart
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Give the PDC the next chunk of the execution trace, or if there is none
+//                    the next chunk of the log, with its header.  Called by SCIDriver() when the
+//                    transmitter of the port is idle.
+// Arguments		: ptrPort = the port.
+// Return			: None.
+static void SCITraceStart(SCI_PORT *ptrPort)
+{
+	Pdc *ptrPdc = ptrPort->ptrConfig->ptrPdc;
+#ifdef __OS_TRACE
+	OS_TRACE_RECORD *ptrRecord;
+#endif
+#ifdef __OS_LOG
+	uint8_t *ptrLog;
+#endif
+
+#ifdef __OS_TRACE
+	ptrPort->bytTraceChunk = OSTraceChunk(ptrPort->bytTraceHeader, &ptrRecord, __OS_TRACE_CHUNK);
+	if (ptrPort->bytTraceChunk > 0)
+	{
+		PIN_LED2_SET;								// On indicator LED2.
+		ptrPdc->PERIPH_TPR = (uint32_t)(uintptr_t) ptrPort->bytTraceHeader;
+		ptrPdc->PERIPH_TCR = sizeof(ptrPort->bytTraceHeader);
+		ptrPdc->PERIPH_TNPR = (uint32_t)(uintptr_t) ptrRecord;
+		ptrPdc->PERIPH_TNCR = ptrPort->bytTraceChunk * sizeof(OS_TRACE_RECORD);
+		ptrPdc->PERIPH_PTCR = PERIPH_PTCR_TXTEN;	// Enable transmitter transfer.
+		return;
+	}
+#endif
+#ifdef __OS_LOG
+	ptrPort->bytLogChunk = OSLogChunk(ptrPort->bytLogHeader, &ptrLog);
+	if (ptrPort->bytLogChunk > 0)
+	{
+		PIN_LED2_SET;								// On indicator LED2.
+		ptrPdc->PERIPH_TPR = (uint32_t)(uintptr_t) ptrPort->bytLogHeader;
+		ptrPdc->PERIPH_TCR = sizeof(ptrPort->bytLogHeader);
+		ptrPdc->PERIPH_TNPR = (uint32_t)(uintptr_t) ptrLog;
+		ptrPdc->PERIPH_TNCR = ptrPort->bytLogChunk;
+		ptrPdc->PERIPH_PTCR = PERIPH_PTCR_TXTEN;	// Enable transmitter transfer.
+	}
+#endif
+}
+#endif
@@ -0,0 +1,109 @@
+// Author			: Fabian Kung
+// Date				: 16 Oct 2026
+// Filename			: Driver_SCI_V100.h
+
+#ifndef _DRIVER_SCI_SAM4S_H
+#define _DRIVER_SCI_SAM4S_H
+
+// Include common header to all drivers and sources.  Here absolute path is used.
+// To edit if one change folder
+#include "osmain.h"
+
+//
+// --- PUBLIC CONSTANTS ---
+//
+#define __SCI_PORTS				4			// UART0, UART1, USART0 and USART1.
+
+//
+// --- PUBLIC DATATYPES ---
+//
+// Descriptor of a block of data sent in place by SCITxSend().
+typedef struct StructSCITxDesc
+{
+	const uint8_t *ptrData;							// Start of the block.
+	unsigned int unLength;							// No. of bytes, max. 65535, 0 to skip.
+	struct StructSCITxDesc *ptrNext;				// Next block, 0 for the last one.
+} SCI_TX_DESC;
+
+// Type cast for the descriptor of a serial port, constant.  The registers common to the UART
+// and the USART (CR, MR, IER, IDR, IMR, SR, RHR, THR and BRGR) are at the same offsets with the
+// same bits, so both are accessed through ptrUart.
+typedef struct StructSCIConfig
+{
+	Uart *ptrUart;						// Common registers.
+	Usart *ptrUsart;					// USART specific registers, 0 for a UART.
+	Pdc *ptrPdc;
+	Pio *ptrPio;						// PIO controller of the pins, all in peripheral A.
+	uint32_t unPinRx;
+	uint32_t unPinTx;
+	uint32_t unPinRts;					// 0 if no hardware handshaking.
+	uint32_t unPinCts;
+	IRQn_Type nIRQ;
+	uint8_t bytID;						// Peripheral ID, below 32.
+	uint8_t bytIndex;					// 0 to __SCI_PORTS-1.
+	uint8_t bytTrace;					// 1 to send the execution trace when idle.
+	uint8_t *ptrTXbuffer;				// Transmit buffer, see bTXRDY.
+	uint8_t *ptrRXbuffer;				// Receive buffer, see bRXRDY.
+	uint8_t bytRXbufsize;
+	uint8_t *ptrRing;					// Receive ring, filled by the PDC.
+	unsigned int unRingLength;			// Power of 2, at least 4 x __SCI_RXRING_BLOCK.
+	OS_QUEUE *ptrTXqueue;				// Transmit queue, bytes.
+	OS_QUEUE *ptrTXframe;				// __SCI_PRIORITY_LEVELS frame queues, SCI_FRAME pointers.
+	unsigned int unEventRx;				// Event flag signalled to the task reading the ring.
+	unsigned int unEventTx;				// Event flag signalled to the owner of a frame once sent.
+} SCI_CONFIG;
+
+// Type cast for the variables of a serial port.
+typedef struct StructSCIPort
+{
+	const SCI_CONFIG *ptrConfig;
+	unsigned int unBps;					// Baud rate, see SCISetBaud().
+	SCI_STATUS strcStatus;
+	uint8_t bytTXbufptr;				// Transmit buffer pointer.
+	uint8_t bytTXbuflen;				// Transmit buffer length.
+	uint8_t bytRXbufptr;				// Receive buffer pointer.
+	unsigned int unRXerror;				// No. of receive overrun and framing errors.
+	uint8_t bytPdcTx;					// 1 if the PDC transmit was paused by a clock change.
+	uint8_t bytTxRdy;					// 1 if the transmit ready interrupt was disabled by a clock change.
+	volatile uint8_t bytTxHold;			// 1 while a clock change waits for the transmitter to be empty.
+	volatile unsigned int unRxTail;		// No. of bytes read from the receive ring.
+	unsigned int unRxArm;				// No. of bytes of the receive ring given to the PDC.
+	uint8_t bytRxStall;					// 1 if the PDC receive stops because the ring is full.
+	uint8_t bytRxOpen;					// 1 if the receive ring is read with SCIRxRead().
+	int nRxTask;						// Handle of the task to signal with unEventRx.
+	unsigned int unRxIdle;				// Ring position on the previous tick.
+	unsigned int unRxNotify;			// Ring position at the last unEventRx.
+	SCI_TX_DESC * volatile ptrTxDesc;	// Next block of the chain to give the PDC.
+	volatile uint8_t bytTxChain;		// 0 = idle, 1 = chain waiting, 2 = chain being sent.
+	void (*fptrTxDone)(void *);			// Called when the chain is sent.
+	void *ptrTxArg;						// Argument of fptrTxDone().
+	SCI_TX_DESC strcFrameDesc;			// Block of the frame being sent.
+	SCI_FRAME *ptrFrame;				// Frame being sent.
+#ifdef __OS_TRACE
+	uint8_t bytTraceHeader[8];			// Header of the trace chunk being sent.
+	uint8_t bytTraceChunk;				// No. of trace records being sent by the PDC, 0 if none.
+#endif
+#ifdef __OS_LOG
+	uint8_t bytLogHeader[8];			// Header of the log chunk being sent.
+	uint8_t bytLogChunk;				// No. of log bytes being sent by the PDC, 0 if none.
+#endif
+} SCI_PORT;
+
+//
+// --- PUBLIC FUNCTION PROTOTYPE ---
+//
+void SCIDriver(TASK_ATTRIBUTE *, SCI_PORT *);
+void SCIHandler(SCI_PORT *);
+int SCIClockChange(unsigned int, int);
+void SCIRxOpen(SCI_PORT *, int);
+unsigned int SCIRxCount(SCI_PORT *);
+unsigned int SCIRxRead(SCI_PORT *, uint8_t *, unsigned int);
+unsigned int SCIRxPeek(SCI_PORT *, uint8_t **);
+void SCIRxSkip(SCI_PORT *, unsigned int);
+int SCITxSend(SCI_PORT *, SCI_TX_DESC *, void (*)(void *), void *);
+int SCITxBusy(SCI_PORT *);
+int SCIFrameSend(SCI_PORT *, SCI_FRAME *, int);
+int SCISetBaud(SCI_PORT *, unsigned int);
+int SCISetHandshake(SCI_PORT *, int);
+
+#endif
@@ -0,0 +1,387 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	USER DRIVER ROUTINES DECLARATION (PROCESSOR DEPENDENT)
+//
+//  (c) Copyright 2026, Fabian Kung Wai Lee, Selangor, MALAYSIA
+//  All Rights Reserved
+//
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File				: Driver_TC_V100.c
+// Author(s)		: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Toolsuites		: Atmel Studio 6.2 or later
+//					  GCC C-Compiler
+#include "osmain.h"
+#include "Driver_TC_V100.h"
+
+
+// NOTE: Public function prototypes are declared in the corresponding *.h file.
+
+
+//
+// --- PUBLIC VARIABLES ---
+//
+
+//
+// --- PRIVATE VARIABLES ---
+//
+volatile unsigned int gunTCHigh;		// Upper 16 bits of the 32-bits timer, i.e. the no. of
+										// overflows of the 16-bits TC counter x 65536.
+TC_TIMER *gptrTCTimerHead;				// List of running timers, in order of deadline.
+unsigned int gunTCClockHz;				// Timer tick frequency, MCK/32.
+OS_CLOCK_CLIENT gstrcTCClock = {TCTimerClockChange, 0};	// Notification of master clock change.
+
+//
+// --- Process Level Constants Definition ---
+//
+#define	_TC_MIN_TICK		4			// Deadlines closer than this are serviced immediately.
+
+///
+/// Module name		: TC timer service
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Code version	: 1.00
+///
+/// Processor		: ARM Cortex-M4 family
+///
+/// Processor/System Resource
+/// PINS		: None.
+///
+/// MODULES		: 1. TC0 channel 0 (Internal).
+///               2. NVIC, TC0 interrupt (Internal).
+///
+/// RTOS		: Not required.
+///
+/// Global variable	: None.
+///
+/// Description		: A timer service with microsecond resolution, for deadlines which are
+///                   shorter than or not aligned to the system tick of the RTOS.  TC0 channel 0
+///                   runs free at MCK/32 (3.75 MHz at 120 MHz), and is extended to 32 bits
+///                   with the counter overflow interrupt.  Any no. of software timers, one-shot
+///                   or periodic, share the RC compare of the channel, which is always loaded
+///                   with the earliest deadline.  When a deadline is reached the callback
+///                   routine of the timer is called from the TC0 interrupt service routine,
+///                   so it should be short, e.g. toggle a pin, start a conversion or signal a
+///                   task.  The callback routine can start or stop timers, including its own.
+///                   The deadlines wrap around after 2^31 ticks, about 9.5 minutes, this is
+///                   the maximum delay.
+///                   Note: 16 Oct 2026, when the master clock is changed with OSSetClock() the
+///                   tick frequency changes with it, the remaining time of every running timer
+///                   is rescaled and the periods are recomputed from microseconds.  At 12 MHz
+///                   a tick is 2.67 usec.
+///
+/// Example of usage : Call a routine 20 usec from now and then every 50 usec.
+///			TC_TIMER strcTimer;
+///
+///			TCTimerInit();		// Once, after SAM4S_Init().
+///			TCTimerStart(&strcTimer, 20, 50, Sample_ADC, 0);
+///			...
+///			TCTimerStop(&strcTimer);
+///
+
+// Function name	: TCTimerStatus
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Process the status flags of TC0 channel 0.  The flags are cleared when
+//                    TC_SR is read, thus every read of TC_SR must be passed to this routine.
+// Arguments		: unSR = value of TC_SR.
+//                    bPend = 1 to request the TC0 interrupt if the RC compare flag is set,
+//                    i.e. when the flag is read outside the interrupt service routine.
+// Return			: None.
+static void TCTimerStatus(unsigned int unSR, int bPend)
+{
+	if (unSR & TC_SR_COVFS)
+	{
+		gunTCHigh += 0x10000;			// Counter overflow.
+	}
+	if ((unSR & TC_SR_CPCS) && (bPend == 1))
+	{
+		NVIC_SetPendingIRQ(TC0_IRQn);
+	}
+}
+
+// Function name	: TCTimerRead
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Read the 32-bits timer.  Must be called with interrupts disabled or from
+//                    the TC0 interrupt service routine.  If the counter overflows while TC_CV
+//                    is being read, TC_CV is read again after updating the upper 16 bits.
+// Arguments		: bPend = see TCTimerStatus().
+// Return			: The timer value in ticks.
+static unsigned int TCTimerRead(int bPend)
+{
+	unsigned int unSR;
+	unsigned int unCV;
+
+	TCTimerStatus(TC0->TC_CHANNEL[0].TC_SR, bPend);
+	unCV = TC0->TC_CHANNEL[0].TC_CV;
+	unSR = TC0->TC_CHANNEL[0].TC_SR;
+	TCTimerStatus(unSR, bPend);
+	if (unSR & TC_SR_COVFS)
+	{
+		unCV = TC0->TC_CHANNEL[0].TC_CV;
+	}
+	return gunTCHigh + (unCV & 0xFFFF);
+}
+
+// Function name	: TCTimerInsert
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Insert a timer in the list of running timers, in order of deadline.
+//                    Must be called with interrupts disabled.
+// Arguments		: ptrTimer = pointer to the timer.
+// Return			: None.
+static void TCTimerInsert(TC_TIMER *ptrTimer)
+{
+	TC_TIMER **ptrLink = &gptrTCTimerHead;
+
+	while ((*ptrLink != 0) && ((int)((*ptrLink)->unExpire - ptrTimer->unExpire) <= 0))
+	{
+		ptrLink = &((*ptrLink)->ptrNext);
+	}
+	ptrTimer->ptrNext = *ptrLink;
+	*ptrLink = ptrTimer;
+	ptrTimer->bActive = 1;
+}
+
+// Function name	: TCTimerRemove
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Remove a timer from the list of running timers.  Must be called with
+//                    interrupts disabled.
+// Arguments		: ptrTimer = pointer to the timer.
+// Return			: None.
+static void TCTimerRemove(TC_TIMER *ptrTimer)
+{
+	TC_TIMER **ptrLink = &gptrTCTimerHead;
+
+	while (*ptrLink != 0)
+	{
+		if (*ptrLink == ptrTimer)
+		{
+			*ptrLink = ptrTimer->ptrNext;
+			break;
+		}
+		ptrLink = &((*ptrLink)->ptrNext);
+	}
+	ptrTimer->bActive = 0;
+}
+
+// Function name	: TCTimerArm
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Load the RC compare register with the earliest deadline.  If the deadline
+//                    is too close, or has passed while loading RC, the TC0 interrupt is
+//                    requested straight away.  A deadline more than 65536 ticks away gives
+//                    an early RC compare, which is ignored by the interrupt service routine.
+//                    Must be called with interrupts disabled or from the TC0 interrupt
+//                    service routine.
+// Arguments		: bPend = see TCTimerStatus().
+// Return			: None.
+static void TCTimerArm(int bPend)
+{
+	if (gptrTCTimerHead == 0)
+	{
+		return;
+	}
+	TC0->TC_CHANNEL[0].TC_RC = gptrTCTimerHead->unExpire & 0xFFFF;
+	if ((int)(gptrTCTimerHead->unExpire - TCTimerRead(bPend)) < _TC_MIN_TICK)
+	{
+		NVIC_SetPendingIRQ(TC0_IRQn);
+	}
+}
+
+// Function name	: TCTimerInit
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Initialize TC0 channel 0 as a free running 16-bits counter clocked by
+//                    MCK/32, with interrupt on counter overflow and RC compare.
+// Arguments		: None.
+// Return			: None.
+void TCTimerInit(void)
+{
+	unsigned int unTemp;
+
+	PMC->PMC_PCER0 |= PMC_PCER0_PID23;		// Enable peripheral clock to TC0 (ID23).
+
+	TC0->TC_CHANNEL[0].TC_CCR = TC_CCR_CLKDIS;				// Stop the counter.
+	TC0->TC_CHANNEL[0].TC_IDR = 0xFFFFFFFF;					// Disable all interrupts.
+	TC0->TC_CHANNEL[0].TC_CMR = TC_CMR_TCCLKS_TIMER_CLOCK3;	// Capture mode, clock = MCK/32, no
+															// trigger, i.e. counts from 0 to 0xFFFF.
+	TC0->TC_CHANNEL[0].TC_RC = 0;
+	unTemp = TC0->TC_CHANNEL[0].TC_SR;						// Clear all status flags.
+	(void) unTemp;
+	gunTCHigh = 0;
+	gptrTCTimerHead = 0;
+	gunTCClockHz = gunMCKHz / 32;
+	OSClockRegister(&gstrcTCClock);
+	TC0->TC_CHANNEL[0].TC_IER = TC_IER_COVFS | TC_IER_CPCS;	// Interrupt on overflow and RC compare.
+	NVIC_ClearPendingIRQ(TC0_IRQn);
+	NVIC_EnableIRQ(TC0_IRQn);
+	TC0->TC_CHANNEL[0].TC_CCR = TC_CCR_CLKEN | TC_CCR_SWTRG;	// Enable the clock and start the counter.
+}
+
+// Function name	: TCTimerNow
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Read the 32-bits timer, in ticks of MCK/32, see TCTimerUsToTick().
+// Arguments		: None.
+// Return			: The timer value.
+unsigned int TCTimerNow(void)
+{
+	unsigned int unNow;
+
+	OSEnterCritical();
+	unNow = TCTimerRead(1);
+	OSExitCritical();
+	return unNow;
+}
+
+// Function name	: TCTimerStart
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Start a one-shot or periodic timer.  If the timer is running it is
+//                    restarted.  The deadlines of a periodic timer are spaced exactly by the
+//                    period, independent of the interrupt latency.  Can be called from a task
+//                    or from a callback routine.
+// Arguments		: ptrTimer = pointer to the timer.
+//                    unDelayUs = delay to the first deadline, in microseconds.
+//                    unPeriodUs = period in microseconds, 0 for one-shot timer.
+//                    ptrCallback = routine called when the deadline is reached.
+//                    ptrArg = argument of the callback routine.
+// Return			: 0 if success, 1 if ptrCallback is not valid.
+int TCTimerStart(TC_TIMER *ptrTimer, unsigned int unDelayUs, unsigned int unPeriodUs, void (*ptrCallback)(void *), void *ptrArg)
+{
+	if (ptrCallback == 0)
+	{
+		return 1;
+	}
+	OSEnterCritical();
+	if (ptrTimer->bActive == 1)
+	{
+		TCTimerRemove(ptrTimer);
+	}
+	ptrTimer->ptrCallback = ptrCallback;
+	ptrTimer->ptrArg = ptrArg;
+	ptrTimer->unPeriodUs = unPeriodUs;
+	ptrTimer->unPeriod = TCTimerUsToTick(unPeriodUs);
+	if ((unPeriodUs > 0) && (ptrTimer->unPeriod == 0))
+	{
+		ptrTimer->unPeriod = 1;
+	}
+	ptrTimer->unExpire = TCTimerRead(1) + TCTimerUsToTick(unDelayUs);
+	TCTimerInsert(ptrTimer);
+	TCTimerArm(1);
+	OSExitCritical();
+	return 0;
+}
+
+// Function name	: TCTimerStop
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Stop a timer.  Nothing is done if the timer is not running.
+// Arguments		: ptrTimer = pointer to the timer.
+// Return			: None.
+void TCTimerStop(TC_TIMER *ptrTimer)
+{
+	OSEnterCritical();
+	if (ptrTimer->bActive == 1)
+	{
+		TCTimerRemove(ptrTimer);
+	}
+	OSExitCritical();
+}
+
+// Function name	: TCTimerUsToTick
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Convert microseconds to timer ticks at the current master clock.
+// Arguments		: unUs = time in microseconds.
+// Return			: The no. of ticks, rounded to the nearest tick.
+unsigned int TCTimerUsToTick(unsigned int unUs)
+{
+	return (unsigned int)(((unsigned long long) unUs * gunTCClockHz + 500000) / 1000000);
+}
+
+// Function name	: TCTimerClockChange
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Called by OSSetClock() with interrupts disabled.  After the master clock
+//                    is changed, the remaining time of every running timer is converted to
+//                    ticks of the new clock, and the periods are recomputed.  Scaling keeps
+//                    the order of the deadlines, so the list stays sorted.
+// Arguments		: unMCKHz = new master clock frequency in Hz.
+//                    nPhase = __OS_CLOCK_CHECK, __OS_CLOCK_PRE or __OS_CLOCK_POST.
+// Return			: Always 0.
+int TCTimerClockChange(unsigned int unMCKHz, int nPhase)
+{
+	TC_TIMER *ptrTimer;
+	unsigned int unNow;
+	unsigned int unOldHz = gunTCClockHz;
+	int nRemain;
+
+	if (nPhase != __OS_CLOCK_POST)
+	{
+		return 0;
+	}
+	gunTCClockHz = unMCKHz / 32;
+	unNow = TCTimerRead(1);
+	for (ptrTimer = gptrTCTimerHead; ptrTimer != 0; ptrTimer = ptrTimer->ptrNext)
+	{
+		nRemain = (int)(ptrTimer->unExpire - unNow);
+		if (nRemain < 0)
+		{
+			nRemain = 0;
+		}
+		ptrTimer->unExpire = unNow + (unsigned int)(((unsigned long long) nRemain * gunTCClockHz + unOldHz / 2) / unOldHz);
+		if (ptrTimer->unPeriod > 0)
+		{
+			ptrTimer->unPeriod = TCTimerUsToTick(ptrTimer->unPeriodUs);
+			if (ptrTimer->unPeriod == 0)
+			{
+				ptrTimer->unPeriod = 1;
+			}
+		}
+	}
+	TCTimerArm(1);
+	return 0;
+}
+
+// Function name	: TC0_Handler
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: TC0 channel 0 interrupt service routine.  Call the callback routine of
+//                    all the timers whose deadline is reached, reload the periodic timers,
+//                    and load RC with the next deadline.
+// Arguments		: None.
+// Return			: None.
+void TC0_Handler(void)
+{
+	TC_TIMER *ptrTimer;
+
+	__OS_TRACE_EVENT(__TRACE_ISR_ENTER, TC0_IRQn + 16, 0);
+	while (gptrTCTimerHead != 0)
+	{
+		ptrTimer = gptrTCTimerHead;
+		if ((int)(TCTimerRead(0) - ptrTimer->unExpire) < 0)
+		{
+			break;						// Earliest deadline not reached yet.
+		}
+		gptrTCTimerHead = ptrTimer->ptrNext;
+		ptrTimer->bActive = 0;
+		if (ptrTimer->unPeriod > 0)		// Reload periodic timer.
+		{
+			ptrTimer->unExpire += ptrTimer->unPeriod;
+			TCTimerInsert(ptrTimer);
+		}
+		(*ptrTimer->ptrCallback)(ptrTimer->ptrArg);
+	}
+	TCTimerRead(0);						// Update the upper 16 bits if the interrupt is due
+										// to counter overflow.
+	TCTimerArm(0);
+	__OS_TRACE_EVENT(__TRACE_ISR_EXIT, TC0_IRQn + 16, 0);
+}
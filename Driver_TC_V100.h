@@ -0,0 +1,47 @@
+// Author			: Fabian Kung
+// Date				: 16 Oct 2026
+// Filename			: Driver_TC_V100.h
+
+#ifndef _DRIVER_TC_SAM4S_H
+#define _DRIVER_TC_SAM4S_H
+
+// Include common header to all drivers and sources.  Here absolute path is used.
+// To edit if one change folder
+#include "osmain.h"
+
+//
+// --- PUBLIC CONSTANTS ---
+//
+#define	__TC_CLOCK_kHZ		(__FMCK_HZ/32000)		// TC0 channel 0 is clocked by MCK/32.
+#define __TC_US_TO_TICK(us)	((unsigned int)((((unsigned long long)(us))*__TC_CLOCK_kHZ + 500)/1000))
+														// Convert microseconds to timer ticks at the
+														// start-up MCK, see TCTimerUsToTick().
+
+//
+// --- PUBLIC DATATYPES ---
+//
+// Type cast for a software timer.  The structure is allocated by the user, and must not be
+// modified while the timer is running.
+typedef struct StructTCTimer
+{
+	unsigned int unExpire;				// Deadline in timer ticks.
+	unsigned int unPeriod;				// Period in timer ticks, 0 for one-shot timer.
+	unsigned int unPeriodUs;			// Period in microseconds.
+	void (*ptrCallback)(void *);		// Routine called when the deadline is reached.
+	void *ptrArg;						// Argument of the callback routine.
+	struct StructTCTimer *ptrNext;		// Next timer in the list of running timers.
+	uint8_t bActive;					// 1 if the timer is running.
+} TC_TIMER;
+
+//
+// --- PUBLIC FUNCTION PROTOTYPE ---
+//
+void TCTimerInit(void);
+unsigned int TCTimerNow(void);
+int TCTimerStart(TC_TIMER *, unsigned int, unsigned int, void (*)(void *), void *);
+void TCTimerStop(TC_TIMER *);
+unsigned int TCTimerUsToTick(unsigned int);
+int TCTimerClockChange(unsigned int, int);
+void TC0_Handler(void);
+
+#endif
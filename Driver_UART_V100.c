@@ -9,10 +9,11 @@
 //
 // File				: Drivers_UART_V100.c
 // Author(s)		: Fabian Kung
-// Last modified	: 28 Dec 2015
+// Last modified	: 16 Oct 2026
 // Toolsuites		: Atmel Studio 6.2 or later
 //					  GCC C-Compiler
 #include "osmain.h"
+#include "Driver_UART_V100.h"
 
 
 // NOTE: Public function prototypes are declared in the corresponding *.h file.
@@ -23,25 +24,62 @@
 //
 // Data buffer and address pointers for wired serial communications (UART).
 uint8_t gbytTXbuffer[__SCI_TXBUF_LENGTH-1];       // Transmit buffer.
-uint8_t gbytTXbufptr;                             // Transmit buffer pointer.
-uint8_t gbytTXbuflen;                             // Transmit buffer length.
 uint8_t gbytRXbuffer[__SCI_RXBUF_LENGTH-1];       // Receive buffer length.
-uint8_t gbytRXbufptr;                             // Receive buffer length pointer.
+uint8_t gbytTXqueue[__SCI_TXQUEUE_LENGTH];        // Storage of the transmit queue.
+OS_QUEUE gstrcTXqueue = {0, 0, __SCI_TXQUEUE_LENGTH-1, 1, gbytTXqueue};	// Transmit queue.
+SCI_FRAME *gptrTXframe[__SCI_PRIORITY_LEVELS][__SCI_FRAMEQ_LENGTH];	// Storage of the frame queues.
+OS_QUEUE gstrcTXframe[__SCI_PRIORITY_LEVELS] = {						// Frame queues, one per priority.
+	{0, 0, __SCI_FRAMEQ_LENGTH-1, sizeof(SCI_FRAME *), (uint8_t *) gptrTXframe[0]},
+	{0, 0, __SCI_FRAMEQ_LENGTH-1, sizeof(SCI_FRAME *), (uint8_t *) gptrTXframe[1]}};
+
+uint8_t gbytTXbuffer1[__SCI_TXBUF1_LENGTH-1];     // Same for UART1.
+uint8_t gbytRXbuffer1[__SCI_RXBUF1_LENGTH-1];
+uint8_t gbytTXqueue1[__SCI_TXQUEUE1_LENGTH];
+OS_QUEUE gstrcTXqueue1 = {0, 0, __SCI_TXQUEUE1_LENGTH-1, 1, gbytTXqueue1};
+SCI_FRAME *gptrTXframe1[__SCI_PRIORITY_LEVELS][__SCI_FRAMEQ_LENGTH];
+OS_QUEUE gstrcTXframe1[__SCI_PRIORITY_LEVELS] = {
+	{0, 0, __SCI_FRAMEQ_LENGTH-1, sizeof(SCI_FRAME *), (uint8_t *) gptrTXframe1[0]},
+	{0, 0, __SCI_FRAMEQ_LENGTH-1, sizeof(SCI_FRAME *), (uint8_t *) gptrTXframe1[1]}};
 
 //
 // --- PRIVATE VARIABLES ---
 //
-
+uint8_t gbytRXring[__SCI_RXRING_LENGTH];		// Receive rings, filled by the PDC.
+uint8_t gbytRXring1[__SCI_RXRING1_LENGTH];
 
 //
 // --- Process Level Constants Definition --- 
 //
 
-//#define	_UART_BAUDRATE_kBPS	9.6	// Default datarate in kilobits-per-second, for HC-05 module.
-//#define	_UART_BAUDRATE_kBPS 38.4	// Default datarate in kilobits-per-second for HC-05 module in AT mode.
-#define	_UART_BAUDRATE_kBPS 115.2	// Default datarate in kilobits-per-second
-//#define	_UART_BAUDRATE_kBPS 128.0	// Default datarate in kilobits-per-second
-//#define	_UART_BAUDRATE_kBPS 230.4	// Default datarate in kilobits-per-second
+//#define	_UART_BAUDRATE_BPS	9600	// Default datarate in bits-per-second, for HC-05 module.
+//#define	_UART_BAUDRATE_BPS 38400	// Default datarate in bits-per-second for HC-05 module in AT mode.
+#define	_UART_BAUDRATE_BPS 115200	// Default datarate in bits-per-second
+//#define	_UART_BAUDRATE_BPS 128000	// Default datarate in bits-per-second
+//#define	_UART_BAUDRATE_BPS 230400	// Default datarate in bits-per-second
+#define	_UART1_BAUDRATE_BPS 115200	// Default datarate of UART1.
+
+#if (__UART_BRGR(_UART_BAUDRATE_BPS) < 1) || (__UART_BRGR(_UART_BAUDRATE_BPS) > 65535) || \
+	(__UART_BRGR(_UART1_BAUDRATE_BPS) < 1) || (__UART_BRGR(_UART1_BAUDRATE_BPS) > 65535)
+#error "Driver_UART_V100.c: UART baud rate divisor out of range."
+#endif
+#if (__UART_BAUD_ERROR(_UART_BAUDRATE_BPS) > __BAUD_ERROR_MAX) || (__UART_BAUD_ERROR(_UART1_BAUDRATE_BPS) > __BAUD_ERROR_MAX)
+#error "Driver_UART_V100.c: UART baud rate error too large at this MCK frequency."
+#endif
+
+// Descriptors of the ports, see SCI_CONFIG in "Driver_SCI_V100.h".
+const SCI_CONFIG gstrcUART0Config = {
+	UART0, 0, PDC_UART0, PIOA, PIO_PDR_P9, PIO_PDR_P10, 0, 0,	// PA9 = URXD0, PA10 = UTXD0.
+	UART0_IRQn, ID_UART0, 0, 1,									// Execution trace on UART0.
+	gbytTXbuffer, gbytRXbuffer, sizeof(gbytRXbuffer), gbytRXring, __SCI_RXRING_LENGTH,
+	&gstrcTXqueue, gstrcTXframe, __UART_EVENT_RX, __UART_EVENT_TX};
+const SCI_CONFIG gstrcUART1Config = {
+	UART1, 0, PDC_UART1, PIOB, PIO_PDR_P2, PIO_PDR_P3, 0, 0,	// PB2 = URXD1, PB3 = UTXD1.
+	UART1_IRQn, ID_UART1, 1, 0,
+	gbytTXbuffer1, gbytRXbuffer1, sizeof(gbytRXbuffer1), gbytRXring1, __SCI_RXRING1_LENGTH,
+	&gstrcTXqueue1, gstrcTXframe1, __UART1_EVENT_RX, __UART1_EVENT_TX};
+
+SCI_PORT gstrcUART0 = {&gstrcUART0Config, _UART_BAUDRATE_BPS};	// Variables of the ports.
+SCI_PORT gstrcUART1 = {&gstrcUART1Config, _UART1_BAUDRATE_BPS};
 
 
 ///
@@ -49,7 +87,7 @@ uint8_t gbytRXbufptr;                             // Receive buffer length point
 ///
 /// Author			: Fabian Kung
 ///
-/// Last modified	: 28 Dec 2015
+/// Last modified	: 16 Oct 2026
 ///
 /// Code version	: 1.00
 ///
@@ -71,6 +109,8 @@ uint8_t gbytRXbufptr;                             // Receive buffer length point
 ///                   gbytTXbufptr
 ///                   gbytTXbuflen
 ///                   gSCIstatus
+///                   gstrcTXqueue
+///                   gunRXerror
 ///
 
 #ifdef 				  __OS_VER		// Check RTOS version compatibility.
@@ -82,22 +122,14 @@ uint8_t gbytRXbufptr;                             // Receive buffer length point
 #endif
 
 ///
-/// Description		: 1. Driver for built-in UART0 Module.
-///                   2. Serial Communication Interface (UART) transmit buffer manager.
-///                      Data will be taken from the SCI transmit buffer gbytTXbuffer in FIFO basis
-///                      and transmitted via USART module.  Maximum data length is determined by the
-///						 constant _SCI_TXBUF_LENGTH in file "osmain.h".
-///                      Data transmission can be done with or without the assistance of the Peripheral
-///                      DMA Controller (PDC).
-///                   3. Serial Communication Interface (UART) receive buffer manager.
-///					Data received from the USART module of the micro-controller will be
-///					transferred from the USART registers to the RAM of the micro-controller
-///					called SCI receive buffer (gbytRXbuffer[]).
-///					The flag bRXRDY will be set to indicate to the user modules that valid
-///					data is present.
-///					Maximum data length is determined by the constant _SCI_RXBUF_LENGTH in
-///					file "osmain.h".
-///
+/// Description		: Driver for built-in UART0 Module.
+///                   Note: 16 Oct 2026, the driver is now an instance of the serial driver of 
+///                   "Driver_SCI_V100.c", with the port gstrcUART0, which describes the transmit 
+///                   buffer, the receive ring and buffer, the transmit queue, the scatter-gather
+///                   transmit, the frame queues and the execution trace.  The variables and 
+///                   routines of UART0 keep their names, e.g. gSCIstatus and UART0RxRead(), see
+///                   "Driver_UART_V100.h".  UART1 is served the same way by Proce_UART1_Driver(),
+///                   on PB2 = URXD1 and PB3 = UTXD1, through gstrcUART1 and the SCI routines.
 ///
 /// Example of usage : The codes example below illustrates how to send 2 bytes of character,
 ///			'a' and 'b' via UART without PDC assistance.
@@ -121,6 +153,24 @@ uint8_t gbytRXbufptr;                             // Receive buffer length point
 ///					gSCIstatus.bTXRDY = 1;		// Initiate TX.
 ///					PIN_LED2_SET;				// Lights up indicator LED2.
 ///
+/// Example of usage : The codes example below illustrates how to send a string via the UART
+///          transmit queue.  The no. of bytes accepted is returned, which is less than the length
+///          of the string if the queue is full.
+///          nCount = OSQueueWrite(&gstrcTXqueue, "Hello", 5);
+///
+/// Example of usage : The codes example below illustrates how to send a header and a block of
+///          data in place, bytHeader[] and bytImage[] must not be changed until ImageSent() is
+///          called.  The descriptors are also read until then, so they must not be local.
+///          strcDesc[0].ptrData = bytHeader; strcDesc[0].unLength = 4; strcDesc[0].ptrNext = &strcDesc[1];
+///          strcDesc[1].ptrData = bytImage; strcDesc[1].unLength = 4096; strcDesc[1].ptrNext = 0;
+///          if (UART0TxSend(&strcDesc[0], ImageSent, 0) == 0) ...	// Accepted, 1 if a chain is pending.
+///
+/// Example of usage : The codes example below illustrates how a task reads the receive ring,
+///          waiting for data with the event flag.  UART0RxOpen(ptrTask->nID) is called once.
+///          OSGetEvent(ptrTask, __UART_EVENT_RX);				// Clear the event flag.
+///          nCount = UART0RxRead(bytFrame, sizeof(bytFrame));	// Get up to 64 bytes.
+///          OSWaitEvent(ptrTask, 1, __UART_EVENT_RX, 0);		// Sleep until more data arrive.
+///
 /// Example of usage : The codes example below illustrates how to retrieve 1 byte of data from
 ///                    the UART receive buffer.
 ///			if (gSCIstatus.bRXRDY == 1)	// Check if UART receive any data.
@@ -144,148 +194,38 @@ uint8_t gbytRXbufptr;                             // Receive buffer length point
 
 void Proce_UART_Driver(TASK_ATTRIBUTE *ptrTask)
 {
+	SCIDriver(ptrTask, &gstrcUART0);
+}
 
-	if (ptrTask->nTimer == 0)
-	{
-		switch (ptrTask->nState)
-		{
-			case 0: // State 0 - UART0 Initialization.
-				// Setup IO pins mode and configure the peripheral pins:
-
-				// Setup pin PA9 as input. General purpose input.
-				PIOA->PIO_PPDDR |= PIO_PPDDR_P9;  // Disable internal pull-down to PA9.
-				PIOA->PIO_PUER |= PIO_PUER_P9;	// Enable internal pull-up to PA9.
-				//PIOA->PIO_PER |= PIO_PER_P9;	// PA9 is controlled by PIO.
-				PIOA->PIO_ODR |= PIO_ODR_P9;	// Disable output write to PA9.
-				//PIOA->PIO_IFER |= PIO_IFER_P9;	// Enable input glitch filter to PA9. This is optional.
- 				
-				 // 24 Nov 2015: To enable a peripheral, we need to:
- 				// 1. Assign the IO pins to the peripheral.
- 				// 2. Select the correct peripheral block (A, B, C or D).
- 				PIOA->PIO_PDR = (PIOA->PIO_PDR) | PIO_PDR_P9;	// Set PA9 and PA10 to be controlled by Peripheral.
- 				PIOA->PIO_PDR = (PIOA->PIO_PDR) | PIO_PDR_P10;	// UART0 resides in Peripheral block A, with 
-																// PA9 = URXD0 and PA10 = UTXD0.
- 																
- 				PIOA->PIO_ABCDSR[0] = (PIOA->PIO_ABCDSR[0]) & ~PIO_ABCDSR_P9;	// Select peripheral block A for
- 				PIOA->PIO_ABCDSR[1] = (PIOA->PIO_ABCDSR[1]) & ~PIO_ABCDSR_P9;	// PA9.
- 				PIOA->PIO_ABCDSR[0] = (PIOA->PIO_ABCDSR[0]) & ~PIO_ABCDSR_P10;	// Select peripheral block A for
- 				PIOA->PIO_ABCDSR[1] = (PIOA->PIO_ABCDSR[1]) & ~PIO_ABCDSR_P10;	// PA10.
-
-				// Setup baud rate generator register.  
-				// Baudrate = (Peripheral clock)/(16xCD)
-				// for CD = 65, baud rate = 115.38 kbps
-				// for CD = 781, baud rate = 9.60 kbps
-				// for CD = 32, baud rate = 234.375 kbps
-                if (_UART_BAUDRATE_kBPS == 230.4)
-				{
-					UART0->UART_BRGR = 33;						// Approximate 230.4 kbps
-				}
-				else
-				{
-					UART0->UART_BRGR = (__FPERIPHERAL_MHz*1000)/(16*_UART_BAUDRATE_kBPS);
-				}
-				//UART0->UART_BRGR = 17;					// Approximate 460.8 kbps
-				                
-				// Setup USART0 operation mode part 1:
-				// 1. Enable UART0 RX and TX modules.
-				// 2. Channel mode = Normal.
-				// 3. 8 bits data, no parity, 1 stop bit.
-				// 4. No interrupt.
-				
-				UART0->UART_MR = UART_MR_PAR_NO | UART_MR_CHMODE_NORMAL;	// Set parity and channel mode.
-				UART0->UART_CR = UART0->UART_CR | UART_CR_TXEN | UART_CR_RXEN; // Enable both transmitter and receiver.
-				                                
-				gbytTXbuflen = 0;               // Initialize all relevant variables and flags.
-				gbytTXbufptr = 0;
-				gSCIstatus.bRXRDY = 0;	
-				gSCIstatus.bTXRDY = 0;
-				gSCIstatus.bRXOVF = 0;
-                                
-				gbytRXbufptr = 0;
-                PIN_LED2_CLEAR;							// Off indicator LED2.
-				PMC->PMC_PCER0 |= PMC_PCER0_PID8;		// Enable peripheral clock to UART0 (ID8)
-				OSSetTaskContext(ptrTask, 1, 100);		// Next state = 1, timer = 100.
-			break;
-			
-			case 1: // State 1 - Transmit and receive buffer manager.
-				// Check for data to send via UART.
-				// Note that the transmit buffer is only 2-level deep in ARM Cortex-M4 micro-controllers.
-				if (gSCIstatus.bTXRDY == 1)                         // Check if valid data in SCI buffer.
-				{
-					if (gSCIstatus.bTXDMAEN == 0)					// Transmit without DMA.
-					{
-						while ((UART0->UART_SR & UART_SR_TXRDY) > 0)// Check if UART transmit holding buffer is not full.
-						{
-							PIN_LED2_SET;							// On indicator LED2.
-							if (gbytTXbufptr < gbytTXbuflen)		// Make sure we haven't reach end of valid data to transmit. 
-							{
-								UART0->UART_THR = gbytTXbuffer[gbytTXbufptr];	// Load 1 byte data to UART transmit holding buffer.
-								gbytTXbufptr++;                     // Pointer to next byte in TX buffer.
-							}
-							else                                    // End of data to transmit.
-							{
-								gbytTXbufptr = 0;                   // Reset TX buffer pointer.
-								gbytTXbuflen = 0;                   // Reset TX buffer length.
-								gSCIstatus.bTXRDY = 0;              // Reset transmit flag.
-								PIN_LED2_CLEAR;                     // Off indicator LED2.
-								break;
-							}
-						}
-                    }
-					else											// Transmit with DMA.
-					{
-						if ((UART0->UART_SR & UART_SR_ENDTX) > 0)	// Check if DMA UART transmit is completed.
-						{
-							gSCIstatus.bTXRDY = 0;					// Reset transmit flag.
-							PIN_LED2_CLEAR;							// Off indicator LED2.
-							break;							
-						}
-					}
-				}
-
-
-				// Check for data to receive via UART.
-				// Note that the receive FIFO buffer is only 2-level deep in ARM Cortex-M4 micro-controllers.
-                // Here we ignore Parity error.  If overflow or framing error is detected, we need to write a 1 
-				// to the bit RSTSTA to clear the error flags.  It is also advisable to reset the receiver.
-                                
-				if (((UART0->UART_SR & UART_SR_FRAME) == 0) && ((UART0->UART_SR & UART_SR_OVRE) == 0)) 
-                {															// Make sure no hardware overflow and 
-																			// and framing error.
-                    while ((UART0->UART_SR & UART_SR_RXRDY) > 0)			// Check for availability of data received.
-																			// available at UART
-                    {
-                        PIN_LED2_SET;										// On indicator LED2.
-                        if (gbytRXbufptr < __SCI_RXBUF_LENGTH)				// check for data overflow.
-                        {													// Read a character from USART.
-                            gbytRXbuffer[gbytRXbufptr] = UART0->UART_RHR;	// Get received data byte.
-                            gbytRXbufptr++;									// Pointer to next byte in RX buffer.
-                            gSCIstatus.bRXRDY = 1;							// Set valid data flag.
-                        }
-                        else 												// data overflow.
-                        {
-                            gbytRXbufptr = 0;								// Reset buffer pointer.
-                            gSCIstatus.bRXOVF = 1;							// Set receive data overflow flag.
-                        }
-                        
-                    }
-                }
-                else														// Hard overflow or/and framing error.
-                {
-                    UART0->UART_CR = UART0->UART_CR | UART_CR_RSTSTA;		// Clear overrun and framing error flags.
-					//UART0->UART_CR = UART0->UART_CR | UART_CR_RSTRX;		// Reset the receiver.		
-                    gbytRXbufptr = 0;										// Reset buffer pointer.
-                    gSCIstatus.bRXOVF = 1;									// Set receive data overflow flag.
-                } 
-				
-				OSSetTaskContext(ptrTask, 1, 1); // Next state = 1, timer = 1.
-			break;
-
-			default:
-				OSSetTaskContext(ptrTask, 0, 1); // Back to state = 0, timer = 1.
-			break;
-		}
-	}
+// Function name	: Proce_UART1_Driver
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Driver for built-in UART1 Module, see Proce_UART_Driver().
+// Arguments		: ptrTask = the task.
+// Return			: None.
+void Proce_UART1_Driver(TASK_ATTRIBUTE *ptrTask)
+{
+	SCIDriver(ptrTask, &gstrcUART1);
 }
 
+// Function name	: UART0_Handler
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: UART0 interrupt service routine, see SCIHandler().
+// Arguments		: None.
+// Return			: None.
+void UART0_Handler(void)
+{
+	SCIHandler(&gstrcUART0);
+}
 
+// Function name	: UART1_Handler
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: UART1 interrupt service routine, see SCIHandler().
+// Arguments		: None.
+// Return			: None.
+void UART1_Handler(void)
+{
+	SCIHandler(&gstrcUART1);
+}
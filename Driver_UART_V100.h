@@ -8,23 +8,60 @@
 // Include common header to all drivers and sources.  Here absolute path is used.
 // To edit if one change folder
 #include "osmain.h"
+#include "Driver_SCI_V100.h"
 
-// 
+//
 //
 // --- PUBLIC VARIABLES ---
 //
-				
+
 // Data buffer and address pointers for wired serial communications.
 extern uint8_t gbytTXbuffer[__SCI_TXBUF_LENGTH-1];
-extern uint8_t gbytTXbufptr;
-extern uint8_t gbytTXbuflen;
 extern uint8_t gbytRXbuffer[__SCI_RXBUF_LENGTH-1];
-extern uint8_t gbytRXbufptr;
+extern OS_QUEUE gstrcTXqueue;						// Transmit queue, bytes.
+extern OS_QUEUE gstrcTXframe[__SCI_PRIORITY_LEVELS];	// Frame queues, SCI_FRAME pointers.
+extern SCI_PORT gstrcUART0;
+extern uint8_t gbytTXbuffer1[__SCI_TXBUF1_LENGTH-1];	// UART1.
+extern uint8_t gbytRXbuffer1[__SCI_RXBUF1_LENGTH-1];
+extern OS_QUEUE gstrcTXqueue1;
+extern OS_QUEUE gstrcTXframe1[__SCI_PRIORITY_LEVELS];
+extern SCI_PORT gstrcUART1;
+
+// Note: 16 Oct 2026, the variables of UART0 are kept in gstrcUART0, the names below are kept
+// for the existing codes.
+#define gSCIstatus			(gstrcUART0.strcStatus)
+#define gbytTXbufptr		(gstrcUART0.bytTXbufptr)
+#define gbytTXbuflen		(gstrcUART0.bytTXbuflen)
+#define gbytRXbufptr		(gstrcUART0.bytRXbufptr)
+#define gunRXerror			(gstrcUART0.unRXerror)	// No. of receive overrun and framing errors.
+
+#define __UART_EVENT_RX          0x40000000			// Event flag signalled to the task reading the
+													// receive ring, see UART0RxOpen().
+#define __UART_EVENT_TX          0x10000000			// Event flag signalled to the owner of a frame
+													// once sent, see UART0FrameSend().
+#define __UART1_EVENT_RX         0x04000000			// Same for UART1.
+#define __UART1_EVENT_TX         0x01000000
+
+// Descriptor of a block of data sent in place by UART0TxSend().
+typedef SCI_TX_DESC UART_TX_DESC;
 
 
 //
 // --- PUBLIC FUNCTION PROTOTYPE ---
 //
 void Proce_UART_Driver(TASK_ATTRIBUTE *);
+void Proce_UART1_Driver(TASK_ATTRIBUTE *);
+void UART0_Handler(void);
+void UART1_Handler(void);
+
+// UART0 routines, see "Driver_SCI_V100.c".
+#define UART0RxOpen(nHandle)				SCIRxOpen(&gstrcUART0, (nHandle))
+#define UART0RxCount()						SCIRxCount(&gstrcUART0)
+#define UART0RxRead(ptrData, unMax)			SCIRxRead(&gstrcUART0, (ptrData), (unMax))
+#define UART0RxPeek(pptrData)				SCIRxPeek(&gstrcUART0, (pptrData))
+#define UART0RxSkip(unCount)				SCIRxSkip(&gstrcUART0, (unCount))
+#define UART0TxSend(ptrDesc, fptrDone, ptrArg)	SCITxSend(&gstrcUART0, (ptrDesc), (fptrDone), (ptrArg))
+#define UART0TxBusy()						SCITxBusy(&gstrcUART0)
+#define UART0FrameSend(ptrFrame, nPriority)	SCIFrameSend(&gstrcUART0, (ptrFrame), (nPriority))
 
 #endif
@@ -9,10 +9,11 @@
 //
 // File				: Drivers_USART_V100.c
 // Author(s)		: Fabian Kung
-// Last modified	: 19 Feb 2016
+// Last modified	: 16 Oct 2026
 // Toolsuites		: Atmel Studio 7.0 or later
 //					  GCC C-Compiler
 #include "osmain.h"
+#include "Driver_USART_V100.h"
 
 
 // NOTE: Public function prototypes are declared in the corresponding *.h file.
@@ -21,33 +22,70 @@
 //
 // --- PUBLIC VARIABLES ---
 //
-// Data buffer and address pointers for wired serial communications (UART).
+// Data buffer and address pointers for wired serial communications (USART).
 uint8_t gbytTXbuffer2[__SCI_TXBUF2_LENGTH-1];       // Transmit buffer.
-uint8_t gbytTXbufptr2;                             // Transmit buffer pointer.
-uint8_t gbytTXbuflen2;                             // Transmit buffer length.
 uint8_t gbytRXbuffer2[__SCI_RXBUF2_LENGTH-1];       // Receive buffer length.
-uint8_t gbytRXbufptr2;                             // Receive buffer length pointer.
-
-SCI_STATUS gSCIstatus2;
+uint8_t gbytTXqueue2[__SCI_TXQUEUE2_LENGTH];       // Storage of the transmit queue.
+OS_QUEUE gstrcTXqueue2 = {0, 0, __SCI_TXQUEUE2_LENGTH-1, 1, gbytTXqueue2};	// Transmit queue.
+SCI_FRAME *gptrTXframe2[__SCI_PRIORITY_LEVELS][__SCI_FRAMEQ_LENGTH];	// Storage of the frame queues.
+OS_QUEUE gstrcTXframe2[__SCI_PRIORITY_LEVELS] = {						// Frame queues, one per priority.
+	{0, 0, __SCI_FRAMEQ_LENGTH-1, sizeof(SCI_FRAME *), (uint8_t *) gptrTXframe2[0]},
+	{0, 0, __SCI_FRAMEQ_LENGTH-1, sizeof(SCI_FRAME *), (uint8_t *) gptrTXframe2[1]}};
+
+uint8_t gbytTXbuffer3[__SCI_TXBUF3_LENGTH-1];       // Same for USART1.
+uint8_t gbytRXbuffer3[__SCI_RXBUF3_LENGTH-1];
+uint8_t gbytTXqueue3[__SCI_TXQUEUE3_LENGTH];
+OS_QUEUE gstrcTXqueue3 = {0, 0, __SCI_TXQUEUE3_LENGTH-1, 1, gbytTXqueue3};
+SCI_FRAME *gptrTXframe3[__SCI_PRIORITY_LEVELS][__SCI_FRAMEQ_LENGTH];
+OS_QUEUE gstrcTXframe3[__SCI_PRIORITY_LEVELS] = {
+	{0, 0, __SCI_FRAMEQ_LENGTH-1, sizeof(SCI_FRAME *), (uint8_t *) gptrTXframe3[0]},
+	{0, 0, __SCI_FRAMEQ_LENGTH-1, sizeof(SCI_FRAME *), (uint8_t *) gptrTXframe3[1]}};
 
 //
 // --- PRIVATE VARIABLES ---
 //
-
+uint8_t gbytRXring2[__SCI_RXRING2_LENGTH];		// Receive rings, filled by the PDC.
+uint8_t gbytRXring3[__SCI_RXRING3_LENGTH];
 
 //
 // --- Process Level Constants Definition --- 
 //
 
-#define	_USART_BAUDRATE_kBPS 19.2	// Default datarate in kilobits-per-second
-//#define	_USART_BAUDRATE_kBPS 38.4	// Default datarate in kilobits-per-second
+#define	_USART_BAUDRATE_BPS 19200	// Default datarate in bits-per-second
+//#define	_USART_BAUDRATE_BPS 38400	// Default datarate in bits-per-second
+//#define	_USART_BAUDRATE_BPS 3000000	// High-speed link, 120 MHz/40, use the frames and the 
+									// receive ring, see USART0SetHandshake().
+#define	_USART1_BAUDRATE_BPS 115200	// Default datarate of USART1.
+
+#if (__USART_BRGR(_USART_BAUDRATE_BPS) < 1) || (__USART_BRGR(_USART_BAUDRATE_BPS) > 65535) || \
+	(__USART_BRGR(_USART1_BAUDRATE_BPS) < 1) || (__USART_BRGR(_USART1_BAUDRATE_BPS) > 65535)
+#error "Driver_USART_V100.c: USART baud rate divisor out of range."
+#endif
+#if (__USART_BAUD_ERROR(_USART_BAUDRATE_BPS) > __BAUD_ERROR_MAX) || (__USART_BAUD_ERROR(_USART1_BAUDRATE_BPS) > __BAUD_ERROR_MAX)
+#error "Driver_USART_V100.c: USART baud rate error too large at this MCK frequency."
+#endif
+
+// Descriptors of the ports, see SCI_CONFIG in "Driver_SCI_V100.h".
+const SCI_CONFIG gstrcUSART0Config = {
+	(Uart *) USART0, USART0, PDC_USART0, PIOA, PIO_PDR_P5, PIO_PDR_P6,	// PA5 = RXD0, PA6 = TXD0,
+	PIO_PDR_P7, PIO_PDR_P8,	USART0_IRQn, ID_USART0, 2, 0,				// PA7 = RTS0, PA8 = CTS0.
+	gbytTXbuffer2, gbytRXbuffer2, sizeof(gbytRXbuffer2), gbytRXring2, __SCI_RXRING2_LENGTH,
+	&gstrcTXqueue2, gstrcTXframe2, __USART_EVENT_RX, __USART_EVENT_TX};
+const SCI_CONFIG gstrcUSART1Config = {
+	(Uart *) USART1, USART1, PDC_USART1, PIOA, PIO_PDR_P21, PIO_PDR_P22,	// PA21 = RXD1, PA22 = TXD1,
+	PIO_PDR_P24, PIO_PDR_P25, USART1_IRQn, ID_USART1, 3, 0,				// PA24 = RTS1, PA25 = CTS1.
+	gbytTXbuffer3, gbytRXbuffer3, sizeof(gbytRXbuffer3), gbytRXring3, __SCI_RXRING3_LENGTH,
+	&gstrcTXqueue3, gstrcTXframe3, __USART1_EVENT_RX, __USART1_EVENT_TX};
+
+SCI_PORT gstrcUSART0 = {&gstrcUSART0Config, _USART_BAUDRATE_BPS};	// Variables of the ports.
+SCI_PORT gstrcUSART1 = {&gstrcUSART1Config, _USART1_BAUDRATE_BPS};
 
 ///
 /// Process name	: Proce_USART_Driver
 ///
 /// Author			: Fabian Kung
 ///
-/// Last modified	: 19 Feb 2016
+/// Last modified	: 16 Oct 2026
 ///
 /// Code version	: 1.00
 ///
@@ -56,18 +94,22 @@ SCI_STATUS gSCIstatus2;
 /// Processor/System Resource 
 /// PINS		: 1. Pin PA5 = RXD0, peripheral A, input.
 ///  			  2. Pin PA6 = TXD0, peripheral A, output.
-///               3. PIN_ILED2 = indicator LED2.
+///               3. Pin PA7 = RTS0 and PA8 = CTS0, peripheral A, with the handshaking.
+///               4. PIN_ILED2 = indicator LED2.
 ///
 /// MODULES		: 1. USART0 (Internal).
+///               2. PDC (Peripheral DMA Controller) (Internal).
 ///
 /// RTOS		: Ver 1 or above, round-robin scheduling.
 ///
-/// Global variable	: gbytRX2buffer[]
-///                   gbytRX2bufptr
-///                   gbytTX2buffer[]
-///                   gbytTX2bufptr
-///                   gbytTX2buflen
-///                   gSCI2status
+/// Global variable	: gbytRXbuffer2[]
+///                   gbytRXbufptr2
+///                   gbytTXbuffer2[]
+///                   gbytTXbufptr2
+///                   gbytTXbuflen2
+///                   gSCIstatus2
+///                   gstrcTXqueue2
+///                   gunRXerror2
 ///
 
 #ifdef 				  __OS_VER		// Check RTOS version compatibility.
@@ -79,22 +121,16 @@ SCI_STATUS gSCIstatus2;
 #endif
 
 ///
-/// Description		: 1. Driver for built-in UART0 Module.
-///                   2. Serial Communication Interface (UART) transmit buffer manager.
-///                      Data will be taken from the SCI transmit buffer gbytTX2buffer in FIFO basis
-///                      and transmitted via USART module.  Maximum data length is determined by the
-///						 constant _SCI_TXBUF2_LENGTH in file "osmain.h".
-///                      Data transmission can be done with or without the assistance of the Peripheral
-///                      DMA Controller (PDC).
-///                   3. Serial Communication Interface (UART) receive buffer manager.
-///					Data received from the USART module of the micro-controller will be
-///					transferred from the USART registers to the RAM of the micro-controller
-///					called SCI receive buffer (gbytRX2buffer[]).
-///					The flag bRXRDY will be set to indicate to the user modules that valid
-///					data is present.
-///					Maximum data length is determined by the constant _SCI_RXBUF2_LENGTH in
-///					file "osmain.h".
-///
+/// Description		: Driver for built-in USART0 Module.
+///                   Note: 16 Oct 2026, the driver is now an instance of the serial driver of 
+///                   "Driver_SCI_V100.c", with the port gstrcUSART0, as UART0 in
+///                   "Driver_UART_V100.c".  The end of a received frame is detected with the
+///                   receiver time-out, the baud rate uses the fractional divisor and the 
+///                   RTS/CTS handshaking can be enabled, see USART0SetBaud() and 
+///                   USART0SetHandshake().  The variables and routines of USART0 keep their
+///                   names, see "Driver_USART_V100.h".  USART1 is served the same way by 
+///                   Proce_USART1_Driver(), on PA21 = RXD1, PA22 = TXD1, PA24 = RTS1 and 
+///                   PA25 = CTS1, through gstrcUSART1 and the SCI routines.
 ///
 /// Example of usage : The codes example below illustrates how to send 2 bytes of character,
 ///			'a' and 'b' via USART without PDC assistance.
@@ -130,143 +166,38 @@ SCI_STATUS gSCIstatus2;
 
 void Proce_USART_Driver(TASK_ATTRIBUTE *ptrTask)
 {
+	SCIDriver(ptrTask, &gstrcUSART0);
+}
 
-	if (ptrTask->nTimer == 0)
-	{
-		switch (ptrTask->nState)
-		{
-			case 0: // State 0 - USART0 Initialization.
-				// Setup IO pins mode and configure the peripheral pins:
-
-				// Setup pin PA5 as input. General purpose input.
-				PIOA->PIO_PPDDR |= PIO_PPDDR_P5;				// Disable internal pull-down to PA5.
-				PIOA->PIO_PUER |= PIO_PUER_P5;					// Enable internal pull-up to PA5.
-				//PIOA->PIO_PER |= PIO_PER_P5;					// PA5 is controlled by PIO.
-				PIOA->PIO_ODR |= PIO_ODR_P5;					// Disable output write to PA5.
-				//PIOA->PIO_IFER |= PIO_IFER_P5;				// Enable input glitch filter to PA5. This is optional.
- 				
-				// 24 Nov 2015: To enable a peripheral, we need to:
- 				// 1. Assign the IO pins to the peripheral.
- 				// 2. Select the correct peripheral block (A, B, C or D).
- 				PIOA->PIO_PDR = (PIOA->PIO_PDR) | PIO_PDR_P5;	// Set PA5 and PA6 to be controlled by Peripheral.
- 				PIOA->PIO_PDR = (PIOA->PIO_PDR) | PIO_PDR_P6;	// USART0 resides in Peripheral block A, with 
-																// PA5 = RXD0 and PA6 = TXD0.
- 																
- 				PIOA->PIO_ABCDSR[0] = (PIOA->PIO_ABCDSR[0]) & ~PIO_ABCDSR_P5;	// Select peripheral block A for
- 				PIOA->PIO_ABCDSR[1] = (PIOA->PIO_ABCDSR[1]) & ~PIO_ABCDSR_P5;	// PA5.
- 				PIOA->PIO_ABCDSR[0] = (PIOA->PIO_ABCDSR[0]) & ~PIO_ABCDSR_P6;	// Select peripheral block A for
- 				PIOA->PIO_ABCDSR[1] = (PIOA->PIO_ABCDSR[1]) & ~PIO_ABCDSR_P6;	// PA6.		 
-				 
-				PMC->PMC_PCER0 |= PMC_PCER0_PID14;				// Enable peripheral clock to USART0 (ID14)
-																// 3 Feb 2016: We must first enable the USART clock in the PMC		
-																// before we can use the USART.
-				//USART0->US_WPMR = US_WPMR_WPKEY_PASSWD;		// Disable write protect.
- 				
-
-				// Setup baud rate generator register.
-				// Baudrate = (Peripheral clock)/(8(2-Over)CD)
-				// Here Over = 1.				
-				USART0->US_MR |= US_MR_OVER;
-				USART0->US_BRGR = (__FPERIPHERAL_MHz*1000)/(8*_USART_BAUDRATE_kBPS);
-				
-				// Setup USART0 operation mode:
-				// 1. USART mode = Normal.
-				// 2. Peripheral clock is selected.
-				// 3. 8 bits data, no parity, 1 stop bit.
-				// 4. No interrupt.
-				// 5. Channel mode = Normal.
-				// 6. 8x Oversampling (Over = 1).
-				// 7. The NACK is not generated.
-				// 8. Start frame delimiter is one bit.
-				// 9. Disable Manchester encoder/decoder. 
-				USART0->US_MR |= US_MR_USART_MODE_NORMAL | US_MR_CHRL_8_BIT | US_MR_PAR_NO | US_MR_ONEBIT;
-							 
-				USART0->US_CR = US_CR_TXEN;						// Enable transmitter.             
-			    USART0->US_CR = USART0->US_CR | US_CR_RXEN;		// Enable receiver.           
-						   
-				gbytTXbuflen2 = 0;								// Initialize all relevant variables and flags.
-				gbytTXbufptr2 = 0;								// Clear transmit buffer 2 pointer.
-				gSCIstatus2.bRXRDY = 0;	
-				gSCIstatus2.bTXRDY = 0;
-				gSCIstatus2.bRXOVF = 0;
-                                
-				gbytRXbufptr2 = 0;								// Clear receive buffer 2 pointer.
-                PIN_LED2_CLEAR;									// Off indicator LED2.
-			
-				OSSetTaskContext(ptrTask, 1, 100);				// Next state = 1, timer = 100.
-			break;
-			
-			case 1: // State 1 - Transmit and receive buffer manager.
-							
-				// Check for data to send via UART.
-				// Note that the transmit buffer is only 2-level deep in ARM Cortex-M4 micro-controllers.
-				if (gSCIstatus2.bTXRDY == 1)					// Check if valid data in SCI buffer.
-				{
-					
-					while ((USART0->US_CSR & US_CSR_TXRDY) > 0)	// Check if USART transmit holding buffer is not full.
-					{
-						PIN_LED2_SET;							// On indicator LED2.
-						if (gbytTXbufptr2 < gbytTXbuflen2)		// Make sure we haven't reach end of valid data to transmit. 
-						{
-							USART0->US_THR = gbytTXbuffer2[gbytTXbufptr2];	// Load 1 byte data to USART transmit holding buffer.
-							gbytTXbufptr2++;                    // Pointer to next byte in TX buffer.
-						}
-						else                                    // End of data to transmit.
-						{
-							gbytTXbufptr2 = 0;                  // Reset TX buffer pointer.
-							gbytTXbuflen2 = 0;                  // Reset TX buffer length.
-							gSCIstatus2.bTXRDY = 0;             // Reset transmit flag.
-							PIN_LED2_CLEAR;                     // Off indicator LED2.
-							break;
-						}
-					}
-				}
-
-				
-				// Check for data to receive via USART.
-				// Note that the receive FIFO buffer is only 2-level deep in ARM Cortex-M4 micro-controllers.
-                // Here we ignore Parity error.  If overflow or framing error is detected, we need to write a 1 
-				// to the bit RSTSTA to clear the error flags.  It is also advisable to reset the receiver.
-                                
-				if (((USART0->US_CSR & US_CSR_FRAME) == 0) && ((USART0->US_CSR & US_CSR_OVRE) == 0)) 
-                {															// Make sure no hardware overflow and 
-																			// and framing error.
-                    while ((USART0->US_CSR & US_CSR_RXRDY) > 0)				// Check for availability of data received.
-																			// available at UART
-                    {
-                        PIN_LED2_SET;										// On indicator LED2.
-                        if (gbytRXbufptr2 < __SCI_RXBUF2_LENGTH)			// check for data overflow.
-                        {													// Read a character from USART.
-                            gbytRXbuffer2[gbytRXbufptr2] = USART0->US_RHR;	// Get received data byte.
-                            gbytRXbufptr2++;								// Pointer to next byte in RX buffer.
-                            gSCIstatus2.bRXRDY = 1;							// Set valid data flag.
-                        }
-                        else 												// data overflow.
-                        {
-                            gbytRXbufptr2 = 0;								// Reset buffer pointer.
-                            gSCIstatus2.bRXOVF = 1;							// Set receive data overflow flag.
-                        }
-                        
-                    }
-                }
-                else														// Hard overflow or/and framing error.
-                {
-                    USART0->US_CR = USART0->US_CR | US_CR_RSTSTA;			// Clear overrun and framing error flags.
-					UART0->UART_CR = UART0->UART_CR | UART_CR_RSTRX;		// Reset the receiver.		
-                    gbytRXbufptr2 = 0;										// Reset buffer pointer.
-                    gSCIstatus2.bRXOVF = 1;									// Set receive data overflow flag.
-					PIN_LED2_CLEAR;
-                } 
-				
-				OSSetTaskContext(ptrTask, 1, 1); // Next state = 1, timer = 1.
-				//OSSetTaskContext(ptrTask, 1, 10*__NUM_SYSTEMTICK_MSEC); // Next state = 1, timer = 1.
-			break;
-
-			default:
-				OSSetTaskContext(ptrTask, 0, 1); // Back to state = 0, timer = 1.
-			break;
-		}
-	}
+// Function name	: Proce_USART1_Driver
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Driver for built-in USART1 Module, see Proce_USART_Driver().
+// Arguments		: ptrTask = the task.
+// Return			: None.
+void Proce_USART1_Driver(TASK_ATTRIBUTE *ptrTask)
+{
+	SCIDriver(ptrTask, &gstrcUSART1);
 }
 
+// Function name	: USART0_Handler
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: USART0 interrupt service routine, see SCIHandler().
+// Arguments		: None.
+// Return			: None.
+void USART0_Handler(void)
+{
+	SCIHandler(&gstrcUSART0);
+}
 
+// Function name	: USART1_Handler
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: USART1 interrupt service routine, see SCIHandler().
+// Arguments		: None.
+// Return			: None.
+void USART1_Handler(void)
+{
+	SCIHandler(&gstrcUSART1);
+}
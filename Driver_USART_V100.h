@@ -8,26 +8,56 @@
 // Include common header to all drivers and sources.  Here absolute path is used.
 // To edit if one change folder
 #include "osmain.h"
+#include "Driver_SCI_V100.h"
 
 // 
 //
 // --- PUBLIC VARIABLES ---
 //
 
-#define __SCI_TXBUF2_LENGTH      8			// SCI transmit  buffer2 length in bytes.
-#define __SCI_RXBUF2_LENGTH      8			// SCI receive  buffer2 length in bytes.		
-		
 // Data buffer and address pointers for wired serial communications.
 extern uint8_t gbytTXbuffer2[__SCI_TXBUF2_LENGTH-1];
-extern uint8_t gbytTXbufptr2;
-extern uint8_t gbytTXbuflen2;
 extern uint8_t gbytRXbuffer2[__SCI_RXBUF2_LENGTH-1];
-extern uint8_t gbytRXbufptr2;
+extern	OS_QUEUE gstrcTXqueue2;						// Transmit queue, bytes.
+extern	OS_QUEUE gstrcTXframe2[__SCI_PRIORITY_LEVELS];	// Frame queues, SCI_FRAME pointers.
+extern	SCI_PORT gstrcUSART0;
+extern uint8_t gbytTXbuffer3[__SCI_TXBUF3_LENGTH-1];	// USART1.
+extern uint8_t gbytRXbuffer3[__SCI_RXBUF3_LENGTH-1];
+extern	OS_QUEUE gstrcTXqueue3;
+extern	OS_QUEUE gstrcTXframe3[__SCI_PRIORITY_LEVELS];
+extern	SCI_PORT gstrcUSART1;
+
+// Note: 16 Oct 2026, the variables of USART0 are kept in gstrcUSART0, the names below are kept
+// for the existing codes.
+#define gSCIstatus2			(gstrcUSART0.strcStatus)
+#define gbytTXbufptr2		(gstrcUSART0.bytTXbufptr)
+#define gbytTXbuflen2		(gstrcUSART0.bytTXbuflen)
+#define gbytRXbufptr2		(gstrcUSART0.bytRXbufptr)
+#define gunRXerror2			(gstrcUSART0.unRXerror)	// No. of receive overrun and framing errors.
+
+#define __USART_EVENT_RX         0x20000000			// Event flag signalled to the task reading the
+													// receive ring, see USART0RxOpen().
+#define __USART_EVENT_TX         0x08000000			// Event flag signalled to the owner of a frame
+													// once sent, see USART0FrameSend().
+#define __USART1_EVENT_RX        0x02000000			// Same for USART1.
+#define __USART1_EVENT_TX        0x00800000
 
-extern	SCI_STATUS gSCIstatus2;
 //
 // --- PUBLIC FUNCTION PROTOTYPE ---
 //
 void Proce_USART_Driver(TASK_ATTRIBUTE *);
+void Proce_USART1_Driver(TASK_ATTRIBUTE *);
+void USART0_Handler(void);
+void USART1_Handler(void);
+
+// USART0 routines, see "Driver_SCI_V100.c".
+#define USART0RxOpen(nHandle)				SCIRxOpen(&gstrcUSART0, (nHandle))
+#define USART0RxCount()						SCIRxCount(&gstrcUSART0)
+#define USART0RxRead(ptrData, unMax)		SCIRxRead(&gstrcUSART0, (ptrData), (unMax))
+#define USART0RxPeek(pptrData)				SCIRxPeek(&gstrcUSART0, (pptrData))
+#define USART0RxSkip(unCount)				SCIRxSkip(&gstrcUSART0, (unCount))
+#define USART0FrameSend(ptrFrame, nPriority)	SCIFrameSend(&gstrcUSART0, (ptrFrame), (nPriority))
+#define USART0SetBaud(unBps)				SCISetBaud(&gstrcUSART0, (unBps))
+#define USART0SetHandshake(bEnable)			SCISetHandshake(&gstrcUSART0, (bEnable))
 
 #endif
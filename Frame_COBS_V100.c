@@ -0,0 +1,456 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	USER ROUTINES DECLARATION (PROCESSOR INDEPENDENT)
+//
+//  (c) Copyright 2026, Fabian Kung Wai Lee, Selangor, MALAYSIA
+//  All Rights Reserved
+//
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File				: Frame_COBS_V100.c
+// Author(s)		: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Toolsuites		: Atmel Studio 7.0 or later
+//					  GCC C-Compiler
+#include "osmain.h"
+#include "Frame_COBS_V100.h"
+
+
+// NOTE: Public function prototypes are declared in the corresponding *.h file.
+
+
+//
+// --- PRIVATE VARIABLES ---
+//
+// CRC-16/CCITT-FALSE, polynomial 0x1021, initial value 0xFFFF, not reflected.
+const uint16_t gunCRC16Table[256] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+// CRC-32 (IEEE 802.3), reflected polynomial 0xEDB88320, initial value and final XOR 0xFFFFFFFF.
+const uint32_t gunCRC32Table[256] = {
+	0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
+	0xE963A535, 0x9E6495A3, 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
+	0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2,
+	0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+	0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9,
+	0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
+	0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
+	0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+	0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423,
+	0xCFBA9599, 0xB8BDA50F, 0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924,
+	0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D, 0x76DC4190, 0x01DB7106,
+	0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+	0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D,
+	0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
+	0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950,
+	0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+	0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7,
+	0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
+	0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9, 0x5005713C, 0x270241AA,
+	0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+	0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
+	0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A,
+	0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683, 0xE3630B12, 0x94643B84,
+	0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+	0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB,
+	0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC,
+	0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E,
+	0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+	0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55,
+	0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
+	0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28,
+	0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+	0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F,
+	0x72076785, 0x05005713, 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38,
+	0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21, 0x86D3D2D4, 0xF1D4E242,
+	0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+	0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69,
+	0x616BFFD3, 0x166CCF45, 0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2,
+	0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC,
+	0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+	0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693,
+	0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
+	0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
+};
+
+//
+// --- Process Level Constants Definition ---
+//
+#define	_CRC16_RESIDUE		0x0000		// CRC register after the data and their CRC-16.
+#define	_CRC32_RESIDUE		0xDEBB20E3	// CRC register after the data and their CRC-32, before
+										// the final XOR.
+
+///
+/// Module name		: COBS framing
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Code version	: 1.00
+///
+/// Processor		: Any
+///
+/// Processor/System Resource
+/// PINS		: None.
+///
+/// MODULES		: None.
+///
+/// RTOS		: Not required.
+///
+/// Global variable	: None.
+///
+/// Description		: Framing of the serial links with Consistent Overhead Byte Stuffing (COBS)
+///                   and a CRC.  The 0x00 byte only appears as the frame delimiter, any other
+///                   byte value is sent in blocks of up to 254 bytes, each preceded by a code
+///                   byte.  A receiver can thus always find the start of the next frame after
+///                   a lost or corrupted byte, or after an overrun, and the overhead is at most
+///                   1 byte in 254 plus the delimiter.  A CRC-16 or CRC-32 is appended to the
+///                   data before encoding, both are computed with a 256 entries table.
+///                   The encoder writes the encoded frame straight into the output buffer, 
+///                   e.g. the buffer of a SCI_FRAME, filling in each code byte once its block
+///                   is complete, so the data are copied only once.  The decoder is fed with 
+///                   any no. of bytes at a time, e.g. one byte from a receive register or a
+///                   block of the PDC receive ring, and writes the decoded frame straight into
+///                   the frame buffer.  Frames with a coding error, too long for the frame
+///                   buffer or with a wrong CRC are dropped and counted.
+///
+/// Example of usage : Encode a header and a block of data into a frame and send it.
+///			COBSEncodeStart(&strcEnc, bytOut, sizeof(bytOut), __COBS_CRC16);
+///			COBSEncodeData(&strcEnc, bytHeader, 4);
+///			COBSEncodeData(&strcEnc, bytSample, 120);
+///			strcFrame.unLength = COBSEncodeEnd(&strcEnc);		// 0 if bytOut[] is too small.
+///			strcFrame.ptrData = bytOut;
+///			UART0FrameSend(&strcFrame, __SCI_PRIORITY_LOW);
+///
+/// Example of usage : Decode the frames from the receive ring of UART0.
+///			COBSDecodeStart(&strcDec, bytFrame, sizeof(bytFrame), __COBS_CRC16);	// Once.
+///			while ((unCount = UART0RxPeek(&ptrData)) > 0)
+///			{
+///				unUsed = COBSDecode(&strcDec, ptrData, unCount);
+///				UART0RxSkip(unUsed);
+///				if (strcDec.bytReady == 1)
+///				{
+///					...										// bytFrame[0] to bytFrame[strcDec.unFrameLength-1].
+///				}
+///			}
+
+// Function name	: CRC16Update
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Update a CRC-16/CCITT-FALSE with a block of data.
+// Arguments		: unCRC = CRC of the previous data, 0xFFFF to start.
+//                    ptrData = pointer to the data.
+//                    unLength = no. of bytes.
+// Return			: The updated CRC.
+uint16_t CRC16Update(uint16_t unCRC, const uint8_t *ptrData, unsigned int unLength)
+{
+	while (unLength > 0)
+	{
+		unCRC = (uint16_t)(unCRC << 8) ^ gunCRC16Table[(unCRC >> 8) ^ *ptrData++];
+		unLength--;
+	}
+	return unCRC;
+}
+
+// Function name	: CRC32Update
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Update a CRC-32 with a block of data, without the final XOR.
+// Arguments		: unCRC = CRC of the previous data, 0xFFFFFFFF to start.
+//                    ptrData = pointer to the data.
+//                    unLength = no. of bytes.
+// Return			: The updated CRC, XOR with 0xFFFFFFFF to get the CRC-32 of the data.
+uint32_t CRC32Update(uint32_t unCRC, const uint8_t *ptrData, unsigned int unLength)
+{
+	while (unLength > 0)
+	{
+		unCRC = (unCRC >> 8) ^ gunCRC32Table[(unCRC ^ *ptrData++) & 0xFF];
+		unLength--;
+	}
+	return unCRC;
+}
+
+// Function name	: COBSPutByte
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Encode one byte.
+// Arguments		: ptrEnc = pointer to the encoder.
+//                    bytData = the byte.
+// Return			: None.
+static void COBSPutByte(COBS_ENCODER *ptrEnc, uint8_t bytData)
+{
+	if (ptrEnc->unLength >= ptrEnc->unSize)
+	{
+		ptrEnc->bytOverflow = 1;
+		return;
+	}
+	if (bytData == 0)								// End of block, the zero is implied by the code.
+	{
+		ptrEnc->ptrOut[ptrEnc->unCode] = ptrEnc->bytRun;
+		ptrEnc->unCode = ptrEnc->unLength++;		// Reserve the code byte of the next block.
+		ptrEnc->bytRun = 1;
+		return;
+	}
+	ptrEnc->ptrOut[ptrEnc->unLength++] = bytData;
+	if (++ptrEnc->bytRun == 0xFF)					// Block of 254 bytes, no zero implied.
+	{
+		if (ptrEnc->unLength >= ptrEnc->unSize)
+		{
+			ptrEnc->bytOverflow = 1;
+			return;
+		}
+		ptrEnc->ptrOut[ptrEnc->unCode] = 0xFF;
+		ptrEnc->unCode = ptrEnc->unLength++;
+		ptrEnc->bytRun = 1;
+	}
+}
+
+// Function name	: COBSEncodeStart
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Start encoding a frame.
+// Arguments		: ptrEnc = pointer to the encoder.
+//                    ptrOut = output buffer, at least __COBS_MAX(data + CRC length) bytes.
+//                    unSize = size of the output buffer.
+//                    nCRC = __COBS_CRC_NONE, __COBS_CRC16 or __COBS_CRC32.
+// Return			: None.
+void COBSEncodeStart(COBS_ENCODER *ptrEnc, uint8_t *ptrOut, unsigned int unSize, int nCRC)
+{
+	ptrEnc->ptrOut = ptrOut;
+	ptrEnc->unSize = unSize;
+	ptrEnc->unCode = 0;								// Code byte of the first block.
+	ptrEnc->unLength = 1;
+	ptrEnc->bytRun = 1;
+	ptrEnc->bytCRC = (uint8_t) nCRC;
+	ptrEnc->unCRC = (nCRC == __COBS_CRC16) ? 0xFFFF : 0xFFFFFFFF;
+	ptrEnc->bytOverflow = (unSize < 2);
+}
+
+// Function name	: COBSEncodeData
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Add data to the frame, can be called any no. of times.
+// Arguments		: ptrEnc = pointer to the encoder.
+//                    ptrData = pointer to the data.
+//                    unLength = no. of bytes.
+// Return			: None.
+void COBSEncodeData(COBS_ENCODER *ptrEnc, const uint8_t *ptrData, unsigned int unLength)
+{
+	unsigned int ni;
+
+	if (ptrEnc->bytCRC == __COBS_CRC16)
+	{
+		ptrEnc->unCRC = CRC16Update((uint16_t) ptrEnc->unCRC, ptrData, unLength);
+	}
+	else if (ptrEnc->bytCRC == __COBS_CRC32)
+	{
+		ptrEnc->unCRC = CRC32Update(ptrEnc->unCRC, ptrData, unLength);
+	}
+	for (ni = 0; ni < unLength; ni++)
+	{
+		COBSPutByte(ptrEnc, ptrData[ni]);
+	}
+}
+
+// Function name	: COBSEncodeEnd
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Add the CRC and the delimiter, and complete the frame.
+// Arguments		: ptrEnc = pointer to the encoder.
+// Return			: Length of the encoded frame including the 0x00 delimiter, 0 if the output
+//                    buffer is too small.
+unsigned int COBSEncodeEnd(COBS_ENCODER *ptrEnc)
+{
+	uint32_t unCRC = ptrEnc->unCRC;
+
+	if (ptrEnc->bytCRC == __COBS_CRC16)
+	{
+		COBSPutByte(ptrEnc, (uint8_t)(unCRC >> 8));	// MSB first, the CRC of the data and the
+		COBSPutByte(ptrEnc, (uint8_t) unCRC);		// CRC is then 0.
+	}
+	else if (ptrEnc->bytCRC == __COBS_CRC32)
+	{
+		unCRC = ~unCRC;								// LSB first.
+		COBSPutByte(ptrEnc, (uint8_t) unCRC);
+		COBSPutByte(ptrEnc, (uint8_t)(unCRC >> 8));
+		COBSPutByte(ptrEnc, (uint8_t)(unCRC >> 16));
+		COBSPutByte(ptrEnc, (uint8_t)(unCRC >> 24));
+	}
+	if ((ptrEnc->bytOverflow == 1) || (ptrEnc->unLength >= ptrEnc->unSize))
+	{
+		return 0;
+	}
+	ptrEnc->ptrOut[ptrEnc->unCode] = ptrEnc->bytRun;
+	ptrEnc->ptrOut[ptrEnc->unLength++] = 0x00;		// Delimiter.
+	return ptrEnc->unLength;
+}
+
+// Function name	: COBSDecodeStart
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Initialize a decoder.  The data up to the first delimiter are ignored,
+//                    since the decoder may start in the middle of a frame.
+// Arguments		: ptrDec = pointer to the decoder.
+//                    ptrFrame = frame buffer, for the data and the CRC.
+//                    unSize = size of the frame buffer.
+//                    nCRC = __COBS_CRC_NONE, __COBS_CRC16 or __COBS_CRC32.
+// Return			: None.
+void COBSDecodeStart(COBS_DECODER *ptrDec, uint8_t *ptrFrame, unsigned int unSize, int nCRC)
+{
+	ptrDec->ptrFrame = ptrFrame;
+	ptrDec->unSize = unSize;
+	ptrDec->unLength = 0;
+	ptrDec->unFrameLength = 0;
+	ptrDec->bytReady = 0;
+	ptrDec->bytCode = 0;
+	ptrDec->bytLeft = 0;
+	ptrDec->bytCRC = (uint8_t) nCRC;
+	ptrDec->unCRC = (nCRC == __COBS_CRC16) ? 0xFFFF : 0xFFFFFFFF;
+	ptrDec->bytDiscard = 1;
+	ptrDec->unFrameCount = 0;
+	ptrDec->unFrameError = 0;
+	ptrDec->unCRCError = 0;
+}
+
+// Function name	: COBSDecodeEnd
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Check the frame at the delimiter, and prepare for the next frame.
+// Arguments		: ptrDec = pointer to the decoder.
+// Return			: None.
+static void COBSDecodeEnd(COBS_DECODER *ptrDec)
+{
+	if (ptrDec->bytDiscard == 1)
+	{
+		ptrDec->bytDiscard = 0;
+	}
+	else if (ptrDec->bytLeft > 0)					// Block cut short.
+	{
+		ptrDec->unFrameError++;
+	}
+	else if (ptrDec->bytCode != 0)					// Ignore empty frames.
+	{
+		if (ptrDec->unLength < ptrDec->bytCRC)
+		{
+			ptrDec->unFrameError++;
+		}
+		else if (((ptrDec->bytCRC == __COBS_CRC16) && (ptrDec->unCRC != _CRC16_RESIDUE)) ||
+				 ((ptrDec->bytCRC == __COBS_CRC32) && (ptrDec->unCRC != _CRC32_RESIDUE)))
+		{
+			ptrDec->unCRCError++;
+		}
+		else
+		{
+			ptrDec->unFrameCount++;
+			ptrDec->unFrameLength = ptrDec->unLength - ptrDec->bytCRC;
+			ptrDec->bytReady = 1;
+		}
+	}
+	ptrDec->unLength = 0;
+	ptrDec->bytCode = 0;
+	ptrDec->bytLeft = 0;
+	ptrDec->unCRC = (ptrDec->bytCRC == __COBS_CRC16) ? 0xFFFF : 0xFFFFFFFF;
+}
+
+// Function name	: COBSDecode
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Decode the received bytes, up to the end of the next good frame.  When a 
+//                    frame is complete bytReady is set and unFrameLength is the length of its
+//                    data, the data are at the start of the frame buffer until the next call.
+// Arguments		: ptrDec = pointer to the decoder.
+//                    ptrData = pointer to the received bytes.
+//                    unLength = no. of bytes, any no. from 1.
+// Return			: No. of bytes used, less than unLength if a frame is complete.  The rest 
+//                    is passed again in the next call.
+unsigned int COBSDecode(COBS_DECODER *ptrDec, const uint8_t *ptrData, unsigned int unLength)
+{
+	unsigned int ni;
+	uint8_t bytData;
+	uint8_t bytOut;
+
+	ptrDec->bytReady = 0;
+	for (ni = 0; ni < unLength; ni++)
+	{
+		bytData = ptrData[ni];
+		if (bytData == 0x00)						// Delimiter.
+		{
+			COBSDecodeEnd(ptrDec);
+			if (ptrDec->bytReady == 1)
+			{
+				return ni + 1;
+			}
+			continue;
+		}
+		if (ptrDec->bytDiscard == 1)
+		{
+			continue;
+		}
+		if (ptrDec->bytLeft == 0)					// Code byte.
+		{
+			if ((ptrDec->bytCode == 0) || (ptrDec->bytCode == 0xFF))
+			{
+				ptrDec->bytCode = bytData;			// No zero before the first block or after
+				ptrDec->bytLeft = bytData - 1;		// a block of 254 bytes.
+				continue;
+			}
+			ptrDec->bytCode = bytData;
+			ptrDec->bytLeft = bytData - 1;
+			bytOut = 0x00;							// Zero implied by the previous block.
+		}
+		else
+		{
+			ptrDec->bytLeft--;
+			bytOut = bytData;
+		}
+		if (ptrDec->unLength >= ptrDec->unSize)		// Frame too long.
+		{
+			ptrDec->unFrameError++;
+			ptrDec->bytDiscard = 1;
+			continue;
+		}
+		ptrDec->ptrFrame[ptrDec->unLength++] = bytOut;
+		if (ptrDec->bytCRC == __COBS_CRC16)
+		{
+			ptrDec->unCRC = (uint16_t)(ptrDec->unCRC << 8) ^ gunCRC16Table[((ptrDec->unCRC >> 8) ^ bytOut) & 0xFF];
+		}
+		else if (ptrDec->bytCRC == __COBS_CRC32)
+		{
+			ptrDec->unCRC = (ptrDec->unCRC >> 8) ^ gunCRC32Table[(ptrDec->unCRC ^ bytOut) & 0xFF];
+		}
+	}
+	return unLength;
+}
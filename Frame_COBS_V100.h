@@ -0,0 +1,66 @@
+// Author			: Fabian Kung
+// Date				: 16 Oct 2026
+// Filename			: Frame_COBS_V100.h
+
+#ifndef _FRAME_COBS_H
+#define _FRAME_COBS_H
+
+// Include common header to all drivers and sources.  Here absolute path is used.
+// To edit if one change folder
+#include "osmain.h"
+
+//
+// --- PUBLIC CONSTANTS ---
+//
+#define __COBS_CRC_NONE		0					// No. of CRC bytes at the end of the frame.
+#define __COBS_CRC16		2					// CRC-16/CCITT-FALSE, sent MSB first.
+#define __COBS_CRC32		4					// CRC-32 (IEEE 802.3), sent LSB first.
+#define __COBS_MAX(n)		((n) + (n)/254 + 2)	// Max. encoded size of n bytes, including the
+												// CRC, with the 0x00 delimiter.
+
+//
+// --- PUBLIC DATATYPES ---
+//
+// Type cast for an encoder, the encoded frame is written straight into the output buffer.
+typedef struct StructCOBSEncoder
+{
+	uint8_t *ptrOut;					// Output buffer.
+	unsigned int unSize;				// Size of the output buffer.
+	unsigned int unLength;				// No. of bytes written to the output buffer.
+	unsigned int unCode;				// Position of the code byte of the current block.
+	uint32_t unCRC;
+	uint8_t bytRun;						// Code of the current block, 1 + no. of data bytes.
+	uint8_t bytCRC;						// __COBS_CRC_NONE, __COBS_CRC16 or __COBS_CRC32.
+	uint8_t bytOverflow;				// 1 if the output buffer is too small.
+} COBS_ENCODER;
+
+// Type cast for a decoder, the decoded frame is written straight into the frame buffer.
+typedef struct StructCOBSDecoder
+{
+	uint8_t *ptrFrame;					// Frame buffer, holds the data and the CRC.
+	unsigned int unSize;				// Size of the frame buffer.
+	unsigned int unLength;				// No. of bytes written to the frame buffer.
+	unsigned int unFrameLength;			// Length of the frame received, without the CRC.
+	uint32_t unCRC;
+	uint8_t bytCode;					// Code of the current block, 0 before the first block.
+	uint8_t bytLeft;					// Data bytes left in the current block.
+	uint8_t bytCRC;						// __COBS_CRC_NONE, __COBS_CRC16 or __COBS_CRC32.
+	uint8_t bytDiscard;					// 1 to ignore the data up to the next delimiter.
+	uint8_t bytReady;					// 1 when a good frame is in the frame buffer.
+	unsigned int unFrameCount;			// No. of frames received.
+	unsigned int unFrameError;			// No. of frames with a coding error or too long.
+	unsigned int unCRCError;			// No. of frames with a wrong CRC.
+} COBS_DECODER;
+
+//
+// --- PUBLIC FUNCTION PROTOTYPE ---
+//
+uint16_t CRC16Update(uint16_t, const uint8_t *, unsigned int);
+uint32_t CRC32Update(uint32_t, const uint8_t *, unsigned int);
+void COBSEncodeStart(COBS_ENCODER *, uint8_t *, unsigned int, int);
+void COBSEncodeData(COBS_ENCODER *, const uint8_t *, unsigned int);
+unsigned int COBSEncodeEnd(COBS_ENCODER *);
+void COBSDecodeStart(COBS_DECODER *, uint8_t *, unsigned int, int);
+unsigned int COBSDecode(COBS_DECODER *, const uint8_t *, unsigned int);
+
+#endif
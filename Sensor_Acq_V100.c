@@ -0,0 +1,313 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	USER ROUTINES DECLARATION (PROCESSOR INDEPENDENT)
+//
+//  (c) Copyright 2026, Fabian Kung Wai Lee, Selangor, MALAYSIA
+//  All Rights Reserved
+//
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File				: Sensor_Acq_V100.c
+// Author(s)		: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Toolsuites		: Atmel Studio 7.0 or later
+//					  GCC C-Compiler
+#include "osmain.h"
+#include "Sensor_Acq_V100.h"
+
+
+// NOTE: Public function prototypes are declared in the corresponding *.h file.
+
+
+//
+// --- PUBLIC VARIABLES ---
+//
+SENSOR_ENTRY gstrcSensor[__SENSOR_MAX_ENTRY];	// The sensors, see SensorAdd().
+int         gnSensorTask;               // Handle of the engine task.
+
+static int SensorQueue(SENSOR_ENTRY *);
+static void SensorDone(I2C_TRANSACTION *, int);
+
+///
+/// Function name	: Proce_Sensor_Engine
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Code Version	: 1.00
+///
+/// Processor		: ARM Cortex-M4 family
+///
+/// Processor/System Resource
+/// PINS		: None.
+///
+/// MODULES		: The I2C ports of the sensors, see "Driver_I2C_V100.c".
+///
+/// RTOS		: Ver 1 or above, round-robin scheduling.
+///
+/// Global Variables    : gstrcSensor[], gnSensorTask.
+
+#ifdef __OS_VER			// Check RTOS version compatibility.
+	#if __OS_VER < 1
+		#error "Proce_Sensor_Engine: Incompatible OS version"
+	#endif
+#else
+	#error "Proce_Sensor_Engine: An RTOS is required with this function"
+#endif
+
+///
+/// Description	:
+/// Periodic acquisition of the sensors on the I2C buses.  Each sensor is a block of up to
+/// __MAX_I2C_DATA_BYTE consecutive registers of a Slave, read every unPeriod system ticks,
+/// registered once with SensorAdd().  The engine task puts the read of each sensor due into the
+/// transaction queue of its bus, the I2C driver then runs the reads back-to-back, so the bus
+/// is only idle when no sensor is due.  The engine task sleeps until the next sensor is due.
+///
+/// The data are read by the PDC straight into the back slot of the sensor, and the two slots
+/// are swapped by SensorDone() once the read ends, with the system tick of the end of the read
+/// and the sample number.  A consumer thus always gets a complete sample without locking, as
+/// the slot it reads is only written again by the read after next, i.e. one period later.
+/// The reads are kept on the grid of the period.  When a read cannot start before its next one
+/// is due, e.g. the bus is overloaded, the reads missed are counted in unOverrun.  A read not
+/// acknowledged or aborted on timeout is counted in unError and the previous sample is kept.
+///
+/// Example of usage : Read an IMU (14 bytes from register 0x3B) at 1 kHz on TWI1, and a
+/// pressure sensor (3 bytes from register 0xF7) at 100 Hz on TWI0.
+///			OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_Sensor_Engine);	// In main().
+///			nIMU = SensorAdd(&gstrcI2C1, 0x68, 0x3B, 14, __NUM_SYSTEMTICK_MSEC);
+///			nBaro = SensorAdd(&gstrcI2C0, 0x76, 0xF7, 3, 10*__NUM_SYSTEMTICK_MSEC);
+///
+///			ptrSample = SensorSample(nIMU);					// In the consumer task.
+///			if (ptrSample->unSeq != unLastSeq)				// New sample.
+///			{
+///				unLastSeq = ptrSample->unSeq;
+///				nAccelX = (int16_t)((ptrSample->bytData[0] << 8) | ptrSample->bytData[1]);
+///				...
+///			}
+///
+void Proce_Sensor_Engine(TASK_ATTRIBUTE *ptrTask)
+{
+	SENSOR_ENTRY *ptrEntry;
+	int nIndex;
+	int nLeft;
+	int nWait = 0;
+
+	switch (ptrTask->nState)
+	{
+		case 0: // State 0 - Initialization.
+			gnSensorTask = ptrTask->nID;
+			OSSetTaskContext(ptrTask, 1, 1);		// Next state = 1, timer = 1.
+			break;
+
+		case 1: // State 1 - Queue the sensors due, then sleep until the next one is due.
+			OSGetEvent(ptrTask, __SENSOR_EVENT_DUE);
+			for (nIndex = 0; nIndex < __SENSOR_MAX_ENTRY; nIndex++)
+			{
+				ptrEntry = &gstrcSensor[nIndex];
+				if (ptrEntry->ptrPort == 0)
+				{
+					continue;
+				}
+				nLeft = (int)(ptrEntry->unNext - gunClockTick);
+				if (ptrEntry->bytPending == 1)		// SensorDone() signals the task if the
+				{									// read ends late.
+					nLeft = (nLeft > 1) ? nLeft : 1;
+				}
+				else if (nLeft <= 0)
+				{
+					if (SensorQueue(ptrEntry) == 1)
+					{
+						nLeft = 1;					// I2C queue full, try again on the next tick.
+					}
+					else
+					{
+						nLeft = (int)(ptrEntry->unNext - gunClockTick);
+					}
+				}
+				if ((nWait == 0) || (nLeft < nWait))
+				{
+					nWait = nLeft;
+				}
+			}
+			OSWaitEvent(ptrTask, 1, __SENSOR_EVENT_DUE, nWait);	// No sensor: wait for SensorAdd().
+			break;
+
+		default:
+			OSSetTaskContext(ptrTask, 0, 1);		// Back to state = 0, timer = 1.
+			break;
+	}
+}
+
+// Function name	: SensorQueue
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Put the read of a sensor into the queue of its bus, the data go into the
+//                    back slot.  The next read is due one period later, or on the next period
+//                    not yet started if the read is late by more than a period.
+// Arguments		: ptrEntry = the sensor.
+// Return			: 0 if success, 1 if the queue is full.
+static int SensorQueue(SENSOR_ENTRY *ptrEntry)
+{
+	I2C_TRANSACTION strcTrans = {0};
+	unsigned int unLate;
+
+	strcTrans.bytSlaveAdd = ptrEntry->bytSlaveAdd;
+	strcTrans.bytRegAdd = ptrEntry->bytRegAdd;
+	strcTrans.bytReadCount = ptrEntry->bytCount;
+	strcTrans.ptrbytRead = ptrEntry->strcSlot[1 - ptrEntry->bytFront].bytData;
+	strcTrans.fptrDone = SensorDone;
+	strcTrans.ptrArg = ptrEntry;
+	if (I2CPutTransaction(ptrEntry->ptrPort, &strcTrans) == 1)
+	{
+		return 1;
+	}
+	ptrEntry->bytPending = 1;
+	ptrEntry->unNext += ptrEntry->unPeriod;
+	unLate = gunClockTick - ptrEntry->unNext;
+	if ((int) unLate >= 0)
+	{
+		unLate = unLate / ptrEntry->unPeriod + 1;	// No. of periods skipped.
+		ptrEntry->unOverrun += unLate;
+		ptrEntry->unNext += unLate * ptrEntry->unPeriod;
+	}
+	return 0;
+}
+
+// Function name	: SensorDone
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Called by the I2C driver task at the end of the read of a sensor.  The
+//                    slots are swapped if there is no error, the engine task is woken up if
+//                    the next read is already due.
+// Arguments		: ptrTrans = the transaction, ptrArg is the sensor.
+//                    nError = 1 if the read failed.
+// Return			: None.
+static void SensorDone(I2C_TRANSACTION *ptrTrans, int nError)
+{
+	SENSOR_ENTRY *ptrEntry = (SENSOR_ENTRY *) ptrTrans->ptrArg;
+	uint8_t bytBack = 1 - ptrEntry->bytFront;
+
+	ptrEntry->bytPending = 0;
+	if (nError == 1)
+	{
+		ptrEntry->unError++;
+	}
+	else
+	{
+		ptrEntry->strcSlot[bytBack].unTick = gunClockTick;
+		ptrEntry->strcSlot[bytBack].unSeq = ptrEntry->strcSlot[ptrEntry->bytFront].unSeq + 1;
+		ptrEntry->bytFront = bytBack;
+	}
+	if ((int)(gunClockTick - ptrEntry->unNext) >= 0)
+	{
+		OSSignalEvent(gnSensorTask, __SENSOR_EVENT_DUE);
+	}
+}
+
+///
+/// Function name	: SensorAdd
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Register a sensor, the first read is due at once.  The driver task of the
+///                   bus and Proce_Sensor_Engine() must be created.
+///
+/// Arguments		: ptrPort = the bus, e.g. &gstrcI2C0.
+///                   bytSlaveAdd = Slave address (7 bit).
+///                   bytRegAdd = first register of the block.
+///                   bytCount = no. of registers, 1 to __MAX_I2C_DATA_BYTE.
+///                   unPeriod = period in system ticks, e.g. __NUM_SYSTEMTICK_MSEC for 1 kHz.
+///
+/// Return			: Handle of the sensor, -1 if the arguments are wrong or all the
+///                   __SENSOR_MAX_ENTRY sensors are used.
+///
+int SensorAdd(I2C_PORT *ptrPort, uint8_t bytSlaveAdd, uint8_t bytRegAdd, uint8_t bytCount, unsigned int unPeriod)
+{
+	SENSOR_ENTRY *ptrEntry;
+	int nIndex;
+
+	if ((ptrPort == 0) || (bytCount == 0) || (bytCount > __MAX_I2C_DATA_BYTE) || (unPeriod == 0))
+	{
+		return -1;
+	}
+	for (nIndex = 0; nIndex < __SENSOR_MAX_ENTRY; nIndex++)
+	{
+		ptrEntry = &gstrcSensor[nIndex];
+		if (ptrEntry->ptrPort == 0)
+		{
+			ptrEntry->bytSlaveAdd = bytSlaveAdd;
+			ptrEntry->bytRegAdd = bytRegAdd;
+			ptrEntry->bytCount = bytCount;
+			ptrEntry->bytFront = 0;
+			ptrEntry->bytPending = 0;
+			ptrEntry->unPeriod = unPeriod;
+			ptrEntry->unNext = gunClockTick;
+			ptrEntry->unError = 0;
+			ptrEntry->unOverrun = 0;
+			ptrEntry->strcSlot[0].unSeq = 0;
+			ptrEntry->strcSlot[1].unSeq = 0;
+			ptrEntry->ptrPort = ptrPort;		// Entry in use.
+			if (gnSensorTask != 0)
+			{
+				OSSignalEvent(gnSensorTask, __SENSOR_EVENT_DUE);
+			}
+			return nIndex;
+		}
+	}
+	return -1;
+}
+
+///
+/// Function name	: SensorSample
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Latest sample of a sensor, without copy.  The sample is not changed until
+///                   the read after next ends, so it can be used until the task returns.
+///
+/// Arguments		: nSensor = handle given by SensorAdd().
+///
+/// Return			: Pointer to the sample, unSeq is 0 before the first sample.
+///
+const SENSOR_SAMPLE *SensorSample(int nSensor)
+{
+	SENSOR_ENTRY *ptrEntry = &gstrcSensor[nSensor];
+
+	return &ptrEntry->strcSlot[ptrEntry->bytFront];
+}
+
+///
+/// Function name	: SensorRead
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Copy the latest sample of a sensor.
+///
+/// Arguments		: nSensor = handle given by SensorAdd().
+///                   ptrData = buffer for bytCount bytes of the sensor.
+///                   ptrTick = gunClockTick at the end of the read, 0 if not needed.
+///
+/// Return			: No. of the sample, 0 if none yet.
+///
+unsigned int SensorRead(int nSensor, uint8_t *ptrData, unsigned int *ptrTick)
+{
+	const SENSOR_SAMPLE *ptrSample = SensorSample(nSensor);
+	int ni;
+
+	for (ni = 0; ni < gstrcSensor[nSensor].bytCount; ni++)
+	{
+		ptrData[ni] = ptrSample->bytData[ni];
+	}
+	if (ptrTick != 0)
+	{
+		*ptrTick = ptrSample->unTick;
+	}
+	return ptrSample->unSeq;
+}
@@ -0,0 +1,59 @@
+// Author			: Fabian Kung
+// Date				: 16 Oct 2026
+// Filename			: Sensor_Acq_V100.h
+
+#ifndef _SENSOR_ACQ_H
+#define _SENSOR_ACQ_H
+
+// Include common header to all drivers and sources.  Here absolute path is used.
+// To edit if one change folder
+#include "osmain.h"
+#include "Driver_I2C_V100.h"
+
+//
+// --- PUBLIC CONSTANTS ---
+//
+#define __SENSOR_MAX_ENTRY		8				// Max. no. of sensors.
+#define __SENSOR_EVENT_DUE		0x00000001		// Event flag of the engine task, new sensor or a
+												// sensor is due.
+
+//
+// --- PUBLIC DATATYPES ---
+//
+// Type cast for a sample of a sensor.
+typedef struct StructSensorSample
+{
+	unsigned int unTick;				// gunClockTick at the end of the read.
+	unsigned int unSeq;					// No. of the sample, from 1.
+	uint8_t bytData[__MAX_I2C_DATA_BYTE];
+} SENSOR_SAMPLE;
+
+// Type cast for a sensor, a block of registers read periodically.  The read goes into the back
+// slot, the slots are swapped once it ends without error.
+typedef struct StructSensorEntry
+{
+	I2C_PORT *ptrPort;					// Bus, 0 if the entry is free.
+	uint8_t bytSlaveAdd;				// Slave address (7 bit, from bit0-bit6).
+	uint8_t bytRegAdd;					// First register of the block.
+	uint8_t bytCount;					// No. of registers, max. __MAX_I2C_DATA_BYTE.
+	volatile uint8_t bytFront;			// Slot holding the latest sample, 0 or 1.
+	uint8_t bytPending;					// 1 while the read is in the I2C queue.
+	unsigned int unPeriod;				// In system ticks.
+	unsigned int unNext;				// gunClockTick when the next read is due.
+	unsigned int unError;				// No. of reads not acknowledged or aborted on timeout.
+	unsigned int unOverrun;				// No. of reads skipped, more than a period late.
+	SENSOR_SAMPLE strcSlot[2];
+} SENSOR_ENTRY;
+
+extern  SENSOR_ENTRY gstrcSensor[__SENSOR_MAX_ENTRY];
+extern  int         gnSensorTask;               // Handle of the engine task.
+
+//
+// --- PUBLIC FUNCTION PROTOTYPE ---
+//
+void Proce_Sensor_Engine(TASK_ATTRIBUTE *);
+int SensorAdd(I2C_PORT *, uint8_t, uint8_t, uint8_t, unsigned int);
+const SENSOR_SAMPLE *SensorSample(int);
+unsigned int SensorRead(int, uint8_t *, unsigned int *);
+
+#endif
@@ -7,12 +7,13 @@
 //   
 //////////////////////////////////////////////////////////////////////////////////////////////
 //
-// File				: Drivers_UART_V100.c
+// File				: Driver_DACC_V100.c
 // Author(s)		: Fabian Kung
-// Last modified	: 29 March 2017
+// Last modified	: 16 Oct 2026
 // Toolsuites		: Atmel Studio 7.0 or later
 //					  GCC C-Compiler
 #include "osmain.h"
+#include "driver_dacc_v100.h"
 
 
 // NOTE: Public function prototypes are declared in the corresponding *.h file.
@@ -23,15 +24,25 @@
 //
 unsigned int gunDAC_OutA;
 unsigned int gunDAC_OutB;
+DACC_STREAM gstrcDACCStream;			// Waveform output, see DACCStreamStart().
+OS_CLOCK_CLIENT gstrcDACCClock = {DACCClockChange, 0};	// Notification of master clock change.
 
 //
 // --- PRIVATE VARIABLES ---
 //
+unsigned int gunDACLastA = 0xFFFFFFFF;	// Values written to the DACC, see Proce_DACC_Driver().
+unsigned int gunDACLastB = 0xFFFFFFFF;
 
 
 //
 // --- Process Level Constants Definition --- 
 //
+#define	_DACC_TRGSEL_TC1	2			// Trigger = TIOA output of TC0 channel 1.
+#define	_DACC_INT_STREAM	(DACC_IDR_ENDTX | DACC_IDR_TXBUFE)
+
+static uint32_t DACCStartup(unsigned int);
+static unsigned int DACCTimer(unsigned int, unsigned int, int);
+static unsigned int DACCRefill(int);
 
 
 
@@ -40,20 +51,22 @@ unsigned int gunDAC_OutB;
 ///
 /// Author			: Fabian Kung
 ///
-/// Last modified	: 29 March 2017
+/// Last modified	: 16 Oct 2026
 ///
 /// Code version	: 1.00
 ///
 /// Processor		: ARM Cortex-M4 family                   
 ///
 /// Processor/System Resource 
-/// PINS		: 1. Pin PB14 = DAC1, peripheral B, output.
+/// PINS		: 1. Pin PB14 = DAC1, extra function, output.
+///               2. Pin PB13 = DAC0, extra function, output, see __DACC_CHANNEL_ENABLE.
 ///
-/// MODULES		: 1. DACC (Internal).
+/// MODULES		: 1. DACC (Internal), with interrupt and PDC.
+///               2. TC0 channel 1 (Internal), trigger of the conversions.
 ///
 /// RTOS		: Ver 1 or above, round-robin scheduling.
 ///
-/// Global variable	: 
+/// Global variable	: gunDAC_OutA, gunDAC_OutB, gstrcDACCStream.
 ///
 
 #ifdef 				  __OS_VER		// Check RTOS version compatibility.
@@ -70,6 +83,43 @@ unsigned int gunDAC_OutB;
 /// This module temporary cannot be used as the max clock allowable is 50 MHz.  Here we are
 /// using 120 MHz and the observation is the the DACC output the wrong value.  It cannot go
 /// down to 0V output.
+///
+/// Note: 16 Oct 2026, the DACC registers were written before its peripheral clock was enabled,
+/// so the writes were ignored.  The peripheral clock is now enabled first.  The output range of
+/// the SAM4S DACC is 1/6 to 5/6 of VADVREF, so code 0 never gives 0V.  The DACC has no clock
+/// divider, the DACC clock is MCK/2, i.e. 60 MHz at 120 MHz, above the 50 MHz of the
+/// datasheet.  The start-up time (STARTUP) is computed from the master clock, and the bias
+/// currents are set to the maximum in DACC_ACR, for a conversion every 25 DACC clocks.  A
+/// master clock of 100 MHz or below, see OSSetClock(), keeps the DACC within its rating.
+///
+/// Note: 16 Oct 2026, when no waveform is output the driver writes gunDAC_OutA to channel 0 and
+/// gunDAC_OutB to channel 1 every system tick, if they are changed and the channel is enabled
+/// in __DACC_CHANNEL_ENABLE.  The channel is given by the tag of DACC_CDR.
+///
+/// Note: 16 Oct 2026, DACCStreamStart() outputs a waveform at a given rate on one channel.  The
+/// conversions are triggered by the TIOA output of TC0 channel 1, and the samples are moved to
+/// DACC_CDR by the PDC from two buffers in turn.  Once a buffer is converted DACC_Handler()
+/// calls the refill routine with it, then gives it back to the PDC as the next buffer, so the
+/// CPU only works once per buffer.  With __DACC_STREAM_BOTH the samples carry the channel in
+/// bits 12-13 (tag), so DAC0 and DAC1 share the rate, e.g. interleaved samples give each
+/// channel half the rate.  The refill routine is called in the interrupt, it has the
+/// time to convert a whole buffer to return.  If the PDC runs out of samples, the last one is
+/// held and unUnderrun is counted.  The rate is kept when the master clock is changed.
+///
+/// Example of usage : 1 kHz sine wave at 500 ksps on DAC1.
+///			unsigned int SineRefill(uint16_t *ptrBuf, unsigned int unLength, void *ptrArg)
+///			{
+///				for (ni = 0; ni < unLength; ni++)		// Called by DACC_Handler().
+///				{
+///					ptrBuf[ni] = gunSine[gunPhase];		// 500 samples per period.
+///					gunPhase = (gunPhase == 499) ? 0 : gunPhase + 1;
+///				}
+///				return unLength;
+///			}
+///
+///			SineRefill(gunBuf0, 256, 0);				// Both buffers filled before the start.
+///			SineRefill(gunBuf1, 256, 0);
+///			DACCStreamStart(1, 500000, gunBuf0, gunBuf1, 256, SineRefill, 0);
 
 void Proce_DACC_Driver(TASK_ATTRIBUTE *ptrTask)
 {
@@ -79,43 +129,366 @@ void Proce_DACC_Driver(TASK_ATTRIBUTE *ptrTask)
 		switch (ptrTask->nState)
 		{
 			case 0: // State 0 - Initialization.
-				//PIOB->PIO_PDR = (PIOB->PIO_PDR) | PIO_PDR_P14;	// Set PB14 to be controlled by Peripheral.
-
-				DACC->DACC_CHER |= DACC_CHER_CH1;		// Enable DAC channel 1.
-				DACC->DACC_MR |= DACC_MR_ONE | DACC_MR_USER_SEL_CHANNEL1;	// Select DAC Channel 1.
+				// The DAC outputs are selected by DACC_CHER, not by the PIO.
 				PMC->PMC_PCER0 |= PMC_PCER0_PID30;		// Enable peripheral clock to DACC (ID30)
+				DACC->DACC_CR = DACC_CR_SWRST;
+				DACC->DACC_MR = DACC_MR_ONE | DACC_MR_WORD_HALF | DACC_MR_TAG_EN | DACCStartup(gunMCKHz);
+														// Free running, channel given by the tag.
+				DACC->DACC_ACR = DACC_ACR_IBCTLCH0(2) | DACC_ACR_IBCTLCH1(2) | DACC_ACR_IBCTLDACCORE(1);
+				DACC->DACC_IDR = 0xFFFFFFFF;
+				DACC->DACC_CHER = __DACC_CHANNEL_ENABLE;	// Enable DAC channels.
+				gstrcDACCStream.bytActive = 0;
+				gunDACLastA = 0xFFFFFFFF;
+				gunDACLastB = 0xFFFFFFFF;
+				OSClockRegister(&gstrcDACCClock);
+				NVIC_ClearPendingIRQ(DACC_IRQn);
+				NVIC_EnableIRQ(DACC_IRQn);
 				OSSetTaskContext(ptrTask, 1, 100);		// Next state = 1, timer = 100.
 			break;
 			
-			case 1: // State 1 - See if DACC is ready to accept new data for conversion.
-				if ((DACC->DACC_ISR & DACC_ISR_TXRDY) > 0)		// If DACC is ready to accept new conversion request.
+			case 1: // State 1 - Write the changed outputs once the DACC is ready to accept new data.
+				if (gstrcDACCStream.bytActive == 0)
 				{
-					DACC->DACC_CDR = 0x0000;
+					if ((__DACC_CHANNEL_ENABLE & DACC_CHER_CH0) && (gunDAC_OutA != gunDACLastA) &&
+						((DACC->DACC_ISR & DACC_ISR_TXRDY) > 0))
+					{
+						gunDACLastA = gunDAC_OutA;
+						DACC->DACC_CDR = gunDAC_OutA & 0x0FFF;				// Tag 0.
+					}
+					if ((__DACC_CHANNEL_ENABLE & DACC_CHER_CH1) && (gunDAC_OutB != gunDACLastB) &&
+						((DACC->DACC_ISR & DACC_ISR_TXRDY) > 0))
+					{
+						gunDACLastB = gunDAC_OutB;
+						DACC->DACC_CDR = (gunDAC_OutB & 0x0FFF) | (1 << 12);	// Tag 1.
+					}
 				}
-				OSSetTaskContext(ptrTask, 2, 1); // Next state = 2, timer = 1.
+				OSSetTaskContext(ptrTask, 1, 1); // Next state = 1, timer = 1.
 			break;
 
-			case 2: // State 2 - See if DACC is ready to accept new data for conversion.
-			if ((DACC->DACC_ISR & DACC_ISR_TXRDY) > 0)		// If DACC is ready to accept new conversion request.
-			{
-				DACC->DACC_CDR = 0x02FF;
-			}
-			OSSetTaskContext(ptrTask, 3, 1); // Next state = 3, timer = 1.
+			default:
+				OSSetTaskContext(ptrTask, 0, 1); // Back to state = 0, timer = 1.
 			break;
+		}
+	}
+}
 
-			case 3: // State 3 - See if DACC is ready to accept new data for conversion.
-			if ((DACC->DACC_ISR & DACC_ISR_TXRDY) > 0)		// If DACC is ready to accept new conversion request.
-			{
-				DACC->DACC_CDR = 0x0FFF;
-			}
-			OSSetTaskContext(ptrTask, 1, 1); // Next state = 2, timer = 1.
-			break;
+// Function name	: DACCStartup
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: STARTUP field of DACC_MR for __DACC_STARTUP_US, the DACC clock being MCK/2.
+//                    The start-up time is 0, 8, 16, 24, 64, 80, 96, 112 DACC clocks, then
+//                    512 + 64 x (STARTUP - 8) DACC clocks.
+// Arguments		: unMCKHz = master clock frequency in Hz.
+// Return			: The STARTUP field.
+static uint32_t DACCStartup(unsigned int unMCKHz)
+{
+	unsigned int unClocks = (unMCKHz / 2000) * __DACC_STARTUP_US / 1000;
+	unsigned int unStartup = 0;
+	unsigned int unPeriod = 0;
 
-			default:
-				OSSetTaskContext(ptrTask, 0, 1); // Back to state = 0, timer = 1.
+	while ((unPeriod < unClocks) && (unStartup < 63))
+	{
+		unStartup++;
+		unPeriod = (unStartup < 4) ? 8 * unStartup : ((unStartup < 8) ? 64 + 16 * (unStartup - 4) :
+				   512 + 64 * (unStartup - 8));
+	}
+	return DACC_MR_STARTUP(unStartup);
+}
+
+// Function name	: DACCTimer
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Set TC0 channel 1 to trigger the DACC at a rate.  The counter counts from
+//                    0 to RC, TIOA is set on RA and cleared on RC, the rising edge of TIOA
+//                    triggering a conversion.  The fastest clock with RC below 65536 is used.
+// Arguments		: unMCKHz = master clock frequency in Hz.
+//                    unRateHz = conversion rate.
+//                    bSet = 0 to compute the rate only, without writing the timer.
+// Return			: The rate generated, 0 if the rate is too high.
+static unsigned int DACCTimer(unsigned int unMCKHz, unsigned int unRateHz, int bSet)
+{
+	static const unsigned int unDiv[4] = {2, 8, 32, 128};	// TIMER_CLOCK1 to TIMER_CLOCK4.
+	unsigned int unClock = 0;
+	unsigned int unCount = 0;
+
+	while (unClock < 4)
+	{
+		unCount = (unMCKHz / unDiv[unClock] + unRateHz / 2) / unRateHz;
+		if (unCount <= 65536)
+		{
 			break;
 		}
+		unClock++;
+	}
+	if ((unClock == 4) || (unCount < 3))
+	{
+		return 0;
+	}
+	if (bSet == 0)
+	{
+		return unMCKHz / unDiv[unClock] / unCount;
+	}
+	TC0->TC_CHANNEL[1].TC_CMR = (TC_CMR_TCCLKS_TIMER_CLOCK1 + unClock) | TC_CMR_WAVE | TC_CMR_WAVSEL_UP_RC |
+								TC_CMR_ACPA_SET | TC_CMR_ACPC_CLEAR;
+	TC0->TC_CHANNEL[1].TC_RC = unCount - 1;
+	TC0->TC_CHANNEL[1].TC_RA = unCount / 2;
+	return unMCKHz / unDiv[unClock] / unCount;
+}
+
+// Function name	: DACCRefill
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Refill a buffer of the waveform, bytLast is set once the refill routine
+//                    returns 0.
+// Arguments		: nBuf = buffer, 0 or 1.
+// Return			: No. of samples in the buffer, 0 if none.
+static unsigned int DACCRefill(int nBuf)
+{
+	DACC_STREAM *ptrStream = &gstrcDACCStream;
+	unsigned int unCount;
+
+	if (ptrStream->bytLast == 1)
+	{
+		return 0;
+	}
+	unCount = ptrStream->fptrRefill(ptrStream->ptrBuf[nBuf], ptrStream->unLength, ptrStream->ptrArg);
+	if (unCount > ptrStream->unLength)
+	{
+		unCount = ptrStream->unLength;
+	}
+	if (unCount == 0)
+	{
+		ptrStream->bytLast = 1;
 	}
+	else
+	{
+		ptrStream->unRefill++;
+	}
+	return unCount;
 }
 
+///
+/// Function name	: DACCStreamStart
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Output a waveform on a DAC channel, see Proce_DACC_Driver().  The two
+///                   buffers must be filled before the start, buffer 0 is converted first.
+///                   The waveform stops once the refill routine returns 0 and the buffers are
+///                   converted, or with DACCStreamStop().  Proce_DACC_Driver() must be
+///                   initialized.
+///
+/// Arguments		: nChannel = 0 (DAC0), 1 (DAC1) or __DACC_STREAM_BOTH, enabled in
+///                   __DACC_CHANNEL_ENABLE.
+///                   unRateHz = conversion rate, max. __DACC_MAX_RATE_HZ.
+///                   ptrBuf0, ptrBuf1 = buffers of 12 bits samples, max. 65535 each.  With
+///                   __DACC_STREAM_BOTH the channel of each sample is in bits 12-13.
+///                   unLength = no. of samples of each buffer.
+///                   fptrRefill = routine refilling a buffer, called by DACC_Handler() with the
+///                   buffer, unLength and ptrArg.  It returns the no. of samples written, 0 to
+///                   stop the waveform.
+///                   ptrArg = argument of fptrRefill.
+///
+/// Return			: 0 if success, 1 if an argument is wrong.
+///
+int DACCStreamStart(int nChannel, unsigned int unRateHz, uint16_t *ptrBuf0, uint16_t *ptrBuf1, unsigned int unLength,
+					unsigned int (*fptrRefill)(uint16_t *, unsigned int, void *), void *ptrArg)
+{
+	DACC_STREAM *ptrStream = &gstrcDACCStream;
+	uint32_t unChannel = (nChannel == __DACC_STREAM_BOTH) ? (DACC_CHER_CH0 | DACC_CHER_CH1) : (1u << (nChannel & 1));
+
+	if ((nChannel < 0) || (nChannel > __DACC_STREAM_BOTH) || ((__DACC_CHANNEL_ENABLE & unChannel) != unChannel) ||
+		(unRateHz == 0) || (unRateHz > __DACC_MAX_RATE_HZ) || (unLength == 0) || (unLength > 65535) ||
+		(fptrRefill == 0))
+	{
+		return 1;
+	}
+	DACCStreamStop();
+	ptrStream->ptrBuf[0] = ptrBuf0;
+	ptrStream->ptrBuf[1] = ptrBuf1;
+	ptrStream->unLength = unLength;
+	ptrStream->fptrRefill = fptrRefill;
+	ptrStream->ptrArg = ptrArg;
+	ptrStream->unRateHz = unRateHz;
+	ptrStream->bytChannel = nChannel;
+	ptrStream->bytNext = 1;
+	ptrStream->bytLast = 0;
+	ptrStream->unRefill = 0;
+	ptrStream->unUnderrun = 0;
+
+	PMC->PMC_PCER0 |= PMC_PCER0_PID24;		// Enable peripheral clock to TC0 channel 1 (ID24).
+	TC0->TC_CHANNEL[1].TC_CCR = TC_CCR_CLKDIS;
+	TC0->TC_CHANNEL[1].TC_IDR = 0xFFFFFFFF;
+	ptrStream->unActualHz = DACCTimer(gunMCKHz, unRateHz, 1);
+	if (ptrStream->unActualHz == 0)
+	{
+		return 1;
+	}
+	DACC->DACC_MR = DACC_MR_ONE | DACC_MR_WORD_HALF | DACCStartup(gunMCKHz) | DACC_MR_TRGEN_EN |
+					DACC_MR_TRGSEL(_DACC_TRGSEL_TC1) | ((nChannel == __DACC_STREAM_BOTH) ? DACC_MR_TAG_EN :
+					((nChannel == 1) ? DACC_MR_USER_SEL_CHANNEL1 : DACC_MR_USER_SEL_CHANNEL0));
+	PDC_DACC->PERIPH_TPR = (uint32_t)(uintptr_t) ptrBuf0;
+	PDC_DACC->PERIPH_TCR = unLength;
+	PDC_DACC->PERIPH_TNPR = (uint32_t)(uintptr_t) ptrBuf1;
+	PDC_DACC->PERIPH_TNCR = unLength;
+	ptrStream->bytActive = 1;
+	DACC->DACC_IER = _DACC_INT_STREAM;
+	PDC_DACC->PERIPH_PTCR = PERIPH_PTCR_TXTEN;
+	TC0->TC_CHANNEL[1].TC_CCR = TC_CCR_CLKEN | TC_CCR_SWTRG;	// Start the conversions.
+	return 0;
+}
 
+///
+/// Function name	: DACCStreamRate
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Conversion rate DACCStreamStart() would generate at the current master
+///                   clock, e.g. to compute the samples before the start.
+///
+/// Arguments		: unRateHz = conversion rate requested.
+///
+/// Return			: The rate generated, 0 if not possible.
+///
+unsigned int DACCStreamRate(unsigned int unRateHz)
+{
+	if ((unRateHz == 0) || (unRateHz > __DACC_MAX_RATE_HZ))
+	{
+		return 0;
+	}
+	return DACCTimer(gunMCKHz, unRateHz, 0);
+}
+
+///
+/// Function name	: DACCStreamStop
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Stop the waveform, the output keeps the last sample.  Then the driver
+///                   writes gunDAC_OutA and gunDAC_OutB again.
+///
+/// Arguments		: None.
+///
+/// Return			: None.
+///
+void DACCStreamStop(void)
+{
+	TC0->TC_CHANNEL[1].TC_CCR = TC_CCR_CLKDIS;
+	DACC->DACC_IDR = _DACC_INT_STREAM;
+	PDC_DACC->PERIPH_PTCR = PERIPH_PTCR_TXTDIS;
+	if (gstrcDACCStream.bytActive == 1)
+	{
+		DACC->DACC_MR = DACC_MR_ONE | DACC_MR_WORD_HALF | DACC_MR_TAG_EN | DACCStartup(gunMCKHz);
+		gunDACLastA = 0xFFFFFFFF;			// Write both outputs again.
+		gunDACLastB = 0xFFFFFFFF;
+	}
+	gstrcDACCStream.bytActive = 0;
+}
+
+///
+/// Function name	: DACCClockChange
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: Called by OSSetClock(), the divisor of the trigger timer is recomputed
+///                   after the master clock is changed.  A clock too slow for the rate of the
+///                   waveform is refused.
+///
+/// Arguments		: unMCKHz = new master clock frequency in Hz.
+///                   nPhase = __OS_CLOCK_CHECK, __OS_CLOCK_PRE or __OS_CLOCK_POST.
+///
+/// Return			: 1 to refuse the new clock, 0 otherwise.
+///
+int DACCClockChange(unsigned int unMCKHz, int nPhase)
+{
+	DACC_STREAM *ptrStream = &gstrcDACCStream;
+
+	if (ptrStream->bytActive == 0)
+	{
+		return 0;
+	}
+	if ((nPhase == __OS_CLOCK_CHECK) && ((unMCKHz / 2 + ptrStream->unRateHz / 2) / ptrStream->unRateHz < 3))
+	{
+		return 1;
+	}
+	if (nPhase == __OS_CLOCK_POST)
+	{
+		ptrStream->unActualHz = DACCTimer(unMCKHz, ptrStream->unRateHz, 1);
+		TC0->TC_CHANNEL[1].TC_CCR = TC_CCR_SWTRG;		// Restart the period with the new divisor.
+	}
+	return 0;
+}
+
+///
+/// Function name	: DACC_Handler
+///
+/// Author			: Fabian Kung
+///
+/// Last modified	: 16 Oct 2026
+///
+/// Description		: DACC interrupt service routine.  On ENDTX the PDC has moved to the next
+///                   buffer, the buffer converted is refilled and given back as the next one.
+///                   On TXBUFE the PDC has no sample left: at the end of the waveform, or when
+///                   this routine was too late, then both buffers are refilled.
+///
+/// Arguments		: None.
+///
+/// Return			: None.
+///
+void DACC_Handler(void)
+{
+	DACC_STREAM *ptrStream = &gstrcDACCStream;
+	uint32_t unStatus;
+	unsigned int unCount;
+	int nDone;
+
+	__OS_TRACE_EVENT(__TRACE_ISR_ENTER, DACC_IRQn + 16, 0);
+	unStatus = DACC->DACC_ISR & DACC->DACC_IMR;
+	nDone = ptrStream->bytNext ^ 1;					// Buffer converted first.
+	if (unStatus & DACC_ISR_TXBUFE)
+	{
+		if (ptrStream->bytLast == 0)
+		{
+			ptrStream->unUnderrun++;
+		}
+		unCount = DACCRefill(nDone);
+		if (unCount == 0)
+		{
+			DACCStreamStop();
+		}
+		else
+		{
+			PDC_DACC->PERIPH_TPR = (uint32_t)(uintptr_t) ptrStream->ptrBuf[nDone];
+			PDC_DACC->PERIPH_TCR = unCount;
+			unCount = DACCRefill(nDone ^ 1);
+			if (unCount > 0)
+			{
+				PDC_DACC->PERIPH_TNPR = (uint32_t)(uintptr_t) ptrStream->ptrBuf[nDone ^ 1];
+				PDC_DACC->PERIPH_TNCR = unCount;
+			}
+		}
+	}
+	else if (unStatus & DACC_ISR_ENDTX)
+	{
+		unCount = DACCRefill(nDone);
+		if (unCount == 0)
+		{
+			DACC->DACC_IDR = DACC_IDR_ENDTX;		// Wait for the end of the last buffer.
+		}
+		else
+		{
+			PDC_DACC->PERIPH_TNPR = (uint32_t)(uintptr_t) ptrStream->ptrBuf[nDone];
+			PDC_DACC->PERIPH_TNCR = unCount;
+			ptrStream->bytNext = nDone;
+		}
+	}
+	__OS_TRACE_EVENT(__TRACE_ISR_EXIT, DACC_IRQn + 16, 0);
+}
@@ -3,24 +3,59 @@
 // Filename			: Driver_DACC_V100.h
 
 #ifndef _DRIVER_DACC_SAM4S_H
-#define _DRIVER_DACC_SAM4s_H
+#define _DRIVER_DACC_SAM4S_H
 
 // Include common header to all drivers and sources.  Here absolute path is used.
 // To edit if one change folder
 #include "osmain.h"
 
 // 
+// --- PUBLIC CONSTANTS ---
+//
+#define __DACC_CHANNEL_ENABLE	(DACC_CHER_CH0 | DACC_CHER_CH1)	// Channels used, DAC0 = PB13, DAC1 = PB14.
+#define __DACC_MAX_RATE_HZ		1000000			// Max. conversion rate.
+#define __DACC_STARTUP_US		10				// Start-up time of the DACC, in usec.
+#define __DACC_STREAM_BOTH		2				// DACCStreamStart() on DAC0 and DAC1, tagged samples.
+
+//
+// --- PUBLIC DATATYPES ---
+//
+// Type cast for the waveform output, see DACCStreamStart().
+typedef struct StructDACCStream
+{
+	uint16_t *ptrBuf[2];				// Ping-pong buffers.
+	unsigned int unLength;				// No. of samples of each buffer.
+	unsigned int (*fptrRefill)(uint16_t *, unsigned int, void *);	// Refill a buffer once
+										// converted, returns the no. of samples, 0 to stop.
+	void *ptrArg;						// Argument of fptrRefill().
+	unsigned int unRateHz;				// Conversion rate requested.
+	unsigned int unActualHz;			// Conversion rate generated by the timer.
+	uint8_t bytChannel;					// 0, 1 or __DACC_STREAM_BOTH.
+	uint8_t bytNext;					// Buffer given to the PDC as the next one.
+	volatile uint8_t bytActive;			// 1 while the waveform is output.
+	volatile uint8_t bytLast;			// 1 once fptrRefill() has returned 0.
+	unsigned int unRefill;				// No. of buffers refilled.
+	unsigned int unUnderrun;			// No. of times the PDC ran out of samples.
+} DACC_STREAM;
+
 //
 // --- PUBLIC VARIABLES ---
 //
 				
 extern unsigned int gunDAC_OutA;
 extern unsigned int gunDAC_OutB;
+extern DACC_STREAM gstrcDACCStream;
 
 
 //
 // --- PUBLIC FUNCTION PROTOTYPE ---
 //
 void Proce_DACC_Driver(TASK_ATTRIBUTE *);
+int DACCStreamStart(int, unsigned int, uint16_t *, uint16_t *, unsigned int,
+					unsigned int (*)(uint16_t *, unsigned int, void *), void *);
+unsigned int DACCStreamRate(unsigned int);
+void DACCStreamStop(void);
+int DACCClockChange(unsigned int, int);
+void DACC_Handler(void);
 
 #endif
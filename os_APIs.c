@@ -9,131 +9,1358 @@
 ///
 /// Filename         : os_APIs.c
 /// Author           : Fabian Kung
-/// Last updated     : 25 Nov 2014
-/// File Version     : 1.09
+/// Last updated     : 16 Oct 2026
+/// File Version     : 1.11
 /// Description      : This file contains the implementation of all the important routines
 ///                    used by the Kernel for task management. It include routines to create or
 ///                    initialize a task, delete a task from the Scheduler, setting a task's 
 ///                    context etc.  The routines are general and can be used for most 
 ///                    micro-controller families.
+///                    Note: 16 Oct 2026, the Scheduler no longer scans the task array on every
+///                    tick.  A task waiting for its timer is kept in a hashed timer wheel of
+///                    __TIMER_WHEEL_SIZE slots, indexed by the clock tick at which the task is
+///                    due.  On each tick only the slot of the current tick is visited, and the
+///                    due tasks are flagged in a 2-level ready bitmap.  The Kernel then picks 
+///                    the ready tasks in ascending order of index with the count leading zero
+///                    instruction.  Thus the cost of a tick and of a dispatch does not grow
+///                    with the no. of tasks.
+///                    Note: 16 Oct 2026, the unused task slots are kept in a free list, so a 
+///                    task can be created or deleted at any time, also from within a running
+///                    task, in constant time and without moving the other tasks.  A task is 
+///                    identified by a handle = (generation << 16) + slot index + 1, the 
+///                    generation of a slot is incremented when its task is deleted, so a stale
+///                    handle to a deleted task is rejected.
+///                    Note: 16 Oct 2026, when __OS_PROFILE is defined the execution time of each
+///                    task is measured with the processor cycle counter, see OSRunTask().
+///                    Note: 16 Oct 2026, added single-producer single-consumer queues, OS_QUEUE,
+///                    for passing data between tasks, or between a task and an interrupt service
+///                    routine, without disabling interrupts.  See OSQueuePut() and OSQueueGet().
+///                    Note: 16 Oct 2026, a task can suspend itself until an event flag is
+///                    signalled by another task or by an interrupt service routine, with an
+///                    optional timeout, see OSWaitEvent() and OSSignalEvent().  A suspended
+///                    task is not in the timer wheel, so it is not executed at all until it
+///                    is signalled or its timeout expires.
+///                    Note: 16 Oct 2026, when __OS_TRACE is defined the Kernel, the queues and 
+///                    the interrupt service routines can record compact 8 bytes events with a
+///                    time stamp into a ring buffer, see OSTraceEvent().  The records are sent
+///                    to the host in the background by Proce_UART_Driver(), and decoded into a
+///                    timeline with the program in the folder "tools".
+///                    Note: 16 Oct 2026, tokenized log, see __OS_LOG_MSG().  Only the offset of the 
+///                    format string in the ELF file and the arguments are recorded, the text is
+///                    formatted on the host.  The records are sent with the trace, see OSLogWrite().
 
 // Include common header to all drivers and sources.  Here absolute path is used.
 // To edit if one changes folder
 #include "osmain.h"
 
 // --- GLOBAL VARIABLES AND DATAYPES DECLARATION ---
-int gnRunTask;									// Flag to determine when to run tasks.
-int gnTaskCount;								// Task counter.
-unsigned int gunClockTick;                      // Processor clock tick.
-TASK_ATTRIBUTE gstrcTaskContext[__MAXTASK-1];   // Array to store task contexts.
-TASK_POINTER gfptrTask[__MAXTASK-1];            // Array to store task pointers.
+volatile int gnRunTask;							// Flag to determine when to run tasks.
+volatile int gnTickDispatch;					// 1 from a system tick with due tasks until the main
+												// loop has executed them.
+int gnTaskCount;								// Task counter, the no. of task slots used since start-up.
+volatile unsigned int gunClockTick;             // Processor clock tick.
+TASK_ATTRIBUTE gstrcTaskContext[__MAXTASK];     // Array to store task contexts.
+TASK_POINTER gfptrTask[__MAXTASK];              // Array to store task pointers.
 
-SCI_STATUS gSCIstatus;				// Status for UART and RF serial communication interface.
+// Timer wheel.  The links are task index + 1, so that 0 (__TASK_NONE) marks the end of a list.
+// This way the wheel is valid straight from the zero initialized RAM, even if the SysTick 
+// exception occurs before OSInit() is called.
+uint16_t gunWheelHead[__TIMER_WHEEL_SIZE];		// First task in each slot of the timer wheel.
+uint16_t gunTaskNext[__MAXTASK];				// Next task in the same slot, or next free task slot.
+uint16_t gunTaskPrev[__MAXTASK];				// Previous task in the same slot, or previous free task slot.
+unsigned int gunTaskExpire[__MAXTASK];			// Clock tick at which the task is due.
+uint8_t gbytTaskWait[__MAXTASK];				// 1 if the task is in the timer wheel.
+uint16_t gunFreeHead;							// First free task slot, __TASK_NONE if all are used.
+uint16_t gunTaskGen[__MAXTASK];					// Generation of each task slot.
+unsigned int gunTaskEvent[__MAXTASK];			// Event flags signalled to each task.
+unsigned int gunTaskEventWait[__MAXTASK];		// Event flags a suspended task waits for, 0 if the task
+												// is not waiting for any event.
+
+// Ready bitmap, task ni is bit (31 - ni%32) of word ni/32, so that the count leading zero 
+// instruction returns the task with the lowest index.  Bit (31 - nWord) of gunReadyGroup 
+// is set when word nWord of gunReadyMap[] is not zero.
+unsigned int gunReadyGroup;
+unsigned int gunReadyMap[__READY_MAP_WORD];
+
+int gnCurrentTask = -1;							// Index of the task being executed, or of the last
+												// executed task.
+#ifdef __OS_PROFILE
+TASK_PROFILE gstrcTaskProfile[__MAXTASK];		// Execution time statistic of each task.
+TASK_PROFILE gstrcStateProfile[__PROFILE_STATE];	// Execution time of each state of the profiled task.
+int gnProfileTask;								// Handle of the task with state histogram, 0 for none.
+KERNEL_PROFILE gstrcKernelProfile;				// Load statistic of the Kernel.
+unsigned int gunTickBusy;						// Processor cycles used in the current system tick.
+#endif
+
+#ifdef __OS_TRACE
+OS_TRACE_RECORD gstrcTrace[__OS_TRACE_LENGTH];	// Trace ring buffer.
+volatile unsigned int gunTraceHead;				// No. of records written since OSInit().
+volatile unsigned int gunTraceTail;				// No. of records sent since OSInit().
+uint8_t gbytTraceSeq;							// Sequence no. of the trace chunks.
+#endif
+unsigned int gunTraceMask;						// Event codes to record, bit n for event code n.
+unsigned int gunTraceLost;						// No. of events lost because the trace buffer is full.
+
+#ifdef __OS_LOG
+uint8_t gbytLog[__OS_LOG_LENGTH];				// Log ring buffer, in blocks of __OS_LOG_CHUNK bytes.
+uint8_t gbytLogFill[__OS_LOG_LENGTH/__OS_LOG_CHUNK];	// No. of bytes used in each block.
+volatile unsigned int gunLogHead;				// No. of bytes written since OSInit(), including the
+volatile unsigned int gunLogTail;				// unused end of the blocks, and sent.
+unsigned int gunLogTick;						// Clock tick of the last record.
+uint8_t gbytLogSeq;								// Sequence no. of the log chunks.
+unsigned int gunLogSent;						// Clock tick of the last chunk.
+#endif
+unsigned int gunLogLost;						// No. of log records lost because the buffer is full.
 
 // --- RTOS FUNCTIONS ---
 
 // Function name	: OSInit()
 // Author			: Fabian Kung
-// Last modified	: 20 Nov 2015
+// Last modified	: 16 Oct 2026
 // Purpose			: Initialize the variables and parameters of the RTOS.
 // Arguments		: None.
 // Return			: None.
 void OSInit()
 {
+	int ni;
+
+	OSEnterCritical();
 	gunClockTick = 0; 		// Initialize 32-bits RTOS global timer.
+	for (ni = 0; ni < __TIMER_WHEEL_SIZE; ni++)
+	{
+		gunWheelHead[ni] = __TASK_NONE;		// Empty timer wheel.
+	}
+	for (ni = 0; ni < __MAXTASK; ni++)
+	{
+		gbytTaskWait[ni] = 0;
+		gunTaskEvent[ni] = 0;
+		gunTaskEventWait[ni] = 0;
+		gfptrTask[ni] = 0;					// All task slots are free.
+		gstrcTaskContext[ni].nID = 0;
+		gunTaskGen[ni] = 0;
+		gunTaskPrev[ni] = ni;				// Link all the task slots in the free list in 
+		gunTaskNext[ni] = ni + 2;			// ascending order.
+	}
+	gunTaskNext[__MAXTASK - 1] = __TASK_NONE;
+	gunFreeHead = 1;
+	gnTaskCount = 0;
+	for (ni = 0; ni < __READY_MAP_WORD; ni++)
+	{
+		gunReadyMap[ni] = 0;				// No task is ready.
+	}
+	gunReadyGroup = 0;
+	gnTickDispatch = 0;
+	gnCurrentTask = -1;
+#ifdef __OS_TRACE
+	gunTraceHead = 0;						// Empty trace buffer, recording is off.
+	gunTraceTail = 0;
+	gbytTraceSeq = 0;
+#endif
+	gunTraceMask = 0;
+	gunTraceLost = 0;
+#ifdef __OS_LOG
+	gunLogHead = 0;							// Empty log buffer.
+	gunLogTail = 0;
+	gunLogTick = 0;
+	gbytLogSeq = 0;
+	gunLogSent = 0;
+#endif
+	gunLogLost = 0;
+	OSExitCritical();
+	OSProfileReset();
+}
+
+// Function name	: OSTimerInsert()
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Purpose			: Put a task into the timer wheel slot of the clock tick at which it is due.
+//                    Must be called with the interrupts disabled.
+// Arguments		: ni = index of the task.
+//                    unExpire = the clock tick at which the task is due.
+// Return			: None.
+static void OSTimerInsert(int ni, unsigned int unExpire)
+{
+	int nSlot = unExpire & (__TIMER_WHEEL_SIZE - 1);
+
+	gunTaskExpire[ni] = unExpire;
+	gunTaskPrev[ni] = __TASK_NONE;
+	gunTaskNext[ni] = gunWheelHead[nSlot];
+	if (gunWheelHead[nSlot] != __TASK_NONE)
+	{
+		gunTaskPrev[gunWheelHead[nSlot] - 1] = ni + 1;
+	}
+	gunWheelHead[nSlot] = ni + 1;
+	gbytTaskWait[ni] = 1;
+}
+
+// Function name	: OSTimerRemove()
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Purpose			: Remove a task from the timer wheel.  Must be called with the interrupts
+//                    disabled.
+// Arguments		: ni = index of the task.
+// Return			: None.
+static void OSTimerRemove(int ni)
+{
+	if (gbytTaskWait[ni] == 0)
+	{
+		return;
+	}
+	if (gunTaskPrev[ni] == __TASK_NONE)
+	{
+		gunWheelHead[gunTaskExpire[ni] & (__TIMER_WHEEL_SIZE - 1)] = gunTaskNext[ni];
+	}
+	else
+	{
+		gunTaskNext[gunTaskPrev[ni] - 1] = gunTaskNext[ni];
+	}
+	if (gunTaskNext[ni] != __TASK_NONE)
+	{
+		gunTaskPrev[gunTaskNext[ni] - 1] = gunTaskPrev[ni];
+	}
+	gbytTaskWait[ni] = 0;
+}
+
+// Function name	: OSReadySet()
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Purpose			: Flag a task as ready to run in the ready bitmap.  Must be called with
+//                    the interrupts disabled.
+// Arguments		: ni = index of the task.
+// Return			: None.
+static void OSReadySet(int ni)
+{
+	gunReadyMap[ni >> 5] |= 0x80000000 >> (ni & 31);
+	gunReadyGroup |= 0x80000000 >> (ni >> 5);
+}
+
+// Function name	: OSReadyClear()
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Purpose			: Remove a task from the ready bitmap.  Must be called with the interrupts
+//                    disabled.
+// Arguments		: ni = index of the task.
+// Return			: None.
+static void OSReadyClear(int ni)
+{
+	gunReadyMap[ni >> 5] &= ~(0x80000000 >> (ni & 31));
+	if (gunReadyMap[ni >> 5] == 0)
+	{
+		gunReadyGroup &= ~(0x80000000 >> (ni >> 5));
+	}
+}
+
+#ifdef __OS_PROFILE
+// Function name	: OSProfileClear()
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Purpose			: Clear an execution time statistic.
+// Arguments		: ptrProfile = pointer to the statistic.
+// Return			: None.
+static void OSProfileClear(TASK_PROFILE *ptrProfile)
+{
+	ptrProfile->unCount = 0;
+	ptrProfile->unMin = 0xFFFFFFFF;
+	ptrProfile->unMax = 0;
+	ptrProfile->ullSum = 0;
+}
+
+// Function name	: OSProfileAdd()
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Purpose			: Add one execution to an execution time statistic.
+// Arguments		: ptrProfile = pointer to the statistic.
+//                    unCycle = processor cycles taken by the execution.
+// Return			: None.
+static void OSProfileAdd(TASK_PROFILE *ptrProfile, unsigned int unCycle)
+{
+	ptrProfile->unCount++;
+	ptrProfile->ullSum += unCycle;
+	if (unCycle < ptrProfile->unMin)
+	{
+		ptrProfile->unMin = unCycle;
+	}
+	if (unCycle > ptrProfile->unMax)
+	{
+		ptrProfile->unMax = unCycle;
+	}
+}
+#endif
+
+// Function name	: OSTaskAlloc()
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Purpose			: Take a task slot out of the free list, assign the task routine and 
+//                    schedule it for the next clock tick.  Must be called with the interrupts
+//                    disabled.
+// Arguments		: ni = index of a free task slot.
+//                    ptrTask = a valid pointer to a user routine.
+// Return			: The handle of the task.
+static int OSTaskAlloc(int ni, TASK_POINTER ptrTask)
+{
+	if (gunTaskPrev[ni] == __TASK_NONE)
+	{
+		gunFreeHead = gunTaskNext[ni];
+	}
+	else
+	{
+		gunTaskNext[gunTaskPrev[ni] - 1] = gunTaskNext[ni];
+	}
+	if (gunTaskNext[ni] != __TASK_NONE)
+	{
+		gunTaskPrev[gunTaskNext[ni] - 1] = gunTaskPrev[ni];
+	}
+
+	gstrcTaskContext[ni].nState = 0;	// Initialize the task's state and timer variables.
+	gstrcTaskContext[ni].nTimer = 1;
+	gstrcTaskContext[ni].nID = (gunTaskGen[ni] << 16) + ni + 1;
+	gfptrTask[ni] = ptrTask;			// Assign task's address to function pointer array.
+	gunTaskEvent[ni] = 0;				// No event pending.
+	gunTaskEventWait[ni] = 0;
+	OSTimerInsert(ni, gunClockTick + 1);	// Due on the next clock tick.
+#ifdef __OS_PROFILE
+	OSProfileClear(&gstrcTaskProfile[ni]);	// Clear the statistic of the previous task in this slot.
+#endif
+	if (ni >= gnTaskCount)
+	{
+		gnTaskCount = ni + 1;
+	}
+	return gstrcTaskContext[ni].nID;
+}
+
+// Function name	: OSTaskIndex()
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Purpose			: Check a task handle.
+// Arguments		: nHandle = handle of the task.
+// Return			: Index of the task slot, or -1 if the handle does not refer to a running task.
+static int OSTaskIndex(int nHandle)
+{
+	int ni = (nHandle & 0xFFFF) - 1;
+
+	if ((ni < 0) || (ni >= __MAXTASK))
+	{
+		return -1;
+	}
+	if ((gfptrTask[ni] == 0) || (gstrcTaskContext[ni].nID != nHandle))
+	{
+		return -1;
+	}
+	return ni;
 }
 
 /// Function name	: OSTaskCreate()
 /// Author			: Fabian Kung
-/// Last modified	: 20 Nov 2015
-/// Purpose			: Add a new task to the OS's scheduler.
-/// Arguments		: ptrTaskData = A pointer to the structure structTASK.
+/// Last modified	: 16 Oct 2026
+/// Purpose			: Add a new task to the OS's scheduler in the task slot pointed to by
+///                   ptrTaskData.  The task will be executed on the next clock tick.  The
+///                   handle of the task is stored in ptrTaskData->nID.
+/// Arguments		: ptrTaskData = A pointer to a free element of gstrcTaskContext[].
 ///                   ptrTask = a valid pointer to a user routine.
 /// Return			: 0 if success, 1 or >0 if not successful.
-/// Others			: Increment global variable gnTaskCount.
+/// Others			: Update global variable gnTaskCount.
 int OSCreateTask(TASK_ATTRIBUTE *ptrTaskData, TASK_POINTER ptrTask)
 {
-	if (gnTaskCount> __MAXTASK) 
+	int ni = ptrTaskData - gstrcTaskContext;	// Index of the task slot.
+
+	if ((ni < 0) || (ni >= __MAXTASK)) 
 	{
 		return 1;                               // Maximum tasks exceeded.
 	}
-	else
+	OSEnterCritical();
+	if (gfptrTask[ni] != 0)
 	{
-		ptrTaskData->nState = 0;		// Initialize the task's state and timer variables.
-		ptrTaskData->nTimer = 1;
-											
-		gfptrTask[gnTaskCount] = ptrTask;	// Assign task's address to function pointer array.
-		gnTaskCount++; 				// Increment task counter.
-							// Initialize the task's ID
-		ptrTaskData->nID = gnTaskCount; 	// Task's ID = current Task Count + 1.
+		OSExitCritical();
+		return 1;								// Task slot is in use.
+	}
+	OSTaskAlloc(ni, ptrTask);
+	OSExitCritical();
+	return 0;
+}
 
+/// Function name	: OSSpawnTask()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Purpose			: Add a new task to the OS's scheduler in any free task slot.  The task 
+///                   will be executed on the next clock tick.  This routine can be called
+///                   from within a running task.
+/// Arguments		: ptrTask = a valid pointer to a user routine.
+/// Return			: Handle of the new task, or 0 if there is no free task slot.
+int OSSpawnTask(TASK_POINTER ptrTask)
+{
+	int nHandle = 0;
+
+	OSEnterCritical();
+	if (gunFreeHead != __TASK_NONE)
+	{
+		nHandle = OSTaskAlloc(gunFreeHead - 1, ptrTask);
+	}
+	OSExitCritical();
+	return nHandle;
+}
+
+/// Function name	: OSGetTask()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Purpose			: Get the context of a task from its handle.
+/// Arguments		: nHandle = handle of the task.
+/// Return			: Pointer to the task's context, or 0 if the task has been deleted.
+TASK_ATTRIBUTE *OSGetTask(int nHandle)
+{
+	int ni = OSTaskIndex(nHandle);
+
+	if (ni < 0)
+	{
 		return 0;
 	}
+	return &gstrcTaskContext[ni];
 }
 
 /// Function name	: OSSetTaskContext()
 /// Author			: Fabian Kung
-/// Last modified	: 20 Nov 2015
-/// Purpose			: Set the task's State and Timer variables.
+/// Last modified	: 16 Oct 2026
+/// Purpose			: Set the task's State and Timer variables.  The task is moved to the 
+///                   timer wheel slot of the clock tick at which it is due.
 /// Arguments		: ptrTaskData = A pointer to the structure structTASK.
 ///					  nState = Next state of the task.
 ///					  nTimer = Timer, the no. of clock ticks before the task
-///					  executes again.
+///					  executes again.  A value of 0 or 1 executes the task on the next
+///                   clock tick.
 /// Return			: None.
 void OSSetTaskContext(TASK_ATTRIBUTE *ptrTaskData, int nState, int nTimer)
 {
+	int ni = ptrTaskData - gstrcTaskContext;	// Index of the task.
+
 	ptrTaskData->nState = nState;
 	ptrTaskData->nTimer = nTimer;
+	if (nTimer < 1)
+	{
+		nTimer = 1;
+	}
+	OSEnterCritical();
+	if (gfptrTask[ni] == 0)						// Ignore if the task has deleted itself.
+	{
+		OSExitCritical();
+		return;
+	}
+	OSReadyClear(ni);
+	OSTimerRemove(ni);
+	gunTaskEventWait[ni] = 0;
+	OSTimerInsert(ni, gunClockTick + nTimer);
+	OSExitCritical();
 }
 
 /// Function name	: OSTaskDelete()
 /// Author			: Fabian Kung
-/// Last modified	: 20 Nov 2015
-/// Description		: Delete a task from the OS's scheduler.
-/// Arguments		: nTaskID = An integer indicating the task ID.
-/// Return			: 0 if success, 1 or >0 if not successful.
+/// Last modified	: 16 Oct 2026
+/// Description		: Delete a task from the OS's scheduler.  The task slot is returned to the
+///                   free list, the other tasks are not affected.  A task can delete itself,
+///                   in this case it will not be executed again even if it calls 
+///                   OSSetTaskContext() afterwards.
+/// Arguments		: nTaskID = The handle of the task, i.e. the nID attribute.
+/// Return			: 0 if success, 1 or >0 if not successful (task already deleted).
 int OSTaskDelete(int nTaskID)
 {
 	int ni;
 
-	if (nTaskID < gnTaskCount) // nTaskID can be from 1 to (gnTaskCount-1)
+	OSEnterCritical();
+	ni = OSTaskIndex(nTaskID);
+	if (ni < 0)
 	{
-		if (nTaskID < (gnTaskCount - 1))	// Shift all the elements of the gstrcTaskContext
-		{					// array down 1 position.
-			ni = nTaskID - 1;
-			while (ni < (gnTaskCount - 1))
-			{
-				gstrcTaskContext[ni].nState = gstrcTaskContext[ni + 1].nState;
-				gstrcTaskContext[ni].nTimer = gstrcTaskContext[ni + 1].nTimer;
-				gstrcTaskContext[ni].nID = gstrcTaskContext[ni + 1].nID;
-				gfptrTask[ni] = gfptrTask[ni + 1];
-				ni++;
-			}
-			gnTaskCount--; 			// There is 1 less task to execute now.
-		}
-		return 0;
+		OSExitCritical();
+		return 1;
+	}
+	OSReadyClear(ni);
+	OSTimerRemove(ni);
+	gunTaskEventWait[ni] = 0;
+	gfptrTask[ni] = 0;
+	gstrcTaskContext[ni].nID = 0;				// ID = 0 indicates empty task.
+	gunTaskGen[ni] = (gunTaskGen[ni] + 1) & 0x7FFF;	// Invalidate all handles to this slot.
+	gunTaskPrev[ni] = __TASK_NONE;				// Put the slot at the head of the free list.
+	gunTaskNext[ni] = gunFreeHead;
+	if (gunFreeHead != __TASK_NONE)
+	{
+		gunTaskPrev[gunFreeHead - 1] = ni + 1;
+	}
+	gunFreeHead = ni + 1;
+	OSExitCritical();
+	return 0;
+}
+
+/// Function name	: OSWaitEvent()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Purpose			: Set the task's State, and suspend the task until any of the event flags
+///                   in unMask is signalled with OSSignalEvent(), or until the timeout.  Use
+///                   this in place of OSSetTaskContext() when the task has nothing to do until
+///                   something happens.  If one of the event flags is already signalled the
+///                   task is executed again straight away.  On the next execution the task 
+///                   calls OSGetEvent() to find out which event has occurred, no event means
+///                   the timeout has expired.
+/// Arguments		: ptrTaskData = A pointer to the structure structTASK.
+///					  nState = Next state of the task.
+///                   unMask = The event flags to wait for, must not be 0.
+///                   nTimeout = The max. no. of clock ticks to wait, 0 to wait forever.
+/// Return			: None.
+void OSWaitEvent(TASK_ATTRIBUTE *ptrTaskData, int nState, unsigned int unMask, int nTimeout)
+{
+	int ni = ptrTaskData - gstrcTaskContext;	// Index of the task.
+
+	ptrTaskData->nState = nState;
+	ptrTaskData->nTimer = nTimeout;
+	OSEnterCritical();
+	if (gfptrTask[ni] == 0)						// Ignore if the task has deleted itself.
+	{
+		OSExitCritical();
+		return;
+	}
+	__OS_TRACE_EVENT(__TRACE_EVENT_WAIT, unMask, nTimeout);
+	OSReadyClear(ni);
+	OSTimerRemove(ni);
+	if ((gunTaskEvent[ni] & unMask) != 0)		// Event already signalled.
+	{
+		gunTaskEventWait[ni] = 0;
+		OSReadySet(ni);
+		gnRunTask = 1;
 	}
 	else
 	{
+		gunTaskEventWait[ni] = unMask;
+		if (nTimeout > 0)
+		{
+			OSTimerInsert(ni, gunClockTick + nTimeout);
+		}
+	}
+	OSExitCritical();
+}
+
+/// Function name	: OSSignalEvent()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Purpose			: Signal event flags to a task.  The flags stay set until the task clears
+///                   them with OSGetEvent().  If the task is waiting for one of the flags it
+///                   is made ready, and is executed as soon as the current task returns, or 
+///                   when the interrupt service routine returns to the idle loop, without
+///                   waiting for the next clock tick.  This routine can be called from a task
+///                   or from an interrupt service routine.
+/// Arguments		: nHandle = handle of the task.
+///                   unEvent = the event flags to set.
+/// Return			: 0 if success, 1 if the task has been deleted.
+int OSSignalEvent(int nHandle, unsigned int unEvent)
+{
+	int ni;
+
+	OSEnterCritical();
+	ni = OSTaskIndex(nHandle);
+	if (ni < 0)
+	{
+		OSExitCritical();
 		return 1;
 	}
+	__OS_TRACE_EVENT(__TRACE_EVENT_SIGNAL, unEvent, ni);
+	gunTaskEvent[ni] |= unEvent;
+	if ((gunTaskEventWait[ni] & unEvent) != 0)	// Wake up the task.
+	{
+		gunTaskEventWait[ni] = 0;
+		OSTimerRemove(ni);						// Cancel the timeout.
+		OSReadySet(ni);
+		gnRunTask = 1;
+	}
+	OSExitCritical();
+	return 0;
+}
+
+/// Function name	: OSGetEvent()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Purpose			: Get and clear the event flags signalled to a task.
+/// Arguments		: ptrTaskData = A pointer to the structure structTASK.
+///                   unMask = The event flags to get.
+/// Return			: The event flags in unMask which have been signalled, 0 if none.
+unsigned int OSGetEvent(TASK_ATTRIBUTE *ptrTaskData, unsigned int unMask)
+{
+	int ni = ptrTaskData - gstrcTaskContext;	// Index of the task.
+	unsigned int unEvent;
+
+	OSEnterCritical();
+	unEvent = gunTaskEvent[ni] & unMask;
+	gunTaskEvent[ni] &= ~unEvent;
+	OSExitCritical();
+	return unEvent;
 }
 
 /// Function name	: OSUpdateTaskTimer()
 /// Author			: Fabian Kung
-/// Last modified	: 20 Nov 2015
-/// Description		: Update the timer attribute of each task.
+/// Last modified	: 16 Oct 2026
+/// Description		: Move the tasks which are due on the current clock tick from the timer
+///                   wheel to the ready bitmap.  This routine is called from the system tick
+///                   exception handler once every system tick, after gunClockTick is 
+///                   incremented.  Only the timer wheel slot of the current tick is visited, 
+///                   tasks in the same slot which are due on a later revolution of the 
+///                   wheel are skipped.
 /// Arguments		: None.
+/// Return			: The no. of tasks which are due to run.
+int OSUpdateTaskTimer(void)
+{
+	int ni;
+	int nNext;
+	int nReady = 0;
+	unsigned int unTick = gunClockTick;
+
+	nNext = gunWheelHead[unTick & (__TIMER_WHEEL_SIZE - 1)];
+	while (nNext != __TASK_NONE)
+	{
+		ni = nNext - 1;
+		nNext = gunTaskNext[ni];
+		if (gunTaskExpire[ni] == unTick)
+		{
+			OSTimerRemove(ni);
+			OSReadySet(ni);
+			nReady++;
+		}
+	}
+	return nReady;
+}
+
+/// Function name	: OSGetReadyTask()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Get the ready task with the lowest index and remove it from the ready
+///                   bitmap.  The task is put back into the timer wheel to be executed on 
+///                   the next clock tick, unless it calls OSSetTaskContext() to set another
+///                   delay, as in the previous Kernel a task with timer = 0 is executed on 
+///                   every tick.  The timer attribute of the task is cleared, this is checked
+///                   by some of the drivers.
+/// Arguments		: None.
+/// Return			: Index of the task, or -1 if no task is ready.
+int OSGetReadyTask(void)
+{
+	int nWord;
+	int ni;
+
+	OSEnterCritical();
+	if (gunReadyGroup == 0)
+	{
+		OSExitCritical();
+		return -1;
+	}
+	nWord = __OS_CLZ(gunReadyGroup);
+	ni = (nWord << 5) + __OS_CLZ(gunReadyMap[nWord]);
+	OSReadyClear(ni);
+	OSTimerInsert(ni, gunClockTick + 1);
+	gunTaskEventWait[ni] = 0;					// Timeout or event, the task is no longer waiting.
+	gstrcTaskContext[ni].nTimer = 0;
+	OSExitCritical();
+	return ni;
+}
+
+/// Function name	: OSRunTask()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Execute a task.  When __OS_PROFILE is defined the no. of processor cycles
+///                   taken by the task is added to the statistic of the task, to the state 
+///                   histogram if this is the profiled task, and to the busy cycles of the
+///                   current system tick.  The entry and the return of the task are recorded
+///                   in the execution trace.
+/// Arguments		: ni = index of the task, as returned by OSGetReadyTask().
 /// Return			: None.
-void OSUpdateTaskTimer(void)
+void OSRunTask(int ni)
 {
-	int ni = 0;
+#ifdef __OS_PROFILE
+	unsigned int unStart;
+	unsigned int unCycle;
+	int nState = gstrcTaskContext[ni].nState;	// The state being executed.
+	int nHandle = gstrcTaskContext[ni].nID;
+
+	gnCurrentTask = ni;
+	__OS_TRACE_EVENT(__TRACE_TASK_ENTER, nState, ni);
+	unStart = __OS_CYCLE_COUNT();
+	(*((TASK_POINTER)gfptrTask[ni]))(&gstrcTaskContext[ni]);
+	unCycle = __OS_CYCLE_COUNT() - unStart;
+	__OS_TRACE_EVENT(__TRACE_TASK_EXIT, gstrcTaskContext[ni].nState, ni);
 
-	ni = 0; 					// Reset index.
-	while (ni < gnTaskCount)
-	{	
-		--(gstrcTaskContext[ni].nTimer); 	// Decrement the timer of each task.
-		ni++; 					// Next task.
+	OSEnterCritical();
+	gunTickBusy += unCycle;						// Also updated by the SysTick exception handler.
+	OSExitCritical();
+
+	OSProfileAdd(&gstrcTaskProfile[ni], unCycle);
+	if ((nHandle == gnProfileTask) && (nState >= 0))
+	{
+		if (nState >= __PROFILE_STATE)
+		{
+			nState = __PROFILE_STATE - 1;		// Higher states are counted in the last bin.
+		}
+		OSProfileAdd(&gstrcStateProfile[nState], unCycle);
+	}
+#else
+	gnCurrentTask = ni;
+	__OS_TRACE_EVENT(__TRACE_TASK_ENTER, gstrcTaskContext[ni].nState, ni);
+	(*((TASK_POINTER)gfptrTask[ni]))(&gstrcTaskContext[ni]);
+	__OS_TRACE_EVENT(__TRACE_TASK_EXIT, gstrcTaskContext[ni].nState, ni);
+#endif
+}
+
+/// Function name	: OSProfileReset()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Clear all the profiling statistic.
+/// Arguments		: None.
+/// Return			: None.
+void OSProfileReset(void)
+{
+#ifdef __OS_PROFILE
+	int ni;
+
+	OSEnterCritical();
+	for (ni = 0; ni < __MAXTASK; ni++)
+	{
+		OSProfileClear(&gstrcTaskProfile[ni]);
+	}
+	for (ni = 0; ni < __PROFILE_STATE; ni++)
+	{
+		OSProfileClear(&gstrcStateProfile[ni]);
 	}
+	gstrcKernelProfile.unTickCycle = __TICK_CYCLE;
+	gstrcKernelProfile.unTickBusy = 0;
+	gstrcKernelProfile.unTickBusyMax = 0;
+	gstrcKernelProfile.unOverrun = 0;
+	gstrcKernelProfile.nOverrunTask = 0;
+	gunTickBusy = 0;
+	OSExitCritical();
+#endif
 }
 
+/// Function name	: OSProfileSelect()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Select the task for the state histogram, and clear the histogram.  The
+///                   execution time is accumulated according to the nState attribute of 
+///                   the task on entry.
+/// Arguments		: nHandle = handle of the task, 0 to stop.
+/// Return			: None.
+void OSProfileSelect(int nHandle)
+{
+#ifdef __OS_PROFILE
+	int ni;
+
+	gnProfileTask = 0;
+	for (ni = 0; ni < __PROFILE_STATE; ni++)
+	{
+		OSProfileClear(&gstrcStateProfile[ni]);
+	}
+	gnProfileTask = nHandle;
+#endif
+}
+
+/// Function name	: OSGetTaskProfile()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Get the execution time statistic of a task.
+/// Arguments		: nHandle = handle of the task.
+///                   ptrProfile = pointer to the structure to hold the statistic.
+/// Return			: 0 if success, 1 if the task does not exist or profiling is not enabled.
+int OSGetTaskProfile(int nHandle, TASK_PROFILE *ptrProfile)
+{
+#ifdef __OS_PROFILE
+	int ni = OSTaskIndex(nHandle);
+
+	if (ni < 0)
+	{
+		return 1;
+	}
+	*ptrProfile = gstrcTaskProfile[ni];
+	return 0;
+#else
+	return 1;
+#endif
+}
+
+/// Function name	: OSGetStateProfile()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Get the execution time statistic of one state of the task selected with
+///                   OSProfileSelect().
+/// Arguments		: nState = the state, 0 to __PROFILE_STATE-1.
+///                   ptrProfile = pointer to the structure to hold the statistic.
+/// Return			: 0 if success, 1 if nState is out of range or profiling is not enabled.
+int OSGetStateProfile(int nState, TASK_PROFILE *ptrProfile)
+{
+#ifdef __OS_PROFILE
+	if ((nState < 0) || (nState >= __PROFILE_STATE))
+	{
+		return 1;
+	}
+	*ptrProfile = gstrcStateProfile[nState];
+	return 0;
+#else
+	return 1;
+#endif
+}
+
+/// Function name	: OSGetKernelProfile()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Get the load statistic of the Kernel.
+/// Arguments		: ptrProfile = pointer to the structure to hold the statistic.
+/// Return			: None.
+void OSGetKernelProfile(KERNEL_PROFILE *ptrProfile)
+{
+#ifdef __OS_PROFILE
+	OSEnterCritical();
+	*ptrProfile = gstrcKernelProfile;
+	OSExitCritical();
+#endif
+}
+
+/// Function name	: OSProfileTick()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Close the busy cycles count of the current system tick.  This routine is 
+///                   called at the end of the SysTick exception handler.
+/// Arguments		: unHandlerCycle = processor cycles taken by the SysTick exception handler.
+/// Return			: None.
+void OSProfileTick(unsigned int unHandlerCycle)
+{
+#ifdef __OS_PROFILE
+	gstrcKernelProfile.unTickBusy = gunTickBusy + unHandlerCycle;
+	if (gstrcKernelProfile.unTickBusy > gstrcKernelProfile.unTickBusyMax)
+	{
+		gstrcKernelProfile.unTickBusyMax = gstrcKernelProfile.unTickBusy;
+	}
+	gunTickBusy = 0;
+#endif
+}
+
+/// Function name	: OSProfileOverrun()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Count a tick overrun, i.e. a system tick occurring while the due tasks
+///                   of the previous tick are still being executed, and record the handle of
+///                   the task being executed.  This routine is called from the SysTick
+///                   exception handler.
+/// Arguments		: None.
+/// Return			: None.
+void OSProfileOverrun(void)
+{
+#ifdef __OS_PROFILE
+	gstrcKernelProfile.unOverrun++;
+	__OS_TRACE_EVENT(__TRACE_OVERRUN, 0, gnCurrentTask);
+	if (gnCurrentTask >= 0)
+	{
+		gstrcKernelProfile.nOverrunTask = gstrcTaskContext[gnCurrentTask].nID;
+	}
+	else
+	{
+		gstrcKernelProfile.nOverrunTask = 0;
+	}
+#endif
+}
+
+/// Function name	: OSQueueInit()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Initialize a single-producer single-consumer queue.  The queue must not 
+///                   be in use.
+/// Arguments		: ptrQueue = pointer to the queue.
+///                   ptrBuffer = storage for the items, unLength x unItemSize bytes.
+///                   unLength = max. no. of items in the queue, must be a power of 2.
+///                   unItemSize = size of one item in bytes.
+/// Return			: 0 if success, 1 if unLength is not a power of 2.
+int OSQueueInit(OS_QUEUE *ptrQueue, void *ptrBuffer, unsigned int unLength, unsigned int unItemSize)
+{
+	if ((unLength == 0) || ((unLength & (unLength - 1)) != 0))
+	{
+		return 1;
+	}
+	ptrQueue->unHead = 0;
+	ptrQueue->unTail = 0;
+	ptrQueue->unMask = unLength - 1;
+	ptrQueue->unItemSize = unItemSize;
+	ptrQueue->ptrBuffer = (uint8_t *) ptrBuffer;
+	return 0;
+}
+
+/// Function name	: OSQueuePut()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Put an item at the end of a queue.  This routine is called by the 
+///                   producer of the queue only, which can be a task or an interrupt service
+///                   routine.  The item is copied before unHead is updated, so the consumer
+///                   never sees a partially written item.
+/// Arguments		: ptrQueue = pointer to the queue.
+///                   ptrItem = pointer to the item.
+/// Return			: 0 if success, 1 if the queue is full.
+int OSQueuePut(OS_QUEUE *ptrQueue, const void *ptrItem)
+{
+	unsigned int unHead = ptrQueue->unHead;
+	unsigned int unSize = ptrQueue->unItemSize;
+	uint8_t *ptrDest;
+	const uint8_t *ptrSrc = (const uint8_t *) ptrItem;
+
+	if (unHead - ptrQueue->unTail > ptrQueue->unMask)
+	{
+		return 1;								// Queue is full.
+	}
+	ptrDest = ptrQueue->ptrBuffer + (unHead & ptrQueue->unMask)*unSize;
+	while (unSize > 0)
+	{
+		*ptrDest++ = *ptrSrc++;
+		unSize--;
+	}
+	__OS_MEMORY_BARRIER();						// Item is stored before it is published.
+	ptrQueue->unHead = unHead + 1;
+	__OS_TRACE_EVENT(__TRACE_QUEUE_PUT, 1, (uintptr_t) ptrQueue);
+	return 0;
+}
+
+/// Function name	: OSQueueWrite()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Put a block of consecutive items at the end of a queue, as many as
+///                   there is space for.  This routine is called by the producer of the queue
+///                   only.  Useful for writing a string to a byte queue.
+/// Arguments		: ptrQueue = pointer to the queue.
+///                   ptrData = pointer to the first item.
+///                   unCount = no. of items.
+/// Return			: No. of items put into the queue.
+unsigned int OSQueueWrite(OS_QUEUE *ptrQueue, const void *ptrData, unsigned int unCount)
+{
+	unsigned int unHead = ptrQueue->unHead;
+	unsigned int unSpace = ptrQueue->unMask + 1 - (unHead - ptrQueue->unTail);
+	unsigned int unSize = ptrQueue->unItemSize;
+	unsigned int unByte;
+	unsigned int ni;
+	uint8_t *ptrDest;
+	const uint8_t *ptrSrc = (const uint8_t *) ptrData;
+
+	if (unCount > unSpace)
+	{
+		unCount = unSpace;
+	}
+	for (ni = 0; ni < unCount; ni++)
+	{
+		ptrDest = ptrQueue->ptrBuffer + ((unHead + ni) & ptrQueue->unMask)*unSize;
+		for (unByte = 0; unByte < unSize; unByte++)
+		{
+			*ptrDest++ = *ptrSrc++;
+		}
+	}
+	__OS_MEMORY_BARRIER();						// Items are stored before they are published.
+	ptrQueue->unHead = unHead + unCount;
+	__OS_TRACE_EVENT(__TRACE_QUEUE_PUT, (unCount > 255) ? 255 : unCount, (uintptr_t) ptrQueue);
+	return unCount;
+}
+
+/// Function name	: OSQueueGet()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Get and remove the item at the front of a queue.  This routine is called
+///                   by the consumer of the queue only, which can be a task or an interrupt
+///                   service routine.
+/// Arguments		: ptrQueue = pointer to the queue.
+///                   ptrItem = pointer to the storage for the item.
+/// Return			: 0 if success, 1 if the queue is empty.
+int OSQueueGet(OS_QUEUE *ptrQueue, void *ptrItem)
+{
+	unsigned int unTail = ptrQueue->unTail;
+	unsigned int unSize = ptrQueue->unItemSize;
+	const uint8_t *ptrSrc;
+	uint8_t *ptrDest = (uint8_t *) ptrItem;
+
+	if (ptrQueue->unHead == unTail)
+	{
+		return 1;								// Queue is empty.
+	}
+	__OS_MEMORY_BARRIER();						// Index is read before the item.
+	ptrSrc = ptrQueue->ptrBuffer + (unTail & ptrQueue->unMask)*unSize;
+	while (unSize > 0)
+	{
+		*ptrDest++ = *ptrSrc++;
+		unSize--;
+	}
+	__OS_MEMORY_BARRIER();						// Item is copied before its space is released.
+	ptrQueue->unTail = unTail + 1;
+	__OS_TRACE_EVENT(__TRACE_QUEUE_GET, 1, (uintptr_t) ptrQueue);
+	return 0;
+}
+
+/// Function name	: OSQueuePeek()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Get a pointer to the item at the front of a queue without removing it.
+///                   The item stays valid until OSQueueRemove() is called, thus the consumer 
+///                   can work on a large item in place.  This routine is called by the 
+///                   consumer of the queue only.
+/// Arguments		: ptrQueue = pointer to the queue.
+/// Return			: Pointer to the item, or 0 if the queue is empty.
+void *OSQueuePeek(OS_QUEUE *ptrQueue)
+{
+	unsigned int unTail = ptrQueue->unTail;
+
+	if (ptrQueue->unHead == unTail)
+	{
+		return 0;
+	}
+	__OS_MEMORY_BARRIER();						// Index is read before the item.
+	return ptrQueue->ptrBuffer + (unTail & ptrQueue->unMask)*ptrQueue->unItemSize;
+}
+
+/// Function name	: OSQueueRemove()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Remove the item at the front of a queue, after OSQueuePeek().  This
+///                   routine is called by the consumer of the queue only.
+/// Arguments		: ptrQueue = pointer to the queue.
+/// Return			: None.
+void OSQueueRemove(OS_QUEUE *ptrQueue)
+{
+	unsigned int unTail = ptrQueue->unTail;
+
+	if (ptrQueue->unHead != unTail)
+	{
+		__OS_MEMORY_BARRIER();					// Item is used before its space is released.
+		ptrQueue->unTail = unTail + 1;
+		__OS_TRACE_EVENT(__TRACE_QUEUE_GET, 1, (uintptr_t) ptrQueue);
+	}
+}
+
+/// Function name	: OSQueueCount()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Get the no. of items in a queue.  When called by the producer the actual
+///                   count can only be smaller, when called by the consumer it can only be 
+///                   larger.
+/// Arguments		: ptrQueue = pointer to the queue.
+/// Return			: No. of items in the queue.
+unsigned int OSQueueCount(OS_QUEUE *ptrQueue)
+{
+	return ptrQueue->unHead - ptrQueue->unTail;
+}
+
+/// Function name	: OSQueueSpace()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Get the no. of free item spaces in a queue, see OSQueueCount().
+/// Arguments		: ptrQueue = pointer to the queue.
+/// Return			: No. of items which can be put into the queue.
+unsigned int OSQueueSpace(OS_QUEUE *ptrQueue)
+{
+	return ptrQueue->unMask + 1 - (ptrQueue->unHead - ptrQueue->unTail);
+}
+
+/// Function name	: OSTraceEvent()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Record an event with the DWT cycle counter as time stamp in the trace
+///                   ring buffer.  Normally called through the macro __OS_TRACE_EVENT(), which
+///                   skips the call if the event code is not enabled in gunTraceMask.  This
+///                   routine can be called from a task or from an interrupt service routine,
+///                   the interrupts are only disabled while the record is written, about 20
+///                   processor cycles.  If the buffer is full the event is counted in 
+///                   gunTraceLost and discarded, the earlier records are never overwritten.
+/// Arguments		: unEvent = event code, __TRACE_xxx.
+///                   unData8 = 8-bits data, only the lower 8 bits are recorded.
+///                   unData16 = 16-bits data, only the lower 16 bits are recorded.
+/// Return			: None.
+void OSTraceEvent(unsigned int unEvent, unsigned int unData8, unsigned int unData16)
+{
+#ifdef __OS_TRACE
+	unsigned int unPrimask = __OS_IRQ_SAVE();
+	unsigned int unHead;
+	OS_TRACE_RECORD *ptrRecord;
+
+	__disable_irq();
+	unHead = gunTraceHead;
+	if (unHead - gunTraceTail < __OS_TRACE_LENGTH)
+	{
+		ptrRecord = &gstrcTrace[unHead & (__OS_TRACE_LENGTH - 1)];
+		ptrRecord->unTime = __OS_CYCLE_COUNT();
+		ptrRecord->bytEvent = (uint8_t) unEvent;
+		ptrRecord->bytData = (uint8_t) unData8;
+		ptrRecord->unData = (uint16_t) unData16;
+		gunTraceHead = unHead + 1;
+	}
+	else
+	{
+		gunTraceLost++;							// Buffer full.
+	}
+	__OS_IRQ_RESTORE(unPrimask);
+#endif
+}
+
+/// Function name	: OSTraceControl()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Select the event codes to be recorded in the execution trace.  Must be
+///                   called after OSInit(), which turns the recording off.  The UART0 line 
+///                   only carries about 1400 records per second at 115.2 kbps, so the 
+///                   frequent events, e.g. __TRACE_MASK_QUEUE, are best enabled for a short
+///                   period only, or the records which do not fit are lost.
+/// Arguments		: unMask = bit n set to record event code n, e.g. __TRACE_MASK_KERNEL | 
+///                   __TRACE_MASK_ISR, 0 to stop the recording.
+/// Return			: None.
+void OSTraceControl(unsigned int unMask)
+{
+	gunTraceMask = unMask;
+}
+
+/// Function name	: OSTraceChunk()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Get the oldest records in the trace buffer for sending, and fill in the
+///                   8 bytes chunk header which precedes them on the line:
+///                   0xA5, 0x5A, no. of records, MCK in MHz, gunTraceLost (lower byte first,
+///                   lower 16 bits), sequence no., checksum = ~(sum of the first 7 bytes).
+///                   The records stay in the buffer until OSTraceRelease() is called, so they
+///                   can be sent by the PDC directly.  The records returned are contiguous in
+///                   memory, thus fewer than unMax may be returned at the end of the buffer.
+///                   This routine is called by the consumer of the trace only.
+/// Arguments		: ptrHeader = storage for the 8 bytes chunk header.
+///                   ptrRecord = to return the pointer to the first record.
+///                   unMax = max. no. of records, up to 255.
+/// Return			: No. of records, 0 if the trace buffer is empty.
+unsigned int OSTraceChunk(uint8_t *ptrHeader, OS_TRACE_RECORD **ptrRecord, unsigned int unMax)
+{
+#ifdef __OS_TRACE
+	unsigned int unTail = gunTraceTail;
+	unsigned int unIndex = unTail & (__OS_TRACE_LENGTH - 1);
+	unsigned int unCount = gunTraceHead - unTail;
+	unsigned int unSum = 0;
+	int ni;
+
+	if (unCount > __OS_TRACE_LENGTH - unIndex)
+	{
+		unCount = __OS_TRACE_LENGTH - unIndex;	// Stop at the end of the buffer.
+	}
+	if (unCount > unMax)
+	{
+		unCount = unMax;
+	}
+	if (unCount == 0)
+	{
+		return 0;
+	}
+	__OS_MEMORY_BARRIER();						// Index is read before the records.
+	*ptrRecord = &gstrcTrace[unIndex];
+	ptrHeader[0] = 0xA5;
+	ptrHeader[1] = 0x5A;
+	ptrHeader[2] = (uint8_t) unCount;
+	ptrHeader[3] = (uint8_t) (gunMCKHz / 1000000);
+	ptrHeader[4] = (uint8_t) gunTraceLost;
+	ptrHeader[5] = (uint8_t) (gunTraceLost >> 8);
+	ptrHeader[6] = gbytTraceSeq++;
+	for (ni = 0; ni < 7; ni++)
+	{
+		unSum += ptrHeader[ni];
+	}
+	ptrHeader[7] = (uint8_t) ~unSum;
+	return unCount;
+#else
+	return 0;
+#endif
+}
+
+/// Function name	: OSTraceRelease()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Free the space of the records returned by OSTraceChunk(), once they
+///                   have been sent.
+/// Arguments		: unCount = no. of records returned by OSTraceChunk().
+/// Return			: None.
+void OSTraceRelease(unsigned int unCount)
+{
+#ifdef __OS_TRACE
+	__OS_MEMORY_BARRIER();						// Records are sent before their space is released.
+	gunTraceTail = gunTraceTail + unCount;
+#endif
+}
+
+#ifdef __OS_LOG
+// Function name	: OSLogVarint()
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Purpose			: Store an unsigned integer in 7-bits groups, lower group first, bit 7 set
+//                    on all but the last byte.  Values below 128 take 1 byte, the largest 5.
+// Arguments		: ptrData = where to store the bytes.
+//                    unValue = the integer.
+// Return			: Pointer to the byte after the last one stored.
+static uint8_t *OSLogVarint(uint8_t *ptrData, uint32_t unValue)
+{
+	while (unValue >= 0x80)
+	{
+		*ptrData++ = (uint8_t) (unValue | 0x80);
+		unValue = unValue >> 7;
+	}
+	*ptrData++ = (uint8_t) unValue;
+	return ptrData;
+}
+#endif
+
+/// Function name	: OSLogWrite()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Record a log message in the log ring buffer, normally called through the
+///                   macro __OS_LOG_MSG().  The record is: no. of arguments (1 byte), offset of
+///                   the format string (2 bytes, lower byte first, see __OS_LOG_SECTION_MAX),
+///                   clock ticks since the previous record and the arguments, the last two as
+///                   in OSLogVarint().  A message with 2 small arguments takes 6 bytes on the
+///                   line, instead of 20 to 60 bytes of text, and no formatting is done on the
+///                   target.  The arguments are encoded first, the interrupts are only disabled
+///                   while the record is copied.  This routine can be called from a task or from
+///                   an interrupt service routine.  If the buffer is full the message is counted
+///                   in gunLogLost and discarded.  A record never crosses a multiple of
+///                   __OS_LOG_CHUNK bytes, the unused end of a block is skipped by OSLogChunk().
+/// Arguments		: unFormat = address of the format string in __OS_LOG_SECTION, i.e. its offset.
+///                   unCount = no. of arguments, 0 to 4.
+///                   unArg0 to unArg3 = arguments.
+/// Return			: None.
+void OSLogWrite(unsigned int unFormat, unsigned int unCount, uint32_t unArg0, uint32_t unArg1, uint32_t unArg2, uint32_t unArg3)
+{
+#ifdef __OS_LOG
+	uint8_t bytArg[20];
+	uint8_t bytTick[5];
+	uint8_t *ptrArg = bytArg;
+	uint8_t *ptrTick;
+	uint8_t *ptrRecord;
+	unsigned int unPrimask;
+	unsigned int unHead;
+	unsigned int unTick;
+	unsigned int unLength;
+	unsigned int unOffset;
+	unsigned int unSkip;
+	unsigned int ni;
+
+	if (unCount > 0)
+	{
+		ptrArg = OSLogVarint(ptrArg, unArg0);
+		if (unCount > 1)
+		{
+			ptrArg = OSLogVarint(ptrArg, unArg1);
+			if (unCount > 2)
+			{
+				ptrArg = OSLogVarint(ptrArg, unArg2);
+				if (unCount > 3)
+				{
+					ptrArg = OSLogVarint(ptrArg, unArg3);
+				}
+			}
+		}
+	}
+	unPrimask = __OS_IRQ_SAVE();
+	__disable_irq();
+	unTick = gunClockTick;
+	ptrTick = OSLogVarint(bytTick, unTick - gunLogTick);
+	unLength = 3 + (ptrTick - bytTick) + (ptrArg - bytArg);
+	unHead = gunLogHead;
+	unOffset = unHead & (__OS_LOG_CHUNK - 1);
+	unSkip = (unOffset + unLength > __OS_LOG_CHUNK) ? (__OS_LOG_CHUNK - unOffset) : 0;	// Start a new block.
+	if (unHead + unSkip + unLength - gunLogTail <= __OS_LOG_LENGTH)
+	{
+		unHead = unHead + unSkip;
+		ptrRecord = &gbytLog[unHead & (__OS_LOG_LENGTH - 1)];
+		ptrRecord[0] = (uint8_t) unCount;
+		ptrRecord[1] = (uint8_t) unFormat;
+		ptrRecord[2] = (uint8_t) (unFormat >> 8);
+		ptrRecord = ptrRecord + 3;
+		for (ni = 0; ni < (unsigned int)(ptrTick - bytTick); ni++)
+		{
+			*ptrRecord++ = bytTick[ni];
+		}
+		for (ni = 0; ni < (unsigned int)(ptrArg - bytArg); ni++)
+		{
+			*ptrRecord++ = bytArg[ni];
+		}
+		gbytLogFill[(unHead & (__OS_LOG_LENGTH - 1)) / __OS_LOG_CHUNK] = (uint8_t) ((unHead & (__OS_LOG_CHUNK - 1)) + unLength);
+		gunLogTick = unTick;
+		__OS_MEMORY_BARRIER();					// Record is stored before it is published.
+		gunLogHead = unHead + unLength;
+	}
+	else
+	{
+		gunLogLost++;							// Buffer full.
+	}
+	__OS_IRQ_RESTORE(unPrimask);
+#endif
+}
+
+/// Function name	: OSLogChunk()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Get the oldest bytes in the log buffer for sending, and fill in the 8 bytes 
+///                   chunk header which precedes them on the line:
+///                   0xA5, 0x5B, no. of bytes, __NUM_SYSTEMTICK_MSEC, gunLogLost (lower byte 
+///                   first, lower 16 bits), sequence no., checksum = ~(sum of the first 7 bytes).
+///                   A chunk is one block of the buffer at most, so it holds whole records.  The
+///                   block being filled is only sent once half full, or __OS_LOG_FLUSH ticks
+///                   after the previous chunk, so that a few records share the header.  The
+///                   bytes stay in the buffer until OSLogRelease() is called, so they can be sent
+///                   by the PDC directly.  This routine is called by the consumer of the log only.
+/// Arguments		: ptrHeader = storage for the 8 bytes chunk header.
+///                   ptrData = to return the pointer to the first byte.
+/// Return			: No. of bytes, 0 if the log buffer is empty.
+unsigned int OSLogChunk(uint8_t *ptrHeader, uint8_t **ptrData)
+{
+#ifdef __OS_LOG
+	unsigned int unTail = gunLogTail;
+	unsigned int unHead = gunLogHead;
+	unsigned int unEnd;
+	unsigned int unSum = 0;
+	int ni;
+
+	__OS_MEMORY_BARRIER();						// Index is read before the records.
+	if ((((unHead ^ unTail) & ~(__OS_LOG_CHUNK - 1)) != 0) &&
+		((unTail & (__OS_LOG_CHUNK - 1)) >= gbytLogFill[(unTail & (__OS_LOG_LENGTH - 1)) / __OS_LOG_CHUNK]))
+	{
+		unTail = (unTail | (__OS_LOG_CHUNK - 1)) + 1;	// Block sent, skip its unused end.
+		gunLogTail = unTail;
+	}
+	if (((unHead ^ unTail) & ~(__OS_LOG_CHUNK - 1)) == 0)
+	{
+		unEnd = unHead;							// Block being filled, wait for more records.
+		if ((unEnd - unTail < __OS_LOG_CHUNK / 2) && (gunClockTick - gunLogSent < __OS_LOG_FLUSH))
+		{
+			return 0;
+		}
+	}
+	else
+	{
+		unEnd = (unTail & ~(__OS_LOG_CHUNK - 1)) + gbytLogFill[(unTail & (__OS_LOG_LENGTH - 1)) / __OS_LOG_CHUNK];
+	}
+	if (unEnd == unTail)
+	{
+		return 0;
+	}
+	gunLogSent = gunClockTick;
+	*ptrData = &gbytLog[unTail & (__OS_LOG_LENGTH - 1)];
+	ptrHeader[0] = 0xA5;
+	ptrHeader[1] = 0x5B;
+	ptrHeader[2] = (uint8_t) (unEnd - unTail);
+	ptrHeader[3] = (uint8_t) __NUM_SYSTEMTICK_MSEC;
+	ptrHeader[4] = (uint8_t) gunLogLost;
+	ptrHeader[5] = (uint8_t) (gunLogLost >> 8);
+	ptrHeader[6] = gbytLogSeq++;
+	for (ni = 0; ni < 7; ni++)
+	{
+		unSum += ptrHeader[ni];
+	}
+	ptrHeader[7] = (uint8_t) ~unSum;
+	return unEnd - unTail;
+#else
+	return 0;
+#endif
+}
+
+/// Function name	: OSLogRelease()
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Free the space of the bytes returned by OSLogChunk(), once they have been
+///                   sent.
+/// Arguments		: unCount = no. of bytes returned by OSLogChunk().
+/// Return			: None.
+void OSLogRelease(unsigned int unCount)
+{
+#ifdef __OS_LOG
+	__OS_MEMORY_BARRIER();						// Bytes are sent before their space is released.
+	gunLogTail = gunLogTail + unCount;
+#endif
+}
@@ -9,8 +9,8 @@
 //
 // Filename			: os_SAM4S_APIs.c
 // Author			: Fabian Kung
-// Last modified	: 18 May 2018
-// Version			: 1.02
+// Last modified	: 16 Oct 2026
+// Version			: 1.03
 // Description		: This file contains the implementation of all the important routines
 //                    used by the OS and the user routines. Most of the routines deal with
 //                    micro-controller specifics resources, thus the functions have to be
@@ -26,6 +26,15 @@
 #include "osmain.h"
 
 // --- GLOBAL AND EXTERNAL VARIABLES DECLARATION ---
+unsigned int gunIdleCount;			// Accumulated idle time of the processor core in SysTick counts, over
+									// the current averaging window.
+volatile int gnCPUIdle;				// Processor idle time in percent, averaged over the last
+									// __IDLE_WINDOW_TICK system ticks.  100 - gnCPUIdle gives the CPU load.
+int gnIdleWindow;					// System tick counter for the idle time averaging window.
+int gnCriticalNest;					// Nesting level of OSEnterCritical().
+volatile unsigned int gunMCKHz = __FMCK_HZ;	// Current master clock (MCK) frequency in Hz.
+unsigned int gunSysTickCount = __SYSTICKCOUNT;	// Current SysTick reload value.
+OS_CLOCK_CLIENT *gptrClockClient;	// List of drivers to be notified when MCK changes.
 
 
 // --- FUNCTIONS' PROTOTYPES ---
@@ -49,7 +58,10 @@
 //                    WDV of the WDT_MR register. The default value is 0xFFF.  The Watchdog Timer is
 //                    driven by internal slow clock of 32.768 kHz with pre-scaler of 128, which work
 //                    out to 16 seconds timeout period.
-inline void ClearWatchDog(void)
+//                    Note: 16 Oct 2026, this function is no longer declared inline, as it is 
+//                    called from other files.  The C++ compiler used in the host simulation 
+//                    build does not emit an external definition of an inline function.
+void ClearWatchDog(void)
 {
 	WDT->WDT_CR = (WDT->WDT_CR) | WDT_CR_WDRSTT | WDT_CR_KEY_PASSWD;	// Reload the Watchdog Timer.
 																		// Note that to prevent accidental
@@ -98,24 +110,28 @@ void SAM4S_Init()
 	// For fcore = 120 MHz, FWS = 5, e.g. 6 wait states.
 	// For fcore = 4 MHz, FWS = 0, e.g. 1 wait state.
 	// For fcore = 8-20 MHz, FWS = 1, e.g. 2 wait states.
-	EFC0->EEFC_FMR = EEFC_FMR_FWS(5);
+	// Note: 16 Oct 2026, FWS and the PLLB settings are now derived from __FMCK_TARGET_MHz in "osmain.h".
+	EFC0->EEFC_FMR = EEFC_FMR_FWS(__FLASH_FWS);
 	#if defined(ID_EFC1)
-	EFC1->EEFC_FMR = EEFC_FMR_FWS(5);
+	EFC1->EEFC_FMR = EEFC_FMR_FWS(__FLASH_FWS);
 	#endif
 
 	// Routines to enable PLLB and use this as main clock via the Power Management Controller (PMC)
 	PMC->CKGR_PLLBR = (PMC->CKGR_PLLBR & ~CKGR_PLLBR_PLLBCOUNT_Msk) | CKGR_PLLBR_PLLBCOUNT(100) | CKGR_PLLBR_DIVB(0) | CKGR_PLLBR_MULB(0);	// Disable PLLB first.
-	PMC->CKGR_PLLBR = (PMC->CKGR_PLLBR & ~CKGR_PLLBR_PLLBCOUNT_Msk) | CKGR_PLLBR_PLLBCOUNT(100) | CKGR_PLLBR_DIVB(2) | CKGR_PLLBR_MULB(30);	// Enable PLLB.
+	PMC->CKGR_PLLBR = (PMC->CKGR_PLLBR & ~CKGR_PLLBR_PLLBCOUNT_Msk) | CKGR_PLLBR_PLLBCOUNT(100) | CKGR_PLLBR_DIVB(__PLLB_DIVB) | CKGR_PLLBR_MULB(__PLLB_MULB);	// Enable PLLB.
 	// Here fxtal (crystal oscillator) = 8 MHz
-	// Thus fin = fxtal / DIVB = 8/2 = 4 MHz
-	// fPLLB = fin x MULB = 4 * 30 = 120 MHz.
+	// Thus fin = fxtal / DIVB = 8/1 = 8 MHz
+	// fPLLB = fin x (MULB + 1) = 8 * 15 = 120 MHz.
 	// fcore = fPLLB = 120 MHz.
+	// Note: 16 Oct 2026, the PLL multiplies by MULB + 1.  The previous setting of DIVB = 2, MULB = 30
+	// actually produced 124 MHz.
 	while ((PMC->PMC_SR & PMC_SR_LOCKB) == 0) {}				// Wait until PLLB is locked.
 	
-	// fcore = fPLLB / pre-scaler = fPLLB / 1 = fPLLB = 120 MHz.
-	// Note: we can also set fPLLB to 240 MHz and set pre-scalar to 2 as follows:
-	//PMC->PMC_MCKR = (PMC->PMC_MCKR & ~PMC_MCKR_PRES_Msk) | PMC_MCKR_PRES_CLK_2;		// Set pre-scalar to divide-by-2.
-	//while ((PMC->PMC_SR & PMC_SR_MCKRDY) == 0) {}				// Wait until Master Clock is ready.
+	// fcore = fPLLB / pre-scaler.  For fcore below 80 MHz fPLLB is set to a multiple of fcore, e.g.
+	// fPLLB = 96 MHz and pre-scaler = 2 for fcore = 48 MHz.  The pre-scaler is set before the clock
+	// source is switched to PLLB.
+	PMC->PMC_MCKR = (PMC->PMC_MCKR & ~PMC_MCKR_PRES_Msk) | __PLLB_PRES_BITS;		// Set pre-scalar.
+	while ((PMC->PMC_SR & PMC_SR_MCKRDY) == 0) {}				// Wait until Master Clock is ready.
 
 	PMC->PMC_MCKR = (PMC->PMC_MCKR & ~PMC_MCKR_CSS_Msk) | PMC_MCKR_CSS_PLLB_CLK; 		// Change master clock source to PLLB.
 	while ((PMC->PMC_SR & PMC_SR_MCKRDY) == 0) {}				// Wait until Master Clock is ready.
@@ -159,14 +175,30 @@ void SAM4S_Init()
 	// Note: 16 Oct 2015, the following is not needed, by default SysTick is being triggered with processor clock.
 	// The SysTick module is triggered from the output of the Master Clock (MCK) divided by 8.  Since MCK = fCore,
 	// the timeout for SysTick = [SysTick Value] x 8 x (1/fCore).
-	// For fCore = 120 MHz, SysTick Value = 100
+	// For fCore = 120 MHz, SysTick Value = 2499 for 6 system ticks per msec.
 	//SysTick->CTRL |= SysTick_CTRL_CLKSOURCE_Msk;	// Set this flag, indicate clock source for SysTick from the processor clock.
 	// End of note.
-	//SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;	// Enable SysTick exception request when count down to zero.
-	SysTick->LOAD = __SYSTICKCOUNT;	// Set reload value.
-	SysTick->VAL = __SYSTICKCOUNT;	// Reset current SysTick value.
+	gunMCKHz = __FMCK_HZ;
+	gptrClockClient = 0;
+	gunSysTickCount = __SYSTICKCOUNT;
+	SysTick->LOAD = gunSysTickCount;	// Set reload value.
+	SysTick->VAL = gunSysTickCount;	// Reset current SysTick value.
 	SysTick->CTRL = SysTick->CTRL & ~(SysTick_CTRL_COUNTFLAG_Msk);	// Clear Count Flag.
+	// 16 Oct 2026: The system tick is now interrupt driven, the task timers are updated in 
+	// SysTick_Handler().  This allows the core to sleep in OSIdle() when no task is due.
+	gunIdleCount = 0;
+	gnIdleWindow = 0;
+	gnCPUIdle = 0;
+	SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;	// Enable SysTick exception request when count down to zero.
 	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;	// Enable SysTick.
+
+#if defined(__OS_PROFILE) || defined(__OS_TRACE)
+	// Enable the processor cycle counter in the DWT unit for task profiling and time stamping
+	// the execution trace.
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;	// Enable the DWT unit.
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;		// Start the cycle counter.
+#endif
 	
 	// Enable the Cortex-M Cache Controller
 	if (((CMCC->CMCC_SR) & CMCC_SR_CSTS) == 0)	// Check the CSTS value, if 0 start the Cache Controller.
@@ -176,27 +208,383 @@ void SAM4S_Init()
 
 }
 
+/// Function name	: SysTick_Handler
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: SysTick exception handler, triggered once every system tick.  Here we
+///                   increment the RTOS clock tick, update the timer of each task and assert
+///                   gnRunTask if there is any task due to run.  The main loop will then wake
+///                   up from sleep and execute the due tasks.
+///                   Pin PB1 is set for the duration of the tick update to allow the timing
+///                   to be monitored with an oscilloscope.
+///                   Note: 16 Oct 2026, with __OS_PROFILE defined a task overflow is counted
+///                   and the task being executed is recorded, see OSProfileOverrun().
+///                   Note: 16 Oct 2026, the entry, the exit and the tick are recorded in the
+///                   execution trace when enabled.
+///                   Note: 16 Oct 2026, the task overflow is detected with gnTickDispatch, set
+///                   here only and cleared by the main loop.  gnRunTask is also asserted by
+///                   OSSignalEvent() between two ticks, so it does not tell whether the tasks
+///                   due at the previous tick have been executed.
+/// Arguments		: None
+/// Return			: None
+void SysTick_Handler(void)
+{
+#ifdef __OS_PROFILE
+	unsigned int unStart = __OS_CYCLE_COUNT();
+#endif
+
+	__OS_TRACE_EVENT(__TRACE_ISR_ENTER, SysTick_IRQn + 16, 0);
+
+	PIOB->PIO_SODR = PIO_SODR_P1;				// Set PB1.
+	if (gnTickDispatch == 1)					// If task overflow occur trap the controller
+	{											// indefinitely and turn on indicator LED1.
+#ifdef __OS_PROFILE
+		OSProfileOverrun();
+#else
+		while (1)
+		{
+			ClearWatchDog();					// Clear the Watch Dog Timer.
+			PIN_OSPROCE1_SET; 					// Turn on indicator LED1.
+		}
+#endif
+	}
+
+	gunClockTick++; 							// Increment RTOS clock tick counter.
+	__OS_TRACE_EVENT(__TRACE_TICK, 0, gunClockTick);
+	if (OSUpdateTaskTimer() > 0)				// Move the due tasks to the ready bitmap.
+	{
+		gnRunTask = 1;							// Assert gnRunTask if at least one task is due.
+		gnTickDispatch = 1;
+	}
+
+	gnIdleWindow++;								// Update the processor idle time statistic.
+	if (gnIdleWindow == __IDLE_WINDOW_TICK)
+	{
+		gnCPUIdle = ((gunIdleCount / __IDLE_WINDOW_TICK) * 100) / (gunSysTickCount + 1);
+		gunIdleCount = 0;
+		gnIdleWindow = 0;
+	}
+#ifdef __OS_PROFILE
+	OSProfileTick(__OS_CYCLE_COUNT() - unStart);
+#endif
+	PIOB->PIO_CODR = PIO_CODR_P1;				// Clear PB1.
+	__OS_TRACE_EVENT(__TRACE_ISR_EXIT, SysTick_IRQn + 16, 0);
+}
+
+/// Function name	: OSIdle
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Put the processor core into sleep mode with the WFI instruction until the
+///                   next interrupt, if no task is due to run.  The interrupts are disabled
+///                   while checking gnRunTask, so that a SysTick exception occurring just before
+///                   the WFI instruction is not missed (a pending interrupt will still wake
+///                   up the core from WFI even with PRIMASK set).  The time spent sleeping is
+///                   measured with the SysTick current value register and accumulated in 
+///                   gunIdleCount.
+///                   The core does not sleep either when a task has been made ready by 
+///                   OSSignalEvent() between two system ticks, gnRunTask is asserted instead.
+/// Arguments		: None
+/// Return			: None
+void OSIdle(void)
+{
+	unsigned int unStart;
+	unsigned int unEnd;
+
+	__disable_irq();
+	if (gunReadyGroup != 0)						// A task made ready by OSSignalEvent() after the
+	{											// last dispatch, run it instead of sleeping.
+		gnRunTask = 1;
+	}
+	else if (gnRunTask == 0)					// Only sleep if no task is due.
+	{
+		unStart = SysTick->VAL;
+		__WFI();								// Sleep until an interrupt is pending.
+		unEnd = SysTick->VAL;
+		if (unEnd <= unStart)					// SysTick counts down, check if it has been reloaded.
+		{
+			gunIdleCount += unStart - unEnd;
+		}
+		else
+		{
+			gunIdleCount += unStart + (gunSysTickCount + 1) - unEnd;
+		}
+	}
+	__enable_irq();								// The pending exception will be serviced here.
+}
+
 // Function name	: OSEnterCritical
 // Author			: Fabian Kung
-// Last modified	: 24 April 2007
+// Last modified	: 16 Oct 2026
 // Description		: Disable all processor interrupts for important tasks
 //					  involving Stacks, Program Counter other critical
-//	                  processor registers.
+//	                  processor registers.  Calls can be nested, the interrupts
+//                    are only enabled again by the outermost OSExitCritical().
 void OSEnterCritical(void)
 {
-
+	__disable_irq();
+	gnCriticalNest++;
 }											
 
 // Function name	: OSExitCritical
 // Author		: Fabian Kung
-// Last modified	: 24 April 2007
+// Last modified	: 16 Oct 2026
 // Description		: Enable all processor interrupts for important tasks.
 void OSExitCritical(void)
 {
- 
+	if (gnCriticalNest > 0)
+	{
+		gnCriticalNest--;
+	}
+	if (gnCriticalNest == 0)
+	{
+		__enable_irq();
+	}
 }											
 
 
+// Function name	: OSClockRegister
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Register a driver to be notified when the master clock is changed by
+//                    OSSetClock().  Registering the same client again has no effect.
+// Arguments		: ptrClient = pointer to the client, with ptrCallback set.
+// Return			: None.
+void OSClockRegister(OS_CLOCK_CLIENT *ptrClient)
+{
+	OS_CLOCK_CLIENT *ptrTemp;
+
+	OSEnterCritical();
+	for (ptrTemp = gptrClockClient; ptrTemp != 0; ptrTemp = ptrTemp->ptrNext)
+	{
+		if (ptrTemp == ptrClient)
+		{
+			OSExitCritical();
+			return;
+		}
+	}
+	ptrClient->ptrNext = gptrClockClient;
+	gptrClockClient = ptrClient;
+	OSExitCritical();
+}
+
+// Function name	: OSClockNotify
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Call the callback routine of all the registered clock clients.
+// Arguments		: unMCKHz = new master clock frequency.
+//                    nPhase = __OS_CLOCK_CHECK, __OS_CLOCK_PRE or __OS_CLOCK_POST.
+// Return			: 0 if all the clients accept the new clock, or are ready for it in the
+//                    __OS_CLOCK_PRE phase, non-zero otherwise.
+static int OSClockNotify(unsigned int unMCKHz, int nPhase)
+{
+	OS_CLOCK_CLIENT *ptrClient;
+	int nResult = 0;
+
+	for (ptrClient = gptrClockClient; ptrClient != 0; ptrClient = ptrClient->ptrNext)
+	{
+		nResult |= (*ptrClient->ptrCallback)(unMCKHz, nPhase);
+	}
+	return nResult;
+}
+
+#define _OS_PLL_LOCK_COUNT	2			// PLL lock time in 8 slow clock cycles, about 0.5 msec.
+#define _OS_DRAIN_LOOP		1000000		// Guard of the __OS_CLOCK_PRE loop, in case a transmitter is disabled.
+
+// Function name	: OSFlashWaitState
+// Author			: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Description		: Flash wait states (FWS) required at a given clock, one extra wait state
+//                    for every 20 MHz, same as __FLASH_FWS in "osmain.h".
+// Arguments		: unHz = clock frequency in Hz.
+// Return			: The value of the FWS field.
+static unsigned int OSFlashWaitState(unsigned int unHz)
+{
+	return (unHz - 1) / 20000000UL;
+}
+
+/// Function name	: OSSetClock
+/// Author			: Fabian Kung
+/// Last modified	: 16 Oct 2026
+/// Description		: Change the master clock (MCK) at run time, e.g. 120 MHz when busy and
+///                   12 MHz between bursts of activity.  MCK = fPLL / PRES, where PRES is the
+///                   smallest power of 2 that keeps fPLL within 80-240 MHz, and fPLL is
+///                   synthesized exactly from the crystal, same as at start-up (see "osmain.h").
+///                   The two PLLs are used alternately: the PLL not driving MCK is programmed
+///                   with the new frequency and allowed to lock while the tasks keep running,
+///                   then MCK is switched over in one step.  The sequence is:
+///                   0. Ask the clients if they can work at the new clock (__OS_CLOCK_CHECK),
+///                      e.g. a serial driver refuses a clock where its baud rate error would
+///                      exceed __BAUD_ERROR_MAX.
+///                   1. Program and lock the spare PLL (PLLA if MCK runs from PLLB, and vice
+///                      versa).
+///                   2. Notify the clients (__OS_CLOCK_PRE) with interrupts enabled, until
+///                      they all return 0, so that a serial driver can let the character being
+///                      sent finish.  Then disable interrupts.
+///                   3. Increase the flash wait states to cover the old, the intermediate and
+///                      the new clock.
+///                   4. Set the pre-scaler, then switch MCK to the spare PLL, and disable the
+///                      old PLL.
+///                   5. Reduce the flash wait states to suit the new clock.
+///                   6. Reload SysTick so that the system tick stays at 1/__NUM_SYSTEMTICK_MSEC
+///                      msec.  The remaining count of the current tick is scaled, so no
+///                      fraction of a tick is lost.
+///                   7. Notify the clients (__OS_CLOCK_POST) to recompute their baud rate
+///                      and clock divisors, and enable interrupts.
+///                   The interrupts are only disabled for steps 3 to 7, a few microseconds.
+///                   The PLL lock and the clients of step 2 may take longer than a system
+///                   tick, the ticks are still counted by SysTick_Handler() but gnTickDispatch
+///                   is cleared during these waits, so that they are not taken as a task
+///                   overflow.  Should be called from a task.
+/// Arguments		: unMCKHz = new master clock frequency in Hz, 1.25 to 120 MHz.
+/// Return			: 0 if success, 1 if the frequency cannot be synthesized from the crystal,
+///                   or the system tick cannot be kept within 0.1%, 2 if refused by a client.
+int OSSetClock(unsigned int unMCKHz)
+{
+	unsigned int unPres = 1;
+	unsigned int unPresBits = 0;
+	unsigned int unPLLHz;
+	unsigned int unOldPLLHz;
+	unsigned int unDiv;
+	unsigned int unMul = 0;
+	unsigned int unFWS;
+	unsigned int unReload;
+	unsigned int unRemain;
+	unsigned int unCSS;
+	unsigned int unCount;
+	unsigned long long ullTick;
+
+	if ((unMCKHz == 0) || (unMCKHz > 120000000UL))
+	{
+		return 1;
+	}
+	while ((unMCKHz * unPres) < 80000000UL)		// Pre-scaler.
+	{
+		unPres = unPres * 2;
+		unPresBits++;
+		if (unPresBits > 6)						// PRES = 64 max.
+		{
+			return 1;
+		}
+	}
+	unPLLHz = unMCKHz * unPres;
+	for (unDiv = 1; (__FXTAL_HZ / unDiv) >= 3000000UL; unDiv++)	// PLL input divider.
+	{
+		if (((__FXTAL_HZ % unDiv) == 0) && ((unPLLHz % (__FXTAL_HZ / unDiv)) == 0))
+		{
+			unMul = (unPLLHz / (__FXTAL_HZ / unDiv)) - 1;
+			break;
+		}
+	}
+	if ((unMul == 0) || (unMul > 62))
+	{
+		return 1;
+	}
+	unReload = (((unMCKHz / 8) + 500 * __NUM_SYSTEMTICK_MSEC) / (1000 * __NUM_SYSTEMTICK_MSEC)) - 1;
+	ullTick = (unsigned long long)(unReload + 1) * 8 * 1000 * __NUM_SYSTEMTICK_MSEC;
+	if ((unReload < 100) || (ullTick > unMCKHz + unMCKHz / 1000) || (ullTick < unMCKHz - unMCKHz / 1000))
+	{
+		return 1;
+	}
+
+	if (OSClockNotify(unMCKHz, __OS_CLOCK_CHECK) != 0)
+	{
+		return 2;
+	}
+
+	// Lock the spare PLL on the new frequency.
+	unCSS = PMC->PMC_MCKR & PMC_MCKR_CSS_Msk;
+	if (unCSS == PMC_MCKR_CSS_PLLB_CLK)
+	{
+		PMC->CKGR_PLLAR = CKGR_PLLAR_ONE | CKGR_PLLAR_PLLACOUNT(_OS_PLL_LOCK_COUNT) | CKGR_PLLAR_DIVA(0) | CKGR_PLLAR_MULA(0);
+		PMC->CKGR_PLLAR = CKGR_PLLAR_ONE | CKGR_PLLAR_PLLACOUNT(_OS_PLL_LOCK_COUNT) | CKGR_PLLAR_DIVA(unDiv) | CKGR_PLLAR_MULA(unMul);
+		while ((PMC->PMC_SR & PMC_SR_LOCKA) == 0)
+		{
+			gnTickDispatch = 0;
+		}
+	}
+	else
+	{
+		PMC->CKGR_PLLBR = CKGR_PLLBR_PLLBCOUNT(_OS_PLL_LOCK_COUNT) | CKGR_PLLBR_DIVB(0) | CKGR_PLLBR_MULB(0);
+		PMC->CKGR_PLLBR = CKGR_PLLBR_PLLBCOUNT(_OS_PLL_LOCK_COUNT) | CKGR_PLLBR_DIVB(unDiv) | CKGR_PLLBR_MULB(unMul);
+		while ((PMC->PMC_SR & PMC_SR_LOCKB) == 0)
+		{
+			gnTickDispatch = 0;
+		}
+	}
+
+	unCount = _OS_DRAIN_LOOP;
+	while ((OSClockNotify(unMCKHz, __OS_CLOCK_PRE) != 0) && (unCount > 0))
+	{
+		unCount--;								// Wait for the clients to be ready.
+		gnTickDispatch = 0;
+	}
+
+	OSEnterCritical();
+
+	// Setting PRES first runs the old PLL through the new pre-scaler for a moment, the flash
+	// wait states must also cover this intermediate frequency.
+	unOldPLLHz = gunMCKHz << ((PMC->PMC_MCKR & PMC_MCKR_PRES_Msk) >> PMC_MCKR_PRES_Pos);
+	unFWS = OSFlashWaitState(gunMCKHz);
+	if (OSFlashWaitState(unMCKHz) > unFWS)
+	{
+		unFWS = OSFlashWaitState(unMCKHz);
+	}
+	if (OSFlashWaitState(unOldPLLHz / unPres) > unFWS)
+	{
+		unFWS = OSFlashWaitState(unOldPLLHz / unPres);
+	}
+	EFC0->EEFC_FMR = EEFC_FMR_FWS(unFWS);
+	#if defined(ID_EFC1)
+	EFC1->EEFC_FMR = EEFC_FMR_FWS(unFWS);
+	#endif
+
+	unRemain = SysTick->VAL;					// Remaining count of the current tick.
+	PMC->PMC_MCKR = (PMC->PMC_MCKR & ~PMC_MCKR_PRES_Msk) | (unPresBits << PMC_MCKR_PRES_Pos);
+	while ((PMC->PMC_SR & PMC_SR_MCKRDY) == 0) {}
+	if (unCSS == PMC_MCKR_CSS_PLLB_CLK)
+	{
+		PMC->PMC_MCKR = (PMC->PMC_MCKR & ~PMC_MCKR_CSS_Msk) | PMC_MCKR_CSS_PLLA_CLK;
+		while ((PMC->PMC_SR & PMC_SR_MCKRDY) == 0) {}
+		PMC->CKGR_PLLBR = CKGR_PLLBR_DIVB(0) | CKGR_PLLBR_MULB(0);				// Disable PLLB.
+	}
+	else
+	{
+		PMC->PMC_MCKR = (PMC->PMC_MCKR & ~PMC_MCKR_CSS_Msk) | PMC_MCKR_CSS_PLLB_CLK;
+		while ((PMC->PMC_SR & PMC_SR_MCKRDY) == 0) {}
+		PMC->CKGR_PLLAR = CKGR_PLLAR_ONE | CKGR_PLLAR_DIVA(0) | CKGR_PLLAR_MULA(0);	// Disable PLLA.
+	}
+
+	unFWS = OSFlashWaitState(unMCKHz);
+	EFC0->EEFC_FMR = EEFC_FMR_FWS(unFWS);
+	#if defined(ID_EFC1)
+	EFC1->EEFC_FMR = EEFC_FMR_FWS(unFWS);
+	#endif
+
+	// The remaining count is scaled to the new clock and loaded by clearing the current value,
+	// the counter reloads on the next SysTick clock without requesting the exception.  The
+	// full reload value is set once the counter has reloaded.
+	unRemain = (unsigned int)(((unsigned long long) unRemain * (unReload + 1)) / (gunSysTickCount + 1));
+	if (unRemain < 16)
+	{
+		unRemain = 16;
+	}
+	SysTick->LOAD = unRemain;
+	SysTick->VAL = 0;
+	while (SysTick->VAL == 0) {}
+	SysTick->LOAD = unReload;
+
+	gunMCKHz = unMCKHz;
+	gunSysTickCount = unReload;
+#ifdef __OS_PROFILE
+	gstrcKernelProfile.unTickCycle = (unReload + 1) * 8;
+#endif
+	__OS_TRACE_EVENT(__TRACE_CLOCK, 0, unMCKHz / 10000);
+	OSClockNotify(unMCKHz, __OS_CLOCK_POST);
+	gnTickDispatch = 0;							// A tick may have come after the last wait.
+	OSExitCritical();
+	return 0;
+}
+
 // Function name	: OSProce1
 // Author			: Fabian Kung
 // Last modified	: 20 Nov 2015
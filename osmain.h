@@ -31,25 +31,122 @@
 #define	PIN_LED2_CLEAR			PIOB->PIO_ODSR &= ~PIO_ODSR_P3			// Clear indicator LED2 driver pin, PB3.
 
 // --- Processor Clock and Kernel Cycle in microseconds ---
-// Note: Uncomment the required value for _TIMER1COUNT, and update the corresponding definition
-// for the constant _SYSTEMTICK_US, in microseconds.
+// Note: 16 Oct 2026, all clock dependent constants are now derived at compile time from the
+// crystal frequency __FXTAL_HZ and the target master clock __FMCK_TARGET_MHz.  To run the firmware
+// at another core frequency only __FMCK_TARGET_MHz needs to be changed, e.g. 48, 64 or 120 MHz.
+// The PLLB setting, flash wait states, SysTick reload value, baud rate generators and TWI
+// clock divisors follow.  Out of range settings are rejected with #error.
 
-#define	__FOSC_MHz              120             // Oscillator clock frequency in MHz.
-#define __FCORE_MHz             __FOSC_MHz*1.0  // Processor Core frequency = 120 MHz.
-#define __FPERIPHERAL_MHz		__FOSC_MHz*1.0	// Processor Peripheral Clock frequency = 120 MHz.
-#define	__TCLK_US               0.008333        // Minimum duration to execute 1 instruction
-                                                // Tclk = 1/120000000 = 8.333 nsec.
-                                                
+#define __FXTAL_HZ              8000000         // Main crystal oscillator frequency in Hz.
+#define __FMCK_TARGET_MHz       120             // Master clock (MCK) frequency in MHz, up to 120 MHz.
+
+#define __FMCK_HZ               (__FMCK_TARGET_MHz*1000000UL)	// Master clock = core clock = peripheral clock.
+
+// PLLB: fPLLB = (fxtal / DIVB) x (MULB + 1), 80 <= fPLLB <= 240 MHz, 3 <= fxtal / DIVB <= 32 MHz.
+// MCK = fPLLB / PRES.  Below 80 MHz the PLLB runs at a multiple of MCK and the pre-scaler divides
+// it down.
+#if (__FMCK_HZ >= 80000000UL)
+#define __PLLB_PRES             1
+#define __PLLB_PRES_BITS        PMC_MCKR_PRES_CLK_1
+#elif (__FMCK_HZ >= 40000000UL)
+#define __PLLB_PRES             2
+#define __PLLB_PRES_BITS        PMC_MCKR_PRES_CLK_2
+#elif (__FMCK_HZ >= 20000000UL)
+#define __PLLB_PRES             4
+#define __PLLB_PRES_BITS        PMC_MCKR_PRES_CLK_4
+#else
+#error "osmain.h: __FMCK_TARGET_MHz below 20 MHz is not supported by the PLLB configuration."
+#endif
+#define __FPLLB_HZ              (__FMCK_HZ*__PLLB_PRES)
+
+// Use the largest PLL input frequency that divides fPLLB exactly.
+#if ((__FPLLB_HZ % __FXTAL_HZ) == 0) && (__FXTAL_HZ <= 32000000UL)
+#define __PLLB_DIVB             1
+#elif ((__FPLLB_HZ % (__FXTAL_HZ/2)) == 0) && ((__FXTAL_HZ/2) >= 3000000UL)
+#define __PLLB_DIVB             2
+#elif ((__FPLLB_HZ % (__FXTAL_HZ/4)) == 0) && ((__FXTAL_HZ/4) >= 3000000UL)
+#define __PLLB_DIVB             4
+#else
+#error "osmain.h: __FMCK_TARGET_MHz cannot be synthesized exactly from __FXTAL_HZ by PLLB."
+#endif
+#define __PLLB_MULB             ((__FPLLB_HZ/(__FXTAL_HZ/__PLLB_DIVB)) - 1)	// Value of the MULB field.
+
+#if (__FMCK_HZ > 120000000UL)
+#error "osmain.h: master clock above 120 MHz."
+#endif
+#if (__FPLLB_HZ < 80000000UL) || (__FPLLB_HZ > 240000000UL)
+#error "osmain.h: PLLB output frequency out of range."
+#endif
+#if (__PLLB_MULB > 62)
+#error "osmain.h: PLLB multiplier out of range."
+#endif
+
+// Flash wait states, one extra wait state for every 20 MHz of MCK (VDDCORE = 1.2V).
+// For fcore = 120 MHz, FWS = 5, e.g. 6 wait states.
+#define __FLASH_FWS             ((__FMCK_HZ - 1)/20000000UL)
+
+// Legacy constants, kept for user codes.
+#define	__FOSC_MHz              __FMCK_TARGET_MHz               // Oscillator clock frequency in MHz.
+#define __FCORE_MHz             (__FOSC_MHz*1.0)                // Processor Core frequency.
+#define __FPERIPHERAL_MHz		(__FOSC_MHz*1.0)                // Processor Peripheral Clock frequency.
+#define	__TCLK_US               (1.0/__FOSC_MHz)                // Minimum duration to execute 1 instruction,
+                                                                // Tclk = 1/120000000 = 8.333 nsec.
 
-#define __SYSTICKCOUNT          2500            // No. of Tcyc for SysTick to expire.  The SysTick
-												// is triggered by the Master Clock (MCK) divided by 8.
-												// This value corresponds with 20000 single cycle 
-												// instruction cycles executed by the ARM core.
-												
-#define	__SYSTEMTICK_US         166.67          // System_Tick = _SYSTICKCOUNT x Tclk_US x 8
-									
 #define __NUM_SYSTEMTICK_MSEC         6         // Requires 6 system ticks to hit 1 msec period.
 
+#define __SYSTICKCOUNT          ((((__FMCK_HZ/8) + 500*__NUM_SYSTEMTICK_MSEC)/(1000*__NUM_SYSTEMTICK_MSEC)) - 1)
+												// No. of Tcyc for SysTick to expire.  The SysTick
+												// is triggered by the Master Clock (MCK) divided by 8.
+												// This value corresponds with 20000 single cycle
+												// instruction cycles executed by the ARM core at 120 MHz.
+#if (__SYSTICKCOUNT > 0xFFFFFF) || (__SYSTICKCOUNT < 100)
+#error "osmain.h: SysTick reload value out of range."
+#endif
+// The system tick must be within 0.1% of 1/__NUM_SYSTEMTICK_MSEC msec.
+#if ((((__SYSTICKCOUNT+1)*8*1000ULL*__NUM_SYSTEMTICK_MSEC) > (__FMCK_HZ + __FMCK_HZ/1000)) || \
+	(((__SYSTICKCOUNT+1)*8*1000ULL*__NUM_SYSTEMTICK_MSEC) < (__FMCK_HZ - __FMCK_HZ/1000)))
+#error "osmain.h: system tick period error exceeds 0.1%."
+#endif
+
+#define	__SYSTEMTICK_US         ((__SYSTICKCOUNT+1)*8.0/__FOSC_MHz)	// System_Tick = _SYSTICKCOUNT x Tclk_US x 8
+
+// Baud rate generators of UART and USART, rounded to the nearest divisor.
+// UART: Baudrate = MCK/(16 x CD).  USART with OVER = 1 and the fractional part FP (0 to 7):
+// Baudrate = MCK/(8 x CD + FP), i.e. the divisor __USART_DIV = 8 x CD + FP has a resolution of
+// 1/8, which keeps the error small up to several Mbps.
+// The *_CD(mck, bps) forms are also used at run time after the master clock is changed.
+#define __UART_CD(mck, bps)     (((mck) + 8*(bps))/(16*(bps)))
+#define __USART_DIV(mck, bps)   (((mck) + (bps)/2)/(bps))
+#define __USART_CD(mck, bps)    (__USART_DIV((mck), (bps)) >> 3)
+#define __USART_FP(mck, bps)    (__USART_DIV((mck), (bps)) & 7)
+#define __UART_BRGR(bps)        __UART_CD(__FMCK_HZ, (bps))
+#define __USART_BRGR(bps)       __USART_CD(__FMCK_HZ, (bps))
+#define __BAUD_ERROR_PERMILLE(actual, bps)	((((actual) > (bps)) ? ((actual) - (bps)) : ((bps) - (actual)))*1000/(bps))
+#define __UART_BAUD_ERROR(bps)  __BAUD_ERROR_PERMILLE(__FMCK_HZ/(16*__UART_BRGR(bps)), (bps))
+#define __USART_BAUD_ERROR(bps) __BAUD_ERROR_PERMILLE(__FMCK_HZ/__USART_DIV(__FMCK_HZ, (bps)), (bps))
+#define __BAUD_ERROR_MAX        20              // Maximum baud rate error in 0.1%, i.e. 2.0%.
+
+#define __IDLE_WINDOW_TICK      (1000*__NUM_SYSTEMTICK_MSEC)	// No. of system ticks over which the processor idle
+												// time is averaged, about 1 second.
+
+#define __OS_CLZ(x)             __CLZ(x)        // Count leading zero instruction, used to find the
+												// ready task with the lowest index.
+
+#define __OS_CYCLE_COUNT()      (DWT->CYCCNT)   // Processor cycle counter of the Data Watchpoint and
+												// Trace (DWT) unit, used for task profiling.
+#define __TICK_CYCLE            ((__SYSTICKCOUNT+1)*8)	// No. of processor cycles in one system tick.
+
+#define __OS_MEMORY_BARRIER()   __DMB()         // Data memory barrier, orders the access to the data
+												// and the index of a queue.
+
+#define __OS_IRQ_SAVE()         __get_PRIMASK() // Get the interrupt mask, used with __disable_irq() and
+#define __OS_IRQ_RESTORE(x)     __set_PRIMASK(x)	// __OS_IRQ_RESTORE() for a short critical section which
+												// can also be entered from an interrupt service routine.
+
+#ifndef __OS_LOG_SECTION						// Section of the format strings of the tokenized log, 
+#define __OS_LOG_SECTION        ".os_log,\"\",%progbits @"	// kept in the ELF file but not loaded
+#endif											// into the flash, "@" hides the flags added by GCC.
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //  END OF CODES SPECIFIC TO ARM CORTEX-M4 MICROCONTROLLER  //////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -59,7 +156,49 @@
 #define	__OS_VER				2           // RTOS/Scheduler version, need to be integer (ANSI C preprocessor
 											// expression requires integer). 
 
-#define	__MAXTASK				12			// Maximum no. of concurrent tasks supported.
+#define	__MAXTASK				256			// Maximum no. of concurrent tasks supported, up to 1024.
+#define __TIMER_WHEEL_SIZE		64			// No. of slots in the timer wheel of the Scheduler, must
+											// be a power of 2.
+#define __READY_MAP_WORD		((__MAXTASK + 31)/32)	// No. of 32-bits words in the ready bitmap.
+#define __TASK_NONE				0			// End of list marker in the timer wheel and the free list.
+
+//#define __OS_PROFILE						// Uncomment, or build with -D__OS_PROFILE, to add the task
+											// profiling codes.  With profiling a tick overrun is counted
+											// instead of trapping the controller.
+#define __PROFILE_STATE			32			// No. of bins in the state histogram of the profiled task,
+											// the states above this are counted in the last bin.
+
+//#define __OS_TRACE						// Uncomment, or build with -D__OS_TRACE, to add the execution
+											// trace codes.  Nothing is recorded until OSTraceControl()
+											// is called.
+#define __OS_TRACE_LENGTH		512			// No. of records in the trace ring buffer, must be a power of 2.
+#define __OS_TRACE_CHUNK		32			// Max. no. of records sent in one UART0 PDC transfer, up to 255.
+
+#if (__OS_TRACE_LENGTH & (__OS_TRACE_LENGTH-1)) != 0
+#error "__OS_TRACE_LENGTH must be a power of 2."
+#endif
+#if (__OS_TRACE_CHUNK > 255) || (__OS_TRACE_CHUNK > __OS_TRACE_LENGTH)
+#error "__OS_TRACE_CHUNK cannot exceed 255 or __OS_TRACE_LENGTH."
+#endif
+
+//#define __OS_LOG							// Uncomment, or build with -D__OS_LOG, to add the tokenized
+											// log codes, otherwise __OS_LOG_MSG() compiles to nothing.
+#define __OS_LOG_LENGTH			1024		// Size of the log ring buffer in bytes, must be a power of 2.
+#define __OS_LOG_CHUNK			128			// Max. no. of bytes sent in one UART0 PDC transfer, must be 
+											// a power of 2, a log record never crosses a multiple of it.
+#define __OS_LOG_FLUSH			(10*__NUM_SYSTEMTICK_MSEC)	// A block which is not full is sent after this
+											// no. of ticks, so that the chunk header is shared.
+
+#if ((__OS_LOG_LENGTH & (__OS_LOG_LENGTH-1)) != 0) || ((__OS_LOG_CHUNK & (__OS_LOG_CHUNK-1)) != 0)
+#error "__OS_LOG_LENGTH and __OS_LOG_CHUNK must be powers of 2."
+#endif
+#if (__OS_LOG_CHUNK < 32) || (__OS_LOG_CHUNK > 128) || (__OS_LOG_CHUNK > __OS_LOG_LENGTH)
+#error "__OS_LOG_CHUNK must be 32 to 128, and cannot exceed __OS_LOG_LENGTH."
+#endif
+
+#if (__MAXTASK > 1024)
+#error "__MAXTASK cannot exceed 1024, the ready bitmap only has 32 groups of 32 tasks."
+#endif
 
 //#define __SCI_TXBUF_LENGTH      340			// SCI transmit  buffer length in bytes.
 #define __SCI_TXBUF_LENGTH      200			// SCI transmit  buffer length in bytes.
@@ -68,24 +207,175 @@
 #define __SCI_TXBUF2_LENGTH      8			// SCI transmit  buffer2 length in bytes.
 #define __SCI_RXBUF2_LENGTH      8			// SCI receive  buffer2 length in bytes.
 
+// Note: 16 Oct 2026, the buffers of UART1 and USART1 are numbered after the port, 1 and 3, 
+// the buffers without a number are those of UART0 and the buffers 2 those of USART0.
+#define __SCI_TXBUF1_LENGTH      8			// SCI transmit  buffer1 length in bytes, UART1.
+#define __SCI_RXBUF1_LENGTH      8			// SCI receive  buffer1 length in bytes.
+#define __SCI_TXBUF3_LENGTH      8			// SCI transmit  buffer3 length in bytes, USART1.
+#define __SCI_RXBUF3_LENGTH      8			// SCI receive  buffer3 length in bytes.
+
+#define __SCI_TXQUEUE_LENGTH     256		// SCI transmit queue length in bytes, must be a power of 2.
+#define __SCI_TXQUEUE1_LENGTH    64			// SCI transmit queue1 length in bytes, must be a power of 2.
+#define __SCI_TXQUEUE2_LENGTH    64			// SCI transmit queue2 length in bytes, must be a power of 2.
+#define __SCI_TXQUEUE3_LENGTH    64			// SCI transmit queue3 length in bytes, must be a power of 2.
+
+#if ((__SCI_TXQUEUE_LENGTH & (__SCI_TXQUEUE_LENGTH-1)) != 0) || ((__SCI_TXQUEUE1_LENGTH & (__SCI_TXQUEUE1_LENGTH-1)) != 0) || \
+	((__SCI_TXQUEUE2_LENGTH & (__SCI_TXQUEUE2_LENGTH-1)) != 0) || ((__SCI_TXQUEUE3_LENGTH & (__SCI_TXQUEUE3_LENGTH-1)) != 0)
+#error "The length of the SCI transmit queues must be a power of 2."
+#endif
+
+#define __SCI_RXRING_LENGTH      1024		// SCI receive ring length in bytes, filled by the PDC, must
+#define __SCI_RXRING1_LENGTH     512		// be a power of 2 and at least 4 blocks.
+#define __SCI_RXRING2_LENGTH     1024
+#define __SCI_RXRING3_LENGTH     512
+#define __SCI_RXRING_BLOCK       128		// Size of a PDC receive block in bytes, must be a power of 2.
+
+#if ((__SCI_RXRING_LENGTH & (__SCI_RXRING_LENGTH-1)) != 0) || ((__SCI_RXRING1_LENGTH & (__SCI_RXRING1_LENGTH-1)) != 0) || \
+	((__SCI_RXRING2_LENGTH & (__SCI_RXRING2_LENGTH-1)) != 0) || ((__SCI_RXRING3_LENGTH & (__SCI_RXRING3_LENGTH-1)) != 0) || \
+	((__SCI_RXRING_BLOCK & (__SCI_RXRING_BLOCK-1)) != 0)
+#error "The length of the SCI receive rings and blocks must be a power of 2."
+#endif
+#if (__SCI_RXRING_LENGTH < 4*__SCI_RXRING_BLOCK) || (__SCI_RXRING1_LENGTH < 4*__SCI_RXRING_BLOCK) || \
+	(__SCI_RXRING2_LENGTH < 4*__SCI_RXRING_BLOCK) || (__SCI_RXRING3_LENGTH < 4*__SCI_RXRING_BLOCK)
+#error "The SCI receive rings must hold at least 4 blocks."
+#endif
+
+#define __SCI_FRAMEQ_LENGTH      8			// Frames per priority level in the SCI frame queues, power of 2.
+#if ((__SCI_FRAMEQ_LENGTH & (__SCI_FRAMEQ_LENGTH-1)) != 0)
+#error "The length of the SCI frame queues must be a power of 2."
+#endif
+
 // --- RTOS DATATYPES DECLARATIONS ---
 // Type cast for a structure defining the attributes of a task,
 // e.g. the task's ID, current state, counter, variables etc.
 typedef struct StructTASK
 {	
-	int nID;      // The task identification.  Also determines the sequence
-                    // in which the task is executed by the Kernel.  Task with 
-                    // ID = 1 will be executed first. Valid value is 1-255.
+	int nID;      // The task identification or handle, (generation << 16) + slot index + 1.
+                    // The slot index determines the sequence in which the task is 
+                    // executed by the Kernel.  Task in slot 0 will be executed first.
+                    // The generation is incremented when a task is deleted, thus a stale
+                    // handle does not refer to a newer task in the same slot.
                     // ID = 0 is used to indicate empty task.  
 	int nState;	// The current state of the task.  Useful for implementing 
                     // an algorithmic state machine.
-	int nTimer;	// This variable will be decremented on every clock tick. 
-                    // The Scheduler uses this variable to determine whether to execute a 
-                    // task or not.  If nTimer = 0, the corresponding task will be
-                    // executed, else the task will be skipped.
-                    // Useful for implementing a non-critical delay within a task.
+	int nTimer;	// The no. of clock ticks before the task is executed again, as set by
+                    // OSSetTaskContext().  Useful for implementing a non-critical delay 
+                    // within a task.  Note: 16 Oct 2026, this variable is no longer 
+                    // decremented on every clock tick, the Scheduler keeps the due tick of
+                    // the task in a timer wheel instead.  nTimer = 0 while the task is
+                    // being executed.
 } TASK_ATTRIBUTE;
 
+// Type cast for a structure holding the execution time statistic of a task, or of a state
+// of a task.  The cycles are counted with the DWT cycle counter, and include the time spent
+// in the interrupt service routines while the task is executed.
+typedef struct StructTASKPROFILE
+{
+	unsigned int unCount;		// No. of times the task is executed.
+	unsigned int unMin;			// Min. processor cycles per execution.
+	unsigned int unMax;			// Max. processor cycles per execution.
+	unsigned long long ullSum;	// Total processor cycles, mean = ullSum/unCount.
+} TASK_PROFILE;
+
+// Type cast for a structure holding the load statistic of the Kernel.
+typedef struct StructKERNELPROFILE
+{
+	unsigned int unTickCycle;	// No. of processor cycles in one system tick.
+	unsigned int unTickBusy;	// Processor cycles used by the tasks and the SysTick exception
+								// handler in the last system tick.
+	unsigned int unTickBusyMax;	// Max. of unTickBusy.
+	unsigned int unOverrun;		// No. of system ticks occurring before all the due tasks are executed.
+	int nOverrunTask;			// Handle of the task being executed at the last overrun, 0 if none.
+} KERNEL_PROFILE;
+
+// Type cast for a record of the execution trace, 8 bytes, sent as is (little endian) to the host,
+// see OSTraceEvent() and the decoder in the folder "tools".
+typedef struct StructOSTraceRecord
+{
+	uint32_t unTime;			// DWT cycle counter when the event is recorded.
+	uint8_t bytEvent;			// Event code, __TRACE_xxx.
+	uint8_t bytData;			// 8-bits data, depends on the event code.
+	uint16_t unData;			// 16-bits data, depends on the event code.
+} OS_TRACE_RECORD;
+
+// Trace event codes, bit n of the trace mask enables event code n, see OSTraceControl().
+#define __TRACE_TASK_ENTER		1			// Task is executed, data8 = state, data16 = task slot.
+#define __TRACE_TASK_EXIT		2			// Task returns, data8 = next state, data16 = task slot.
+#define __TRACE_ISR_ENTER		3			// Exception handler entered, data8 = exception no.
+#define __TRACE_ISR_EXIT		4			// Exception handler returns, data8 = exception no.
+#define __TRACE_QUEUE_PUT		5			// Items put, data8 = no. of items, data16 = queue address.
+#define __TRACE_QUEUE_GET		6			// Items got, data8 = no. of items, data16 = queue address.
+#define __TRACE_EVENT_SIGNAL	7			// Event flags signalled, data8 = flags, data16 = task slot.
+#define __TRACE_EVENT_WAIT		8			// Task waits for event, data8 = flags, data16 = timeout.
+#define __TRACE_TICK			9			// System tick, data16 = clock tick.
+#define __TRACE_CLOCK			10			// Master clock changed, data16 = MCK in 10 kHz unit.
+#define __TRACE_OVERRUN			11			// Tick overrun, data16 = slot of the task being executed.
+#define __TRACE_USER			16			// Event codes 16 to 31 are free for the application.
+
+#define __TRACE_MASK_KERNEL		((1u << __TRACE_TASK_ENTER) | (1u << __TRACE_TASK_EXIT) | \
+								 (1u << __TRACE_EVENT_SIGNAL) | (1u << __TRACE_EVENT_WAIT) | \
+								 (1u << __TRACE_CLOCK) | (1u << __TRACE_OVERRUN))
+#define __TRACE_MASK_ISR		((1u << __TRACE_ISR_ENTER) | (1u << __TRACE_ISR_EXIT))
+#define __TRACE_MASK_QUEUE		((1u << __TRACE_QUEUE_PUT) | (1u << __TRACE_QUEUE_GET))
+
+// Record an event if enabled in the trace mask, the mask is tested in line so that a disabled
+// event only costs a load and a test.  Nothing is compiled without __OS_TRACE.
+#ifdef __OS_TRACE
+#define __OS_TRACE_EVENT(ev, d8, d16)	do { if (gunTraceMask & (1u << (ev))) OSTraceEvent((ev), (d8), (d16)); } while (0)
+#else
+#define __OS_TRACE_EVENT(ev, d8, d16)
+#endif
+
+// Tokenized log.  The format string is placed in the section __OS_LOG_SECTION of the ELF file,
+// which is not loaded, and only its offset in that section and the arguments are recorded as a
+// binary record, see OSLogWrite().  The text is formatted on the host from the ELF file by the
+// program in the folder "tools".  Up to 4 arguments, each converted to 32 bits: integers, 
+// characters or pointers, a float is passed as OSLogFloat(x).  %s is not supported.  e.g.
+// __OS_LOG_MSG("adc ch %d = %d mV", nChannel, nValue);
+// The arguments are not evaluated at all without __OS_LOG.
+// The offset is recorded in 16 bits, so the section can hold __OS_LOG_SECTION_MAX bytes of format
+// strings at most, beyond that a message would be decoded with another format string.  The
+// decoder refuses an ELF file with a larger section, the linker script can also check it with
+// ASSERT(SIZEOF(.os_log) <= 0xFFFF, "too many __OS_LOG_MSG() format strings").
+#define __OS_LOG_SECTION_MAX	0xFFFF
+#ifdef __OS_LOG
+#define __OS_LOG_MSG(...)		do { static const char _strLogFormat[] __attribute__((section(__OS_LOG_SECTION), used)) = \
+									 __OS_LOG_FORMAT(__VA_ARGS__, 0); \
+								OSLogWrite((unsigned int)(uintptr_t) _strLogFormat, \
+									 __OS_LOG_NARG(__VA_ARGS__, __OS_LOG_TOO_MANY_ARGUMENTS, 4, 3, 2, 1, 0, 0), \
+									 __OS_LOG_ARGS(__VA_ARGS__, 0, 0, 0, 0, 0)); } while (0)
+#else
+#define __OS_LOG_MSG(...)
+#endif
+#define __OS_LOG_FORMAT(fmt, ...)				fmt
+#define __OS_LOG_NARG(fmt, a, b, c, d, e, n, ...)	n
+#define __OS_LOG_ARGS(fmt, a, b, c, d, ...)		(uint32_t)(uintptr_t)(a), (uint32_t)(uintptr_t)(b), \
+												(uint32_t)(uintptr_t)(c), (uint32_t)(uintptr_t)(d)
+
+// Bit pattern of a float argument of __OS_LOG_MSG(), no conversion is done on the target.
+static inline uint32_t OSLogFloat(float fValue)
+{
+	union { float fValue; uint32_t unValue; } strcValue;
+
+	strcValue.fValue = fValue;
+	return strcValue.unValue;
+}
+
+// Type cast for a structure defining a single-producer single-consumer queue of fixed size
+// items.  The producer only modifies unHead and the consumer only modifies unTail, so one
+// task or interrupt service routine can put items while another gets them, without disabling
+// interrupts.  The indices run freely and wrap around at 2^32, the no. of items in the queue
+// is unHead - unTail.  The queue can be initialized statically, e.g. 
+// OS_QUEUE strcQueue = {0, 0, 16-1, 1, bytBuffer}; for a queue of 16 bytes.
+typedef struct StructOSQueue
+{
+	volatile unsigned int unHead;	// No. of items put since initialization.
+	volatile unsigned int unTail;	// No. of items got since initialization.
+	unsigned int unMask;			// Length - 1, the length is a power of 2.
+	unsigned int unItemSize;		// Size of one item in bytes.
+	uint8_t *ptrBuffer;				// Storage for the items, length x unItemSize bytes.
+} OS_QUEUE;
+
 // Type cast for a pointer to a task, TASK_POINTER with argument of TASK_ATTRIBUTE
 typedef void (*TASK_POINTER)(TASK_ATTRIBUTE *);
 
@@ -107,6 +397,25 @@ typedef struct StructSCI
 	unsigned bRFTXERR:	1;	// Set to indicate transmission is not successful.
 } SCI_STATUS;
 
+// Type cast for a frame sent by the PDC from the caller's memory, see SCIFrameSend() in
+// "Driver_SCI_V100.c".  Many tasks can submit frames to the same driver, the frames of higher
+// priority are sent first.
+typedef struct StructSCIFrame
+{
+	const uint8_t *ptrData;			// Data to send, must not be changed until the frame is sent.
+	unsigned int unLength;			// No. of bytes, 1 to 65535.
+	int nTask;						// Handle of the task to signal when the frame is sent, 0 for none.
+	volatile uint8_t bytStatus;		// __SCI_FRAME_DONE, __SCI_FRAME_QUEUED or __SCI_FRAME_SENDING.
+} SCI_FRAME;
+
+#define __SCI_FRAME_DONE			0	// Frame sent, or not submitted.
+#define __SCI_FRAME_QUEUED			1	// Frame waiting in the queue.
+#define __SCI_FRAME_SENDING			2	// Frame being sent by the PDC.
+
+#define __SCI_PRIORITY_HIGH			0	// Priority of the frames, e.g. control messages.
+#define __SCI_PRIORITY_LOW			1	// E.g. bulk data.
+#define __SCI_PRIORITY_LEVELS		2
+
 
 // Type cast for Bit-field structure - I2C interface status.
 typedef struct StructI2CStatus
@@ -117,29 +426,97 @@ typedef struct StructI2CStatus
     unsigned bSend:         1;      // Set to initiate sending of data (Master -> Slave).
 } I2C_STATUS;
 
+// Type cast for a client of the master clock, see OSSetClock().  The structure is allocated by
+// the driver and registered once with OSClockRegister().
+typedef struct StructOSClockClient
+{
+	int (*ptrCallback)(unsigned int, int);	// Called with the new MCK in Hz and the phase, returns
+											// non-zero in the __OS_CLOCK_CHECK phase to refuse the clock,
+											// and in the __OS_CLOCK_PRE phase until ready for the change.
+	struct StructOSClockClient *ptrNext;	// Next client in the list.
+} OS_CLOCK_CLIENT;
+
+#define __OS_CLOCK_CHECK		0			// Can the driver work at the new master clock?
+#define __OS_CLOCK_PRE			1			// Master clock is about to change.
+#define __OS_CLOCK_POST			2			// Master clock has changed.
+
 // --- RTOS FUNCTIONS' PROTOTYPES ---
 // Note: The body of the followings routines is in the file "os_APIs.c"
 void OSInit(void);
 int OSCreateTask(TASK_ATTRIBUTE *, TASK_POINTER );
 void OSSetTaskContext(TASK_ATTRIBUTE *, int, int);
+int OSSpawnTask(TASK_POINTER);
+TASK_ATTRIBUTE *OSGetTask(int);
 int OSTaskDelete(int);
-void OSUpdateTaskTimer(void);
+void OSWaitEvent(TASK_ATTRIBUTE *, int, unsigned int, int);
+int OSSignalEvent(int, unsigned int);
+unsigned int OSGetEvent(TASK_ATTRIBUTE *, unsigned int);
+int OSUpdateTaskTimer(void);
+int OSGetReadyTask(void);
+void OSRunTask(int);
+void OSProfileReset(void);
+void OSProfileSelect(int);
+int OSGetTaskProfile(int, TASK_PROFILE *);
+int OSGetStateProfile(int, TASK_PROFILE *);
+void OSGetKernelProfile(KERNEL_PROFILE *);
+void OSProfileTick(unsigned int);
+void OSProfileOverrun(void);
+int OSQueueInit(OS_QUEUE *, void *, unsigned int, unsigned int);
+int OSQueuePut(OS_QUEUE *, const void *);
+unsigned int OSQueueWrite(OS_QUEUE *, const void *, unsigned int);
+int OSQueueGet(OS_QUEUE *, void *);
+void *OSQueuePeek(OS_QUEUE *);
+void OSQueueRemove(OS_QUEUE *);
+unsigned int OSQueueCount(OS_QUEUE *);
+unsigned int OSQueueSpace(OS_QUEUE *);
+void OSTraceEvent(unsigned int, unsigned int, unsigned int);
+void OSTraceControl(unsigned int);
+unsigned int OSTraceChunk(uint8_t *, OS_TRACE_RECORD **, unsigned int);
+void OSTraceRelease(unsigned int);
+void OSLogWrite(unsigned int, unsigned int, uint32_t, uint32_t, uint32_t, uint32_t);
+unsigned int OSLogChunk(uint8_t *, uint8_t **);
+void OSLogRelease(unsigned int);
+// Note: The body of the followings routines is in the file "os_SAM4S_APIs.c"
 void OSEnterCritical(void);
 void OSExitCritical(void);
+void OSIdle(void);
 void OSProce1(TASK_ATTRIBUTE *ptrTask); 	// Blink indicator LED1 process.
-// Note: The body of the followings routines is in the file "os dsPIC33E_APIs.c"
 void ClearWatchDog(void);
 void SAM4S_Init(void);
+void SysTick_Handler(void);
+int OSSetClock(unsigned int);
+void OSClockRegister(OS_CLOCK_CLIENT *);
 
 // --- GLOBAL/EXTERNAL VARIABLES DECLARATION ---
 
 // Note: The followings are defined in the file "os_APIs.c"
-extern int gnRunTask;
+extern volatile int gnRunTask;
+extern volatile int gnTickDispatch;
+extern unsigned int gunReadyGroup;
 extern int gnTaskCount;
-extern unsigned int gunClockTick;
-extern TASK_ATTRIBUTE gstrcTaskContext[__MAXTASK-1];
-extern TASK_POINTER gfptrTask[__MAXTASK-1];
-extern SCI_STATUS gSCIstatus;
+extern volatile unsigned int gunClockTick;
+extern TASK_ATTRIBUTE gstrcTaskContext[__MAXTASK];
+extern TASK_POINTER gfptrTask[__MAXTASK];
+#ifdef __OS_PROFILE
+extern KERNEL_PROFILE gstrcKernelProfile;
+#endif
+extern unsigned int gunTraceMask;
+extern unsigned int gunTraceLost;
+#ifdef __OS_TRACE
+extern volatile unsigned int gunTraceHead;
+extern volatile unsigned int gunTraceTail;
+#endif
+extern unsigned int gunLogLost;
+#ifdef __OS_LOG
+extern volatile unsigned int gunLogHead;
+extern volatile unsigned int gunLogTail;
+#endif
+
+// Note: The followings are defined in the file "os_SAM4S_APIs.c"
+extern unsigned int gunIdleCount;
+extern volatile int gnCPUIdle;
+extern volatile unsigned int gunMCKHz;
+extern unsigned int gunSysTickCount;
 
 // Note: The followings is defined in file "main.c"
 extern int gnRunImage;
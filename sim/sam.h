@@ -0,0 +1,1667 @@
+// Author			: Fabian Kung
+// Date				: 16 Oct 2026
+// Filename			: sam.h (host simulation)
+//
+// Virtual register model of the ATSAM4SD16B used by the host simulation build.  This header
+// replaces the Atmel/CMSIS "sam.h" when the firmware sources are compiled on a Linux host (see
+// "Makefile" in this folder).  The peripheral structures keep the same register names as the
+// Atmel device header, so the drivers compile unmodified.
+//
+// Each register is a SimReg object.  Every read or write of a register is routed to the
+// behavioural models in "sim_model.cpp", which advance the virtual clock by one master clock
+// cycle per access and update the peripheral status bits.  Because of the operator overloading
+// the firmware sources are compiled as C++ in the simulation build.
+//
+// Note: The register layout is NOT the same as the real device, only the names are.  Pointers
+// written into the PDC address registers are truncated to 32 bits, thus the simulation must
+// be linked as a non position independent executable (-no-pie) so that all global buffers
+// reside below 4 GBytes.
+
+#ifndef _SIM_SAM_H
+#define _SIM_SAM_H
+
+#ifndef __cplusplus
+	#error "sam.h (host simulation): the firmware must be compiled as C++ in the simulation build"
+#endif
+
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//  REGISTER ACCESS   /////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct SimReg;
+uint32_t SimRead(SimReg *ptrReg);
+void SimWrite(SimReg *ptrReg, uint32_t unValue);
+
+// A 32-bits peripheral register.  unValue holds the raw content and is only accessed directly
+// by the behavioural models.
+struct SimReg
+{
+	uint32_t unValue;
+
+	operator uint32_t() { return SimRead(this); }
+	SimReg &operator=(uint32_t unData) { SimWrite(this, unData); return *this; }
+	SimReg &operator=(SimReg &rReg) { SimWrite(this, SimRead(&rReg)); return *this; }
+	SimReg &operator|=(uint32_t unData) { SimWrite(this, SimRead(this) | unData); return *this; }
+	SimReg &operator&=(uint32_t unData) { SimWrite(this, SimRead(this) & unData); return *this; }
+	SimReg &operator^=(uint32_t unData) { SimWrite(this, SimRead(this) ^ unData); return *this; }
+};
+
+typedef SimReg RoReg;		// Read-only register.
+typedef SimReg WoReg;		// Write-only register.
+typedef SimReg RwReg;		// Read-write register.
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//  CORTEX-M4 CORE   //////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SimDisableIRQ(void);
+void SimEnableIRQ(void);
+uint32_t SimGetPrimask(void);
+void SimWaitForInterrupt(void);
+
+static inline void __disable_irq(void) { SimDisableIRQ(); }
+static inline void __enable_irq(void) { SimEnableIRQ(); }
+static inline uint32_t __get_PRIMASK(void) { return SimGetPrimask(); }
+static inline void __set_PRIMASK(uint32_t unPrimask) { if (unPrimask & 1) SimDisableIRQ(); else SimEnableIRQ(); }
+static inline void __WFI(void) { SimWaitForInterrupt(); }
+static inline void __DSB(void) {}
+static inline void __ISB(void) {}
+static inline void __DMB(void) { __asm__ volatile ("" ::: "memory"); }
+static inline void __NOP(void) {}
+static inline uint32_t __CLZ(uint32_t unValue) { return (unValue == 0) ? 32 : __builtin_clz(unValue); }
+
+// Section of the log format strings, as in "osmain.h" with the comment character of the x86 assembler.
+#define __OS_LOG_SECTION        ".os_log,\"\",@progbits #"
+
+typedef struct
+{
+	RwReg CTRL;
+	RwReg LOAD;
+	RwReg VAL;
+	RoReg CALIB;
+} SysTick_Type;
+
+#define SysTick_CTRL_ENABLE_Msk		(0x1u << 0)
+#define SysTick_CTRL_TICKINT_Msk	(0x1u << 1)
+#define SysTick_CTRL_CLKSOURCE_Msk	(0x1u << 2)
+#define SysTick_CTRL_COUNTFLAG_Msk	(0x1u << 16)
+
+extern SysTick_Type gSimSysTick;
+#define SysTick		(&gSimSysTick)
+
+typedef struct
+{
+	RwReg CTRL;
+	RwReg CYCCNT;
+	RwReg CPICNT;
+	RwReg EXCCNT;
+	RwReg SLEEPCNT;
+	RwReg LSUCNT;
+	RwReg FOLDCNT;
+	RoReg PCSR;
+} DWT_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk		(0x1u << 0)
+
+typedef struct
+{
+	RwReg DHCSR;
+	WoReg DCRSR;
+	RwReg DCRDR;
+	RwReg DEMCR;
+} CoreDebug_Type;
+
+#define CoreDebug_DEMCR_TRCENA_Msk	(0x1u << 24)
+
+extern DWT_Type gSimDWT;
+extern CoreDebug_Type gSimCoreDebug;
+#define DWT			(&gSimDWT)
+#define CoreDebug	(&gSimCoreDebug)
+
+// Interrupt numbers of the peripherals, same as the device header.
+typedef enum IRQn
+{
+	SysTick_IRQn	= -1,
+	UART0_IRQn		= 8,
+	UART1_IRQn		= 9,
+	PIOA_IRQn		= 11,
+	PIOB_IRQn		= 12,
+	PIOC_IRQn		= 13,
+	USART0_IRQn		= 14,
+	USART1_IRQn		= 15,
+	TWI0_IRQn		= 19,
+	TWI1_IRQn		= 20,
+	TC0_IRQn		= 23,
+	TC1_IRQn		= 24,
+	TC2_IRQn		= 25,
+	TC3_IRQn		= 26,
+	TC4_IRQn		= 27,
+	TC5_IRQn		= 28,
+	ADC_IRQn		= 29,
+	DACC_IRQn		= 30
+} IRQn_Type;
+
+void SimNvicEnable(int nIrq, int bEnable);
+void SimNvicPend(int nIrq, int bPend);
+
+static inline void NVIC_EnableIRQ(IRQn_Type IRQn) { SimNvicEnable(IRQn, 1); }
+static inline void NVIC_DisableIRQ(IRQn_Type IRQn) { SimNvicEnable(IRQn, 0); }
+static inline void NVIC_SetPendingIRQ(IRQn_Type IRQn) { SimNvicPend(IRQn, 1); }
+static inline void NVIC_ClearPendingIRQ(IRQn_Type IRQn) { SimNvicPend(IRQn, 0); }
+static inline void NVIC_SetPriority(IRQn_Type IRQn, uint32_t unPriority) { (void) IRQn; (void) unPriority; }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//  PERIPHERAL IDENTIFIERS   //////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define ID_UART0	8
+#define ID_UART1	9
+#define ID_PIOA		11
+#define ID_PIOB		12
+#define ID_PIOC		13
+#define ID_USART0	14
+#define ID_USART1	15
+#define ID_TWI0		19
+#define ID_TWI1		20
+#define ID_TC0		23
+#define ID_TC1		24
+#define ID_TC2		25
+#define ID_TC3		26
+#define ID_TC4		27
+#define ID_TC5		28
+#define ID_ADC		29
+#define ID_DACC		30
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//  PDC (PERIPHERAL DMA CONTROLLER)   /////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The PDC registers of a peripheral, in the same order as at the end of each peripheral
+// structure below, so that PDC_xxx can point into the peripheral.
+#define SIM_PDC_REGISTERS(prefix)	\
+	RwReg prefix##_RPR;				\
+	RwReg prefix##_RCR;				\
+	RwReg prefix##_TPR;				\
+	RwReg prefix##_TCR;				\
+	RwReg prefix##_RNPR;			\
+	RwReg prefix##_RNCR;			\
+	RwReg prefix##_TNPR;			\
+	RwReg prefix##_TNCR;			\
+	WoReg prefix##_PTCR;			\
+	RoReg prefix##_PTSR;
+
+typedef struct
+{
+	SIM_PDC_REGISTERS(PERIPH)
+} Pdc;
+
+#define PERIPH_PTCR_RXTEN	(0x1u << 0)
+#define PERIPH_PTCR_RXTDIS	(0x1u << 1)
+#define PERIPH_PTCR_TXTEN	(0x1u << 8)
+#define PERIPH_PTCR_TXTDIS	(0x1u << 9)
+#define PERIPH_PTSR_RXTEN	(0x1u << 0)
+#define PERIPH_PTSR_TXTEN	(0x1u << 8)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//  PMC, EEFC, WDT AND CMCC   /////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+	WoReg PMC_SCER;
+	WoReg PMC_SCDR;
+	RoReg PMC_SCSR;
+	WoReg PMC_PCER0;
+	WoReg PMC_PCDR0;
+	RoReg PMC_PCSR0;
+	RwReg CKGR_MOR;
+	RoReg CKGR_MCFR;
+	RwReg CKGR_PLLAR;
+	RwReg CKGR_PLLBR;
+	RwReg PMC_MCKR;
+	WoReg PMC_IER;
+	WoReg PMC_IDR;
+	RoReg PMC_SR;
+	RoReg PMC_IMR;
+	RwReg PMC_FSMR;
+	RwReg PMC_FSPR;
+	WoReg PMC_FOCR;
+	RwReg PMC_WPMR;
+	RoReg PMC_WPSR;
+	WoReg PMC_PCER1;
+	WoReg PMC_PCDR1;
+	RoReg PMC_PCSR1;
+} Pmc;
+
+#define CKGR_MOR_MOSCXTEN			(0x1u << 0)
+#define CKGR_MOR_MOSCXTBY			(0x1u << 1)
+#define CKGR_MOR_MOSCRCEN			(0x1u << 3)
+#define CKGR_MOR_MOSCXTST(value)	((0xFFu << 8) & ((value) << 8))
+#define CKGR_MOR_KEY_PASSWD			(0x37u << 16)
+#define CKGR_MOR_MOSCSEL			(0x1u << 24)
+#define CKGR_PLLAR_DIVA_Msk			(0xFFu << 0)
+#define CKGR_PLLAR_DIVA(value)		((0xFFu << 0) & ((value) << 0))
+#define CKGR_PLLAR_PLLACOUNT_Msk	(0x3Fu << 8)
+#define CKGR_PLLAR_PLLACOUNT(value)	((0x3Fu << 8) & ((value) << 8))
+#define CKGR_PLLAR_MULA_Msk			(0x7FFu << 16)
+#define CKGR_PLLAR_MULA(value)		((0x7FFu << 16) & ((value) << 16))
+#define CKGR_PLLAR_ONE				(0x1u << 29)
+#define CKGR_PLLBR_DIVB_Msk			(0xFFu << 0)
+#define CKGR_PLLBR_DIVB(value)		((0xFFu << 0) & ((value) << 0))
+#define CKGR_PLLBR_PLLBCOUNT_Msk	(0x3Fu << 8)
+#define CKGR_PLLBR_PLLBCOUNT(value)	((0x3Fu << 8) & ((value) << 8))
+#define CKGR_PLLBR_MULB_Msk			(0x7FFu << 16)
+#define CKGR_PLLBR_MULB(value)		((0x7FFu << 16) & ((value) << 16))
+#define PMC_MCKR_CSS_Msk			(0x3u << 0)
+#define PMC_MCKR_CSS_SLOW_CLK		(0x0u << 0)
+#define PMC_MCKR_CSS_MAIN_CLK		(0x1u << 0)
+#define PMC_MCKR_CSS_PLLA_CLK		(0x2u << 0)
+#define PMC_MCKR_CSS_PLLB_CLK		(0x3u << 0)
+#define PMC_MCKR_PRES_Pos			4
+#define PMC_MCKR_PRES_Msk			(0x7u << 4)
+#define PMC_MCKR_PRES_CLK_1			(0x0u << 4)
+#define PMC_MCKR_PRES_CLK_2			(0x1u << 4)
+#define PMC_MCKR_PRES_CLK_4			(0x2u << 4)
+#define PMC_MCKR_PRES_CLK_8			(0x3u << 4)
+#define PMC_MCKR_PRES_CLK_16		(0x4u << 4)
+#define PMC_MCKR_PRES_CLK_32		(0x5u << 4)
+#define PMC_MCKR_PRES_CLK_64		(0x6u << 4)
+#define PMC_MCKR_PRES_CLK_3			(0x7u << 4)
+#define PMC_SR_MOSCXTS				(0x1u << 0)
+#define PMC_SR_LOCKA				(0x1u << 1)
+#define PMC_SR_LOCKB				(0x1u << 2)
+#define PMC_SR_MCKRDY				(0x1u << 3)
+#define PMC_SR_MOSCSELS				(0x1u << 16)
+#define PMC_SR_MOSCRCS				(0x1u << 17)
+#define PMC_PCER0_PID8  (0x1u << 8)
+#define PMC_PCER0_PID9  (0x1u << 9)
+#define PMC_PCER0_PID10  (0x1u << 10)
+#define PMC_PCER0_PID11  (0x1u << 11)
+#define PMC_PCER0_PID12  (0x1u << 12)
+#define PMC_PCER0_PID13  (0x1u << 13)
+#define PMC_PCER0_PID14  (0x1u << 14)
+#define PMC_PCER0_PID15  (0x1u << 15)
+#define PMC_PCER0_PID16  (0x1u << 16)
+#define PMC_PCER0_PID17  (0x1u << 17)
+#define PMC_PCER0_PID18  (0x1u << 18)
+#define PMC_PCER0_PID19  (0x1u << 19)
+#define PMC_PCER0_PID20  (0x1u << 20)
+#define PMC_PCER0_PID21  (0x1u << 21)
+#define PMC_PCER0_PID22  (0x1u << 22)
+#define PMC_PCER0_PID23  (0x1u << 23)
+#define PMC_PCER0_PID24  (0x1u << 24)
+#define PMC_PCER0_PID25  (0x1u << 25)
+#define PMC_PCER0_PID26  (0x1u << 26)
+#define PMC_PCER0_PID27  (0x1u << 27)
+#define PMC_PCER0_PID28  (0x1u << 28)
+#define PMC_PCER0_PID29  (0x1u << 29)
+#define PMC_PCER0_PID30  (0x1u << 30)
+#define PMC_PCER0_PID31  (0x1u << 31)
+#define PMC_PCDR0_PID8  (0x1u << 8)
+#define PMC_PCDR0_PID9  (0x1u << 9)
+#define PMC_PCDR0_PID10  (0x1u << 10)
+#define PMC_PCDR0_PID11  (0x1u << 11)
+#define PMC_PCDR0_PID12  (0x1u << 12)
+#define PMC_PCDR0_PID13  (0x1u << 13)
+#define PMC_PCDR0_PID14  (0x1u << 14)
+#define PMC_PCDR0_PID15  (0x1u << 15)
+#define PMC_PCDR0_PID16  (0x1u << 16)
+#define PMC_PCDR0_PID17  (0x1u << 17)
+#define PMC_PCDR0_PID18  (0x1u << 18)
+#define PMC_PCDR0_PID19  (0x1u << 19)
+#define PMC_PCDR0_PID20  (0x1u << 20)
+#define PMC_PCDR0_PID21  (0x1u << 21)
+#define PMC_PCDR0_PID22  (0x1u << 22)
+#define PMC_PCDR0_PID23  (0x1u << 23)
+#define PMC_PCDR0_PID24  (0x1u << 24)
+#define PMC_PCDR0_PID25  (0x1u << 25)
+#define PMC_PCDR0_PID26  (0x1u << 26)
+#define PMC_PCDR0_PID27  (0x1u << 27)
+#define PMC_PCDR0_PID28  (0x1u << 28)
+#define PMC_PCDR0_PID29  (0x1u << 29)
+#define PMC_PCDR0_PID30  (0x1u << 30)
+#define PMC_PCDR0_PID31  (0x1u << 31)
+#define PMC_PCER1_PID32  (0x1u << 0)
+#define PMC_PCER1_PID33  (0x1u << 1)
+#define PMC_PCER1_PID34  (0x1u << 2)
+#define PMC_PCDR1_PID32  (0x1u << 0)
+#define PMC_PCDR1_PID33  (0x1u << 1)
+#define PMC_PCDR1_PID34  (0x1u << 2)
+
+extern Pmc gSimPMC;
+#define PMC			(&gSimPMC)
+
+typedef struct
+{
+	RwReg EEFC_FMR;
+	WoReg EEFC_FCR;
+	RoReg EEFC_FSR;
+	RoReg EEFC_FRR;
+} Efc;
+
+#define EEFC_FMR_FWS_Msk			(0xFu << 8)
+#define EEFC_FMR_FWS(value)			((0xFu << 8) & ((value) << 8))
+
+extern Efc gSimEFC0;
+#define EFC0		(&gSimEFC0)
+
+typedef struct
+{
+	WoReg WDT_CR;
+	RwReg WDT_MR;
+	RoReg WDT_SR;
+} Wdt;
+
+#define WDT_CR_WDRSTT				(0x1u << 0)
+#define WDT_CR_KEY_PASSWD			(0xA5u << 24)
+
+extern Wdt gSimWDT;
+#define WDT			(&gSimWDT)
+
+typedef struct
+{
+	RoReg CMCC_TYPE;
+	RwReg CMCC_CFG;
+	WoReg CMCC_CTRL;
+	RoReg CMCC_SR;
+} Cmcc;
+
+#define CMCC_CTRL_CEN				(0x1u << 0)
+#define CMCC_SR_CSTS				(0x1u << 0)
+
+extern Cmcc gSimCMCC;
+#define CMCC		(&gSimCMCC)
+
+typedef struct
+{
+	RwReg CCFG_SYSIO;
+} Matrix;
+
+#define CCFG_SYSIO_SYSIO4			(0x1u << 4)
+#define CCFG_SYSIO_SYSIO5			(0x1u << 5)
+
+extern Matrix gSimMATRIX;
+#define MATRIX		(&gSimMATRIX)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//  PIO   /////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+	WoReg PIO_PER;
+	WoReg PIO_PDR;
+	RoReg PIO_PSR;
+	WoReg PIO_OER;
+	WoReg PIO_ODR;
+	RoReg PIO_OSR;
+	WoReg PIO_IFER;
+	WoReg PIO_IFDR;
+	RoReg PIO_IFSR;
+	WoReg PIO_SODR;
+	WoReg PIO_CODR;
+	RwReg PIO_ODSR;
+	RoReg PIO_PDSR;
+	WoReg PIO_IER;
+	WoReg PIO_IDR;
+	RoReg PIO_IMR;
+	RoReg PIO_ISR;
+	WoReg PIO_MDER;
+	WoReg PIO_MDDR;
+	RoReg PIO_MDSR;
+	WoReg PIO_PUDR;
+	WoReg PIO_PUER;
+	RoReg PIO_PUSR;
+	RwReg PIO_ABCDSR[2];
+	WoReg PIO_PPDDR;
+	WoReg PIO_PPDER;
+	RoReg PIO_PPDSR;
+	WoReg PIO_OWER;
+	WoReg PIO_OWDR;
+	RoReg PIO_OWSR;
+} Pio;
+
+#define PIO_PER_P0      (0x1u << 0)
+#define PIO_PER_P1      (0x1u << 1)
+#define PIO_PER_P2      (0x1u << 2)
+#define PIO_PER_P3      (0x1u << 3)
+#define PIO_PER_P4      (0x1u << 4)
+#define PIO_PER_P5      (0x1u << 5)
+#define PIO_PER_P6      (0x1u << 6)
+#define PIO_PER_P7      (0x1u << 7)
+#define PIO_PER_P8      (0x1u << 8)
+#define PIO_PER_P9      (0x1u << 9)
+#define PIO_PER_P10     (0x1u << 10)
+#define PIO_PER_P11     (0x1u << 11)
+#define PIO_PER_P12     (0x1u << 12)
+#define PIO_PER_P13     (0x1u << 13)
+#define PIO_PER_P14     (0x1u << 14)
+#define PIO_PER_P15     (0x1u << 15)
+#define PIO_PER_P16     (0x1u << 16)
+#define PIO_PER_P17     (0x1u << 17)
+#define PIO_PER_P18     (0x1u << 18)
+#define PIO_PER_P19     (0x1u << 19)
+#define PIO_PER_P20     (0x1u << 20)
+#define PIO_PER_P21     (0x1u << 21)
+#define PIO_PER_P22     (0x1u << 22)
+#define PIO_PER_P23     (0x1u << 23)
+#define PIO_PER_P24     (0x1u << 24)
+#define PIO_PER_P25     (0x1u << 25)
+#define PIO_PER_P26     (0x1u << 26)
+#define PIO_PER_P27     (0x1u << 27)
+#define PIO_PER_P28     (0x1u << 28)
+#define PIO_PER_P29     (0x1u << 29)
+#define PIO_PER_P30     (0x1u << 30)
+#define PIO_PER_P31     (0x1u << 31)
+#define PIO_PDR_P0      (0x1u << 0)
+#define PIO_PDR_P1      (0x1u << 1)
+#define PIO_PDR_P2      (0x1u << 2)
+#define PIO_PDR_P3      (0x1u << 3)
+#define PIO_PDR_P4      (0x1u << 4)
+#define PIO_PDR_P5      (0x1u << 5)
+#define PIO_PDR_P6      (0x1u << 6)
+#define PIO_PDR_P7      (0x1u << 7)
+#define PIO_PDR_P8      (0x1u << 8)
+#define PIO_PDR_P9      (0x1u << 9)
+#define PIO_PDR_P10     (0x1u << 10)
+#define PIO_PDR_P11     (0x1u << 11)
+#define PIO_PDR_P12     (0x1u << 12)
+#define PIO_PDR_P13     (0x1u << 13)
+#define PIO_PDR_P14     (0x1u << 14)
+#define PIO_PDR_P15     (0x1u << 15)
+#define PIO_PDR_P16     (0x1u << 16)
+#define PIO_PDR_P17     (0x1u << 17)
+#define PIO_PDR_P18     (0x1u << 18)
+#define PIO_PDR_P19     (0x1u << 19)
+#define PIO_PDR_P20     (0x1u << 20)
+#define PIO_PDR_P21     (0x1u << 21)
+#define PIO_PDR_P22     (0x1u << 22)
+#define PIO_PDR_P23     (0x1u << 23)
+#define PIO_PDR_P24     (0x1u << 24)
+#define PIO_PDR_P25     (0x1u << 25)
+#define PIO_PDR_P26     (0x1u << 26)
+#define PIO_PDR_P27     (0x1u << 27)
+#define PIO_PDR_P28     (0x1u << 28)
+#define PIO_PDR_P29     (0x1u << 29)
+#define PIO_PDR_P30     (0x1u << 30)
+#define PIO_PDR_P31     (0x1u << 31)
+#define PIO_PSR_P0      (0x1u << 0)
+#define PIO_PSR_P1      (0x1u << 1)
+#define PIO_PSR_P2      (0x1u << 2)
+#define PIO_PSR_P3      (0x1u << 3)
+#define PIO_PSR_P4      (0x1u << 4)
+#define PIO_PSR_P5      (0x1u << 5)
+#define PIO_PSR_P6      (0x1u << 6)
+#define PIO_PSR_P7      (0x1u << 7)
+#define PIO_PSR_P8      (0x1u << 8)
+#define PIO_PSR_P9      (0x1u << 9)
+#define PIO_PSR_P10     (0x1u << 10)
+#define PIO_PSR_P11     (0x1u << 11)
+#define PIO_PSR_P12     (0x1u << 12)
+#define PIO_PSR_P13     (0x1u << 13)
+#define PIO_PSR_P14     (0x1u << 14)
+#define PIO_PSR_P15     (0x1u << 15)
+#define PIO_PSR_P16     (0x1u << 16)
+#define PIO_PSR_P17     (0x1u << 17)
+#define PIO_PSR_P18     (0x1u << 18)
+#define PIO_PSR_P19     (0x1u << 19)
+#define PIO_PSR_P20     (0x1u << 20)
+#define PIO_PSR_P21     (0x1u << 21)
+#define PIO_PSR_P22     (0x1u << 22)
+#define PIO_PSR_P23     (0x1u << 23)
+#define PIO_PSR_P24     (0x1u << 24)
+#define PIO_PSR_P25     (0x1u << 25)
+#define PIO_PSR_P26     (0x1u << 26)
+#define PIO_PSR_P27     (0x1u << 27)
+#define PIO_PSR_P28     (0x1u << 28)
+#define PIO_PSR_P29     (0x1u << 29)
+#define PIO_PSR_P30     (0x1u << 30)
+#define PIO_PSR_P31     (0x1u << 31)
+#define PIO_OER_P0      (0x1u << 0)
+#define PIO_OER_P1      (0x1u << 1)
+#define PIO_OER_P2      (0x1u << 2)
+#define PIO_OER_P3      (0x1u << 3)
+#define PIO_OER_P4      (0x1u << 4)
+#define PIO_OER_P5      (0x1u << 5)
+#define PIO_OER_P6      (0x1u << 6)
+#define PIO_OER_P7      (0x1u << 7)
+#define PIO_OER_P8      (0x1u << 8)
+#define PIO_OER_P9      (0x1u << 9)
+#define PIO_OER_P10     (0x1u << 10)
+#define PIO_OER_P11     (0x1u << 11)
+#define PIO_OER_P12     (0x1u << 12)
+#define PIO_OER_P13     (0x1u << 13)
+#define PIO_OER_P14     (0x1u << 14)
+#define PIO_OER_P15     (0x1u << 15)
+#define PIO_OER_P16     (0x1u << 16)
+#define PIO_OER_P17     (0x1u << 17)
+#define PIO_OER_P18     (0x1u << 18)
+#define PIO_OER_P19     (0x1u << 19)
+#define PIO_OER_P20     (0x1u << 20)
+#define PIO_OER_P21     (0x1u << 21)
+#define PIO_OER_P22     (0x1u << 22)
+#define PIO_OER_P23     (0x1u << 23)
+#define PIO_OER_P24     (0x1u << 24)
+#define PIO_OER_P25     (0x1u << 25)
+#define PIO_OER_P26     (0x1u << 26)
+#define PIO_OER_P27     (0x1u << 27)
+#define PIO_OER_P28     (0x1u << 28)
+#define PIO_OER_P29     (0x1u << 29)
+#define PIO_OER_P30     (0x1u << 30)
+#define PIO_OER_P31     (0x1u << 31)
+#define PIO_ODR_P0      (0x1u << 0)
+#define PIO_ODR_P1      (0x1u << 1)
+#define PIO_ODR_P2      (0x1u << 2)
+#define PIO_ODR_P3      (0x1u << 3)
+#define PIO_ODR_P4      (0x1u << 4)
+#define PIO_ODR_P5      (0x1u << 5)
+#define PIO_ODR_P6      (0x1u << 6)
+#define PIO_ODR_P7      (0x1u << 7)
+#define PIO_ODR_P8      (0x1u << 8)
+#define PIO_ODR_P9      (0x1u << 9)
+#define PIO_ODR_P10     (0x1u << 10)
+#define PIO_ODR_P11     (0x1u << 11)
+#define PIO_ODR_P12     (0x1u << 12)
+#define PIO_ODR_P13     (0x1u << 13)
+#define PIO_ODR_P14     (0x1u << 14)
+#define PIO_ODR_P15     (0x1u << 15)
+#define PIO_ODR_P16     (0x1u << 16)
+#define PIO_ODR_P17     (0x1u << 17)
+#define PIO_ODR_P18     (0x1u << 18)
+#define PIO_ODR_P19     (0x1u << 19)
+#define PIO_ODR_P20     (0x1u << 20)
+#define PIO_ODR_P21     (0x1u << 21)
+#define PIO_ODR_P22     (0x1u << 22)
+#define PIO_ODR_P23     (0x1u << 23)
+#define PIO_ODR_P24     (0x1u << 24)
+#define PIO_ODR_P25     (0x1u << 25)
+#define PIO_ODR_P26     (0x1u << 26)
+#define PIO_ODR_P27     (0x1u << 27)
+#define PIO_ODR_P28     (0x1u << 28)
+#define PIO_ODR_P29     (0x1u << 29)
+#define PIO_ODR_P30     (0x1u << 30)
+#define PIO_ODR_P31     (0x1u << 31)
+#define PIO_OSR_P0      (0x1u << 0)
+#define PIO_OSR_P1      (0x1u << 1)
+#define PIO_OSR_P2      (0x1u << 2)
+#define PIO_OSR_P3      (0x1u << 3)
+#define PIO_OSR_P4      (0x1u << 4)
+#define PIO_OSR_P5      (0x1u << 5)
+#define PIO_OSR_P6      (0x1u << 6)
+#define PIO_OSR_P7      (0x1u << 7)
+#define PIO_OSR_P8      (0x1u << 8)
+#define PIO_OSR_P9      (0x1u << 9)
+#define PIO_OSR_P10     (0x1u << 10)
+#define PIO_OSR_P11     (0x1u << 11)
+#define PIO_OSR_P12     (0x1u << 12)
+#define PIO_OSR_P13     (0x1u << 13)
+#define PIO_OSR_P14     (0x1u << 14)
+#define PIO_OSR_P15     (0x1u << 15)
+#define PIO_OSR_P16     (0x1u << 16)
+#define PIO_OSR_P17     (0x1u << 17)
+#define PIO_OSR_P18     (0x1u << 18)
+#define PIO_OSR_P19     (0x1u << 19)
+#define PIO_OSR_P20     (0x1u << 20)
+#define PIO_OSR_P21     (0x1u << 21)
+#define PIO_OSR_P22     (0x1u << 22)
+#define PIO_OSR_P23     (0x1u << 23)
+#define PIO_OSR_P24     (0x1u << 24)
+#define PIO_OSR_P25     (0x1u << 25)
+#define PIO_OSR_P26     (0x1u << 26)
+#define PIO_OSR_P27     (0x1u << 27)
+#define PIO_OSR_P28     (0x1u << 28)
+#define PIO_OSR_P29     (0x1u << 29)
+#define PIO_OSR_P30     (0x1u << 30)
+#define PIO_OSR_P31     (0x1u << 31)
+#define PIO_IFER_P0     (0x1u << 0)
+#define PIO_IFER_P1     (0x1u << 1)
+#define PIO_IFER_P2     (0x1u << 2)
+#define PIO_IFER_P3     (0x1u << 3)
+#define PIO_IFER_P4     (0x1u << 4)
+#define PIO_IFER_P5     (0x1u << 5)
+#define PIO_IFER_P6     (0x1u << 6)
+#define PIO_IFER_P7     (0x1u << 7)
+#define PIO_IFER_P8     (0x1u << 8)
+#define PIO_IFER_P9     (0x1u << 9)
+#define PIO_IFER_P10    (0x1u << 10)
+#define PIO_IFER_P11    (0x1u << 11)
+#define PIO_IFER_P12    (0x1u << 12)
+#define PIO_IFER_P13    (0x1u << 13)
+#define PIO_IFER_P14    (0x1u << 14)
+#define PIO_IFER_P15    (0x1u << 15)
+#define PIO_IFER_P16    (0x1u << 16)
+#define PIO_IFER_P17    (0x1u << 17)
+#define PIO_IFER_P18    (0x1u << 18)
+#define PIO_IFER_P19    (0x1u << 19)
+#define PIO_IFER_P20    (0x1u << 20)
+#define PIO_IFER_P21    (0x1u << 21)
+#define PIO_IFER_P22    (0x1u << 22)
+#define PIO_IFER_P23    (0x1u << 23)
+#define PIO_IFER_P24    (0x1u << 24)
+#define PIO_IFER_P25    (0x1u << 25)
+#define PIO_IFER_P26    (0x1u << 26)
+#define PIO_IFER_P27    (0x1u << 27)
+#define PIO_IFER_P28    (0x1u << 28)
+#define PIO_IFER_P29    (0x1u << 29)
+#define PIO_IFER_P30    (0x1u << 30)
+#define PIO_IFER_P31    (0x1u << 31)
+#define PIO_IFDR_P0     (0x1u << 0)
+#define PIO_IFDR_P1     (0x1u << 1)
+#define PIO_IFDR_P2     (0x1u << 2)
+#define PIO_IFDR_P3     (0x1u << 3)
+#define PIO_IFDR_P4     (0x1u << 4)
+#define PIO_IFDR_P5     (0x1u << 5)
+#define PIO_IFDR_P6     (0x1u << 6)
+#define PIO_IFDR_P7     (0x1u << 7)
+#define PIO_IFDR_P8     (0x1u << 8)
+#define PIO_IFDR_P9     (0x1u << 9)
+#define PIO_IFDR_P10    (0x1u << 10)
+#define PIO_IFDR_P11    (0x1u << 11)
+#define PIO_IFDR_P12    (0x1u << 12)
+#define PIO_IFDR_P13    (0x1u << 13)
+#define PIO_IFDR_P14    (0x1u << 14)
+#define PIO_IFDR_P15    (0x1u << 15)
+#define PIO_IFDR_P16    (0x1u << 16)
+#define PIO_IFDR_P17    (0x1u << 17)
+#define PIO_IFDR_P18    (0x1u << 18)
+#define PIO_IFDR_P19    (0x1u << 19)
+#define PIO_IFDR_P20    (0x1u << 20)
+#define PIO_IFDR_P21    (0x1u << 21)
+#define PIO_IFDR_P22    (0x1u << 22)
+#define PIO_IFDR_P23    (0x1u << 23)
+#define PIO_IFDR_P24    (0x1u << 24)
+#define PIO_IFDR_P25    (0x1u << 25)
+#define PIO_IFDR_P26    (0x1u << 26)
+#define PIO_IFDR_P27    (0x1u << 27)
+#define PIO_IFDR_P28    (0x1u << 28)
+#define PIO_IFDR_P29    (0x1u << 29)
+#define PIO_IFDR_P30    (0x1u << 30)
+#define PIO_IFDR_P31    (0x1u << 31)
+#define PIO_SODR_P0     (0x1u << 0)
+#define PIO_SODR_P1     (0x1u << 1)
+#define PIO_SODR_P2     (0x1u << 2)
+#define PIO_SODR_P3     (0x1u << 3)
+#define PIO_SODR_P4     (0x1u << 4)
+#define PIO_SODR_P5     (0x1u << 5)
+#define PIO_SODR_P6     (0x1u << 6)
+#define PIO_SODR_P7     (0x1u << 7)
+#define PIO_SODR_P8     (0x1u << 8)
+#define PIO_SODR_P9     (0x1u << 9)
+#define PIO_SODR_P10    (0x1u << 10)
+#define PIO_SODR_P11    (0x1u << 11)
+#define PIO_SODR_P12    (0x1u << 12)
+#define PIO_SODR_P13    (0x1u << 13)
+#define PIO_SODR_P14    (0x1u << 14)
+#define PIO_SODR_P15    (0x1u << 15)
+#define PIO_SODR_P16    (0x1u << 16)
+#define PIO_SODR_P17    (0x1u << 17)
+#define PIO_SODR_P18    (0x1u << 18)
+#define PIO_SODR_P19    (0x1u << 19)
+#define PIO_SODR_P20    (0x1u << 20)
+#define PIO_SODR_P21    (0x1u << 21)
+#define PIO_SODR_P22    (0x1u << 22)
+#define PIO_SODR_P23    (0x1u << 23)
+#define PIO_SODR_P24    (0x1u << 24)
+#define PIO_SODR_P25    (0x1u << 25)
+#define PIO_SODR_P26    (0x1u << 26)
+#define PIO_SODR_P27    (0x1u << 27)
+#define PIO_SODR_P28    (0x1u << 28)
+#define PIO_SODR_P29    (0x1u << 29)
+#define PIO_SODR_P30    (0x1u << 30)
+#define PIO_SODR_P31    (0x1u << 31)
+#define PIO_CODR_P0     (0x1u << 0)
+#define PIO_CODR_P1     (0x1u << 1)
+#define PIO_CODR_P2     (0x1u << 2)
+#define PIO_CODR_P3     (0x1u << 3)
+#define PIO_CODR_P4     (0x1u << 4)
+#define PIO_CODR_P5     (0x1u << 5)
+#define PIO_CODR_P6     (0x1u << 6)
+#define PIO_CODR_P7     (0x1u << 7)
+#define PIO_CODR_P8     (0x1u << 8)
+#define PIO_CODR_P9     (0x1u << 9)
+#define PIO_CODR_P10    (0x1u << 10)
+#define PIO_CODR_P11    (0x1u << 11)
+#define PIO_CODR_P12    (0x1u << 12)
+#define PIO_CODR_P13    (0x1u << 13)
+#define PIO_CODR_P14    (0x1u << 14)
+#define PIO_CODR_P15    (0x1u << 15)
+#define PIO_CODR_P16    (0x1u << 16)
+#define PIO_CODR_P17    (0x1u << 17)
+#define PIO_CODR_P18    (0x1u << 18)
+#define PIO_CODR_P19    (0x1u << 19)
+#define PIO_CODR_P20    (0x1u << 20)
+#define PIO_CODR_P21    (0x1u << 21)
+#define PIO_CODR_P22    (0x1u << 22)
+#define PIO_CODR_P23    (0x1u << 23)
+#define PIO_CODR_P24    (0x1u << 24)
+#define PIO_CODR_P25    (0x1u << 25)
+#define PIO_CODR_P26    (0x1u << 26)
+#define PIO_CODR_P27    (0x1u << 27)
+#define PIO_CODR_P28    (0x1u << 28)
+#define PIO_CODR_P29    (0x1u << 29)
+#define PIO_CODR_P30    (0x1u << 30)
+#define PIO_CODR_P31    (0x1u << 31)
+#define PIO_ODSR_P0     (0x1u << 0)
+#define PIO_ODSR_P1     (0x1u << 1)
+#define PIO_ODSR_P2     (0x1u << 2)
+#define PIO_ODSR_P3     (0x1u << 3)
+#define PIO_ODSR_P4     (0x1u << 4)
+#define PIO_ODSR_P5     (0x1u << 5)
+#define PIO_ODSR_P6     (0x1u << 6)
+#define PIO_ODSR_P7     (0x1u << 7)
+#define PIO_ODSR_P8     (0x1u << 8)
+#define PIO_ODSR_P9     (0x1u << 9)
+#define PIO_ODSR_P10    (0x1u << 10)
+#define PIO_ODSR_P11    (0x1u << 11)
+#define PIO_ODSR_P12    (0x1u << 12)
+#define PIO_ODSR_P13    (0x1u << 13)
+#define PIO_ODSR_P14    (0x1u << 14)
+#define PIO_ODSR_P15    (0x1u << 15)
+#define PIO_ODSR_P16    (0x1u << 16)
+#define PIO_ODSR_P17    (0x1u << 17)
+#define PIO_ODSR_P18    (0x1u << 18)
+#define PIO_ODSR_P19    (0x1u << 19)
+#define PIO_ODSR_P20    (0x1u << 20)
+#define PIO_ODSR_P21    (0x1u << 21)
+#define PIO_ODSR_P22    (0x1u << 22)
+#define PIO_ODSR_P23    (0x1u << 23)
+#define PIO_ODSR_P24    (0x1u << 24)
+#define PIO_ODSR_P25    (0x1u << 25)
+#define PIO_ODSR_P26    (0x1u << 26)
+#define PIO_ODSR_P27    (0x1u << 27)
+#define PIO_ODSR_P28    (0x1u << 28)
+#define PIO_ODSR_P29    (0x1u << 29)
+#define PIO_ODSR_P30    (0x1u << 30)
+#define PIO_ODSR_P31    (0x1u << 31)
+#define PIO_PDSR_P0     (0x1u << 0)
+#define PIO_PDSR_P1     (0x1u << 1)
+#define PIO_PDSR_P2     (0x1u << 2)
+#define PIO_PDSR_P3     (0x1u << 3)
+#define PIO_PDSR_P4     (0x1u << 4)
+#define PIO_PDSR_P5     (0x1u << 5)
+#define PIO_PDSR_P6     (0x1u << 6)
+#define PIO_PDSR_P7     (0x1u << 7)
+#define PIO_PDSR_P8     (0x1u << 8)
+#define PIO_PDSR_P9     (0x1u << 9)
+#define PIO_PDSR_P10    (0x1u << 10)
+#define PIO_PDSR_P11    (0x1u << 11)
+#define PIO_PDSR_P12    (0x1u << 12)
+#define PIO_PDSR_P13    (0x1u << 13)
+#define PIO_PDSR_P14    (0x1u << 14)
+#define PIO_PDSR_P15    (0x1u << 15)
+#define PIO_PDSR_P16    (0x1u << 16)
+#define PIO_PDSR_P17    (0x1u << 17)
+#define PIO_PDSR_P18    (0x1u << 18)
+#define PIO_PDSR_P19    (0x1u << 19)
+#define PIO_PDSR_P20    (0x1u << 20)
+#define PIO_PDSR_P21    (0x1u << 21)
+#define PIO_PDSR_P22    (0x1u << 22)
+#define PIO_PDSR_P23    (0x1u << 23)
+#define PIO_PDSR_P24    (0x1u << 24)
+#define PIO_PDSR_P25    (0x1u << 25)
+#define PIO_PDSR_P26    (0x1u << 26)
+#define PIO_PDSR_P27    (0x1u << 27)
+#define PIO_PDSR_P28    (0x1u << 28)
+#define PIO_PDSR_P29    (0x1u << 29)
+#define PIO_PDSR_P30    (0x1u << 30)
+#define PIO_PDSR_P31    (0x1u << 31)
+#define PIO_IER_P0      (0x1u << 0)
+#define PIO_IER_P1      (0x1u << 1)
+#define PIO_IER_P2      (0x1u << 2)
+#define PIO_IER_P3      (0x1u << 3)
+#define PIO_IER_P4      (0x1u << 4)
+#define PIO_IER_P5      (0x1u << 5)
+#define PIO_IER_P6      (0x1u << 6)
+#define PIO_IER_P7      (0x1u << 7)
+#define PIO_IER_P8      (0x1u << 8)
+#define PIO_IER_P9      (0x1u << 9)
+#define PIO_IER_P10     (0x1u << 10)
+#define PIO_IER_P11     (0x1u << 11)
+#define PIO_IER_P12     (0x1u << 12)
+#define PIO_IER_P13     (0x1u << 13)
+#define PIO_IER_P14     (0x1u << 14)
+#define PIO_IER_P15     (0x1u << 15)
+#define PIO_IER_P16     (0x1u << 16)
+#define PIO_IER_P17     (0x1u << 17)
+#define PIO_IER_P18     (0x1u << 18)
+#define PIO_IER_P19     (0x1u << 19)
+#define PIO_IER_P20     (0x1u << 20)
+#define PIO_IER_P21     (0x1u << 21)
+#define PIO_IER_P22     (0x1u << 22)
+#define PIO_IER_P23     (0x1u << 23)
+#define PIO_IER_P24     (0x1u << 24)
+#define PIO_IER_P25     (0x1u << 25)
+#define PIO_IER_P26     (0x1u << 26)
+#define PIO_IER_P27     (0x1u << 27)
+#define PIO_IER_P28     (0x1u << 28)
+#define PIO_IER_P29     (0x1u << 29)
+#define PIO_IER_P30     (0x1u << 30)
+#define PIO_IER_P31     (0x1u << 31)
+#define PIO_IDR_P0      (0x1u << 0)
+#define PIO_IDR_P1      (0x1u << 1)
+#define PIO_IDR_P2      (0x1u << 2)
+#define PIO_IDR_P3      (0x1u << 3)
+#define PIO_IDR_P4      (0x1u << 4)
+#define PIO_IDR_P5      (0x1u << 5)
+#define PIO_IDR_P6      (0x1u << 6)
+#define PIO_IDR_P7      (0x1u << 7)
+#define PIO_IDR_P8      (0x1u << 8)
+#define PIO_IDR_P9      (0x1u << 9)
+#define PIO_IDR_P10     (0x1u << 10)
+#define PIO_IDR_P11     (0x1u << 11)
+#define PIO_IDR_P12     (0x1u << 12)
+#define PIO_IDR_P13     (0x1u << 13)
+#define PIO_IDR_P14     (0x1u << 14)
+#define PIO_IDR_P15     (0x1u << 15)
+#define PIO_IDR_P16     (0x1u << 16)
+#define PIO_IDR_P17     (0x1u << 17)
+#define PIO_IDR_P18     (0x1u << 18)
+#define PIO_IDR_P19     (0x1u << 19)
+#define PIO_IDR_P20     (0x1u << 20)
+#define PIO_IDR_P21     (0x1u << 21)
+#define PIO_IDR_P22     (0x1u << 22)
+#define PIO_IDR_P23     (0x1u << 23)
+#define PIO_IDR_P24     (0x1u << 24)
+#define PIO_IDR_P25     (0x1u << 25)
+#define PIO_IDR_P26     (0x1u << 26)
+#define PIO_IDR_P27     (0x1u << 27)
+#define PIO_IDR_P28     (0x1u << 28)
+#define PIO_IDR_P29     (0x1u << 29)
+#define PIO_IDR_P30     (0x1u << 30)
+#define PIO_IDR_P31     (0x1u << 31)
+#define PIO_IMR_P0      (0x1u << 0)
+#define PIO_IMR_P1      (0x1u << 1)
+#define PIO_IMR_P2      (0x1u << 2)
+#define PIO_IMR_P3      (0x1u << 3)
+#define PIO_IMR_P4      (0x1u << 4)
+#define PIO_IMR_P5      (0x1u << 5)
+#define PIO_IMR_P6      (0x1u << 6)
+#define PIO_IMR_P7      (0x1u << 7)
+#define PIO_IMR_P8      (0x1u << 8)
+#define PIO_IMR_P9      (0x1u << 9)
+#define PIO_IMR_P10     (0x1u << 10)
+#define PIO_IMR_P11     (0x1u << 11)
+#define PIO_IMR_P12     (0x1u << 12)
+#define PIO_IMR_P13     (0x1u << 13)
+#define PIO_IMR_P14     (0x1u << 14)
+#define PIO_IMR_P15     (0x1u << 15)
+#define PIO_IMR_P16     (0x1u << 16)
+#define PIO_IMR_P17     (0x1u << 17)
+#define PIO_IMR_P18     (0x1u << 18)
+#define PIO_IMR_P19     (0x1u << 19)
+#define PIO_IMR_P20     (0x1u << 20)
+#define PIO_IMR_P21     (0x1u << 21)
+#define PIO_IMR_P22     (0x1u << 22)
+#define PIO_IMR_P23     (0x1u << 23)
+#define PIO_IMR_P24     (0x1u << 24)
+#define PIO_IMR_P25     (0x1u << 25)
+#define PIO_IMR_P26     (0x1u << 26)
+#define PIO_IMR_P27     (0x1u << 27)
+#define PIO_IMR_P28     (0x1u << 28)
+#define PIO_IMR_P29     (0x1u << 29)
+#define PIO_IMR_P30     (0x1u << 30)
+#define PIO_IMR_P31     (0x1u << 31)
+#define PIO_ISR_P0      (0x1u << 0)
+#define PIO_ISR_P1      (0x1u << 1)
+#define PIO_ISR_P2      (0x1u << 2)
+#define PIO_ISR_P3      (0x1u << 3)
+#define PIO_ISR_P4      (0x1u << 4)
+#define PIO_ISR_P5      (0x1u << 5)
+#define PIO_ISR_P6      (0x1u << 6)
+#define PIO_ISR_P7      (0x1u << 7)
+#define PIO_ISR_P8      (0x1u << 8)
+#define PIO_ISR_P9      (0x1u << 9)
+#define PIO_ISR_P10     (0x1u << 10)
+#define PIO_ISR_P11     (0x1u << 11)
+#define PIO_ISR_P12     (0x1u << 12)
+#define PIO_ISR_P13     (0x1u << 13)
+#define PIO_ISR_P14     (0x1u << 14)
+#define PIO_ISR_P15     (0x1u << 15)
+#define PIO_ISR_P16     (0x1u << 16)
+#define PIO_ISR_P17     (0x1u << 17)
+#define PIO_ISR_P18     (0x1u << 18)
+#define PIO_ISR_P19     (0x1u << 19)
+#define PIO_ISR_P20     (0x1u << 20)
+#define PIO_ISR_P21     (0x1u << 21)
+#define PIO_ISR_P22     (0x1u << 22)
+#define PIO_ISR_P23     (0x1u << 23)
+#define PIO_ISR_P24     (0x1u << 24)
+#define PIO_ISR_P25     (0x1u << 25)
+#define PIO_ISR_P26     (0x1u << 26)
+#define PIO_ISR_P27     (0x1u << 27)
+#define PIO_ISR_P28     (0x1u << 28)
+#define PIO_ISR_P29     (0x1u << 29)
+#define PIO_ISR_P30     (0x1u << 30)
+#define PIO_ISR_P31     (0x1u << 31)
+#define PIO_MDER_P0     (0x1u << 0)
+#define PIO_MDER_P1     (0x1u << 1)
+#define PIO_MDER_P2     (0x1u << 2)
+#define PIO_MDER_P3     (0x1u << 3)
+#define PIO_MDER_P4     (0x1u << 4)
+#define PIO_MDER_P5     (0x1u << 5)
+#define PIO_MDER_P6     (0x1u << 6)
+#define PIO_MDER_P7     (0x1u << 7)
+#define PIO_MDER_P8     (0x1u << 8)
+#define PIO_MDER_P9     (0x1u << 9)
+#define PIO_MDER_P10    (0x1u << 10)
+#define PIO_MDER_P11    (0x1u << 11)
+#define PIO_MDER_P12    (0x1u << 12)
+#define PIO_MDER_P13    (0x1u << 13)
+#define PIO_MDER_P14    (0x1u << 14)
+#define PIO_MDER_P15    (0x1u << 15)
+#define PIO_MDER_P16    (0x1u << 16)
+#define PIO_MDER_P17    (0x1u << 17)
+#define PIO_MDER_P18    (0x1u << 18)
+#define PIO_MDER_P19    (0x1u << 19)
+#define PIO_MDER_P20    (0x1u << 20)
+#define PIO_MDER_P21    (0x1u << 21)
+#define PIO_MDER_P22    (0x1u << 22)
+#define PIO_MDER_P23    (0x1u << 23)
+#define PIO_MDER_P24    (0x1u << 24)
+#define PIO_MDER_P25    (0x1u << 25)
+#define PIO_MDER_P26    (0x1u << 26)
+#define PIO_MDER_P27    (0x1u << 27)
+#define PIO_MDER_P28    (0x1u << 28)
+#define PIO_MDER_P29    (0x1u << 29)
+#define PIO_MDER_P30    (0x1u << 30)
+#define PIO_MDER_P31    (0x1u << 31)
+#define PIO_MDDR_P0     (0x1u << 0)
+#define PIO_MDDR_P1     (0x1u << 1)
+#define PIO_MDDR_P2     (0x1u << 2)
+#define PIO_MDDR_P3     (0x1u << 3)
+#define PIO_MDDR_P4     (0x1u << 4)
+#define PIO_MDDR_P5     (0x1u << 5)
+#define PIO_MDDR_P6     (0x1u << 6)
+#define PIO_MDDR_P7     (0x1u << 7)
+#define PIO_MDDR_P8     (0x1u << 8)
+#define PIO_MDDR_P9     (0x1u << 9)
+#define PIO_MDDR_P10    (0x1u << 10)
+#define PIO_MDDR_P11    (0x1u << 11)
+#define PIO_MDDR_P12    (0x1u << 12)
+#define PIO_MDDR_P13    (0x1u << 13)
+#define PIO_MDDR_P14    (0x1u << 14)
+#define PIO_MDDR_P15    (0x1u << 15)
+#define PIO_MDDR_P16    (0x1u << 16)
+#define PIO_MDDR_P17    (0x1u << 17)
+#define PIO_MDDR_P18    (0x1u << 18)
+#define PIO_MDDR_P19    (0x1u << 19)
+#define PIO_MDDR_P20    (0x1u << 20)
+#define PIO_MDDR_P21    (0x1u << 21)
+#define PIO_MDDR_P22    (0x1u << 22)
+#define PIO_MDDR_P23    (0x1u << 23)
+#define PIO_MDDR_P24    (0x1u << 24)
+#define PIO_MDDR_P25    (0x1u << 25)
+#define PIO_MDDR_P26    (0x1u << 26)
+#define PIO_MDDR_P27    (0x1u << 27)
+#define PIO_MDDR_P28    (0x1u << 28)
+#define PIO_MDDR_P29    (0x1u << 29)
+#define PIO_MDDR_P30    (0x1u << 30)
+#define PIO_MDDR_P31    (0x1u << 31)
+#define PIO_PUDR_P0     (0x1u << 0)
+#define PIO_PUDR_P1     (0x1u << 1)
+#define PIO_PUDR_P2     (0x1u << 2)
+#define PIO_PUDR_P3     (0x1u << 3)
+#define PIO_PUDR_P4     (0x1u << 4)
+#define PIO_PUDR_P5     (0x1u << 5)
+#define PIO_PUDR_P6     (0x1u << 6)
+#define PIO_PUDR_P7     (0x1u << 7)
+#define PIO_PUDR_P8     (0x1u << 8)
+#define PIO_PUDR_P9     (0x1u << 9)
+#define PIO_PUDR_P10    (0x1u << 10)
+#define PIO_PUDR_P11    (0x1u << 11)
+#define PIO_PUDR_P12    (0x1u << 12)
+#define PIO_PUDR_P13    (0x1u << 13)
+#define PIO_PUDR_P14    (0x1u << 14)
+#define PIO_PUDR_P15    (0x1u << 15)
+#define PIO_PUDR_P16    (0x1u << 16)
+#define PIO_PUDR_P17    (0x1u << 17)
+#define PIO_PUDR_P18    (0x1u << 18)
+#define PIO_PUDR_P19    (0x1u << 19)
+#define PIO_PUDR_P20    (0x1u << 20)
+#define PIO_PUDR_P21    (0x1u << 21)
+#define PIO_PUDR_P22    (0x1u << 22)
+#define PIO_PUDR_P23    (0x1u << 23)
+#define PIO_PUDR_P24    (0x1u << 24)
+#define PIO_PUDR_P25    (0x1u << 25)
+#define PIO_PUDR_P26    (0x1u << 26)
+#define PIO_PUDR_P27    (0x1u << 27)
+#define PIO_PUDR_P28    (0x1u << 28)
+#define PIO_PUDR_P29    (0x1u << 29)
+#define PIO_PUDR_P30    (0x1u << 30)
+#define PIO_PUDR_P31    (0x1u << 31)
+#define PIO_PUER_P0     (0x1u << 0)
+#define PIO_PUER_P1     (0x1u << 1)
+#define PIO_PUER_P2     (0x1u << 2)
+#define PIO_PUER_P3     (0x1u << 3)
+#define PIO_PUER_P4     (0x1u << 4)
+#define PIO_PUER_P5     (0x1u << 5)
+#define PIO_PUER_P6     (0x1u << 6)
+#define PIO_PUER_P7     (0x1u << 7)
+#define PIO_PUER_P8     (0x1u << 8)
+#define PIO_PUER_P9     (0x1u << 9)
+#define PIO_PUER_P10    (0x1u << 10)
+#define PIO_PUER_P11    (0x1u << 11)
+#define PIO_PUER_P12    (0x1u << 12)
+#define PIO_PUER_P13    (0x1u << 13)
+#define PIO_PUER_P14    (0x1u << 14)
+#define PIO_PUER_P15    (0x1u << 15)
+#define PIO_PUER_P16    (0x1u << 16)
+#define PIO_PUER_P17    (0x1u << 17)
+#define PIO_PUER_P18    (0x1u << 18)
+#define PIO_PUER_P19    (0x1u << 19)
+#define PIO_PUER_P20    (0x1u << 20)
+#define PIO_PUER_P21    (0x1u << 21)
+#define PIO_PUER_P22    (0x1u << 22)
+#define PIO_PUER_P23    (0x1u << 23)
+#define PIO_PUER_P24    (0x1u << 24)
+#define PIO_PUER_P25    (0x1u << 25)
+#define PIO_PUER_P26    (0x1u << 26)
+#define PIO_PUER_P27    (0x1u << 27)
+#define PIO_PUER_P28    (0x1u << 28)
+#define PIO_PUER_P29    (0x1u << 29)
+#define PIO_PUER_P30    (0x1u << 30)
+#define PIO_PUER_P31    (0x1u << 31)
+#define PIO_ABCDSR_P0   (0x1u << 0)
+#define PIO_ABCDSR_P1   (0x1u << 1)
+#define PIO_ABCDSR_P2   (0x1u << 2)
+#define PIO_ABCDSR_P3   (0x1u << 3)
+#define PIO_ABCDSR_P4   (0x1u << 4)
+#define PIO_ABCDSR_P5   (0x1u << 5)
+#define PIO_ABCDSR_P6   (0x1u << 6)
+#define PIO_ABCDSR_P7   (0x1u << 7)
+#define PIO_ABCDSR_P8   (0x1u << 8)
+#define PIO_ABCDSR_P9   (0x1u << 9)
+#define PIO_ABCDSR_P10  (0x1u << 10)
+#define PIO_ABCDSR_P11  (0x1u << 11)
+#define PIO_ABCDSR_P12  (0x1u << 12)
+#define PIO_ABCDSR_P13  (0x1u << 13)
+#define PIO_ABCDSR_P14  (0x1u << 14)
+#define PIO_ABCDSR_P15  (0x1u << 15)
+#define PIO_ABCDSR_P16  (0x1u << 16)
+#define PIO_ABCDSR_P17  (0x1u << 17)
+#define PIO_ABCDSR_P18  (0x1u << 18)
+#define PIO_ABCDSR_P19  (0x1u << 19)
+#define PIO_ABCDSR_P20  (0x1u << 20)
+#define PIO_ABCDSR_P21  (0x1u << 21)
+#define PIO_ABCDSR_P22  (0x1u << 22)
+#define PIO_ABCDSR_P23  (0x1u << 23)
+#define PIO_ABCDSR_P24  (0x1u << 24)
+#define PIO_ABCDSR_P25  (0x1u << 25)
+#define PIO_ABCDSR_P26  (0x1u << 26)
+#define PIO_ABCDSR_P27  (0x1u << 27)
+#define PIO_ABCDSR_P28  (0x1u << 28)
+#define PIO_ABCDSR_P29  (0x1u << 29)
+#define PIO_ABCDSR_P30  (0x1u << 30)
+#define PIO_ABCDSR_P31  (0x1u << 31)
+#define PIO_OWER_P0     (0x1u << 0)
+#define PIO_OWER_P1     (0x1u << 1)
+#define PIO_OWER_P2     (0x1u << 2)
+#define PIO_OWER_P3     (0x1u << 3)
+#define PIO_OWER_P4     (0x1u << 4)
+#define PIO_OWER_P5     (0x1u << 5)
+#define PIO_OWER_P6     (0x1u << 6)
+#define PIO_OWER_P7     (0x1u << 7)
+#define PIO_OWER_P8     (0x1u << 8)
+#define PIO_OWER_P9     (0x1u << 9)
+#define PIO_OWER_P10    (0x1u << 10)
+#define PIO_OWER_P11    (0x1u << 11)
+#define PIO_OWER_P12    (0x1u << 12)
+#define PIO_OWER_P13    (0x1u << 13)
+#define PIO_OWER_P14    (0x1u << 14)
+#define PIO_OWER_P15    (0x1u << 15)
+#define PIO_OWER_P16    (0x1u << 16)
+#define PIO_OWER_P17    (0x1u << 17)
+#define PIO_OWER_P18    (0x1u << 18)
+#define PIO_OWER_P19    (0x1u << 19)
+#define PIO_OWER_P20    (0x1u << 20)
+#define PIO_OWER_P21    (0x1u << 21)
+#define PIO_OWER_P22    (0x1u << 22)
+#define PIO_OWER_P23    (0x1u << 23)
+#define PIO_OWER_P24    (0x1u << 24)
+#define PIO_OWER_P25    (0x1u << 25)
+#define PIO_OWER_P26    (0x1u << 26)
+#define PIO_OWER_P27    (0x1u << 27)
+#define PIO_OWER_P28    (0x1u << 28)
+#define PIO_OWER_P29    (0x1u << 29)
+#define PIO_OWER_P30    (0x1u << 30)
+#define PIO_OWER_P31    (0x1u << 31)
+#define PIO_OWDR_P0     (0x1u << 0)
+#define PIO_OWDR_P1     (0x1u << 1)
+#define PIO_OWDR_P2     (0x1u << 2)
+#define PIO_OWDR_P3     (0x1u << 3)
+#define PIO_OWDR_P4     (0x1u << 4)
+#define PIO_OWDR_P5     (0x1u << 5)
+#define PIO_OWDR_P6     (0x1u << 6)
+#define PIO_OWDR_P7     (0x1u << 7)
+#define PIO_OWDR_P8     (0x1u << 8)
+#define PIO_OWDR_P9     (0x1u << 9)
+#define PIO_OWDR_P10    (0x1u << 10)
+#define PIO_OWDR_P11    (0x1u << 11)
+#define PIO_OWDR_P12    (0x1u << 12)
+#define PIO_OWDR_P13    (0x1u << 13)
+#define PIO_OWDR_P14    (0x1u << 14)
+#define PIO_OWDR_P15    (0x1u << 15)
+#define PIO_OWDR_P16    (0x1u << 16)
+#define PIO_OWDR_P17    (0x1u << 17)
+#define PIO_OWDR_P18    (0x1u << 18)
+#define PIO_OWDR_P19    (0x1u << 19)
+#define PIO_OWDR_P20    (0x1u << 20)
+#define PIO_OWDR_P21    (0x1u << 21)
+#define PIO_OWDR_P22    (0x1u << 22)
+#define PIO_OWDR_P23    (0x1u << 23)
+#define PIO_OWDR_P24    (0x1u << 24)
+#define PIO_OWDR_P25    (0x1u << 25)
+#define PIO_OWDR_P26    (0x1u << 26)
+#define PIO_OWDR_P27    (0x1u << 27)
+#define PIO_OWDR_P28    (0x1u << 28)
+#define PIO_OWDR_P29    (0x1u << 29)
+#define PIO_OWDR_P30    (0x1u << 30)
+#define PIO_OWDR_P31    (0x1u << 31)
+#define PIO_PPDDR_P0    (0x1u << 0)
+#define PIO_PPDDR_P1    (0x1u << 1)
+#define PIO_PPDDR_P2    (0x1u << 2)
+#define PIO_PPDDR_P3    (0x1u << 3)
+#define PIO_PPDDR_P4    (0x1u << 4)
+#define PIO_PPDDR_P5    (0x1u << 5)
+#define PIO_PPDDR_P6    (0x1u << 6)
+#define PIO_PPDDR_P7    (0x1u << 7)
+#define PIO_PPDDR_P8    (0x1u << 8)
+#define PIO_PPDDR_P9    (0x1u << 9)
+#define PIO_PPDDR_P10   (0x1u << 10)
+#define PIO_PPDDR_P11   (0x1u << 11)
+#define PIO_PPDDR_P12   (0x1u << 12)
+#define PIO_PPDDR_P13   (0x1u << 13)
+#define PIO_PPDDR_P14   (0x1u << 14)
+#define PIO_PPDDR_P15   (0x1u << 15)
+#define PIO_PPDDR_P16   (0x1u << 16)
+#define PIO_PPDDR_P17   (0x1u << 17)
+#define PIO_PPDDR_P18   (0x1u << 18)
+#define PIO_PPDDR_P19   (0x1u << 19)
+#define PIO_PPDDR_P20   (0x1u << 20)
+#define PIO_PPDDR_P21   (0x1u << 21)
+#define PIO_PPDDR_P22   (0x1u << 22)
+#define PIO_PPDDR_P23   (0x1u << 23)
+#define PIO_PPDDR_P24   (0x1u << 24)
+#define PIO_PPDDR_P25   (0x1u << 25)
+#define PIO_PPDDR_P26   (0x1u << 26)
+#define PIO_PPDDR_P27   (0x1u << 27)
+#define PIO_PPDDR_P28   (0x1u << 28)
+#define PIO_PPDDR_P29   (0x1u << 29)
+#define PIO_PPDDR_P30   (0x1u << 30)
+#define PIO_PPDDR_P31   (0x1u << 31)
+#define PIO_PPDER_P0    (0x1u << 0)
+#define PIO_PPDER_P1    (0x1u << 1)
+#define PIO_PPDER_P2    (0x1u << 2)
+#define PIO_PPDER_P3    (0x1u << 3)
+#define PIO_PPDER_P4    (0x1u << 4)
+#define PIO_PPDER_P5    (0x1u << 5)
+#define PIO_PPDER_P6    (0x1u << 6)
+#define PIO_PPDER_P7    (0x1u << 7)
+#define PIO_PPDER_P8    (0x1u << 8)
+#define PIO_PPDER_P9    (0x1u << 9)
+#define PIO_PPDER_P10   (0x1u << 10)
+#define PIO_PPDER_P11   (0x1u << 11)
+#define PIO_PPDER_P12   (0x1u << 12)
+#define PIO_PPDER_P13   (0x1u << 13)
+#define PIO_PPDER_P14   (0x1u << 14)
+#define PIO_PPDER_P15   (0x1u << 15)
+#define PIO_PPDER_P16   (0x1u << 16)
+#define PIO_PPDER_P17   (0x1u << 17)
+#define PIO_PPDER_P18   (0x1u << 18)
+#define PIO_PPDER_P19   (0x1u << 19)
+#define PIO_PPDER_P20   (0x1u << 20)
+#define PIO_PPDER_P21   (0x1u << 21)
+#define PIO_PPDER_P22   (0x1u << 22)
+#define PIO_PPDER_P23   (0x1u << 23)
+#define PIO_PPDER_P24   (0x1u << 24)
+#define PIO_PPDER_P25   (0x1u << 25)
+#define PIO_PPDER_P26   (0x1u << 26)
+#define PIO_PPDER_P27   (0x1u << 27)
+#define PIO_PPDER_P28   (0x1u << 28)
+#define PIO_PPDER_P29   (0x1u << 29)
+#define PIO_PPDER_P30   (0x1u << 30)
+#define PIO_PPDER_P31   (0x1u << 31)
+
+extern Pio gSimPIOA;
+extern Pio gSimPIOB;
+extern Pio gSimPIOC;
+#define PIOA		(&gSimPIOA)
+#define PIOB		(&gSimPIOB)
+#define PIOC		(&gSimPIOC)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//  UART   ////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+	WoReg UART_CR;
+	RwReg UART_MR;
+	WoReg UART_IER;
+	WoReg UART_IDR;
+	RoReg UART_IMR;
+	RoReg UART_SR;
+	RoReg UART_RHR;
+	WoReg UART_THR;
+	RwReg UART_BRGR;
+	SIM_PDC_REGISTERS(UART)
+} Uart;
+
+#define UART_CR_RSTRX				(0x1u << 2)
+#define UART_CR_RSTTX				(0x1u << 3)
+#define UART_CR_RXEN				(0x1u << 4)
+#define UART_CR_RXDIS				(0x1u << 5)
+#define UART_CR_TXEN				(0x1u << 6)
+#define UART_CR_TXDIS				(0x1u << 7)
+#define UART_CR_RSTSTA				(0x1u << 8)
+#define UART_MR_PAR_EVEN			(0x0u << 9)
+#define UART_MR_PAR_ODD				(0x1u << 9)
+#define UART_MR_PAR_NO				(0x4u << 9)
+#define UART_MR_CHMODE_NORMAL		(0x0u << 14)
+#define UART_MR_CHMODE_LOCAL_LOOPBACK	(0x2u << 14)
+#define UART_SR_RXRDY				(0x1u << 0)
+#define UART_SR_TXRDY				(0x1u << 1)
+#define UART_SR_ENDRX				(0x1u << 3)
+#define UART_SR_ENDTX				(0x1u << 4)
+#define UART_SR_OVRE				(0x1u << 5)
+#define UART_SR_FRAME				(0x1u << 6)
+#define UART_SR_PARE				(0x1u << 7)
+#define UART_SR_TXEMPTY				(0x1u << 9)
+#define UART_SR_TXBUFE				(0x1u << 11)
+#define UART_SR_RXBUFF				(0x1u << 12)
+#define UART_IER_RXRDY				UART_SR_RXRDY
+#define UART_IER_TXRDY				UART_SR_TXRDY
+#define UART_IER_ENDRX				UART_SR_ENDRX
+#define UART_IER_ENDTX				UART_SR_ENDTX
+#define UART_IER_TXEMPTY			UART_SR_TXEMPTY
+#define UART_IER_TXBUFE				UART_SR_TXBUFE
+#define UART_IER_RXBUFF				UART_SR_RXBUFF
+#define UART_IDR_RXRDY				UART_SR_RXRDY
+#define UART_IDR_TXRDY				UART_SR_TXRDY
+#define UART_IDR_ENDRX				UART_SR_ENDRX
+#define UART_IDR_ENDTX				UART_SR_ENDTX
+#define UART_IDR_TXEMPTY			UART_SR_TXEMPTY
+#define UART_IDR_TXBUFE				UART_SR_TXBUFE
+#define UART_IDR_RXBUFF				UART_SR_RXBUFF
+#define UART_IMR_RXRDY				UART_SR_RXRDY
+#define UART_IMR_TXRDY				UART_SR_TXRDY
+#define UART_IMR_ENDRX				UART_SR_ENDRX
+#define UART_IMR_ENDTX				UART_SR_ENDTX
+#define UART_IMR_TXBUFE				UART_SR_TXBUFE
+#define UART_BRGR_CD(value)			((0xFFFFu << 0) & ((value) << 0))
+
+extern Uart gSimUART0;
+extern Uart gSimUART1;
+#define UART0		(&gSimUART0)
+#define UART1		(&gSimUART1)
+#define PDC_UART0	((Pdc *)&gSimUART0.UART_RPR)
+#define PDC_UART1	((Pdc *)&gSimUART1.UART_RPR)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//  USART   ///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+	WoReg US_CR;
+	RwReg US_MR;
+	WoReg US_IER;
+	WoReg US_IDR;
+	RoReg US_IMR;
+	RoReg US_CSR;
+	RoReg US_RHR;
+	WoReg US_THR;
+	RwReg US_BRGR;
+	RwReg US_RTOR;
+	RwReg US_TTGR;
+	RwReg US_FIDI;
+	RoReg US_NER;
+	RwReg US_IF;
+	RwReg US_MAN;
+	RwReg US_WPMR;
+	RoReg US_WPSR;
+	SIM_PDC_REGISTERS(US)
+} Usart;
+
+#define US_CR_RSTRX					(0x1u << 2)
+#define US_CR_RSTTX					(0x1u << 3)
+#define US_CR_RXEN					(0x1u << 4)
+#define US_CR_RXDIS					(0x1u << 5)
+#define US_CR_TXEN					(0x1u << 6)
+#define US_CR_TXDIS					(0x1u << 7)
+#define US_CR_RSTSTA				(0x1u << 8)
+#define US_CR_STTTO					(0x1u << 11)
+#define US_CR_RETTO					(0x1u << 15)
+#define US_CR_RTSEN					(0x1u << 18)
+#define US_CR_RTSDIS				(0x1u << 19)
+#define US_MR_USART_MODE_Msk		(0xFu << 0)
+#define US_MR_USART_MODE_NORMAL		(0x0u << 0)
+#define US_MR_USART_MODE_HW_HANDSHAKING	(0x2u << 0)
+#define US_MR_USCLKS_MCK			(0x0u << 4)
+#define US_MR_CHRL_8_BIT			(0x3u << 6)
+#define US_MR_PAR_NO				(0x4u << 9)
+#define US_MR_NBSTOP_1_BIT			(0x0u << 12)
+#define US_MR_CHMODE_NORMAL			(0x0u << 14)
+#define US_MR_OVER					(0x1u << 19)
+#define US_MR_ONEBIT				(0x1u << 31)
+#define US_CSR_RXRDY				(0x1u << 0)
+#define US_CSR_TXRDY				(0x1u << 1)
+#define US_CSR_ENDRX				(0x1u << 3)
+#define US_CSR_ENDTX				(0x1u << 4)
+#define US_CSR_OVRE					(0x1u << 5)
+#define US_CSR_FRAME				(0x1u << 6)
+#define US_CSR_PARE					(0x1u << 7)
+#define US_CSR_TIMEOUT				(0x1u << 8)
+#define US_CSR_TXEMPTY				(0x1u << 9)
+#define US_CSR_TXBUFE				(0x1u << 11)
+#define US_CSR_RXBUFF				(0x1u << 12)
+#define US_CSR_CTSIC				(0x1u << 19)
+#define US_CSR_CTS					(0x1u << 23)
+#define US_IER_RXRDY				US_CSR_RXRDY
+#define US_IER_TXRDY				US_CSR_TXRDY
+#define US_IER_ENDRX				US_CSR_ENDRX
+#define US_IER_ENDTX				US_CSR_ENDTX
+#define US_IER_TIMEOUT				US_CSR_TIMEOUT
+#define US_IER_TXEMPTY				US_CSR_TXEMPTY
+#define US_IER_TXBUFE				US_CSR_TXBUFE
+#define US_IER_RXBUFF				US_CSR_RXBUFF
+#define US_IDR_RXRDY				US_CSR_RXRDY
+#define US_IDR_TXRDY				US_CSR_TXRDY
+#define US_IDR_ENDRX				US_CSR_ENDRX
+#define US_IDR_ENDTX				US_CSR_ENDTX
+#define US_IDR_TIMEOUT				US_CSR_TIMEOUT
+#define US_IDR_TXEMPTY				US_CSR_TXEMPTY
+#define US_IDR_TXBUFE				US_CSR_TXBUFE
+#define US_IDR_RXBUFF				US_CSR_RXBUFF
+#define US_IMR_TXRDY				US_CSR_TXRDY
+#define US_IMR_ENDRX				US_CSR_ENDRX
+#define US_IMR_TIMEOUT				US_CSR_TIMEOUT
+#define US_BRGR_CD(value)			((0xFFFFu << 0) & ((value) << 0))
+#define US_BRGR_FP(value)			((0x7u << 16) & ((value) << 16))
+#define US_RTOR_TO(value)			((0xFFFFu << 0) & ((value) << 0))
+#define US_WPMR_WPEN				(0x1u << 0)
+#define US_WPMR_WPKEY_PASSWD		(0x555341u << 8)
+
+extern Usart gSimUSART0;
+extern Usart gSimUSART1;
+#define USART0		(&gSimUSART0)
+#define USART1		(&gSimUSART1)
+#define PDC_USART0	((Pdc *)&gSimUSART0.US_RPR)
+#define PDC_USART1	((Pdc *)&gSimUSART1.US_RPR)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//  TWI   /////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+	WoReg TWI_CR;
+	RwReg TWI_MMR;
+	RwReg TWI_SMR;
+	RwReg TWI_IADR;
+	RwReg TWI_CWGR;
+	RoReg TWI_SR;
+	WoReg TWI_IER;
+	WoReg TWI_IDR;
+	RoReg TWI_IMR;
+	RoReg TWI_RHR;
+	WoReg TWI_THR;
+	SIM_PDC_REGISTERS(TWI)
+} Twi;
+
+#define TWI_CR_START				(0x1u << 0)
+#define TWI_CR_STOP					(0x1u << 1)
+#define TWI_CR_MSEN					(0x1u << 2)
+#define TWI_CR_MSDIS				(0x1u << 3)
+#define TWI_CR_SVEN					(0x1u << 4)
+#define TWI_CR_SVDIS				(0x1u << 5)
+#define TWI_CR_QUICK				(0x1u << 6)
+#define TWI_CR_SWRST				(0x1u << 7)
+#define TWI_MMR_IADRSZ_Pos			8
+#define TWI_MMR_IADRSZ_Msk			(0x3u << 8)
+#define TWI_MMR_IADRSZ_NONE			(0x0u << 8)
+#define TWI_MMR_IADRSZ_1_BYTE		(0x1u << 8)
+#define TWI_MMR_IADRSZ_2_BYTE		(0x2u << 8)
+#define TWI_MMR_IADRSZ_3_BYTE		(0x3u << 8)
+#define TWI_MMR_MREAD				(0x1u << 12)
+#define TWI_MMR_DADR_Msk			(0x7Fu << 16)
+#define TWI_MMR_DADR(value)			((0x7Fu << 16) & ((value) << 16))
+#define TWI_IADR_IADR(value)		((0xFFFFFFu << 0) & ((value) << 0))
+#define TWI_CWGR_CLDIV(value)		((0xFFu << 0) & ((value) << 0))
+#define TWI_CWGR_CHDIV(value)		((0xFFu << 8) & ((value) << 8))
+#define TWI_CWGR_CKDIV(value)		((0x7u << 16) & ((value) << 16))
+#define TWI_SR_TXCOMP				(0x1u << 0)
+#define TWI_SR_RXRDY				(0x1u << 1)
+#define TWI_SR_TXRDY				(0x1u << 2)
+#define TWI_SR_OVRE					(0x1u << 6)
+#define TWI_SR_NACK					(0x1u << 8)
+#define TWI_SR_ARBLST				(0x1u << 9)
+#define TWI_SR_SCLWS				(0x1u << 10)
+#define TWI_SR_ENDRX				(0x1u << 12)
+#define TWI_SR_ENDTX				(0x1u << 13)
+#define TWI_SR_RXBUFF				(0x1u << 14)
+#define TWI_SR_TXBUFE				(0x1u << 15)
+#define TWI_IER_TXCOMP				TWI_SR_TXCOMP
+#define TWI_IER_RXRDY				TWI_SR_RXRDY
+#define TWI_IER_TXRDY				TWI_SR_TXRDY
+#define TWI_IER_NACK				TWI_SR_NACK
+#define TWI_IER_ENDRX				TWI_SR_ENDRX
+#define TWI_IER_ENDTX				TWI_SR_ENDTX
+#define TWI_IDR_TXCOMP				TWI_SR_TXCOMP
+#define TWI_IDR_RXRDY				TWI_SR_RXRDY
+#define TWI_IDR_TXRDY				TWI_SR_TXRDY
+#define TWI_IDR_NACK				TWI_SR_NACK
+#define TWI_IDR_ENDRX				TWI_SR_ENDRX
+#define TWI_IDR_ENDTX				TWI_SR_ENDTX
+
+extern Twi gSimTWI0;
+extern Twi gSimTWI1;
+#define TWI0		(&gSimTWI0)
+#define TWI1		(&gSimTWI1)
+#define PDC_TWI0	((Pdc *)&gSimTWI0.TWI_RPR)
+#define PDC_TWI1	((Pdc *)&gSimTWI1.TWI_RPR)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADC   /////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+	WoReg ADC_CR;
+	RwReg ADC_MR;
+	RwReg ADC_SEQR1;
+	RwReg ADC_SEQR2;
+	WoReg ADC_CHER;
+	WoReg ADC_CHDR;
+	RoReg ADC_CHSR;
+	RoReg ADC_LCDR;
+	WoReg ADC_IER;
+	WoReg ADC_IDR;
+	RoReg ADC_IMR;
+	RoReg ADC_ISR;
+	RoReg ADC_OVER;
+	RwReg ADC_EMR;
+	RwReg ADC_CWR;
+	RwReg ADC_CGR;
+	RwReg ADC_COR;
+	RoReg ADC_CDR[16];
+	RwReg ADC_ACR;
+	RwReg ADC_WPMR;
+	RoReg ADC_WPSR;
+	SIM_PDC_REGISTERS(ADC)
+} Adc;
+
+#define ADC_CR_SWRST				(0x1u << 0)
+#define ADC_CR_START				(0x1u << 1)
+#define ADC_MR_TRGEN_EN				(0x1u << 0)
+#define ADC_MR_TRGSEL(value)		((0x7u << 1) & ((value) << 1))
+#define ADC_MR_LOWRES				(0x1u << 4)
+#define ADC_MR_SLEEP				(0x1u << 5)
+#define ADC_MR_FREERUN				(0x1u << 7)
+#define ADC_MR_PRESCAL_Msk			(0xFFu << 8)
+#define ADC_MR_PRESCAL(value)		((0xFFu << 8) & ((value) << 8))
+#define ADC_MR_STARTUP_Msk			(0xFu << 16)
+#define ADC_MR_STARTUP(value)		((0xFu << 16) & ((value) << 16))
+#define ADC_MR_SETTLING(value)		((0x3u << 20) & ((value) << 20))
+#define ADC_MR_ANACH				(0x1u << 23)
+#define ADC_MR_TRACKTIM(value)		((0xFu << 24) & ((value) << 24))
+#define ADC_MR_TRANSFER(value)		((0x3u << 28) & ((value) << 28))
+#define ADC_MR_USEQ					(0x1u << 31)
+#define ADC_LCDR_LDATA_Msk			(0xFFFu << 0)
+#define ADC_ISR_DRDY				(0x1u << 24)
+#define ADC_ISR_GOVRE				(0x1u << 25)
+#define ADC_ISR_COMPE				(0x1u << 26)
+#define ADC_ISR_ENDRX				(0x1u << 27)
+#define ADC_ISR_RXBUFF				(0x1u << 28)
+#define ADC_IER_ENDRX				(0x1u << 27)
+#define ADC_IER_RXBUFF				(0x1u << 28)
+#define ADC_IDR_ENDRX				(0x1u << 27)
+#define ADC_IDR_RXBUFF				(0x1u << 28)
+#define ADC_EMR_TAG					(0x1u << 24)
+
+extern Adc gSimADC;
+#define ADC			(&gSimADC)
+#define PDC_ADC		((Pdc *)&gSimADC.ADC_RPR)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//  DACC   ////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+	WoReg DACC_CR;
+	RwReg DACC_MR;
+	WoReg DACC_CHER;
+	WoReg DACC_CHDR;
+	RoReg DACC_CHSR;
+	WoReg DACC_CDR;
+	WoReg DACC_IER;
+	WoReg DACC_IDR;
+	RoReg DACC_IMR;
+	RoReg DACC_ISR;
+	RwReg DACC_ACR;
+	RwReg DACC_WPMR;
+	RoReg DACC_WPSR;
+	SIM_PDC_REGISTERS(DACC)
+} Dacc;
+
+#define DACC_CR_SWRST				(0x1u << 0)
+#define DACC_MR_TRGEN_EN			(0x1u << 0)
+#define DACC_MR_TRGSEL(value)		((0x7u << 1) & ((value) << 1))
+#define DACC_MR_WORD_HALF			(0x0u << 4)
+#define DACC_MR_WORD_WORD			(0x1u << 4)
+#define DACC_MR_ONE					(0x1u << 8)
+#define DACC_MR_USER_SEL_Msk		(0x3u << 16)
+#define DACC_MR_USER_SEL_CHANNEL0	(0x0u << 16)
+#define DACC_MR_USER_SEL_CHANNEL1	(0x1u << 16)
+#define DACC_MR_TAG_EN				(0x1u << 20)
+#define DACC_MR_MAXS				(0x1u << 21)
+#define DACC_MR_STARTUP(value)		((0x3Fu << 24) & ((value) << 24))
+#define DACC_CHER_CH0				(0x1u << 0)
+#define DACC_CHER_CH1				(0x1u << 1)
+#define DACC_CHDR_CH0				(0x1u << 0)
+#define DACC_CHDR_CH1				(0x1u << 1)
+#define DACC_ISR_TXRDY				(0x1u << 0)
+#define DACC_ISR_EOC				(0x1u << 1)
+#define DACC_ISR_ENDTX				(0x1u << 2)
+#define DACC_ISR_TXBUFE				(0x1u << 3)
+#define DACC_IER_TXRDY				(0x1u << 0)
+#define DACC_IER_EOC				(0x1u << 1)
+#define DACC_IER_ENDTX				(0x1u << 2)
+#define DACC_IER_TXBUFE				(0x1u << 3)
+#define DACC_IDR_TXRDY				(0x1u << 0)
+#define DACC_IDR_EOC				(0x1u << 1)
+#define DACC_IDR_ENDTX				(0x1u << 2)
+#define DACC_IDR_TXBUFE				(0x1u << 3)
+#define DACC_ACR_IBCTLCH0(value)	((0x3u << 0) & ((value) << 0))
+#define DACC_ACR_IBCTLCH1(value)	((0x3u << 2) & ((value) << 2))
+#define DACC_ACR_IBCTLDACCORE(value)	((0x3u << 8) & ((value) << 8))
+
+extern Dacc gSimDACC;
+#define DACC		(&gSimDACC)
+#define PDC_DACC	((Pdc *)&gSimDACC.DACC_RPR)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//  TC (TIMER COUNTER)   //////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+	WoReg TC_CCR;
+	RwReg TC_CMR;
+	RwReg TC_SMMR;
+	RoReg Reserved1;
+	RoReg TC_CV;
+	RwReg TC_RA;
+	RwReg TC_RB;
+	RwReg TC_RC;
+	RoReg TC_SR;
+	WoReg TC_IER;
+	WoReg TC_IDR;
+	RoReg TC_IMR;
+	RoReg Reserved2[4];
+} TcChannel;
+
+typedef struct
+{
+	TcChannel TC_CHANNEL[3];
+	WoReg TC_BCR;
+	RwReg TC_BMR;
+	WoReg TC_QIER;
+	WoReg TC_QIDR;
+	RoReg TC_QIMR;
+	RoReg TC_QISR;
+	RwReg TC_FMR;
+	RwReg TC_WPMR;
+} Tc;
+
+#define TC_CCR_CLKEN				(0x1u << 0)
+#define TC_CCR_CLKDIS				(0x1u << 1)
+#define TC_CCR_SWTRG				(0x1u << 2)
+#define TC_CMR_TCCLKS_Msk			(0x7u << 0)
+#define TC_CMR_TCCLKS_TIMER_CLOCK1	(0x0u << 0)		// MCK/2
+#define TC_CMR_TCCLKS_TIMER_CLOCK2	(0x1u << 0)		// MCK/8
+#define TC_CMR_TCCLKS_TIMER_CLOCK3	(0x2u << 0)		// MCK/32
+#define TC_CMR_TCCLKS_TIMER_CLOCK4	(0x3u << 0)		// MCK/128
+#define TC_CMR_TCCLKS_TIMER_CLOCK5	(0x4u << 0)		// SLCK
+#define TC_CMR_CPCSTOP				(0x1u << 6)
+#define TC_CMR_CPCDIS				(0x1u << 7)
+#define TC_CMR_CPCTRG				(0x1u << 14)
+#define TC_CMR_WAVSEL_Msk			(0x3u << 13)
+#define TC_CMR_WAVSEL_UP			(0x0u << 13)
+#define TC_CMR_WAVSEL_UPDOWN		(0x1u << 13)
+#define TC_CMR_WAVSEL_UP_RC			(0x2u << 13)
+#define TC_CMR_WAVSEL_UPDOWN_RC		(0x3u << 13)
+#define TC_CMR_WAVE					(0x1u << 15)
+#define TC_CMR_ACPA_NONE			(0x0u << 16)
+#define TC_CMR_ACPA_SET				(0x1u << 16)
+#define TC_CMR_ACPA_CLEAR			(0x2u << 16)
+#define TC_CMR_ACPA_TOGGLE			(0x3u << 16)
+#define TC_CMR_ACPC_NONE			(0x0u << 18)
+#define TC_CMR_ACPC_SET				(0x1u << 18)
+#define TC_CMR_ACPC_CLEAR			(0x2u << 18)
+#define TC_CMR_ACPC_TOGGLE			(0x3u << 18)
+#define TC_SR_COVFS					(0x1u << 0)
+#define TC_SR_LOVRS					(0x1u << 1)
+#define TC_SR_CPAS					(0x1u << 2)
+#define TC_SR_CPBS					(0x1u << 3)
+#define TC_SR_CPCS					(0x1u << 4)
+#define TC_SR_CLKSTA				(0x1u << 16)
+#define TC_SR_MTIOA					(0x1u << 17)
+#define TC_IER_COVFS				(0x1u << 0)
+#define TC_IER_CPAS					(0x1u << 2)
+#define TC_IER_CPBS					(0x1u << 3)
+#define TC_IER_CPCS					(0x1u << 4)
+#define TC_IDR_COVFS				(0x1u << 0)
+#define TC_IDR_CPAS					(0x1u << 2)
+#define TC_IDR_CPBS					(0x1u << 3)
+#define TC_IDR_CPCS					(0x1u << 4)
+
+extern Tc gSimTC0;
+extern Tc gSimTC1;
+#define TC0			(&gSimTC0)
+#define TC1			(&gSimTC1)
+
+#endif
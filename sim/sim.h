@@ -0,0 +1,76 @@
+// Author			: Fabian Kung
+// Date				: 16 Oct 2026
+// Filename			: sim.h
+//
+// Control interface of the host simulation.  The behavioural models of the peripherals are
+// implemented in "sim_model.cpp".  These routines are used by the simulation main program
+// "sim_main.cpp" to drive the virtual clock, inject data into the serial ports, attach virtual
+// I2C slave devices and collect the data transmitted by the firmware.
+
+#ifndef _SIM_H
+#define _SIM_H
+
+#include <stdint.h>
+
+#define __SIM_MAX_TWI_SLAVE		8		// Max. no. of virtual I2C slave devices per TWI bus.
+
+// Index of the serial ports in SimSerialxxx() routines.
+#define __SIM_UART0				0
+#define __SIM_UART1				1
+#define __SIM_USART0			2
+#define __SIM_USART1			3
+
+// A virtual I2C slave device with 256 8-bits registers and an auto-incrementing register
+// pointer, e.g. a typical sensor.
+typedef struct StructSimTwiSlave
+{
+	uint8_t bytAddress;				// 7-bits slave address.
+	uint8_t bytRegister[256];		// Register file.
+	uint8_t bytPointer;				// Register pointer.
+	unsigned int unReadCount;		// No. of bytes read by the Master.
+	unsigned int unWriteCount;		// No. of bytes written by the Master (excluding register pointer).
+	int nHold;						// No. of transfers during which the slave holds SCL low after
+									// its address, until the TWI is reset.
+} SIM_TWI_SLAVE;
+
+// Virtual clock.
+extern uint64_t gullSimTimePs;				// Current virtual time in pico-seconds.
+extern uint64_t gullSimAccessCount;			// No. of peripheral register accesses.
+double SimTime(void);						// Current virtual time in seconds.
+double SimMasterClockHz(void);				// Current master clock (MCK) frequency.
+void SimReset(void);						// Reset the virtual clock and all peripherals.
+
+// Serial ports (UART0/1 and USART0/1).
+void SimSerialInject(int nPort, const uint8_t *ptrData, int nLength);	// Data arrive at RX pin at line rate.
+unsigned int SimSerialTxCount(int nPort);		// No. of bytes transmitted on the TX pin.
+int SimSerialTxRead(int nPort, uint8_t *ptrData, int nMax);			// Retrieve transmitted bytes.
+double SimSerialTxLastTime(int nPort);		// Virtual time of the last byte transmitted, in seconds.
+unsigned int SimSerialRxOverrun(int nPort);	// No. of receive overrun events.
+unsigned int SimSerialRxPending(int nPort);	// No. of bytes injected but not yet arrived.
+unsigned int SimSerialTxGlitch(int nPort);	// No. of characters being sent while MCK changed.
+void SimSerialTxBaud(int nPort, double *ptrMin, double *ptrMax);	// Range of baud rates used.
+void SimSerialCts(int nPort, int bHigh);		// Drive the CTS input of a USART, 1 = peer not ready.
+unsigned int SimSerialRtsHold(int nPort);		// No. of times the peer waited for RTS.
+
+// TWI (I2C) buses.
+void SimTwiAttach(int nBus, SIM_TWI_SLAVE *ptrSlave);
+double SimTwiBusTime(int nBus);				// Accumulated time the TWI bus is busy, in seconds.
+
+// DACC outputs.
+unsigned int SimDaccCount(int nChannel);		// No. of samples converted and not yet retrieved.
+int SimDaccOutput(int nChannel, uint16_t *ptrData, int nMax);		// Retrieve converted samples.
+unsigned int SimDaccUnderrun(void);			// No. of triggers without sample from the PDC.
+void SimDaccTime(int nChannel, double *ptrFirst, double *ptrLast);	// Virtual time of the first and
+											// last conversions since all were retrieved.
+
+// ADC inputs.
+void SimAdcSource(int (*fptrSource)(int nChannel, double dTime));	// Code of an input at a time.
+unsigned int SimAdcConversions(void);		// No. of conversions.
+unsigned int SimAdcLost(void);				// No. of results not taken by the PDC.
+
+// PIO pin trace.
+void SimPioTrace(int nPort, int nPin);		// Record the rising edge of a PIO output pin.
+unsigned int SimPioEdgeCount(void);
+double SimPioEdgeTime(unsigned int unIndex);	// Virtual time of the rising edge, in seconds.
+
+#endif
@@ -0,0 +1,2128 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	HOST SIMULATION MAIN PROGRAM
+//
+//  (c) Copyright 2026, Fabian Kung Wai Lee, Selangor, MALAYSIA
+//  All Rights Reserved
+//
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File				: sim_main.cpp
+// Author(s)		: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Toolsuites		: GCC C++ Compiler (Linux host)
+// Description		: Runs the RTOS kernel and the drivers against the virtual register model
+//                    of "sim_model.cpp" and reports the throughput and latency figures of a
+//                    few experiments.  Each experiment starts from a peripheral reset and runs
+//                    for a fixed virtual time, much faster than real time.
+//                    Usage: sim [virtual seconds per experiment] [UART0 capture of the trace]
+//                               [UART0 capture of the log]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <vector>
+#include "osmain.h"
+#include "Driver_UART_V100.h"
+#include "Driver_USART_V100.h"
+#include "Driver_I2C_V100.h"
+#include "Driver_TC_V100.h"
+#include "Frame_COBS_V100.h"
+#include "driver_dacc_v100.h"
+#include "DAC_DDS_V100.h"
+#include "Driver_ADC_V100.h"
+#include "Sensor_Acq_V100.h"
+#include "sim.h"
+
+static double gdRunTime = 1.0;				// Virtual time per experiment in seconds.
+
+// --- Kernel main loop, same as main() in "ATSAM4SD16B.c" ---
+static void SimRunKernel(double dSeconds)
+{
+	int ni;
+
+	while (SimTime() < dSeconds)
+	{
+		ClearWatchDog();
+		if (gnRunTask > 0)
+		{
+			while ((ni = OSGetReadyTask()) >= 0)
+			{
+				OSRunTask(ni);
+			}
+			gnRunTask = 0;
+			gnTickDispatch = 0;
+		}
+		OSIdle();
+	}
+}
+
+static unsigned int gunSimOverrun;			// Tick overruns of the Kernel, all experiments.
+static unsigned int gunSimClockOverrun;		// Of which in experiment 6, while OSSetClock() waits for
+											// the PLL lock and UART0 with the interrupts on.
+
+// End of an experiment, returns its virtual time.
+static double SimEnd(void)
+{
+#ifdef __OS_PROFILE
+	gunSimOverrun += gstrcKernelProfile.unOverrun;
+#endif
+	return SimTime();
+}
+
+static void SimBoot(void)
+{
+	SimReset();
+	SAM4S_Init();
+	OSInit();
+	gnTaskCount = 0;
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], OSProce1);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 1: KERNEL TICK AND IDLE TIME   ////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+static void SimKernel(void)
+{
+	unsigned int ni;
+	double dMaxJitter = 0.0;
+	double dPeriod;
+	double dNominal;
+	KERNEL_PROFILE strcKernel;
+
+	SimBoot();
+	SimPioTrace(1, 1);						// Tick probe on PB1.
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_UART_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_USART_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_I2C0_Driver);
+	SimRunKernel(gdRunTime);
+
+	dNominal = (SimPioEdgeCount() > 1) ? (SimPioEdgeTime(SimPioEdgeCount() - 1) - SimPioEdgeTime(0)) / (SimPioEdgeCount() - 1) : 0.0;
+	for (ni = 1; ni < SimPioEdgeCount(); ni++)
+	{
+		dPeriod = SimPioEdgeTime(ni) - SimPioEdgeTime(ni - 1);
+		if ((dPeriod - dNominal > dMaxJitter) || (dNominal - dPeriod > dMaxJitter))
+		{
+			dMaxJitter = (dPeriod > dNominal) ? dPeriod - dNominal : dNominal - dPeriod;
+		}
+	}
+	printf("kernel: MCK = %.3f MHz, %u ticks, tick period = %.2f us, jitter = %.3f us, idle = %d %%\n",
+		SimMasterClockHz() * 1.0e-6, gunClockTick, dNominal * 1.0e6, dMaxJitter * 1.0e6, gnCPUIdle);
+	OSGetKernelProfile(&strcKernel);
+	printf("kernel: busy cycles per tick = %u (max %u) of %u, %u overruns\n",
+		strcKernel.unTickBusy, strcKernel.unTickBusyMax, strcKernel.unTickCycle, strcKernel.unOverrun);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 2: UART0 TRANSMIT THROUGHPUT   ////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_TX_FRAME		100
+
+static unsigned int gunTxFrame;
+
+static void SimTxSource(TASK_ATTRIBUTE *ptrTask)
+{
+	int ni;
+
+	if (gSCIstatus.bTXRDY == 0)				// Load a new frame once the previous is sent.
+	{
+		for (ni = 0; ni < __SIM_TX_FRAME; ni++)
+		{
+			gbytTXbuffer[ni] = (uint8_t) ni;
+		}
+		gbytTXbuflen = __SIM_TX_FRAME;
+		gSCIstatus.bTXRDY = 1;
+		gunTxFrame++;
+	}
+	OSSetTaskContext(ptrTask, 0, 1);
+}
+
+// Same frames through the transmit queue, topped up whenever there is space.
+static void SimTxQueue(TASK_ATTRIBUTE *ptrTask)
+{
+	static uint8_t bytFrame[__SIM_TX_FRAME];
+	static unsigned int unSent = 0;
+	int ni;
+
+	if (gunTxFrame == 0)
+	{
+		for (ni = 0; ni < __SIM_TX_FRAME; ni++)
+		{
+			bytFrame[ni] = (uint8_t) ni;
+		}
+		unSent = __SIM_TX_FRAME;
+	}
+	if (unSent == __SIM_TX_FRAME)
+	{
+		unSent = 0;
+		gunTxFrame++;
+	}
+	unSent += OSQueueWrite(&gstrcTXqueue, bytFrame + unSent, __SIM_TX_FRAME - unSent);
+	OSSetTaskContext(ptrTask, 0, 1);
+}
+
+// An image of 4 kbytes with a header and a trailer sent in place, the callback submits the
+// next frame.
+#define __SIM_TX_IMAGE		4096
+
+static UART_TX_DESC gSimTxDesc[3];
+
+static void SimTxChainDone(void *ptrArg)
+{
+	(void) ptrArg;
+	gunTxFrame++;
+	UART0TxSend(&gSimTxDesc[0], SimTxChainDone, 0);
+}
+
+static void SimTxChain(TASK_ATTRIBUTE *ptrTask)
+{
+	static uint8_t bytHeader[4] = {0xA5, 0x5A, __SIM_TX_IMAGE & 0xFF, __SIM_TX_IMAGE >> 8};
+	static uint8_t bytImage[__SIM_TX_IMAGE];
+	static uint8_t bytTrailer[2] = {0x0D, 0x0A};
+	int ni;
+
+	if (ptrTask->nState == 0)
+	{
+		for (ni = 0; ni < __SIM_TX_IMAGE; ni++)
+		{
+			bytImage[ni] = (uint8_t) ni;
+		}
+		gSimTxDesc[0].ptrData = bytHeader;
+		gSimTxDesc[0].unLength = sizeof(bytHeader);
+		gSimTxDesc[0].ptrNext = &gSimTxDesc[1];
+		gSimTxDesc[1].ptrData = bytImage;
+		gSimTxDesc[1].unLength = sizeof(bytImage);
+		gSimTxDesc[1].ptrNext = &gSimTxDesc[2];
+		gSimTxDesc[2].ptrData = bytTrailer;
+		gSimTxDesc[2].unLength = sizeof(bytTrailer);
+		gSimTxDesc[2].ptrNext = 0;
+		UART0TxSend(&gSimTxDesc[0], SimTxChainDone, 0);
+	}
+	OSSetTaskContext(ptrTask, 1, 1000);
+}
+
+static void SimUartTx(TASK_POINTER ptrSource, const char *ptrName)
+{
+	double dLine;
+	unsigned int unCount;
+
+	SimBoot();
+	gunTxFrame = 0;
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_UART_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], ptrSource);
+	SimRunKernel(gdRunTime);
+
+	unCount = SimSerialTxCount(__SIM_UART0);
+	dLine = SimMasterClockHz() / (16.0 * (UART0->UART_BRGR & 0xFFFF)) / 10.0;
+	printf("uart0 tx (%s): %u bytes in %.3f s = %.1f kbytes/s, line capacity %.1f kbytes/s (%.1f %%)\n",
+		ptrName, unCount, SimTime(), unCount / SimTime() * 1.0e-3, dLine * 1.0e-3, 100.0 * unCount / SimTime() / dLine);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 3: UART0 RECEIVE AT LINE RATE   ///////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+static unsigned int gunRxCount;
+static unsigned int gunRxOverflow;
+
+static void SimRxSink(TASK_ATTRIBUTE *ptrTask)
+{
+	if (gSCIstatus.bRXRDY == 1)
+	{
+		if (gSCIstatus.bRXOVF == 0)
+		{
+			gunRxCount += gbytRXbufptr;
+		}
+		else
+		{
+			gunRxOverflow++;
+			gSCIstatus.bRXOVF = 0;
+		}
+		gSCIstatus.bRXRDY = 0;
+		gbytRXbufptr = 0;
+	}
+	OSSetTaskContext(ptrTask, 0, 1);
+}
+
+static void SimUartRx(void)
+{
+	static uint8_t bytData[20000];
+	unsigned int unInject;
+
+	SimBoot();
+	gunRxCount = 0;
+	gunRxOverflow = 0;
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_UART_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimRxSink);
+	SimRunKernel(0.05);						// Let the driver initialize the UART.
+	unInject = (unsigned int)((gdRunTime - 0.1) * SimMasterClockHz() / (16.0 * (UART0->UART_BRGR & 0xFFFF)) / 10.0);
+	unInject = (unInject > sizeof(bytData)) ? sizeof(bytData) : unInject;
+	memset(bytData, 0x55, sizeof(bytData));
+	SimSerialInject(__SIM_UART0, bytData, unInject);
+	SimRunKernel(gdRunTime);
+
+	printf("uart0 rx: %u bytes injected, %u received, %u hardware overruns, %u buffer overflows\n",
+		unInject, gunRxCount, SimSerialRxOverrun(__SIM_UART0), gunRxOverflow);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 4: I2C0 WRITE TRANSACTIONS   //////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+static SIM_TWI_SLAVE gSimSensor;
+static unsigned int gunI2CWrite;
+
+static void SimI2CClient(TASK_ATTRIBUTE *ptrTask)
+{
+	if ((gI2CStat.bI2CBusy == 0) && (gI2CStat.bSend == 0))
+	{
+		gbytI2CByteCount = 2;
+		gbytI2CRegAdd = 0x20;
+		gbytI2CTXbuf[0] = 0xFA;
+		gbytI2CTXbuf[1] = (uint8_t) gunI2CWrite;
+		gbytI2CSlaveAdd = 0x1E;
+		gI2CStat.bSend = 1;
+		gunI2CWrite++;
+	}
+	OSSetTaskContext(ptrTask, 0, 1);
+}
+
+// Same transactions through the transaction queue.  The client fills the queue, then sleeps
+// until the driver signals that a transaction is done.
+static void SimI2CQueue(TASK_ATTRIBUTE *ptrTask)
+{
+	I2C_TRANSACTION strcTrans = {0};
+
+	OSGetEvent(ptrTask, __I2C_EVENT_DONE);
+	strcTrans.bytSlaveAdd = 0x1E;
+	strcTrans.bytRegAdd = 0x20;
+	strcTrans.bytByteCount = 2;
+	strcTrans.bytData[0] = 0xFA;
+	strcTrans.nTaskNotify = ptrTask->nID;
+	while (OSQueueSpace(&gstrcI2CQueue) > 0)
+	{
+		strcTrans.bytData[1] = (uint8_t) gunI2CWrite;
+		I2C0PutTransaction(&strcTrans);
+		gunI2CWrite++;
+	}
+	OSWaitEvent(ptrTask, 0, __I2C_EVENT_DONE, 0);
+}
+
+static void SimI2C(TASK_POINTER ptrClient, const char *ptrName)
+{
+	SimBoot();
+	memset(&gSimSensor, 0, sizeof(gSimSensor));
+	gSimSensor.bytAddress = 0x1E;
+	SimTwiAttach(0, &gSimSensor);
+	int nDriver, nClient;
+	TASK_PROFILE strcDriver, strcClient;
+
+	gunI2CWrite = 0;
+	nDriver = gnTaskCount;
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_I2C0_Driver);
+	nClient = gnTaskCount;
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], ptrClient);
+	SimRunKernel(gdRunTime);
+	OSGetTaskProfile(gstrcTaskContext[nDriver].nID, &strcDriver);
+	OSGetTaskProfile(gstrcTaskContext[nClient].nID, &strcClient);
+	gunI2CWrite -= OSQueueCount(&gstrcI2CQueue);			// Not yet sent.
+	gstrcI2CQueue.unTail = gstrcI2CQueue.unHead;			// Flush for the next experiment.
+
+	printf("i2c0 write (%s): %u transactions, %u data bytes acknowledged, bus busy %.1f %%, %.1f transactions/s\n",
+		ptrName, gunI2CWrite, gSimSensor.unWriteCount, 100.0 * SimTwiBusTime(0) / SimTime(), gunI2CWrite / SimTime());
+	printf("i2c0 write (%s): driver %.0f dispatches/s, client %.0f dispatches/s\n",
+		ptrName, strcDriver.unCount / SimTime(), strcClient.unCount / SimTime());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 5: TC0 MICROSECOND TIMERS   ///////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_TC_PERIOD		20				// Period of the periodic timer in usec.
+#define __SIM_TC_ONESHOT	8				// No. of one-shot timers.
+
+static TC_TIMER gSimPeriodic;
+static TC_TIMER gSimOneShot[__SIM_TC_ONESHOT];
+static int gnTcMaxLate;						// In ticks of MCK/32.
+static int gnTcMaxEarly;
+static unsigned int gunTcPeriodic;
+static unsigned int gunTcOneShot;
+
+// Compare the time a callback is called with its deadline.
+static void SimTcLate(unsigned int unDue)
+{
+	int nLate = (int)(TCTimerNow() - unDue);
+
+	gnTcMaxLate = (nLate > gnTcMaxLate) ? nLate : gnTcMaxLate;
+	gnTcMaxEarly = (-nLate > gnTcMaxEarly) ? -nLate : gnTcMaxEarly;
+}
+
+static void SimTcPeriodic(void *ptrArg)
+{
+	TC_TIMER *ptrTimer = (TC_TIMER *) ptrArg;
+
+	gunTcPeriodic++;
+	SimTcLate(ptrTimer->unExpire - ptrTimer->unPeriod);	// Already reloaded.
+}
+
+static void SimTcOneShot(void *ptrArg)
+{
+	TC_TIMER *ptrTimer = (TC_TIMER *) ptrArg;
+
+	gunTcOneShot++;
+	SimTcLate(ptrTimer->unExpire);
+}
+
+static void SimTcClient(TASK_ATTRIBUTE *ptrTask)
+{
+	int ni;
+
+	for (ni = 0; ni < __SIM_TC_ONESHOT; ni++)
+	{
+		if (gSimOneShot[ni].bActive == 0)		// Restart expired one-shot timers with
+		{										// pseudo-random delays of 3 to 1000 usec.
+			TCTimerStart(&gSimOneShot[ni], 3 + (unsigned int)(rand() % 998), 0, SimTcOneShot, &gSimOneShot[ni]);
+		}
+	}
+	OSSetTaskContext(ptrTask, 0, 1);
+}
+
+static void SimTc(void)
+{
+	SimBoot();
+	TCTimerInit();
+	memset(gSimOneShot, 0, sizeof(gSimOneShot));
+	memset(&gSimPeriodic, 0, sizeof(gSimPeriodic));
+	gnTcMaxLate = 0;
+	gnTcMaxEarly = 0;
+	gunTcPeriodic = 0;
+	gunTcOneShot = 0;
+	srand(1);
+	TCTimerStart(&gSimPeriodic, __SIM_TC_PERIOD, __SIM_TC_PERIOD, SimTcPeriodic, &gSimPeriodic);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimTcClient);
+	SimRunKernel(gdRunTime);
+
+	printf("tc0 timer: %u periodic (%d us), %u one-shot callbacks, max late = %.2f us, max early = %.2f us\n",
+		gunTcPeriodic, __SIM_TC_PERIOD, gunTcOneShot, gnTcMaxLate * 32.0e6 / SimMasterClockHz(), gnTcMaxEarly * 32.0e6 / SimMasterClockHz());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 6: DYNAMIC FREQUENCY SCALING   ////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_DFS_FAST		120000000		// MCK during a burst of activity.
+#define __SIM_DFS_SLOW		24000000		// MCK between bursts.
+#define __SIM_DFS_BURST		20				// Burst length in msec.
+#define __SIM_DFS_IDLE		80				// Time between bursts in msec.
+#define __SIM_DFS_TC_PERIOD	1000			// Period of the TC0 timer in usec.
+
+static TC_TIMER gSimDfsTimer;
+static unsigned int gunDfsSwitch;
+static unsigned int gunDfsTimer;
+static double gdDfsMaxLate;					// In usec.
+static double gdDfsMaxEarly;
+static double gdDfsSlowTime;				// Virtual time spent at the slow clock.
+static double gdDfsSlowStart;
+static int gnDfsRefused;					// Result of OSSetClock() for a clock the UART cannot use.
+
+static void SimDfsTimer(void *ptrArg)
+{
+	TC_TIMER *ptrTimer = (TC_TIMER *) ptrArg;
+	double dLate = (int)(TCTimerNow() - (ptrTimer->unExpire - ptrTimer->unPeriod)) * 32.0e6 / SimMasterClockHz();
+
+	gunDfsTimer++;
+	gdDfsMaxLate = (dLate > gdDfsMaxLate) ? dLate : gdDfsMaxLate;
+	gdDfsMaxEarly = (-dLate > gdDfsMaxEarly) ? -dLate : gdDfsMaxEarly;
+}
+
+static void SimDfsGovernor(TASK_ATTRIBUTE *ptrTask)
+{
+	switch (ptrTask->nState)
+	{
+		case 0:
+			gnDfsRefused = OSSetClock(12000000);	// 115.2 kbps is 7 % off at 12 MHz.
+			OSSetTaskContext(ptrTask, 1, 1);
+			break;
+
+		case 1:								// Burst.
+			if (OSSetClock(__SIM_DFS_FAST) == 0)
+			{
+				gunDfsSwitch++;
+				if (gdDfsSlowStart > 0.0)
+				{
+					gdDfsSlowTime += SimTime() - gdDfsSlowStart;
+				}
+			}
+			OSSetTaskContext(ptrTask, 2, __SIM_DFS_BURST * __NUM_SYSTEMTICK_MSEC);
+			break;
+
+		case 2:								// Idle.
+			if (OSSetClock(__SIM_DFS_SLOW) == 0)
+			{
+				gunDfsSwitch++;
+				gdDfsSlowStart = SimTime();
+			}
+			OSSetTaskContext(ptrTask, 1, __SIM_DFS_IDLE * __NUM_SYSTEMTICK_MSEC);
+			break;
+	}
+}
+
+static void SimDfs(void)
+{
+	double dMin, dMax;
+
+	SimBoot();
+	TCTimerInit();
+	memset(&gSimDfsTimer, 0, sizeof(gSimDfsTimer));
+	memset(&gSimSensor, 0, sizeof(gSimSensor));
+	gSimSensor.bytAddress = 0x1E;
+	SimTwiAttach(0, &gSimSensor);
+	gunTxFrame = 0;
+	gunI2CWrite = 0;
+	gunDfsSwitch = 0;
+	gunDfsTimer = 0;
+	gdDfsMaxLate = 0.0;
+	gdDfsMaxEarly = 0.0;
+	gdDfsSlowTime = 0.0;
+	gdDfsSlowStart = 0.0;
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_UART_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_I2C0_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimTxQueue);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimI2CQueue);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimDfsGovernor);
+	TCTimerStart(&gSimDfsTimer, __SIM_DFS_TC_PERIOD, __SIM_DFS_TC_PERIOD, SimDfsTimer, &gSimDfsTimer);
+	SimRunKernel(gdRunTime);
+	if (gunDfsSwitch & 1)
+	{
+		gdDfsSlowTime += SimTime() - gdDfsSlowStart;
+	}
+	gunI2CWrite -= OSQueueCount(&gstrcI2CQueue);
+	gstrcI2CQueue.unTail = gstrcI2CQueue.unHead;
+
+	printf("dfs: %u switches between %d and %d MHz, %.0f %% of the time at %d MHz, 12 MHz refused (%d)\n",
+		gunDfsSwitch, __SIM_DFS_FAST / 1000000, __SIM_DFS_SLOW / 1000000, 100.0 * gdDfsSlowTime / SimTime(),
+		__SIM_DFS_SLOW / 1000000, gnDfsRefused);
+	printf("dfs: %u ticks in %.3f s, error %+.2f ticks\n", gunClockTick, SimTime(),
+		gunClockTick - SimTime() * 1000.0 * __NUM_SYSTEMTICK_MSEC);
+	SimSerialTxBaud(__SIM_UART0, &dMin, &dMax);
+	printf("dfs: uart0 %u bytes sent, %u lost to clock switching, baud %.0f to %.0f\n",
+		SimSerialTxCount(__SIM_UART0), SimSerialTxGlitch(__SIM_UART0), dMin, dMax);
+	printf("dfs: tc0 %u of %.0f periodic callbacks, max late = %.2f us, max early = %.2f us\n",
+		gunDfsTimer, SimTime() * 1.0e6 / __SIM_DFS_TC_PERIOD, gdDfsMaxLate, gdDfsMaxEarly);
+	printf("dfs: i2c0 %u transactions, %u data bytes acknowledged\n", gunI2CWrite, gSimSensor.unWriteCount);
+#ifdef __OS_PROFILE
+	gunSimClockOverrun = gstrcKernelProfile.unOverrun;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 7: EXECUTION TRACE OVER UART0   ///////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_TRACE_START	50				// Start of the trace window in msec.
+#define __SIM_TRACE_WINDOW	40				// Length of the trace window in ticks.
+#define __SIM_TRACE_TEXT	10				// Period of the text messages in msec.
+
+static const char *gptrTraceFile;			// Capture of the UART0 line, 0 for none.
+static TC_TIMER gSimTraceTimer;
+static unsigned int gunTraceTimer;			// TC0 callbacks while tracing.
+static unsigned int gunTraceText;			// Text bytes sent on the same line.
+
+static void SimTraceTimer(void *ptrArg)
+{
+	(void) ptrArg;
+	if (gunTraceMask != 0)
+	{
+		gunTraceTimer++;
+	}
+}
+
+static void SimTraceText(TASK_ATTRIBUTE *ptrTask)
+{
+	char chrText[32];
+	int nLength;
+
+	nLength = snprintf(chrText, sizeof(chrText), "tick %u\r\n", gunClockTick);
+	gunTraceText += OSQueueWrite(&gstrcTXqueue, chrText, nLength);
+	OSSetTaskContext(ptrTask, 0, __SIM_TRACE_TEXT * __NUM_SYSTEMTICK_MSEC);
+}
+
+// Record the Kernel and the interrupt events over a short window, with a clock change in the
+// middle, while the other tasks keep using the line.
+static void SimTraceWindow(TASK_ATTRIBUTE *ptrTask)
+{
+	switch (ptrTask->nState)
+	{
+		case 0:
+			OSSetTaskContext(ptrTask, 1, __SIM_TRACE_START * __NUM_SYSTEMTICK_MSEC);
+			break;
+
+		case 1:
+			OSTraceControl(__TRACE_MASK_KERNEL | __TRACE_MASK_ISR);
+			OSSetTaskContext(ptrTask, 2, __SIM_TRACE_WINDOW / 2);
+			break;
+
+		case 2:
+			OSSetClock(__SIM_DFS_SLOW);
+			OSSetTaskContext(ptrTask, 3, __SIM_TRACE_WINDOW / 2);
+			break;
+
+		case 3:
+			OSTraceControl(0);
+			OSSetTaskContext(ptrTask, 4, 1);
+			break;
+
+		default:
+			OSSetTaskContext(ptrTask, 4, 1000);
+			break;
+	}
+}
+
+static void SimTrace(void)
+{
+	static uint8_t bytLine[1 << 16];
+	int nCount;
+	FILE *fp;
+
+	SimBoot();
+	TCTimerInit();
+	memset(&gSimTraceTimer, 0, sizeof(gSimTraceTimer));
+	memset(&gSimSensor, 0, sizeof(gSimSensor));
+	gSimSensor.bytAddress = 0x1E;
+	SimTwiAttach(0, &gSimSensor);
+	gunI2CWrite = 0;
+	gunTraceTimer = 0;
+	gunTraceText = 0;
+	gstrcTXqueue.unTail = gstrcTXqueue.unHead;	// Drop the data left by the previous experiment.
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_UART_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_I2C0_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimI2CQueue);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimTraceText);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimTraceWindow);
+	TCTimerStart(&gSimTraceTimer, 500, 500, SimTraceTimer, 0);
+	SimRunKernel(gdRunTime);
+	gstrcI2CQueue.unTail = gstrcI2CQueue.unHead;
+
+	nCount = SimSerialTxRead(__SIM_UART0, bytLine, sizeof(bytLine));
+#ifdef __OS_TRACE
+	printf("trace: %u records in %u ticks, %u lost, %u still buffered, %d bytes on uart0 (%u text)\n",
+		gunTraceHead, __SIM_TRACE_WINDOW, gunTraceLost, gunTraceHead - gunTraceTail, nCount, gunTraceText);
+#else
+	printf("trace: __OS_TRACE not defined, %d bytes on uart0 (%u text)\n", nCount, gunTraceText);
+#endif
+	printf("trace: %u tc0 callbacks while tracing\n", gunTraceTimer);
+	if (gptrTraceFile != 0)
+	{
+		fp = fopen(gptrTraceFile, "wb");
+		if ((fp == 0) || (fwrite(bytLine, 1, nCount, fp) != (size_t) nCount))
+		{
+			perror(gptrTraceFile);
+		}
+		if (fp != 0)
+		{
+			fclose(fp);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 8: UART0 RECEIVE RING AT 937.5 KBPS   /////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_RING_BUSY		10				// Period of the long task in msec.
+#define __SIM_RING_SPIN		240000			// Register accesses in the long task, 2 msec at 120 MHz.
+
+static unsigned int gunRingCount;			// Bytes read from the ring.
+static unsigned int gunRingError;			// Bytes out of sequence.
+static unsigned int gunRingWake;			// Executions of the reader.
+
+static void SimRingReader(TASK_ATTRIBUTE *ptrTask)
+{
+	uint8_t bytData[64];
+	unsigned int unCount;
+	unsigned int ni;
+
+	if (ptrTask->nState == 0)
+	{
+		UART0RxOpen(ptrTask->nID);
+	}
+	else
+	{
+		gunRingWake++;
+		OSGetEvent(ptrTask, __UART_EVENT_RX);
+	}
+	while ((unCount = UART0RxRead(bytData, sizeof(bytData))) > 0)
+	{
+		for (ni = 0; ni < unCount; ni++)
+		{
+			if (bytData[ni] != (uint8_t)(gunRingCount + ni))
+			{
+				gunRingError++;
+			}
+		}
+		gunRingCount += unCount;
+	}
+	OSWaitEvent(ptrTask, 1, __UART_EVENT_RX, 0);
+}
+
+// A task keeping the processor for several character periods.
+static void SimRingBusy(TASK_ATTRIBUTE *ptrTask)
+{
+	unsigned int ni;
+
+	for (ni = 0; ni < __SIM_RING_SPIN; ni++)
+	{
+		(void) PIOA->PIO_PDSR;
+	}
+	OSSetTaskContext(ptrTask, 0, __SIM_RING_BUSY * __NUM_SYSTEMTICK_MSEC);
+}
+
+static void SimUartRing(void)
+{
+	static uint8_t bytData[100000];
+	unsigned int unInject;
+	unsigned int ni;
+
+	SimBoot();
+	gunRingCount = 0;
+	gunRingError = 0;
+	gunRingWake = 0;
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_UART_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimRingReader);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimRingBusy);
+	SimRunKernel(0.05);						// Let the driver initialize the UART.
+	UART0->UART_BRGR = 8;					// MCK/(16 x 8) = 937.5 kbps.
+	unInject = (unsigned int)((gdRunTime - 0.1) * SimMasterClockHz() / (16.0 * 8) / 10.0);
+	unInject = (unInject > sizeof(bytData)) ? sizeof(bytData) : unInject;
+	for (ni = 0; ni < unInject; ni++)
+	{
+		bytData[ni] = (uint8_t) ni;
+	}
+	SimSerialInject(__SIM_UART0, bytData, unInject);
+	SimRunKernel(gdRunTime);
+
+	printf("uart0 rx (ring): %u bytes injected at 937.5 kbps, %u received, %u out of sequence, %u hardware overruns\n",
+		unInject, gunRingCount, gunRingError, SimSerialRxOverrun(__SIM_UART0));
+	printf("uart0 rx (ring): %u reader executions, %.1f bytes per execution\n",
+		gunRingWake, (gunRingWake > 0) ? (double) gunRingCount / gunRingWake : 0.0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 9: USART0 FRAMES WITH THE RECEIVER TIME-OUT   /////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_FRAME_PERIOD	10				// Period of the frames in msec.
+#define __SIM_FRAME_MAX		60				// Max. frame length, 5.2 msec at 115.2 kbps.
+
+static unsigned int gunFrameSent;
+static unsigned int gunFrameGood;			// Frames received with the correct length and data.
+static unsigned int gunFrameBad;
+static unsigned int gunFrameWake;
+static unsigned int gunFrameWakeEnd;		// Executions which found a complete frame.
+
+// Each frame starts with its length, followed by a count.
+static void SimFrameSource(TASK_ATTRIBUTE *ptrTask)
+{
+	uint8_t bytFrame[__SIM_FRAME_MAX];
+	unsigned int unLength = 1 + (gunFrameSent * 7) % __SIM_FRAME_MAX;
+	unsigned int ni;
+
+	if (ptrTask->nState == 1)
+	{
+		bytFrame[0] = (uint8_t) unLength;
+		for (ni = 1; ni < unLength; ni++)
+		{
+			bytFrame[ni] = (uint8_t)(gunFrameSent + ni);
+		}
+		SimSerialInject(__SIM_USART0, bytFrame, unLength);
+		gunFrameSent++;
+	}
+	OSSetTaskContext(ptrTask, 1, __SIM_FRAME_PERIOD * __NUM_SYSTEMTICK_MSEC);
+}
+
+static void SimFrameReader(TASK_ATTRIBUTE *ptrTask)
+{
+	static uint8_t bytFrame[256];
+	static unsigned int unLength;
+	unsigned int ni;
+	int nEnd = 0;
+
+	if (ptrTask->nState == 0)
+	{
+		USART0RxOpen(ptrTask->nID);
+		unLength = 0;
+	}
+	else
+	{
+		gunFrameWake++;
+		OSGetEvent(ptrTask, __USART_EVENT_RX);
+	}
+	while (USART0RxCount() > 0)
+	{
+		if (unLength == 0)
+		{
+			unLength = USART0RxRead(bytFrame, 1);
+		}
+		unLength += USART0RxRead(&bytFrame[unLength], bytFrame[0] - unLength);
+		if (unLength < bytFrame[0])
+		{
+			break;							// Rest of the frame not received yet.
+		}
+		for (ni = 1; ni < unLength; ni++)
+		{
+			if (bytFrame[ni] != (uint8_t)(bytFrame[1] + ni - 1))
+			{
+				break;
+			}
+		}
+		if (ni == unLength)
+		{
+			gunFrameGood++;
+		}
+		else
+		{
+			gunFrameBad++;
+		}
+		unLength = 0;
+		nEnd = 1;
+	}
+	gunFrameWakeEnd += nEnd;
+	OSWaitEvent(ptrTask, 1, __USART_EVENT_RX, 0);
+}
+
+static void SimUsartFrame(void)
+{
+	SimBoot();
+	gunFrameSent = 0;
+	gunFrameGood = 0;
+	gunFrameBad = 0;
+	gunFrameWake = 0;
+	gunFrameWakeEnd = 0;
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_USART_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimFrameReader);
+	SimRunKernel(0.05);						// Let the driver initialize the USART.
+	USART0SetBaud(115200);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimFrameSource);
+	SimRunKernel(gdRunTime);
+
+	printf("usart0 rx (frame): %u frames sent, %u received, %u corrupted, %u hardware overruns\n",
+		gunFrameSent, gunFrameGood, gunFrameBad, SimSerialRxOverrun(__SIM_USART0));
+	printf("usart0 rx (frame): %u reader executions, %u with a complete frame\n", gunFrameWake, gunFrameWakeEnd);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 10: PRIORITY FRAMES FROM SEVERAL TASKS   //////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_BULK_FRAME	256				// Bulk frame length, 22 msec at 115.2 kbps.
+#define __SIM_BULK_TASK		2				// Tasks sending bulk frames.
+#define __SIM_CTRL_PERIOD	7				// Period of the control messages in msec.
+
+static SCI_PORT *gptrFramePort;
+static unsigned int gunEventTx;
+static unsigned int gunBulkFrame;
+static unsigned int gunCtrlFrame;
+static unsigned int gunCtrlRefused;
+static double gdCtrlMax;					// Control message latency, in sec.
+static double gdCtrlSum;
+static SCI_FRAME gSimBulkFrame[__SIM_BULK_TASK][2];
+static SCI_FRAME gSimCtrlFrame;
+static int gnFrameStop;						// 1 to stop submitting frames.
+static unsigned int gunFrameFlushEvent;		// unEventTx received after the stop.
+
+// Each bulk task keeps two frames in the queue.
+static void SimBulkSource(TASK_ATTRIBUTE *ptrTask)
+{
+	static uint8_t bytBulk[__SIM_BULK_FRAME];
+	SCI_FRAME *ptrFrame;
+	int nTask = (ptrTask->nID & 0xFFFF) % __SIM_BULK_TASK;
+	int ni;
+
+	for (ni = 0; (ni < 2) && (gnFrameStop == 0); ni++)
+	{
+		ptrFrame = &gSimBulkFrame[nTask][ni];
+		if (ptrFrame->bytStatus == __SCI_FRAME_DONE)
+		{
+			ptrFrame->ptrData = bytBulk;
+			ptrFrame->unLength = sizeof(bytBulk);
+			ptrFrame->nTask = ptrTask->nID;
+			if (SCIFrameSend(gptrFramePort, ptrFrame, __SCI_PRIORITY_LOW) == 0)
+			{
+				gunBulkFrame++;
+			}
+		}
+	}
+	OSWaitEvent(ptrTask, 1, gunEventTx, 0);
+	if ((OSGetEvent(ptrTask, gunEventTx) != 0) && (gnFrameStop == 1))
+	{
+		gunFrameFlushEvent++;
+	}
+}
+
+// A short control message, the latency is measured from the submission to the end of the 
+// frame.
+static void SimCtrlSource(TASK_ATTRIBUTE *ptrTask)
+{
+	static uint8_t bytCtrl[8] = {'C', 'T', 'R', 'L', 0, 0, 0x0D, 0x0A};
+	static double dSubmit;
+	double dLatency;
+
+	switch (ptrTask->nState)
+	{
+		case 0:
+			OSSetTaskContext(ptrTask, 1, __SIM_CTRL_PERIOD * __NUM_SYSTEMTICK_MSEC);
+			break;
+
+		case 1:
+			gSimCtrlFrame.ptrData = bytCtrl;
+			gSimCtrlFrame.unLength = sizeof(bytCtrl);
+			gSimCtrlFrame.nTask = ptrTask->nID;
+			dSubmit = SimTime();
+			if (SCIFrameSend(gptrFramePort, &gSimCtrlFrame, __SCI_PRIORITY_HIGH) != 0)
+			{
+				gunCtrlRefused++;
+				OSSetTaskContext(ptrTask, 1, __SIM_CTRL_PERIOD * __NUM_SYSTEMTICK_MSEC);
+				break;
+			}
+			OSWaitEvent(ptrTask, 2, gunEventTx, 0);
+			break;
+
+		default:
+			OSGetEvent(ptrTask, gunEventTx);
+			dLatency = SimTime() - dSubmit;
+			gdCtrlMax = (dLatency > gdCtrlMax) ? dLatency : gdCtrlMax;
+			gdCtrlSum += dLatency;
+			gunCtrlFrame++;
+			OSSetTaskContext(ptrTask, 1, __SIM_CTRL_PERIOD * __NUM_SYSTEMTICK_MSEC);
+			break;
+	}
+}
+
+static void SimFrames(int nPort)
+{
+	TASK_ATTRIBUTE *ptrDriver;
+	int ni, nQueued = 0, nLeft = 0;
+
+	SimBoot();
+	gnFrameStop = 0;
+	gunFrameFlushEvent = 0;
+	gunBulkFrame = 0;
+	gunCtrlFrame = 0;
+	gunCtrlRefused = 0;
+	gdCtrlMax = 0.0;
+	gdCtrlSum = 0.0;
+	memset(gSimBulkFrame, 0, sizeof(gSimBulkFrame));
+	memset(&gSimCtrlFrame, 0, sizeof(gSimCtrlFrame));
+	ptrDriver = &gstrcTaskContext[gnTaskCount];
+	if (nPort == __SIM_UART0)
+	{
+		gptrFramePort = &gstrcUART0;
+		gunEventTx = __UART_EVENT_TX;
+		OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_UART_Driver);
+	}
+	else
+	{
+		gptrFramePort = &gstrcUSART0;
+		gunEventTx = __USART_EVENT_TX;
+		OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_USART_Driver);
+	}
+	SimRunKernel(0.05);						// Let the driver initialize the port.
+	if (nPort == __SIM_USART0)
+	{
+		USART0SetBaud(115200);
+	}
+	for (ni = 0; ni < __SIM_BULK_TASK; ni++)
+	{
+		OSCreateTask(&gstrcTaskContext[gnTaskCount], SimBulkSource);
+	}
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimCtrlSource);
+	SimRunKernel(gdRunTime);
+
+	printf("%s tx (frames): %u bytes, %u bulk frames from %d tasks, %u control frames, %u refused\n",
+		(nPort == __SIM_UART0) ? "uart0" : "usart0", SimSerialTxCount(nPort), gunBulkFrame, __SIM_BULK_TASK, 
+		gunCtrlFrame, gunCtrlRefused);
+	printf("%s tx (frames): control latency avg %.2f ms, max %.2f ms, with %d bulk frames of %.2f ms queued\n",
+		(nPort == __SIM_UART0) ? "uart0" : "usart0", (gunCtrlFrame > 0) ? gdCtrlSum / gunCtrlFrame * 1.0e3 : 0.0, 
+		gdCtrlMax * 1.0e3, 2 * __SIM_BULK_TASK, __SIM_BULK_FRAME * 10.0e3 / 115200.0);
+
+	// Initialize the port again with frames queued, they must all be given back.
+	gnFrameStop = 1;
+	for (ni = 0; ni < 2 * __SIM_BULK_TASK; ni++)
+	{
+		nQueued += (gSimBulkFrame[ni / 2][ni % 2].bytStatus != __SCI_FRAME_DONE);
+	}
+	OSSetTaskContext(ptrDriver, 0, 1);
+	SimRunKernel(SimTime() + 0.01);
+	for (ni = 0; ni < 2 * __SIM_BULK_TASK; ni++)
+	{
+		nLeft += (gSimBulkFrame[ni / 2][ni % 2].bytStatus != __SCI_FRAME_DONE);
+	}
+	printf("%s tx (frames): initialized again with %d bulk frames pending, %d not given back, %u owners signalled\n",
+		(nPort == __SIM_UART0) ? "uart0" : "usart0", nQueued, nLeft, gunFrameFlushEvent);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 11: USART0 HIGH-SPEED LINK WITH RTS/CTS   /////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_LINK_BPS		3000000			// MCK/40 at 120 MHz.
+#define __SIM_LINK_READ		1024			// Bytes read by the slow reader every 10 msec.
+#define __SIM_LINK_FRAME	1024
+#define __SIM_LINK_CTS		5				// CTS period in msec, high for 2 msec.
+
+static unsigned int gunLinkCount;
+static unsigned int gunLinkError;
+static SCI_FRAME gSimLinkFrame[2];
+static double gdLinkCtsHigh;				// Time CTS was high, in sec.
+
+// A reader slower than the line.
+static void SimLinkReader(TASK_ATTRIBUTE *ptrTask)
+{
+	static uint8_t bytData[__SIM_LINK_READ];
+	unsigned int unCount;
+	unsigned int ni;
+
+	if (ptrTask->nState == 0)
+	{
+		USART0RxOpen(0);
+	}
+	unCount = USART0RxRead(bytData, sizeof(bytData));
+	for (ni = 0; ni < unCount; ni++)
+	{
+		if (bytData[ni] != (uint8_t)(gunLinkCount + ni))
+		{
+			gunLinkError++;
+		}
+	}
+	gunLinkCount += unCount;
+	OSSetTaskContext(ptrTask, 1, 10 * __NUM_SYSTEMTICK_MSEC);
+}
+
+// Keeps two frames queued, each frame continues the count of the previous one.
+static void SimLinkWriter(TASK_ATTRIBUTE *ptrTask)
+{
+	static uint8_t bytFrame[__SIM_LINK_FRAME + 256];
+	int ni;
+
+	if (ptrTask->nState == 0)
+	{
+		for (ni = 0; ni < (int) sizeof(bytFrame); ni++)
+		{
+			bytFrame[ni] = (uint8_t) ni;
+		}
+	}
+	for (ni = 0; ni < 2; ni++)
+	{
+		if (gSimLinkFrame[ni].bytStatus == __SCI_FRAME_DONE)
+		{
+			gSimLinkFrame[ni].ptrData = bytFrame;
+			gSimLinkFrame[ni].unLength = __SIM_LINK_FRAME;
+			gSimLinkFrame[ni].nTask = ptrTask->nID;
+			USART0FrameSend(&gSimLinkFrame[ni], __SCI_PRIORITY_LOW);
+		}
+	}
+	OSWaitEvent(ptrTask, 1, __USART_EVENT_TX, 0);
+	OSGetEvent(ptrTask, __USART_EVENT_TX);
+}
+
+// The peer holds CTS high for 2 msec of every __SIM_LINK_CTS msec.
+static void SimLinkCts(TASK_ATTRIBUTE *ptrTask)
+{
+	if (ptrTask->nState == 1)
+	{
+		SimSerialCts(__SIM_USART0, 1);
+		OSSetTaskContext(ptrTask, 2, 2 * __NUM_SYSTEMTICK_MSEC);
+		gdLinkCtsHigh += 2.0e-3;
+	}
+	else
+	{
+		SimSerialCts(__SIM_USART0, 0);
+		OSSetTaskContext(ptrTask, 1, (__SIM_LINK_CTS - 2) * __NUM_SYSTEMTICK_MSEC);
+	}
+}
+
+static void SimUsartLink(int bHandshake)
+{
+	static uint8_t bytData[200000];
+	static uint8_t bytLine[1 << 20];
+	unsigned int unInject;
+	unsigned int unLine;
+	unsigned int unError = 0;
+	unsigned int ni;
+
+	SimBoot();
+	gunLinkCount = 0;
+	gunLinkError = 0;
+	gdLinkCtsHigh = 0.0;
+	memset(gSimLinkFrame, 0, sizeof(gSimLinkFrame));
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_USART_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimLinkReader);
+	SimRunKernel(0.05);						// Let the driver initialize the USART.
+	USART0SetBaud(__SIM_LINK_BPS);
+	USART0SetHandshake(bHandshake);
+	if (bHandshake == 1)
+	{
+		OSCreateTask(&gstrcTaskContext[gnTaskCount], SimLinkWriter);
+		OSCreateTask(&gstrcTaskContext[gnTaskCount], SimLinkCts);
+	}
+	unInject = (unsigned int)((gdRunTime - 0.1) * __SIM_LINK_READ * 100);	// What the reader can take.
+	unInject = (unInject > sizeof(bytData)) ? sizeof(bytData) : unInject;
+	for (ni = 0; ni < unInject; ni++)
+	{
+		bytData[ni] = (uint8_t) ni;
+	}
+	SimSerialInject(__SIM_USART0, bytData, unInject);
+	SimRunKernel(gdRunTime);
+	SimSerialCts(__SIM_USART0, 0);
+
+	printf("usart0 link (%s): rx %u bytes injected at %.2f Mbps, %u received, %u held by the peer, %u out of sequence, %u overruns\n",
+		bHandshake ? "rts/cts" : "no handshake", unInject, __SIM_LINK_BPS * 1.0e-6, gunLinkCount + USART0RxCount(), 
+		SimSerialRxPending(__SIM_USART0), gunLinkError, SimSerialRxOverrun(__SIM_USART0));
+	printf("usart0 link (%s): reader %.1f kbytes/s, peer held by rts %u times\n", bHandshake ? "rts/cts" : "no handshake",
+		gunLinkCount / (SimTime() - 0.05) * 1.0e-3, SimSerialRtsHold(__SIM_USART0));
+	if (bHandshake == 1)
+	{
+		unLine = SimSerialTxRead(__SIM_USART0, bytLine, sizeof(bytLine));
+		for (ni = 0; ni < unLine; ni++)
+		{
+			if (bytLine[ni] != (uint8_t)(ni % __SIM_LINK_FRAME))
+			{
+				unError++;
+			}
+		}
+		printf("usart0 link (rts/cts): tx %u bytes, %.1f %% of the line while cts low, %u out of sequence\n",
+			unLine, 100.0 * unLine * 10.0 / __SIM_LINK_BPS / (SimTime() - 0.05 - gdLinkCtsHigh), unError);
+		USART0SetHandshake(0);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 12: COBS FRAMES WITH CRC-32 ON UART0   ////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_COBS_FRAME	200				// Frames sent.
+#define __SIM_COBS_MAX		300				// Max. frame length.
+
+static COBS_DECODER gSimCobs;
+static unsigned int gunCobsGood;			// Frames decoded with the correct length and data.
+static unsigned int gunCobsBad;
+
+// Frame i is (i x 37) % __SIM_COBS_MAX bytes long, starting with its no. if long enough.
+static unsigned int SimCobsFrame(unsigned int unFrame, uint8_t *ptrData)
+{
+	unsigned int unLength = (unFrame * 37) % __SIM_COBS_MAX;
+	unsigned int ni;
+
+	for (ni = 0; ni < unLength; ni++)
+	{
+		ptrData[ni] = (uint8_t)(unFrame * 13 + ni);	// Includes zeros.
+	}
+	if (unLength >= 2)
+	{
+		ptrData[0] = (uint8_t) unFrame;
+		ptrData[1] = (uint8_t)(unFrame >> 8);
+	}
+	return unLength;
+}
+
+// Decodes the frames in place in the receive ring.
+static void SimCobsReader(TASK_ATTRIBUTE *ptrTask)
+{
+	static uint8_t bytFrame[__SIM_COBS_MAX + __COBS_CRC32];
+	uint8_t bytExpect[__SIM_COBS_MAX];
+	uint8_t *ptrData;
+	unsigned int unCount;
+	unsigned int unFrame;
+
+	if (ptrTask->nState == 0)
+	{
+		UART0RxOpen(ptrTask->nID);
+		COBSDecodeStart(&gSimCobs, bytFrame, sizeof(bytFrame), __COBS_CRC32);
+	}
+	else
+	{
+		OSGetEvent(ptrTask, __UART_EVENT_RX);
+	}
+	while ((unCount = UART0RxPeek(&ptrData)) > 0)
+	{
+		UART0RxSkip(COBSDecode(&gSimCobs, ptrData, unCount));
+		if (gSimCobs.bytReady == 1)
+		{
+			unFrame = (gSimCobs.unFrameLength >= 2) ? bytFrame[0] + (bytFrame[1] << 8) : 0;
+			if ((gSimCobs.unFrameLength < 2) && (gSimCobs.unFrameLength != SimCobsFrame(0, bytExpect)))
+			{
+				unFrame = 73;						// The only frame with 1 byte.
+			}
+			if ((SimCobsFrame(unFrame, bytExpect) == gSimCobs.unFrameLength) && 
+				(memcmp(bytExpect, bytFrame, gSimCobs.unFrameLength) == 0))
+			{
+				gunCobsGood++;
+			}
+			else
+			{
+				gunCobsBad++;
+			}
+		}
+	}
+	OSWaitEvent(ptrTask, 1, __UART_EVENT_RX, 0);
+}
+
+static void SimUartCobs(void)
+{
+	static uint8_t bytStream[__SIM_COBS_FRAME * __COBS_MAX(__SIM_COBS_MAX + __COBS_CRC32)];
+	uint8_t bytData[__SIM_COBS_MAX];
+	COBS_ENCODER strcEnc;
+	unsigned int unStream = 0;
+	unsigned int unLength;
+	unsigned int unFrame;
+	unsigned int ni;
+
+	SimBoot();
+	gunCobsGood = 0;
+	gunCobsBad = 0;
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_UART_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimCobsReader);
+	SimRunKernel(0.05);						// Let the driver initialize the UART.
+	UART0->UART_BRGR = 8;					// MCK/(16 x 8) = 937.5 kbps.
+	for (unFrame = 0; unFrame < __SIM_COBS_FRAME; unFrame++)
+	{
+		unLength = SimCobsFrame(unFrame, bytData);
+		COBSEncodeStart(&strcEnc, &bytStream[unStream], __COBS_MAX(unLength + __COBS_CRC32), __COBS_CRC32);
+		COBSEncodeData(&strcEnc, bytData, unLength / 3);	// In two pieces.
+		COBSEncodeData(&strcEnc, &bytData[unLength / 3], unLength - unLength / 3);
+		unLength = COBSEncodeEnd(&strcEnc);
+		if (unFrame == 50)					// Corrupt one byte.
+		{
+			bytStream[unStream + unLength / 2] ^= (bytStream[unStream + unLength / 2] == 0x01) ? 0x02 : 0x01;
+		}
+		if (unFrame == 100)					// Lose 10 bytes.
+		{
+			memmove(&bytStream[unStream + 20], &bytStream[unStream + 30], unLength - 30);
+			unLength -= 10;
+		}
+		if (unFrame == 150)					// Lose the delimiter, frame 151 is lost too.
+		{
+			bytStream[unStream + unLength - 1] = 0x33;
+		}
+		unStream += unLength;
+	}
+	for (ni = 0; ni < 3; ni++)				// Noise, the decoder ignores it up to the delimiter
+	{										// sent before the first frame.
+		bytData[ni] = 0x5A;
+	}
+	bytData[3] = 0x00;
+	SimSerialInject(__SIM_UART0, bytData, 4);
+	SimSerialInject(__SIM_UART0, bytStream, unStream);
+	SimRunKernel(gdRunTime);
+
+	printf("uart0 cobs: %u frames (%u bytes) sent at 937.5 kbps with 3 corrupted, %u good, %u bad\n",
+		__SIM_COBS_FRAME, unStream, gunCobsGood, gunCobsBad);
+	printf("uart0 cobs: decoder %u frames, %u frame errors, %u crc errors\n",
+		gSimCobs.unFrameCount, gSimCobs.unFrameError, gSimCobs.unCRCError);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 13: ALL FOUR SERIAL PORTS AT 921.6 KBPS   /////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_PORTS_BPS		921600
+#define __SIM_PORTS_FRAME	512
+
+static SCI_PORT *gptrSimPort[__SCI_PORTS] = {&gstrcUART0, &gstrcUART1, &gstrcUSART0, &gstrcUSART1};
+static const int gnSimPort[__SCI_PORTS] = {__SIM_UART0, __SIM_UART1, __SIM_USART0, __SIM_USART1};
+static const char *gptrSimPortName[__SCI_PORTS] = {"uart0", "uart1", "usart0", "usart1"};
+static unsigned int gunPortsCount[__SCI_PORTS];
+static unsigned int gunPortsError[__SCI_PORTS];
+static SCI_FRAME gSimPortsFrame[__SCI_PORTS][2];
+
+// Reads the four receive rings, the data of port n start at n x 64.
+static void SimPortsReader(TASK_ATTRIBUTE *ptrTask)
+{
+	uint8_t bytData[256];
+	unsigned int unCount;
+	unsigned int ni;
+	int nPort;
+
+	for (nPort = 0; nPort < __SCI_PORTS; nPort++)
+	{
+		if (ptrTask->nState == 0)
+		{
+			SCIRxOpen(gptrSimPort[nPort], 0);
+		}
+		while ((unCount = SCIRxRead(gptrSimPort[nPort], bytData, sizeof(bytData))) > 0)
+		{
+			for (ni = 0; ni < unCount; ni++)
+			{
+				if (bytData[ni] != (uint8_t)(gunPortsCount[nPort] + ni + nPort * 64))
+				{
+					gunPortsError[nPort]++;
+				}
+			}
+			gunPortsCount[nPort] += unCount;
+		}
+	}
+	OSSetTaskContext(ptrTask, 1, 1 * __NUM_SYSTEMTICK_MSEC);
+}
+
+// Keeps two frames queued on each port.
+static void SimPortsWriter(TASK_ATTRIBUTE *ptrTask)
+{
+	static uint8_t bytFrame[__SIM_PORTS_FRAME];
+	int nPort;
+	int ni;
+
+	if (ptrTask->nState == 0)
+	{
+		for (ni = 0; ni < (int) sizeof(bytFrame); ni++)
+		{
+			bytFrame[ni] = (uint8_t) ni;
+		}
+	}
+	for (nPort = 0; nPort < __SCI_PORTS; nPort++)
+	{
+		for (ni = 0; ni < 2; ni++)
+		{
+			if (gSimPortsFrame[nPort][ni].bytStatus == __SCI_FRAME_DONE)
+			{
+				gSimPortsFrame[nPort][ni].ptrData = bytFrame;
+				gSimPortsFrame[nPort][ni].unLength = __SIM_PORTS_FRAME;
+				gSimPortsFrame[nPort][ni].nTask = ptrTask->nID;
+				SCIFrameSend(gptrSimPort[nPort], &gSimPortsFrame[nPort][ni], __SCI_PRIORITY_LOW);
+			}
+		}
+	}
+	OSWaitEvent(ptrTask, 1, __UART_EVENT_TX | __UART1_EVENT_TX | __USART_EVENT_TX | __USART1_EVENT_TX, 0);
+	OSGetEvent(ptrTask, __UART_EVENT_TX | __UART1_EVENT_TX | __USART_EVENT_TX | __USART1_EVENT_TX);
+}
+
+static void SimPorts(void)
+{
+	static uint8_t bytData[100000];
+	static uint8_t bytLine[200000];
+	unsigned int unInject;
+	unsigned int unLine;
+	unsigned int unError;
+	unsigned int ni;
+	int nPort;
+	int nResult = 0;
+
+	SimBoot();
+	memset(gunPortsCount, 0, sizeof(gunPortsCount));
+	memset(gunPortsError, 0, sizeof(gunPortsError));
+	memset(gSimPortsFrame, 0, sizeof(gSimPortsFrame));
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_UART_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_UART1_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_USART_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_USART1_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimPortsReader);
+	SimRunKernel(0.05);						// Let the drivers initialize the ports.
+	for (nPort = 0; nPort < __SCI_PORTS; nPort++)
+	{
+		nResult |= SCISetBaud(gptrSimPort[nPort], __SIM_PORTS_BPS);
+	}
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimPortsWriter);
+	unInject = (unsigned int)((gdRunTime - 0.1) * __SIM_PORTS_BPS / 10.0);
+	unInject = (unInject > sizeof(bytData)) ? sizeof(bytData) : unInject;
+	for (nPort = 0; nPort < __SCI_PORTS; nPort++)
+	{
+		for (ni = 0; ni < unInject; ni++)
+		{
+			bytData[ni] = (uint8_t)(ni + nPort * 64);
+		}
+		SimSerialInject(gnSimPort[nPort], bytData, unInject);
+	}
+	SimRunKernel(gdRunTime);
+
+	for (nPort = 0; nPort < __SCI_PORTS; nPort++)
+	{
+		unLine = SimSerialTxRead(gnSimPort[nPort], bytLine, sizeof(bytLine));
+		unError = 0;
+		for (ni = 0; ni < unLine; ni++)
+		{
+			if (bytLine[ni] != (uint8_t) ni)
+			{
+				unError++;
+			}
+		}
+		printf("ports (%s): rx %u of %u bytes, %u out of sequence, %u overruns, tx %u bytes (%.1f %% of the nominal rate), %u out of sequence\n",
+			gptrSimPortName[nPort], gunPortsCount[nPort], unInject, gunPortsError[nPort], SimSerialRxOverrun(gnSimPort[nPort]),
+			unLine, 100.0 * unLine * 10.0 / __SIM_PORTS_BPS / (SimTime() - 0.05), unError);
+	}
+	printf("ports: 4 ports at %.1f kbps%s, idle = %d %%\n", __SIM_PORTS_BPS * 1.0e-3,
+		(nResult == 0) ? "" : " (baud rate refused)", gnCPUIdle);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 14: TOKENIZED LOG OVER UART0   ////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_LOG_PERIOD	1				// Period of the log task in msec.
+#define __SIM_LOG_BPS		115200			// Baud rate of UART0.
+
+static const char *gptrLogFile;				// Capture of the UART0 line, 0 for none.
+static TC_TIMER gSimLogTimer;
+static unsigned int gunLogCount;			// Messages logged.
+static unsigned int gunLogText;				// Length of the same messages formatted as text.
+
+// Same message from an interrupt service routine, every 5 msec.
+static void SimLogTimer(void *ptrArg)
+{
+	char chrText[64];
+
+	(void) ptrArg;
+	__OS_LOG_MSG("tc0 callback %u, tick %u", gunLogCount, gunClockTick);
+	gunLogText += snprintf(chrText, sizeof(chrText), "tc0 callback %u, tick %u\r\n", gunLogCount, gunClockTick);
+	gunLogCount++;
+}
+
+static void SimLogTask(TASK_ATTRIBUTE *ptrTask)
+{
+	char chrText[64];
+	int nChannel = gunClockTick % 8;
+	int nValue = 1650 + (int)(gunClockTick % 200) - 100;
+	float fVolt = 3.3f + 0.001f * (gunClockTick % 50);
+
+	__OS_LOG_MSG("adc ch %d = %d mV", nChannel, nValue);
+	gunLogText += snprintf(chrText, sizeof(chrText), "adc ch %d = %d mV\r\n", nChannel, nValue);
+	if (ptrTask->nState == 9)
+	{
+		__OS_LOG_MSG("battery %.3f V, offset %d, status 0x%04X", OSLogFloat(fVolt), nValue - 1650, gunClockTick & 0xFFFF);
+		gunLogText += snprintf(chrText, sizeof(chrText), "battery %.3f V, offset %d, status 0x%04X\r\n", fVolt, nValue - 1650, gunClockTick & 0xFFFF);
+		gunLogCount++;
+	}
+	gunLogCount++;
+	OSSetTaskContext(ptrTask, (ptrTask->nState + 1) % 10, __SIM_LOG_PERIOD * __NUM_SYSTEMTICK_MSEC);
+}
+
+static void SimLog(void)
+{
+	static uint8_t bytLine[1 << 18];
+	int nCount;
+	FILE *fp;
+
+	SimBoot();
+	TCTimerInit();
+	memset(&gSimLogTimer, 0, sizeof(gSimLogTimer));
+	gunLogCount = 0;
+	gunLogText = 0;
+	gstrcTXqueue.unTail = gstrcTXqueue.unHead;	// Drop the data left by the previous experiment.
+	gstrcUART0.unBps = __SIM_LOG_BPS;			// Set by the previous experiment.
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_UART_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimLogTask);
+	TCTimerStart(&gSimLogTimer, 5000, 5000, SimLogTimer, 0);
+	SimRunKernel(gdRunTime);
+
+	nCount = SimSerialTxRead(__SIM_UART0, bytLine, sizeof(bytLine));
+#ifdef __OS_LOG
+	printf("log: %u messages, %u lost, %u bytes still buffered, %d bytes on uart0 (%.1f per message)\n",
+		gunLogCount, gunLogLost, gunLogHead - gunLogTail, nCount, (gunLogCount > 0) ? (double) nCount / gunLogCount : 0.0);
+#else
+	printf("log: __OS_LOG not defined, %d bytes on uart0\n", nCount);
+#endif
+	printf("log: same messages as text %u bytes, %.1f x the line capacity at %u bps\n", gunLogText,
+		gunLogText * 10.0 / (gstrcUART0.unBps * SimTime()), gstrcUART0.unBps);
+	if (gptrLogFile != 0)
+	{
+		fp = fopen(gptrLogFile, "wb");
+		if ((fp == 0) || (fwrite(bytLine, 1, nCount, fp) != (size_t) nCount))
+		{
+			perror(gptrLogFile);
+		}
+		if (fp != 0)
+		{
+			fclose(fp);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 15: I2C0 READ BURSTS   ////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_I2C_BURST		16				// Bytes per read burst.
+#define __SIM_I2C_HZ		200000			// SCL frequency.
+#define __SIM_I2C_ABSENT	64				// Every 64th burst is read from an absent Slave.
+
+static unsigned int gunI2CBurst;			// Bursts read.
+static unsigned int gunI2CBadByte;			// Bytes not matching the registers of the Slave.
+static unsigned int gunI2CNack;				// Bursts from the absent Slave with bCommError set.
+static unsigned int gunI2CAbsent;			// Bursts from the absent Slave.
+static double gdI2CStart;
+static double gdI2CLatency;					// Sum of the time from request to end of burst.
+
+static void SimI2CReader(TASK_ATTRIBUTE *ptrTask)
+{
+	int ni;
+
+	switch (ptrTask->nState)
+	{
+		case 0:								// Wait for the initialization of the driver.
+			if (gI2CStat.bI2CBusy == 0)
+			{
+				I2CSetBaud(&gstrcI2C0, __SIM_I2C_HZ);
+				OSSetTaskContext(ptrTask, 1, 1);
+			}
+			else
+			{
+				OSSetTaskContext(ptrTask, 0, 1);
+			}
+			break;
+
+		case 1:								// New register values, then read them.
+			for (ni = 0; ni < __SIM_I2C_BURST; ni++)
+			{
+				gSimSensor.bytRegister[0x40 + ni] = (uint8_t)(gunI2CBurst * 7 + ni);
+			}
+			gbytI2CByteCount = __SIM_I2C_BURST;
+			gbytI2CRegAdd = 0x40;
+			gbytI2CSlaveAdd = (((gunI2CBurst + gunI2CAbsent) % __SIM_I2C_ABSENT) == __SIM_I2C_ABSENT - 1) ? 0x2A : 0x1E;
+			gI2CStat.bRead = 1;
+			OSSignalEvent(gnI2C0Task, __I2C_EVENT_REQUEST);
+			gdI2CStart = SimTime();
+			OSSetTaskContext(ptrTask, 2, 1);
+			break;
+
+		case 2:
+			if (gI2CStat.bRead == 1)
+			{
+				OSSetTaskContext(ptrTask, 2, 1);
+				break;
+			}
+			if (gbytI2CSlaveAdd == 0x2A)
+			{
+				gunI2CAbsent++;
+				gunI2CNack += gI2CStat.bCommError;
+			}
+			else
+			{
+				for (ni = 0; ni < __SIM_I2C_BURST; ni++)
+				{
+					gunI2CBadByte += (gbytI2CRXbuf[ni] != (uint8_t)(gunI2CBurst * 7 + ni));
+				}
+				gdI2CLatency += SimTime() - gdI2CStart;
+				gunI2CBurst++;
+			}
+			OSSetTaskContext(ptrTask, 1, 1);
+			break;
+	}
+}
+
+static void SimI2CRead(void)
+{
+	SimBoot();
+	memset(&gSimSensor, 0, sizeof(gSimSensor));
+	gSimSensor.bytAddress = 0x1E;
+	SimTwiAttach(0, &gSimSensor);
+	gunI2CBurst = 0;
+	gunI2CBadByte = 0;
+	gunI2CNack = 0;
+	gunI2CAbsent = 0;
+	gdI2CLatency = 0.0;
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_I2C0_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimI2CReader);
+	SimRunKernel(gdRunTime);
+
+	printf("i2c0 read: %u bursts of %d bytes at %d kHz, %u bytes wrong, %u of %u absent slave reads with error\n",
+		gunI2CBurst, __SIM_I2C_BURST, __SIM_I2C_HZ / 1000, gunI2CBadByte, gunI2CNack, gunI2CAbsent);
+	printf("i2c0 read: bus time %.3f ms per burst, request to data %.3f ms (tick %.3f ms)\n",
+		1000.0 * SimTwiBusTime(0) / (gunI2CBurst + gunI2CAbsent), (gunI2CBurst > 0) ? 1000.0 * gdI2CLatency / gunI2CBurst : 0.0,
+		1.0 / __NUM_SYSTEMTICK_MSEC);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 16: FOUR I2C0 SENSORS SHARING THE TRANSACTION QUEUE   /////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_SENSORS		4
+#define __SIM_SENSOR_READ	12				// Bytes read per transaction.
+
+static SIM_TWI_SLAVE gSimSensors[__SIM_SENSORS];
+static int gnSimSensorTask[__SIM_SENSORS];
+static uint8_t gbytSensorData[__SIM_SENSORS][__SIM_SENSOR_READ];
+static unsigned int gunSensorRead[__SIM_SENSORS];
+static unsigned int gunSensorBad;			// Transactions with wrong data or an error.
+static I2C_PORT *gptrSensorPort[__SIM_SENSORS];	// Bus of each sensor.
+static unsigned int gunSensorHz;
+
+// Called by the driver task, check the byte written then the bytes read.
+static void SimSensorDone(I2C_TRANSACTION *ptrTrans, int nError)
+{
+	int nSensor = (int)(intptr_t) ptrTrans->ptrArg;
+	int ni;
+	int bBad = nError || (gSimSensors[nSensor].bytRegister[0x40] != ptrTrans->bytData[0]);
+
+	for (ni = 0; ni < __SIM_SENSOR_READ; ni++)
+	{
+		bBad |= (ptrTrans->ptrbytRead[ni] != (uint8_t)(nSensor * 32 + ni));
+	}
+	gunSensorBad += bBad;
+	gunSensorRead[nSensor]++;
+}
+
+// Each sensor writes a command byte to register 0x40 and reads the registers from 0x41, then
+// waits for the end of the transaction.
+static void SimSensorTask(TASK_ATTRIBUTE *ptrTask)
+{
+	I2C_TRANSACTION strcTrans = {0};
+	int nSensor = 0;
+
+	while (gnSimSensorTask[nSensor] != ptrTask->nID)
+	{
+		nSensor++;
+	}
+	if (ptrTask->nState == 0)				// Wait for the initialization of the driver.
+	{
+		OSSetTaskContext(ptrTask, 2, __NUM_SYSTEMTICK_MSEC);
+		return;
+	}
+	if (ptrTask->nState == 2)
+	{
+		I2CSetBaud(gptrSensorPort[nSensor], gunSensorHz);
+	}
+	OSGetEvent(ptrTask, __I2C_EVENT_DONE);
+	memset(gbytSensorData[nSensor], 0, __SIM_SENSOR_READ);
+	strcTrans.bytSlaveAdd = 0x18 + nSensor;
+	strcTrans.bytRegAdd = 0x40;
+	strcTrans.bytByteCount = 1;
+	strcTrans.bytData[0] = (uint8_t) gunSensorRead[nSensor];
+	strcTrans.bytReadCount = __SIM_SENSOR_READ;
+	strcTrans.ptrbytRead = gbytSensorData[nSensor];
+	strcTrans.fptrDone = SimSensorDone;
+	strcTrans.ptrArg = (void *)(intptr_t) nSensor;
+	strcTrans.nTaskNotify = ptrTask->nID;
+	if (I2CPutTransaction(gptrSensorPort[nSensor], &strcTrans) == 1)
+	{
+		OSSetTaskContext(ptrTask, 1, 1);	// Queue full, try again.
+	}
+	else
+	{
+		OSWaitEvent(ptrTask, 1, __I2C_EVENT_DONE, 0);
+	}
+}
+
+// Sensor ni on the bus nBus[ni], 0 = TWI0 and 1 = TWI1, at unHz.
+static void SimSensorsRun(const int *ptrBus, unsigned int unHz)
+{
+	int ni, nk;
+
+	gunSensorBad = 0;
+	gunSensorHz = unHz;
+	for (ni = 0; ni < __SIM_SENSORS; ni++)
+	{
+		memset(&gSimSensors[ni], 0, sizeof(gSimSensors[ni]));
+		gSimSensors[ni].bytAddress = 0x18 + ni;
+		for (nk = 0; nk < __SIM_SENSOR_READ; nk++)
+		{
+			gSimSensors[ni].bytRegister[0x41 + nk] = (uint8_t)(ni * 32 + nk);
+		}
+		SimTwiAttach(ptrBus[ni], &gSimSensors[ni]);
+		gptrSensorPort[ni] = (ptrBus[ni] == 0) ? &gstrcI2C0 : &gstrcI2C1;
+		gunSensorRead[ni] = 0;
+	}
+	gSimSensors[__SIM_SENSORS-1].nHold = (ptrBus[__SIM_SENSORS-1] == 1);	// Stuck once on TWI1.
+	for (ni = 0; ni < __SIM_SENSORS; ni++)
+	{
+		gnSimSensorTask[ni] = gnTaskCount;
+		OSCreateTask(&gstrcTaskContext[gnTaskCount], SimSensorTask);
+		gnSimSensorTask[ni] = gstrcTaskContext[gnSimSensorTask[ni]].nID;
+	}
+	SimRunKernel(gdRunTime);
+	gstrcI2CQueue.unTail = gstrcI2CQueue.unHead;			// Flush for the next experiment.
+	gstrcI2CQueue1.unTail = gstrcI2CQueue1.unHead;
+}
+
+static void SimI2CSensors(void)
+{
+	static const int nBus[__SIM_SENSORS] = {0, 0, 0, 0};
+	unsigned int unTotal = 0;
+	int ni;
+	double dBits;
+
+	SimBoot();
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_I2C0_Driver);
+	SimSensorsRun(nBus, __SIM_I2C_HZ);
+
+	for (ni = 0; ni < __SIM_SENSORS; ni++)
+	{
+		unTotal += gunSensorRead[ni];
+	}
+	dBits = 10 + 9 + 9 + 10 + 9 * __SIM_SENSOR_READ + 1;	// START, address, register, command,
+															// repeated START, data, STOP.
+	printf("i2c0 sensors: %d sensors, %u %u %u %u write then read transactions, %u wrong\n", __SIM_SENSORS,
+		gunSensorRead[0], gunSensorRead[1], gunSensorRead[2], gunSensorRead[3], gunSensorBad);
+	printf("i2c0 sensors: bus busy %.1f %%, %.1f transactions/s of max. %.1f at %d kHz\n",
+		100.0 * SimTwiBusTime(0) / SimTime(), unTotal / SimTime(), __SIM_I2C_HZ / dBits, __SIM_I2C_HZ / 1000);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 17: TWO SENSORS ON EACH OF TWI0 AND TWI1 IN FAST MODE   ///////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_I2C_FAST_HZ	400000
+
+// The sensors of experiment 16 split over the two buses at 400 kHz, the last one holds SCL
+// low during its first transaction, which is aborted on timeout, then the bus is recovered.
+static void SimI2CFast(void)
+{
+	static const int nBus[__SIM_SENSORS] = {0, 0, 1, 1};
+	unsigned int unTotal = 0;
+	int ni;
+	double dBits;
+
+	SimBoot();
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_I2C0_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_I2C1_Driver);
+	SimSensorsRun(nBus, __SIM_I2C_FAST_HZ);
+
+	for (ni = 0; ni < __SIM_SENSORS; ni++)
+	{
+		unTotal += gunSensorRead[ni];
+	}
+	dBits = 10 + 9 + 9 + 10 + 9 * __SIM_SENSOR_READ + 1;
+	printf("i2c fast: %d sensors, %u %u on twi0, %u %u on twi1, %u wrong, %u timeout, %u not recovered\n",
+		__SIM_SENSORS, gunSensorRead[0], gunSensorRead[1], gunSensorRead[2], gunSensorRead[3], gunSensorBad,
+		gstrcI2C0.unTimeout + gstrcI2C1.unTimeout, gstrcI2C0.unRecover + gstrcI2C1.unRecover);
+	printf("i2c fast: bus busy %.1f %% and %.1f %%, %.1f transactions/s of max. %.1f at %d kHz\n",
+		100.0 * SimTwiBusTime(0) / SimTime(), 100.0 * SimTwiBusTime(1) / SimTime(), unTotal / SimTime(),
+		2 * __SIM_I2C_FAST_HZ / dBits, __SIM_I2C_FAST_HZ / 1000);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 18: EIGHT SENSORS AT 1 KHZ WITH THE ACQUISITION ENGINE   //////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_ACQ			8				// Sensors, the first half on TWI0.
+#define __SIM_ACQ_PERIOD	__NUM_SYSTEMTICK_MSEC	// 1 kHz.
+
+static SIM_TWI_SLAVE gSimAcqSlave[__SIM_ACQ];
+static int gnAcqSensor[__SIM_ACQ];
+static unsigned int gunAcqSeq[__SIM_ACQ];	// Last sample seen by the consumer.
+static unsigned int gunAcqCount[__SIM_ACQ];	// New samples seen by the consumer.
+static unsigned int gunAcqBad;				// Samples with wrong data.
+static unsigned int gunAcqGap;				// Samples not seen by the consumer.
+static double gdAcqAge;						// Sum of the age of the samples when seen, in ticks.
+
+// Even sensors are IMUs, 6 bytes from register 0x3B, odd ones pressure sensors, 3 bytes from
+// register 0xF7.
+static void SimAcqSensor(int nSensor, uint8_t *ptrReg, uint8_t *ptrCount)
+{
+	*ptrReg = (nSensor & 1) ? 0xF7 : 0x3B;
+	*ptrCount = (nSensor & 1) ? 3 : 6;
+}
+
+// Consumer, looks at all the sensors on every tick.
+static void SimAcqConsumer(TASK_ATTRIBUTE *ptrTask)
+{
+	const SENSOR_SAMPLE *ptrSample;
+	uint8_t bytReg, bytCount;
+	int ni, nk;
+
+	for (ni = 0; ni < __SIM_ACQ; ni++)
+	{
+		ptrSample = SensorSample(gnAcqSensor[ni]);
+		if (ptrSample->unSeq == gunAcqSeq[ni])
+		{
+			continue;
+		}
+		SimAcqSensor(ni, &bytReg, &bytCount);
+		for (nk = 0; nk < bytCount; nk++)
+		{
+			gunAcqBad += (ptrSample->bytData[nk] != (uint8_t)(ni * 16 + nk));
+		}
+		gunAcqGap += ptrSample->unSeq - gunAcqSeq[ni] - 1;
+		gdAcqAge += gunClockTick - ptrSample->unTick;
+		gunAcqSeq[ni] = ptrSample->unSeq;
+		gunAcqCount[ni]++;
+	}
+	OSSetTaskContext(ptrTask, 1, 1);
+}
+
+static void SimAcq(void)
+{
+	uint8_t bytReg, bytCount;
+	unsigned int unMin = UINT32_MAX, unMax = 0, unTotal = 0, unOverrun = 0, unError = 0;
+	int ni, nk;
+
+	SimBoot();
+	memset(gstrcSensor, 0, sizeof(gstrcSensor));
+	gnSensorTask = 0;
+	gunAcqBad = 0;
+	gunAcqGap = 0;
+	gdAcqAge = 0.0;
+	I2CSetBaud(&gstrcI2C0, __SIM_I2C_FAST_HZ);
+	I2CSetBaud(&gstrcI2C1, __SIM_I2C_FAST_HZ);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_I2C0_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_I2C1_Driver);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_Sensor_Engine);
+	for (ni = 0; ni < __SIM_ACQ; ni++)
+	{
+		SimAcqSensor(ni, &bytReg, &bytCount);
+		memset(&gSimAcqSlave[ni], 0, sizeof(gSimAcqSlave[ni]));
+		gSimAcqSlave[ni].bytAddress = 0x18 + ni;
+		for (nk = 0; nk < bytCount; nk++)
+		{
+			gSimAcqSlave[ni].bytRegister[bytReg + nk] = (uint8_t)(ni * 16 + nk);
+		}
+		SimTwiAttach(ni / (__SIM_ACQ / 2), &gSimAcqSlave[ni]);
+		gnAcqSensor[ni] = SensorAdd((ni < __SIM_ACQ / 2) ? &gstrcI2C0 : &gstrcI2C1, 0x18 + ni, bytReg, bytCount,
+									__SIM_ACQ_PERIOD);
+		gunAcqSeq[ni] = 0;
+		gunAcqCount[ni] = 0;
+	}
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], SimAcqConsumer);
+	SimRunKernel(gdRunTime);
+	gstrcI2CQueue.unTail = gstrcI2CQueue.unHead;			// Flush for the next experiment.
+	gstrcI2CQueue1.unTail = gstrcI2CQueue1.unHead;
+
+	for (ni = 0; ni < __SIM_ACQ; ni++)
+	{
+		unMin = (gunAcqCount[ni] < unMin) ? gunAcqCount[ni] : unMin;
+		unMax = (gunAcqCount[ni] > unMax) ? gunAcqCount[ni] : unMax;
+		unTotal += gunAcqCount[ni];
+		unOverrun += gstrcSensor[gnAcqSensor[ni]].unOverrun;
+		unError += gstrcSensor[gnAcqSensor[ni]].unError;
+	}
+	printf("sensor engine: %d sensors at %d Hz, %.0f to %.0f samples/s, %u wrong, %u not seen, %u overrun, %u error\n",
+		__SIM_ACQ, 1000 * __NUM_SYSTEMTICK_MSEC / __SIM_ACQ_PERIOD, unMin / SimTime(), unMax / SimTime(), gunAcqBad,
+		gunAcqGap, unOverrun, unError);
+	printf("sensor engine: bus busy %.1f %% and %.1f %% at %d kHz, sample age %.3f ms when seen\n",
+		100.0 * SimTwiBusTime(0) / SimTime(), 100.0 * SimTwiBusTime(1) / SimTime(), __SIM_I2C_FAST_HZ / 1000,
+		(unTotal > 0) ? gdAcqAge / unTotal / __NUM_SYSTEMTICK_MSEC : 0.0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 19: DAC WAVEFORM AT 500 KSPS WITH TWO PDC BUFFERS   ///////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_DAC_RATE		500000			// Conversions per second.
+#define __SIM_DAC_LENGTH	256				// Samples per buffer.
+
+static uint16_t gunSimDacBuf[2][__SIM_DAC_LENGTH];
+static unsigned int gunSimDacNext;			// Next sample of the ramp.
+
+static unsigned int SimDacRefill(uint16_t *ptrBuf, unsigned int unLength, void *ptrArg)
+{
+	unsigned int ni;
+
+	for (ni = 0; ni < unLength; ni++)
+	{
+		ptrBuf[ni] = (uint16_t)(gunSimDacNext++ & 0x0FFF);
+	}
+	return unLength;
+}
+
+static void SimDac(void)
+{
+	uint16_t unOut[1024];
+	unsigned int unCount = 0, unBad = 0, unExpect = 0, unStatic = 0;
+	int ni, nk;
+	double dFirst, dLast;
+
+	SimBoot();
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_DACC_Driver);
+	gunDAC_OutB = 0x0123;
+	SimRunKernel(0.02);										// Static output first.
+	while ((nk = SimDaccOutput(1, unOut, 1024)) > 0)
+	{
+		unStatic = unOut[nk - 1];
+	}
+
+	gunSimDacNext = 0;
+	SimDacRefill(gunSimDacBuf[0], __SIM_DAC_LENGTH, 0);
+	SimDacRefill(gunSimDacBuf[1], __SIM_DAC_LENGTH, 0);
+	DACCStreamStart(1, __SIM_DAC_RATE, gunSimDacBuf[0], gunSimDacBuf[1], __SIM_DAC_LENGTH, SimDacRefill, 0);
+	SimRunKernel(0.02 + gdRunTime);
+	DACCStreamStop();
+	SimDaccTime(1, &dFirst, &dLast);
+	while ((nk = SimDaccOutput(1, unOut, 1024)) > 0)
+	{
+		for (ni = 0; ni < nk; ni++)
+		{
+			unBad += (unOut[ni] != (unExpect & 0x0FFF));
+			unExpect++;
+		}
+		unCount += nk;
+	}
+	printf("dac: static output 0x%03X, %u samples at %.0f samples/s (%u requested), %u wrong, %u underrun, %u seen by the driver\n",
+		unStatic, unCount, (unCount > 1) ? (unCount - 1) / (dLast - dFirst) : 0.0, __SIM_DAC_RATE, unBad,
+		SimDaccUnderrun(), gstrcDACCStream.unUnderrun);
+	printf("dac: %.0f buffer refills/s of %d samples, actual timer rate %u Hz\n",
+		gstrcDACCStream.unRefill / gdRunTime, __SIM_DAC_LENGTH, gstrcDACCStream.unActualHz);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 20: DDS SINE AND CHIRP ON THE TWO DAC CHANNELS   //////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_DDS_RATE		500000			// Conversions per second, both channels.
+#define __SIM_DDS_SINE		1000000			// DAC0, mHz.
+#define __SIM_DDS_SINE2		1234567			// DAC0 after the change, mHz.
+#define __SIM_DDS_CHIRP_MS	100				// DAC1, 10 Hz to 20 kHz.
+#define __SIM_DDS_RATE2		300000			// Divisor of the trigger timer changes at 100 MHz.
+#define __SIM_DDS_MCK		100000000
+
+// Upward crossings of the offset by the samples of a channel, from the sample unFrom.
+static void SimDdsCross(const std::vector<uint16_t> &vecOut, unsigned int unFrom, double dRate,
+						unsigned int *ptrCount, double *ptrFirst, double *ptrLast)
+{
+	unsigned int ni;
+	double dTime;
+
+	*ptrCount = 0;
+	for (ni = unFrom + 1; ni < vecOut.size(); ni++)
+	{
+		if ((vecOut[ni - 1] < 2048) && (vecOut[ni] >= 2048))
+		{
+			dTime = (ni - 1 + (2048.0 - vecOut[ni - 1]) / (vecOut[ni] - vecOut[ni - 1])) / dRate;
+			*ptrFirst = (*ptrCount == 0) ? dTime : *ptrFirst;
+			*ptrLast = dTime;
+			(*ptrCount)++;
+		}
+	}
+}
+
+static void SimDds(void)
+{
+	std::vector<uint16_t> vecOut[2];
+	uint16_t unOut[1024];
+	unsigned int unCross, unChange;
+	int ni, nk, nStep, nMaxStep = 0;
+	double dError, dMaxError = 0.0, dFirst = 0.0, dLast = 0.0, dFreq, dRate;
+
+	SimBoot();
+	memset(gstrcDDS, 0, sizeof(gstrcDDS));
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_DACC_Driver);
+	SimRunKernel(0.02);
+	for (ni = 0; ni < 2; ni++)
+	{
+		while (SimDaccOutput(ni, unOut, 1024) > 0);			// Static outputs.
+	}
+	DDSSetWave(0, __DDS_WAVE_SINE, 2000, 2048);
+	DDSSetFrequency(0, __SIM_DDS_SINE);
+	DDSSetWave(1, __DDS_WAVE_TRIANGLE, 1000, 2048);
+	DDSSetChirp(1, 10000, 20000000, __SIM_DDS_CHIRP_MS);
+	DDSStart(__SIM_DDS_RATE);
+	SimRunKernel(0.02 + gdRunTime / 2);
+	unChange = SimDaccCount(0);
+	DDSSetFrequency(0, __SIM_DDS_SINE2);
+	SimRunKernel(0.02 + gdRunTime);
+	DDSStop();
+	for (ni = 0; ni < 2; ni++)
+	{
+		while ((nk = SimDaccOutput(ni, unOut, 1024)) > 0)
+		{
+			vecOut[ni].insert(vecOut[ni].end(), unOut, unOut + nk);
+		}
+	}
+
+	for (ni = 0; ni < (int) unChange; ni++)				// Against the exact sine.
+	{
+		dError = fabs(vecOut[0][ni] - (2048.0 + 2000.0 * sin(2.0 * M_PI * __SIM_DDS_SINE * 1.0e-3 * ni / gunDDSRateHz)));
+		dMaxError = (dError > dMaxError) ? dError : dMaxError;
+	}
+	for (ni = 1; ni < (int) vecOut[0].size(); ni++)
+	{
+		nStep = abs((int) vecOut[0][ni] - (int) vecOut[0][ni - 1]);
+		nMaxStep = (nStep > nMaxStep) ? nStep : nMaxStep;
+	}
+	SimDdsCross(vecOut[0], unChange + 2 * __DDS_BLOCK, gunDDSRateHz, &unCross, &dFirst, &dLast);
+	dFreq = (unCross > 1) ? (unCross - 1) / (dLast - dFirst) : 0.0;
+	printf("dds: %u samples/s per channel, sine max. error %.2f LSB, then %.3f Hz (%.3f set), max. step %d LSB (%.0f expected)\n",
+		gunDDSRateHz, dMaxError, dFreq, __SIM_DDS_SINE2 * 1.0e-3, nMaxStep,
+		2.0 * M_PI * __SIM_DDS_SINE2 * 1.0e-3 / gunDDSRateHz * 2000.0);
+	SimDdsCross(vecOut[1], 0, gunDDSRateHz, &unCross, &dFirst, &dLast);
+	printf("dds: chirp %.1f periods per sweep (%.1f expected), %u %u samples, %u underrun\n",
+		unCross * (__SIM_DDS_CHIRP_MS * 1.0e-3) / ((double) vecOut[1].size() / gunDDSRateHz),
+		(10.0 + 20000.0) / 2 * __SIM_DDS_CHIRP_MS * 1.0e-3, (unsigned int) vecOut[0].size(),
+		(unsigned int) vecOut[1].size(), SimDaccUnderrun() + gstrcDACCStream.unUnderrun);
+
+	// The same sine at a rate the trigger timer generates exactly at 120 MHz only.
+	DDSStart(__SIM_DDS_RATE2);
+	SimRunKernel(SimTime() + 0.01);
+	OSSetClock(__SIM_DDS_MCK);
+	SimRunKernel(SimTime() + 0.01);
+	while (SimDaccOutput(0, unOut, 1024) > 0);
+	vecOut[0].clear();
+	SimRunKernel(SimTime() + gdRunTime / 4);
+	DDSStop();
+	while ((nk = SimDaccOutput(0, unOut, 1024)) > 0)
+	{
+		vecOut[0].insert(vecOut[0].end(), unOut, unOut + nk);
+	}
+	dRate = SimMasterClockHz() / 2.0 / (TC0->TC_CHANNEL[1].TC_RC + 1) / 2.0;	// TIMER_CLOCK1, two channels.
+	SimDdsCross(vecOut[0], 0, dRate, &unCross, &dFirst, &dLast);
+	dFreq = (unCross > 1) ? (unCross - 1) / (dLast - dFirst) : 0.0;
+	printf("dds: at %.0f MHz %.1f samples/s per channel (%u), sine %.3f Hz (%.3f set)\n",
+		SimMasterClockHz() * 1.0e-6, dRate, gunDDSRateHz, dFreq, __SIM_DDS_SINE2 * 1.0e-3);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPERIMENT 21: ADC, THREE INPUTS AT 100 KSPS EACH   //////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_ADC_CHANNEL	0x13			// AD0, AD1 and AD4.
+#define __SIM_ADC_COUNT		3
+#define __SIM_ADC_RATE		100000			// Scans per second.
+#define __SIM_ADC_SCAN		300				// Scans per block, 3 msec.
+
+static unsigned int gunSimAdcCount[16];		// Conversions of each input.
+static double gdSimAdcFirst, gdSimAdcLast;	// Time of the first and last scans.
+static double gdSimAdcMin, gdSimAdcMax;		// Range of the interval between two scans.
+static unsigned int gunAdcBlock;			// Blocks seen by the consumer.
+static unsigned int gunAdcBad;				// Samples with wrong value.
+static unsigned int gunAdcGap;				// Blocks not seen by the consumer.
+static unsigned int gunAdcLastSeq;
+static double gdAdcLatency;					// Sum of the delays from the last scan to the consumer.
+
+// Each input gives the no. of its conversion, plus 1000 x the channel.
+static int SimAdcInput(int nChannel, double dTime)
+{
+	double dStep;
+
+	if (nChannel == 0)
+	{
+		if (gunSimAdcCount[0] == 0)
+		{
+			gdSimAdcFirst = dTime;
+		}
+		else
+		{
+			dStep = dTime - gdSimAdcLast;
+			gdSimAdcMin = (dStep < gdSimAdcMin) ? dStep : gdSimAdcMin;
+			gdSimAdcMax = (dStep > gdSimAdcMax) ? dStep : gdSimAdcMax;
+		}
+		gdSimAdcLast = dTime;
+	}
+	return (int)(gunSimAdcCount[nChannel]++ + 1000 * nChannel) & 0xFFF;
+}
+
+static void SimAdcConsumer(const ADC_BLOCK *ptrBlock, void *ptrArg)
+{
+	static const int nChannel[__SIM_ADC_COUNT] = {0, 1, 4};
+	unsigned int ni;
+	int nk;
+	double dPeriod;
+
+	gunAdcGap += ptrBlock->unSeq - gunAdcLastSeq - 1;
+	gunAdcLastSeq = ptrBlock->unSeq;
+	for (ni = 0; ni < __SIM_ADC_SCAN; ni++)
+	{
+		for (nk = 0; nk < __SIM_ADC_COUNT; nk++)
+		{
+			gunAdcBad += (ptrBlock->unData[ni * __SIM_ADC_COUNT + nk] !=
+						  ((ptrBlock->unScan + ni + 1000 * nChannel[nk]) & 0xFFF));
+		}
+	}
+	dPeriod = (gdSimAdcLast - gdSimAdcFirst) / (gunSimAdcCount[0] - 1);		// Simulated, not 1 / unActualHz.
+	gdAdcLatency += SimTime() - (gdSimAdcFirst + (ptrBlock->unScan + __SIM_ADC_SCAN - 1) * dPeriod);
+	gunAdcBlock++;
+}
+
+static void SimAdcRun(void)
+{
+	SimBoot();
+	memset(gunSimAdcCount, 0, sizeof(gunSimAdcCount));
+	gdSimAdcMin = 1.0;
+	gdSimAdcMax = 0.0;
+	gunAdcBlock = 0;
+	gunAdcBad = 0;
+	gunAdcGap = 0;
+	gunAdcLastSeq = 0;
+	gdAdcLatency = 0.0;
+	SimAdcSource(SimAdcInput);
+	OSCreateTask(&gstrcTaskContext[gnTaskCount], Proce_ADC_Driver);
+	SimRunKernel(0.001);
+	ADCStart(__SIM_ADC_CHANNEL, __SIM_ADC_RATE, __SIM_ADC_SCAN, SimAdcConsumer, 0);
+	SimRunKernel(0.001 + gdRunTime);
+	ADCStop();
+
+	printf("adc: %d inputs at %.0f scans/s (%u Hz), interval %.3f to %.3f usec, %u %u %u conversions, %u lost\n",
+		__SIM_ADC_COUNT, (gunSimAdcCount[0] - 1) / (gdSimAdcLast - gdSimAdcFirst), gstrcADC.unActualHz,
+		gdSimAdcMin * 1.0e6, gdSimAdcMax * 1.0e6, gunSimAdcCount[0], gunSimAdcCount[1], gunSimAdcCount[4], SimAdcLost());
+	printf("adc: %u blocks of %d scans, %u wrong, %u not seen, %u overrun, latency %.1f usec after the last scan\n",
+		gunAdcBlock, __SIM_ADC_SCAN, gunAdcBad, gunAdcGap, gstrcADC.unOverrun + gstrcADC.unLost,
+		(gunAdcBlock > 0) ? gdAdcLatency / gunAdcBlock * 1.0e6 : 0.0);
+}
+
+int main(int argc, char *argv[])
+{
+	clock_t lStart = clock();
+	double dVirtual = 0.0;
+	double dWall;
+
+	if (argc > 1)
+	{
+		gdRunTime = atof(argv[1]);
+	}
+	if (argc > 2)
+	{
+		gptrTraceFile = argv[2];
+	}
+	if (argc > 3)
+	{
+		gptrLogFile = argv[3];
+	}
+
+	SimKernel();
+	dVirtual += SimEnd();
+	SimUartTx(SimTxSource, "frame");
+	dVirtual += SimEnd();
+	SimUartTx(SimTxQueue, "queue");
+	dVirtual += SimEnd();
+	SimUartTx(SimTxChain, "chain");
+	dVirtual += SimEnd();
+	SimUartRx();
+	dVirtual += SimEnd();
+	SimI2C(SimI2CClient, "flag");
+	dVirtual += SimEnd();
+	SimI2C(SimI2CQueue, "queue");
+	dVirtual += SimEnd();
+	SimTc();
+	dVirtual += SimEnd();
+	SimDfs();
+	dVirtual += SimEnd();
+	SimTrace();
+	dVirtual += SimEnd();
+	SimUartRing();
+	dVirtual += SimEnd();
+	SimUsartFrame();
+	dVirtual += SimEnd();
+	SimFrames(__SIM_UART0);
+	dVirtual += SimEnd();
+	SimFrames(__SIM_USART0);
+	dVirtual += SimEnd();
+	SimUsartLink(0);
+	dVirtual += SimEnd();
+	SimUsartLink(1);
+	dVirtual += SimEnd();
+	SimUartCobs();
+	dVirtual += SimEnd();
+	SimPorts();
+	dVirtual += SimEnd();
+	SimLog();
+	dVirtual += SimEnd();
+	SimI2CRead();
+	dVirtual += SimEnd();
+	SimI2CSensors();
+	dVirtual += SimEnd();
+	SimI2CFast();
+	dVirtual += SimEnd();
+	SimAcq();
+	dVirtual += SimEnd();
+	SimDac();
+	dVirtual += SimEnd();
+	SimDds();
+	dVirtual += SimEnd();
+	SimAdcRun();
+	dVirtual += SimEnd();
+
+	printf("kernel: %u tick overruns with event driven tasks, %u while switching the clock\n",
+		gunSimOverrun - gunSimClockOverrun, gunSimClockOverrun);
+	dWall = (double)(clock() - lStart) / CLOCKS_PER_SEC;
+	printf("simulated %.3f s in %.3f s of host time (%.0fx real time)\n", dVirtual, dWall, (dWall > 0.0) ? dVirtual / dWall : 0.0);
+	return 0;
+}
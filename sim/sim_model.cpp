@@ -0,0 +1,2652 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	BEHAVIOURAL MODELS OF THE SAM4S PERIPHERALS FOR THE HOST SIMULATION
+//
+//  (c) Copyright 2026, Fabian Kung Wai Lee, Selangor, MALAYSIA
+//  All Rights Reserved
+//
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File				: sim_model.cpp
+// Author(s)		: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Toolsuites		: GCC C++ Compiler (Linux host)
+// Description		: This file implements the virtual clock and the behavioural models of the
+//                    peripherals used by the drivers, namely:
+//                    1. PMC, master clock (MCK) derived from the MCKR, PLLA and PLLB settings.
+//                    2. SysTick count down and exception request, DWT cycle counter.
+//                    3. PIO set/clear register pairs and output pin trace.
+//                    4. UART0/1 and USART0/1 with baud rate dependent shift timing, receive
+//                       overrun, the PDC channels and the interrupt line.  Characters being
+//                       sent while MCK changes are counted as lost.  ENDRX is latched until 
+//                       RCR or RNCR is written, and the USART has the receiver time-out.
+//                    5. TWI0/1 master with ACK/NAK from virtual slave devices, bit timing
+//                       from TWI_CWGR, internal address, the PDC channels and the interrupt
+//                       line.  A slave can hold SCL low until the TWI is reset.
+//                    6. DACC conversions written to DACC_CDR or triggered by TIOA of a TC
+//                       channel with the PDC channel, ENDTX latched until TCR or TNCR is
+//                       written, and the interrupt line.  EEFC, WDT and CMCC as plain registers.
+//                       ADC conversions of the enabled channels triggered by TIOA of a TC
+//                       channel, from virtual analog inputs, with the PDC channel.
+//                    7. TC0/TC1 channels, counter, compare and overflow events, and the NVIC
+//                       with level sensitive peripheral interrupts.
+//                    Every register access advances the virtual clock by one MCK cycle.  The
+//                    code executed between accesses takes no virtual time.  WFI advances the
+//                    virtual clock to the next peripheral event.  Exceptions are delivered
+//                    between register accesses when PRIMASK is clear, and are not nested.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+#include "sam.h"
+#include "sim.h"
+
+// --- Firmware exception handlers ---
+// Declared weak so that the simulation links when a handler is not implemented.
+void SysTick_Handler(void) __attribute__((weak));
+void UART0_Handler(void) __attribute__((weak));
+void UART1_Handler(void) __attribute__((weak));
+void USART0_Handler(void) __attribute__((weak));
+void USART1_Handler(void) __attribute__((weak));
+void TWI0_Handler(void) __attribute__((weak));
+void TWI1_Handler(void) __attribute__((weak));
+void TC0_Handler(void) __attribute__((weak));
+void TC1_Handler(void) __attribute__((weak));
+void TC2_Handler(void) __attribute__((weak));
+void TC3_Handler(void) __attribute__((weak));
+void TC4_Handler(void) __attribute__((weak));
+void TC5_Handler(void) __attribute__((weak));
+void ADC_Handler(void) __attribute__((weak));
+void DACC_Handler(void) __attribute__((weak));
+
+// --- Register blocks ---
+SysTick_Type gSimSysTick;
+DWT_Type gSimDWT;
+CoreDebug_Type gSimCoreDebug;
+Pmc gSimPMC;
+Efc gSimEFC0;
+Wdt gSimWDT;
+Cmcc gSimCMCC;
+Matrix gSimMATRIX;
+Pio gSimPIOA;
+Pio gSimPIOB;
+Pio gSimPIOC;
+Uart gSimUART0;
+Uart gSimUART1;
+Usart gSimUSART0;
+Usart gSimUSART1;
+Twi gSimTWI0;
+Twi gSimTWI1;
+Dacc gSimDACC;
+Adc gSimADC;
+Tc gSimTC0;
+Tc gSimTC1;
+
+// --- Virtual clock ---
+uint64_t gullSimTimePs;
+uint64_t gullSimAccessCount;
+
+#define __SIM_MAINCK_XTAL_HZ	8000000.0		// 8 MHz crystal on the core board.
+#define __SIM_MAINCK_RC_HZ		4000000.0		// Fast RC oscillator after reset.
+#define __SIM_SLCK_HZ			32768.0
+#define __SIM_WDT_TIMEOUT_S		16.0			// Default watchdog timeout.
+#define __SIM_HANDLER_LIMIT		100000000ULL	// Max. register accesses in one exception handler.
+
+static double gdMCKHz;
+static uint64_t gullCyclePs;
+static int gnPrimask;
+static int gnInHandler;
+static uint64_t gullHandlerAccess;
+static uint64_t gullLastWatchdog;
+
+static uint64_t gullCycleBasePs;				// Virtual time and DWT cycle count at the last clock
+static uint64_t gullCycleBase;					// change, write to CYCCNT or counter enable.
+
+static int gnSysTickPending;
+static uint64_t gullSysTickZero;				// Virtual time when SysTick counter reaches 0.
+
+static uint32_t gunNvicEnable;					// NVIC interrupt set-enable bits, IRQ 0 to 31.
+static uint32_t gunNvicPending;					// NVIC interrupt pending bits.
+
+static void SimDeliver(void);
+static void SimIrqUpdate(int nIrq);
+static void SimTcRebase(uint64_t ullOldCyclePs);
+static void SimSerialClockChange(void);
+
+static int SimPending(void)
+{
+	return gnSysTickPending | ((gunNvicPending & gunNvicEnable) != 0);
+}
+
+void SimNvicEnable(int nIrq, int bEnable)
+{
+	if (bEnable)
+	{
+		gunNvicEnable |= 1u << nIrq;
+		SimIrqUpdate(nIrq);
+		SimDeliver();
+	}
+	else
+	{
+		gunNvicEnable &= ~(1u << nIrq);
+	}
+}
+
+void SimNvicPend(int nIrq, int bPend)
+{
+	if (bPend)
+	{
+		gunNvicPending |= 1u << nIrq;
+		SimDeliver();
+	}
+	else
+	{
+		gunNvicPending &= ~(1u << nIrq);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  SYSTICK   ////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t SimSysTickClockPs(void)
+{
+	if (gSimSysTick.CTRL.unValue & SysTick_CTRL_CLKSOURCE_Msk)
+	{
+		return gullCyclePs;						// Processor clock.
+	}
+	return gullCyclePs * 8;						// External reference clock, MCK/8.
+}
+
+static uint64_t SimSysTickPeriodPs(void)
+{
+	return (uint64_t)((gSimSysTick.LOAD.unValue & 0xFFFFFF) + 1) * SimSysTickClockPs();
+}
+
+static int SimSysTickRunning(void)
+{
+	return ((gSimSysTick.CTRL.unValue & SysTick_CTRL_ENABLE_Msk) != 0) && ((gSimSysTick.LOAD.unValue & 0xFFFFFF) != 0);
+}
+
+static void SimSysTickUpdate(void)
+{
+	if (SimSysTickRunning() == 0)
+	{
+		return;
+	}
+	while (gullSimTimePs >= gullSysTickZero)
+	{
+		gSimSysTick.CTRL.unValue |= SysTick_CTRL_COUNTFLAG_Msk;
+		if (gSimSysTick.CTRL.unValue & SysTick_CTRL_TICKINT_Msk)
+		{
+			gnSysTickPending = 1;
+		}
+		gullSysTickZero += SimSysTickPeriodPs();
+	}
+}
+
+static uint32_t SimSysTickRead(SimReg *ptrReg)
+{
+	uint32_t unValue;
+	uint64_t ullCount;
+
+	SimSysTickUpdate();
+	if (ptrReg == &gSimSysTick.VAL)
+	{
+		if (SimSysTickRunning() == 0)
+		{
+			return ptrReg->unValue;
+		}
+		ullCount = (gullSysTickZero - gullSimTimePs) / SimSysTickClockPs();
+		if (ullCount > (gSimSysTick.LOAD.unValue & 0xFFFFFF))
+		{
+			ullCount = gSimSysTick.LOAD.unValue & 0xFFFFFF;
+		}
+		return (uint32_t) ullCount;
+	}
+	unValue = ptrReg->unValue;
+	if (ptrReg == &gSimSysTick.CTRL)
+	{
+		gSimSysTick.CTRL.unValue &= ~SysTick_CTRL_COUNTFLAG_Msk;	// COUNTFLAG is cleared on read.
+	}
+	return unValue;
+}
+
+static void SimSysTickWrite(SimReg *ptrReg, uint32_t unValue)
+{
+	int bWasRunning = SimSysTickRunning();
+
+	SimSysTickUpdate();
+	if (ptrReg == &gSimSysTick.CTRL)
+	{
+		gSimSysTick.CTRL.unValue = (gSimSysTick.CTRL.unValue & SysTick_CTRL_COUNTFLAG_Msk) | (unValue & 0x7);
+		if ((bWasRunning == 0) && SimSysTickRunning())
+		{
+			gullSysTickZero = gullSimTimePs + SimSysTickPeriodPs();
+		}
+	}
+	else if (ptrReg == &gSimSysTick.VAL)		// Any write clears the counter and COUNTFLAG.
+	{
+		gSimSysTick.VAL.unValue = 0;
+		gSimSysTick.CTRL.unValue &= ~SysTick_CTRL_COUNTFLAG_Msk;
+		gullSysTickZero = gullSimTimePs + SimSysTickPeriodPs();
+	}
+	else if (ptrReg == &gSimSysTick.LOAD)
+	{
+		gSimSysTick.LOAD.unValue = unValue & 0xFFFFFF;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  PMC, EEFC, WDT, CMCC   ///////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+static double SimPllHz(uint32_t unPllr, double dInput)
+{
+	uint32_t unMul = (unPllr >> 16) & 0x7FF;
+	uint32_t unDiv = unPllr & 0xFF;
+
+	if ((unMul == 0) || (unDiv == 0))
+	{
+		return 0.0;									// PLL disabled.
+	}
+	return dInput * (unMul + 1) / unDiv;
+}
+
+static void SimUpdateClock(void)
+{
+	double dMain;
+	double dHz;
+	uint32_t unPres;
+	uint64_t ullOldClockPs = SimSysTickClockPs();
+	uint64_t ullOldCyclePs;
+	uint64_t ullCount;
+
+	dMain = (gSimPMC.CKGR_MOR.unValue & CKGR_MOR_MOSCSEL) ? __SIM_MAINCK_XTAL_HZ : __SIM_MAINCK_RC_HZ;
+	switch (gSimPMC.PMC_MCKR.unValue & PMC_MCKR_CSS_Msk)
+	{
+		case PMC_MCKR_CSS_SLOW_CLK:	dHz = __SIM_SLCK_HZ;	break;
+		case PMC_MCKR_CSS_MAIN_CLK:	dHz = dMain;			break;
+		case PMC_MCKR_CSS_PLLA_CLK:	dHz = SimPllHz(gSimPMC.CKGR_PLLAR.unValue, dMain);	break;
+		default:					dHz = SimPllHz(gSimPMC.CKGR_PLLBR.unValue, dMain);	break;
+	}
+	unPres = (gSimPMC.PMC_MCKR.unValue & PMC_MCKR_PRES_Msk) >> 4;
+	dHz = (unPres == 7) ? dHz / 3.0 : dHz / (1 << unPres);
+	if (dHz <= 0.0)
+	{
+		fprintf(stderr, "sim: master clock stopped (MCKR = 0x%08X)\n", gSimPMC.PMC_MCKR.unValue);
+		exit(2);
+	}
+	if (gullCyclePs != 0)						// Fold the cycles counted at the old clock.
+	{
+		gullCycleBase += (gullSimTimePs - gullCycleBasePs) / gullCyclePs;
+		gullCycleBasePs = gullSimTimePs;
+	}
+	ullOldCyclePs = gullCyclePs;
+	gdMCKHz = dHz;
+	gullCyclePs = (uint64_t)(1.0e12 / dHz + 0.5);
+	SimTcRebase(ullOldCyclePs);
+	if ((ullOldCyclePs != 0) && (ullOldCyclePs != gullCyclePs))
+	{
+		SimSerialClockChange();
+	}
+
+	if (SimSysTickRunning())					// Keep the remaining SysTick count.
+	{
+		ullCount = (gullSysTickZero > gullSimTimePs) ? (gullSysTickZero - gullSimTimePs) / ullOldClockPs : 0;
+		gullSysTickZero = gullSimTimePs + ullCount * SimSysTickClockPs();
+	}
+}
+
+// DWT cycle counter, counts the master clock cycles while CYCCNTENA and TRCENA are set.
+static int SimDwtRunning(void)
+{
+	return ((gSimDWT.CTRL.unValue & DWT_CTRL_CYCCNTENA_Msk) != 0) &&
+		((gSimCoreDebug.DEMCR.unValue & CoreDebug_DEMCR_TRCENA_Msk) != 0);
+}
+
+static uint32_t SimDwtCycles(void)
+{
+	if (SimDwtRunning() == 0)
+	{
+		return (uint32_t) gullCycleBase;
+	}
+	return (uint32_t)(gullCycleBase + (gullSimTimePs - gullCycleBasePs) / gullCyclePs);
+}
+
+static uint32_t SimDwtRead(SimReg *ptrReg)
+{
+	if (ptrReg == &gSimDWT.CYCCNT)
+	{
+		return SimDwtCycles();
+	}
+	return ptrReg->unValue;
+}
+
+static void SimDwtWrite(SimReg *ptrReg, uint32_t unValue)
+{
+	gullCycleBase = SimDwtCycles();				// Freeze the count before changing the mode.
+	gullCycleBasePs = gullSimTimePs;
+	if (ptrReg == &gSimDWT.CYCCNT)
+	{
+		gullCycleBase = unValue;
+	}
+	else if (ptrReg != &gSimDWT.PCSR)
+	{
+		ptrReg->unValue = unValue;
+	}
+}
+
+static uint32_t SimPmcRead(SimReg *ptrReg)
+{
+	if (ptrReg == &gSimPMC.PMC_SR)				// Oscillators, PLLs and MCK are always ready.
+	{
+		return PMC_SR_MOSCXTS | PMC_SR_LOCKA | PMC_SR_LOCKB | PMC_SR_MCKRDY | PMC_SR_MOSCSELS | PMC_SR_MOSCRCS;
+	}
+	if ((ptrReg == &gSimPMC.PMC_PCER0) || (ptrReg == &gSimPMC.PMC_PCDR0) || (ptrReg == &gSimPMC.PMC_PCER1) ||
+		(ptrReg == &gSimPMC.PMC_PCDR1))
+	{
+		return 0;								// Write-only.
+	}
+	return ptrReg->unValue;
+}
+
+static void SimPmcWrite(SimReg *ptrReg, uint32_t unValue)
+{
+	if (ptrReg == &gSimPMC.PMC_PCER0)
+	{
+		gSimPMC.PMC_PCSR0.unValue |= unValue;
+	}
+	else if (ptrReg == &gSimPMC.PMC_PCDR0)
+	{
+		gSimPMC.PMC_PCSR0.unValue &= ~unValue;
+	}
+	else if (ptrReg == &gSimPMC.PMC_PCER1)
+	{
+		gSimPMC.PMC_PCSR1.unValue |= unValue;
+	}
+	else if (ptrReg == &gSimPMC.PMC_PCDR1)
+	{
+		gSimPMC.PMC_PCSR1.unValue &= ~unValue;
+	}
+	else if ((ptrReg == &gSimPMC.PMC_SR) || (ptrReg == &gSimPMC.PMC_PCSR0) || (ptrReg == &gSimPMC.PMC_PCSR1))
+	{
+		return;									// Read-only.
+	}
+	else
+	{
+		if (ptrReg == &gSimPMC.CKGR_MOR)
+		{
+			unValue &= ~(0xFFu << 16);			// Remove the key.
+		}
+		ptrReg->unValue = unValue;
+		if ((ptrReg == &gSimPMC.CKGR_MOR) || (ptrReg == &gSimPMC.CKGR_PLLAR) || (ptrReg == &gSimPMC.CKGR_PLLBR) ||
+			(ptrReg == &gSimPMC.PMC_MCKR))
+		{
+			SimUpdateClock();
+		}
+	}
+}
+
+static uint32_t SimMiscRead(SimReg *ptrReg)
+{
+	if ((ptrReg == &gSimWDT.WDT_CR) || (ptrReg == &gSimCMCC.CMCC_CTRL) || (ptrReg == &gSimEFC0.EEFC_FCR))
+	{
+		return 0;								// Write-only.
+	}
+	return ptrReg->unValue;
+}
+
+static void SimMiscWrite(SimReg *ptrReg, uint32_t unValue)
+{
+	if (ptrReg == &gSimWDT.WDT_CR)
+	{
+		if (((unValue & WDT_CR_WDRSTT) != 0) && ((unValue & (0xFFu << 24)) == WDT_CR_KEY_PASSWD))
+		{
+			gullLastWatchdog = gullSimTimePs;	// Watchdog restarted.
+		}
+	}
+	else if (ptrReg == &gSimCMCC.CMCC_CTRL)
+	{
+		gSimCMCC.CMCC_SR.unValue = unValue & CMCC_CTRL_CEN;
+	}
+	else if ((ptrReg == &gSimCMCC.CMCC_SR) || (ptrReg == &gSimWDT.WDT_SR) || (ptrReg == &gSimEFC0.EEFC_FSR))
+	{
+		return;									// Read-only.
+	}
+	else
+	{
+		ptrReg->unValue = unValue;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  PIO   ////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+static int gnTracePort = -1;
+static uint32_t gunTraceMask;
+static std::vector<uint64_t> gvecTraceEdge;
+
+static Pio *SimPioPort(int nPort)
+{
+	return (nPort == 0) ? &gSimPIOA : ((nPort == 1) ? &gSimPIOB : &gSimPIOC);
+}
+
+static void SimPioOutput(Pio *ptrPio, uint32_t unNew)
+{
+	uint32_t unOld = ptrPio->PIO_ODSR.unValue;
+
+	ptrPio->PIO_ODSR.unValue = unNew;
+	if ((gnTracePort >= 0) && (ptrPio == SimPioPort(gnTracePort)) && ((~unOld & unNew & gunTraceMask) != 0))
+	{
+		gvecTraceEdge.push_back(gullSimTimePs);
+	}
+}
+
+static uint32_t SimPioRead(Pio *ptrPio, SimReg *ptrReg)
+{
+	if (ptrReg == &ptrPio->PIO_PDSR)
+	{
+		return ptrPio->PIO_ODSR.unValue;		// Pin level follows the output data.
+	}
+	if ((ptrReg == &ptrPio->PIO_ODSR) || (ptrReg == &ptrPio->PIO_ABCDSR[0]) || (ptrReg == &ptrPio->PIO_ABCDSR[1]) ||
+		(ptrReg == &ptrPio->PIO_PSR) || (ptrReg == &ptrPio->PIO_OSR) || (ptrReg == &ptrPio->PIO_IFSR) ||
+		(ptrReg == &ptrPio->PIO_IMR) || (ptrReg == &ptrPio->PIO_MDSR) || (ptrReg == &ptrPio->PIO_PUSR) ||
+		(ptrReg == &ptrPio->PIO_PPDSR) || (ptrReg == &ptrPio->PIO_OWSR))
+	{
+		return ptrReg->unValue;
+	}
+	if (ptrReg == &ptrPio->PIO_ISR)
+	{
+		uint32_t unValue = ptrReg->unValue;
+		ptrReg->unValue = 0;					// Cleared on read.
+		return unValue;
+	}
+	return 0;									// Write-only.
+}
+
+static void SimPioWrite(Pio *ptrPio, SimReg *ptrReg, uint32_t unValue)
+{
+	// Set/clear register pairs and the corresponding status register.
+	struct { SimReg *ptrSet; SimReg *ptrClear; SimReg *ptrStatus; } strcPair[] =
+	{
+		{ &ptrPio->PIO_PER, &ptrPio->PIO_PDR, &ptrPio->PIO_PSR },
+		{ &ptrPio->PIO_OER, &ptrPio->PIO_ODR, &ptrPio->PIO_OSR },
+		{ &ptrPio->PIO_IFER, &ptrPio->PIO_IFDR, &ptrPio->PIO_IFSR },
+		{ &ptrPio->PIO_IER, &ptrPio->PIO_IDR, &ptrPio->PIO_IMR },
+		{ &ptrPio->PIO_MDER, &ptrPio->PIO_MDDR, &ptrPio->PIO_MDSR },
+		{ &ptrPio->PIO_PUDR, &ptrPio->PIO_PUER, &ptrPio->PIO_PUSR },	// PUSR = 1 means pull-up disabled.
+		{ &ptrPio->PIO_PPDDR, &ptrPio->PIO_PPDER, &ptrPio->PIO_PPDSR },
+		{ &ptrPio->PIO_OWER, &ptrPio->PIO_OWDR, &ptrPio->PIO_OWSR }
+	};
+	unsigned int ni;
+
+	if (ptrReg == &ptrPio->PIO_SODR)
+	{
+		SimPioOutput(ptrPio, ptrPio->PIO_ODSR.unValue | unValue);
+		return;
+	}
+	if (ptrReg == &ptrPio->PIO_CODR)
+	{
+		SimPioOutput(ptrPio, ptrPio->PIO_ODSR.unValue & ~unValue);
+		return;
+	}
+	if (ptrReg == &ptrPio->PIO_ODSR)			// Only bits enabled in OWSR are affected.
+	{
+		SimPioOutput(ptrPio, (ptrPio->PIO_ODSR.unValue & ~ptrPio->PIO_OWSR.unValue) | (unValue & ptrPio->PIO_OWSR.unValue));
+		return;
+	}
+	if ((ptrReg == &ptrPio->PIO_ABCDSR[0]) || (ptrReg == &ptrPio->PIO_ABCDSR[1]))
+	{
+		ptrReg->unValue = unValue;
+		return;
+	}
+	for (ni = 0; ni < sizeof(strcPair) / sizeof(strcPair[0]); ni++)
+	{
+		if (ptrReg == strcPair[ni].ptrSet)
+		{
+			strcPair[ni].ptrStatus->unValue |= unValue;
+			return;
+		}
+		if (ptrReg == strcPair[ni].ptrClear)
+		{
+			strcPair[ni].ptrStatus->unValue &= ~unValue;
+			return;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  UART AND USART   /////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+// State of a serial port.  The UART and USART registers used by the model are in the same
+// order, the USART specific registers are only accessed when bUsart = 1.
+struct SimSerial
+{
+	int bUsart;
+	int nIrq;
+	SimReg *ptrCR, *ptrMR, *ptrIER, *ptrIDR, *ptrIMR, *ptrSR, *ptrRHR, *ptrTHR, *ptrBRGR;
+	SimReg *ptrRTOR;							// USART only, 0 for the UART.
+	Pdc *ptrPdc;
+
+	int bTxEn;
+	int bRxEn;
+	int bHolding;								// Transmit holding register full.
+	uint8_t bytHolding;
+	uint64_t ullHoldTime;						// Virtual time the holding register is loaded.
+	int bShifting;								// Transmit shift register busy.
+	uint8_t bytShift;
+	uint64_t ullShiftDone;
+	uint64_t ullTxFree;							// Virtual time the shift register became free.
+	std::vector<uint8_t> vecTx;					// Data transmitted on the TX pin.
+	size_t unTxRead;
+	uint64_t ullLastTx;
+
+	std::deque<uint8_t> dqRx;					// Data injected on the RX pin.
+	uint64_t ullNextRx;							// Arrival time of the first byte in dqRx.
+	unsigned int unOverrun;
+	int bEndRx;									// ENDRX latched, RCR has reached 0.
+	int bTimeoutWait;							// Time-out started, waiting for a character.
+	int bTimeoutRun;							// Time-out counting from the last character.
+	uint64_t ullTimeout;						// Virtual time the time-out expires.
+	int bCtsHigh;								// CTS input high, the peer is not ready (USART).
+	int bRtsHeld;								// The peer waits for RTS low to send (USART).
+	unsigned int unRtsHold;						// No. of times the peer was held by RTS.
+
+	unsigned int unTxGlitch;					// Characters being shifted out while MCK changed.
+	double dTxBaudMin, dTxBaudMax;				// Range of baud rates of the characters sent.
+};
+
+static SimSerial gSimSerial[4];
+static uint64_t SimSerialNextEvent(SimSerial *ptrS);
+static uint64_t gullSerialNextEvent = UINT64_MAX;	// Virtual time of the next event of any serial port.
+
+static uint64_t SimSerialBitPs(SimSerial *ptrS)
+{
+	uint32_t unCD = ptrS->ptrBRGR->unValue & 0xFFFF;
+	uint32_t unFP;
+	uint32_t unOver;
+
+	if (unCD == 0)
+	{
+		return 0;								// Baud rate clock disabled.
+	}
+	if (ptrS->bUsart == 0)
+	{
+		return 16 * unCD * gullCyclePs;
+	}
+	unFP = (ptrS->ptrBRGR->unValue >> 16) & 0x7;
+	unOver = (ptrS->ptrMR->unValue & US_MR_OVER) ? 8 : 16;
+	return (unOver * (8 * unCD + unFP) * gullCyclePs) / 8;
+}
+
+static uint64_t SimSerialFramePs(SimSerial *ptrS)
+{
+	uint32_t unPar = (ptrS->ptrMR->unValue >> 9) & 0x7;
+	uint64_t ullBit = SimSerialBitPs(ptrS);
+
+	return ((unPar >= 4) ? 10 : 11) * ullBit;	// Start + 8 data + [parity] + stop.
+}
+
+// Hardware handshaking mode of the USART: the transmitter waits while CTS is high, RTS is high
+// while the receiver is disabled or both PDC receive buffers are full (RXBUFF).
+static int SimSerialHandshake(SimSerial *ptrS)
+{
+	return ptrS->bUsart && ((ptrS->ptrMR->unValue & US_MR_USART_MODE_Msk) == US_MR_USART_MODE_HW_HANDSHAKING);
+}
+
+static int SimSerialRtsHigh(SimSerial *ptrS)
+{
+	return SimSerialHandshake(ptrS) && ((ptrS->bRxEn == 0) ||
+		((ptrS->ptrPdc->PERIPH_RCR.unValue == 0) && (ptrS->ptrPdc->PERIPH_RNCR.unValue == 0)));
+}
+
+static uint32_t SimPdcAddress(SimReg *ptrReg)
+{
+	return ptrReg->unValue;
+}
+
+// Compute the status bits which depend on the state of the model and the PDC counters.
+static void SimSerialStatus(SimSerial *ptrS)
+{
+	uint32_t unSR = ptrS->ptrSR->unValue & ~(UART_SR_TXRDY | UART_SR_TXEMPTY | UART_SR_ENDTX | UART_SR_TXBUFE | UART_SR_ENDRX | UART_SR_RXBUFF |
+		(ptrS->bUsart ? US_CSR_CTS : 0));
+	Pdc *ptrPdc = ptrS->ptrPdc;
+
+	if (ptrS->bTxEn && (ptrS->bHolding == 0))
+	{
+		unSR |= UART_SR_TXRDY;
+		if (ptrS->bShifting == 0)
+		{
+			unSR |= UART_SR_TXEMPTY;
+		}
+	}
+	if (ptrPdc->PERIPH_TCR.unValue == 0)
+	{
+		unSR |= UART_SR_ENDTX;
+		if (ptrPdc->PERIPH_TNCR.unValue == 0)
+		{
+			unSR |= UART_SR_TXBUFE;
+		}
+	}
+	if (ptrS->bUsart && ptrS->bCtsHigh)
+	{
+		unSR |= US_CSR_CTS;
+	}
+	if ((ptrPdc->PERIPH_RCR.unValue == 0) || ptrS->bEndRx)
+	{
+		unSR |= UART_SR_ENDRX;
+		if (ptrPdc->PERIPH_RNCR.unValue == 0)
+		{
+			unSR |= UART_SR_RXBUFF;
+		}
+	}
+	ptrS->ptrSR->unValue = unSR;
+	if (unSR & ptrS->ptrIMR->unValue)
+	{
+		gunNvicPending |= 1u << ptrS->nIrq;		// Interrupt line asserted.
+	}
+}
+
+static void SimSerialRxByte(SimSerial *ptrS, uint8_t bytData, uint64_t ullEnd)
+{
+	Pdc *ptrPdc = ptrS->ptrPdc;
+
+	if (ptrS->bRxEn == 0)
+	{
+		return;
+	}
+	if ((ptrS->ptrRTOR != 0) && ((ptrS->ptrRTOR->unValue & 0xFFFF) != 0) && (ptrS->bTimeoutWait || ptrS->bTimeoutRun))
+	{											// Time-out counts from the end of the character.
+		ptrS->bTimeoutWait = 0;
+		ptrS->bTimeoutRun = 1;
+		ptrS->ullTimeout = ullEnd + (ptrS->ptrRTOR->unValue & 0xFFFF) * SimSerialBitPs(ptrS);
+	}
+	if ((ptrPdc->PERIPH_PTSR.unValue & PERIPH_PTSR_RXTEN) && (ptrPdc->PERIPH_RCR.unValue > 0))
+	{
+		*(uint8_t *)(uintptr_t) SimPdcAddress(&ptrPdc->PERIPH_RPR) = bytData;
+		ptrPdc->PERIPH_RPR.unValue++;
+		ptrPdc->PERIPH_RCR.unValue--;
+		if (ptrPdc->PERIPH_RCR.unValue == 0)
+		{
+			ptrS->bEndRx = 1;
+		}
+		if ((ptrPdc->PERIPH_RCR.unValue == 0) && (ptrPdc->PERIPH_RNCR.unValue > 0))
+		{
+			ptrPdc->PERIPH_RPR.unValue = ptrPdc->PERIPH_RNPR.unValue;
+			ptrPdc->PERIPH_RCR.unValue = ptrPdc->PERIPH_RNCR.unValue;
+			ptrPdc->PERIPH_RNCR.unValue = 0;
+		}
+		return;
+	}
+	if (ptrS->ptrSR->unValue & UART_SR_RXRDY)
+	{
+		ptrS->ptrSR->unValue |= UART_SR_OVRE;	// Previous character not read.
+		ptrS->unOverrun++;
+	}
+	ptrS->ptrRHR->unValue = bytData;
+	ptrS->ptrSR->unValue |= UART_SR_RXRDY;
+}
+
+static void SimSerialUpdate(SimSerial *ptrS)
+{
+	Pdc *ptrPdc = ptrS->ptrPdc;
+	uint64_t ullStart;
+	double dBaud;
+
+	// --- Transmitter ---
+	while (1)
+	{
+		if ((ptrS->bHolding == 0) && ptrS->bTxEn && (ptrPdc->PERIPH_PTSR.unValue & PERIPH_PTSR_TXTEN) &&
+			(ptrPdc->PERIPH_TCR.unValue > 0))
+		{										// PDC loads the holding register.
+			ptrS->bytHolding = *(uint8_t *)(uintptr_t) SimPdcAddress(&ptrPdc->PERIPH_TPR);
+			ptrPdc->PERIPH_TPR.unValue++;
+			ptrPdc->PERIPH_TCR.unValue--;
+			if ((ptrPdc->PERIPH_TCR.unValue == 0) && (ptrPdc->PERIPH_TNCR.unValue > 0))
+			{
+				ptrPdc->PERIPH_TPR.unValue = ptrPdc->PERIPH_TNPR.unValue;
+				ptrPdc->PERIPH_TCR.unValue = ptrPdc->PERIPH_TNCR.unValue;
+				ptrPdc->PERIPH_TNCR.unValue = 0;
+			}
+			ptrS->bHolding = 1;
+			ptrS->ullHoldTime = ptrS->bShifting ? ptrS->ullShiftDone : ptrS->ullTxFree;
+			if (ptrS->ullHoldTime > gullSimTimePs)
+			{
+				ptrS->ullHoldTime = gullSimTimePs;
+			}
+		}
+		if (ptrS->bHolding && (ptrS->bShifting == 0) && (SimSerialBitPs(ptrS) > 0) &&
+			((ptrS->bCtsHigh == 0) || (SimSerialHandshake(ptrS) == 0)))
+		{										// Holding register to shift register.
+			ullStart = (ptrS->ullHoldTime > ptrS->ullTxFree) ? ptrS->ullHoldTime : ptrS->ullTxFree;
+			ptrS->bytShift = ptrS->bytHolding;
+			ptrS->bHolding = 0;
+			ptrS->bShifting = 1;
+			ptrS->ullShiftDone = ullStart + SimSerialFramePs(ptrS);
+			dBaud = 1.0e12 / SimSerialBitPs(ptrS);
+			ptrS->dTxBaudMin = ((ptrS->dTxBaudMin == 0.0) || (dBaud < ptrS->dTxBaudMin)) ? dBaud : ptrS->dTxBaudMin;
+			ptrS->dTxBaudMax = (dBaud > ptrS->dTxBaudMax) ? dBaud : ptrS->dTxBaudMax;
+			continue;
+		}
+		if (ptrS->bShifting && (ptrS->ullShiftDone <= gullSimTimePs))
+		{										// Character sent.
+			ptrS->vecTx.push_back(ptrS->bytShift);
+			ptrS->ullLastTx = ptrS->ullShiftDone;
+			ptrS->ullTxFree = ptrS->ullShiftDone;
+			ptrS->bShifting = 0;
+			continue;
+		}
+		break;
+	}
+	if ((ptrS->bShifting == 0) && (ptrS->ullTxFree < gullSimTimePs))
+	{
+		ptrS->ullTxFree = gullSimTimePs;
+	}
+
+	// --- Receiver ---
+	if (ptrS->bRtsHeld && (SimSerialRtsHigh(ptrS) == 0))
+	{											// The peer starts the next character now.
+		ptrS->bRtsHeld = 0;
+		ptrS->ullNextRx = gullSimTimePs + SimSerialFramePs(ptrS);
+	}
+	while ((ptrS->dqRx.empty() == 0) && (ptrS->ullNextRx <= gullSimTimePs) && (SimSerialBitPs(ptrS) > 0) &&
+		   (ptrS->bRtsHeld == 0))
+	{
+		if (SimSerialRtsHigh(ptrS))				// RTS is sampled by the peer at the start of 
+		{										// the character.
+			ptrS->bRtsHeld = 1;
+			ptrS->unRtsHold++;
+			break;
+		}
+		SimSerialRxByte(ptrS, ptrS->dqRx.front(), ptrS->ullNextRx);
+		ptrS->dqRx.pop_front();
+		ptrS->ullNextRx += SimSerialFramePs(ptrS);
+	}
+	if (ptrS->bTimeoutRun && (ptrS->ullTimeout <= gullSimTimePs))
+	{
+		ptrS->bTimeoutRun = 0;
+		ptrS->ptrSR->unValue |= US_CSR_TIMEOUT;	// Line idle for TO bit periods.
+	}
+	SimSerialStatus(ptrS);
+	if (SimSerialNextEvent(ptrS) < gullSerialNextEvent)
+	{
+		gullSerialNextEvent = SimSerialNextEvent(ptrS);
+	}
+}
+
+static uint64_t SimSerialNextEvent(SimSerial *ptrS)
+{
+	uint64_t ullNext = UINT64_MAX;
+
+	if (ptrS->bShifting)
+	{
+		ullNext = ptrS->ullShiftDone;
+	}
+	if ((ptrS->dqRx.empty() == 0) && (ptrS->bRtsHeld == 0) && (ptrS->ullNextRx < ullNext))
+	{
+		ullNext = ptrS->ullNextRx;
+	}
+	if (ptrS->bTimeoutRun && (ptrS->ullTimeout < ullNext))
+	{
+		ullNext = ptrS->ullTimeout;
+	}
+	return ullNext;
+}
+
+// A character being shifted out when the master clock changes is sent partly at the old and
+// partly at the new baud rate, and is lost at the receiver.
+static void SimSerialClockChange(void)
+{
+	int ni;
+
+	for (ni = 0; ni < 4; ni++)
+	{
+		if (gSimSerial[ni].ptrSR == 0)
+		{
+			continue;
+		}
+		SimSerialUpdate(&gSimSerial[ni]);
+		if (gSimSerial[ni].bShifting && (gSimSerial[ni].ullShiftDone > gullSimTimePs))
+		{
+			gSimSerial[ni].unTxGlitch++;
+		}
+	}
+}
+
+static void SimSerialSchedule(void)
+{
+	uint64_t ullEvent;
+	int ni;
+
+	gullSerialNextEvent = UINT64_MAX;
+	for (ni = 0; ni < 4; ni++)
+	{
+		ullEvent = SimSerialNextEvent(&gSimSerial[ni]);
+		gullSerialNextEvent = (ullEvent < gullSerialNextEvent) ? ullEvent : gullSerialNextEvent;
+	}
+}
+
+// Bring the ports with a past event up to date, so that their interrupt line is asserted in time.
+static void SimSerialUpdateAll(void)
+{
+	int ni;
+
+	for (ni = 0; ni < 4; ni++)
+	{
+		if (SimSerialNextEvent(&gSimSerial[ni]) <= gullSimTimePs)
+		{
+			SimSerialUpdate(&gSimSerial[ni]);
+		}
+	}
+	SimSerialSchedule();
+}
+
+static uint32_t SimSerialRead(SimSerial *ptrS, SimReg *ptrReg)
+{
+	uint32_t unValue;
+
+	SimSerialUpdate(ptrS);
+	if (ptrReg == ptrS->ptrRHR)
+	{
+		ptrS->ptrSR->unValue &= ~UART_SR_RXRDY;
+		return ptrReg->unValue;
+	}
+	if ((ptrReg == ptrS->ptrCR) || (ptrReg == ptrS->ptrIER) || (ptrReg == ptrS->ptrIDR) || (ptrReg == ptrS->ptrTHR) ||
+		(ptrReg == &ptrS->ptrPdc->PERIPH_PTCR))
+	{
+		return 0;								// Write-only.
+	}
+	unValue = ptrReg->unValue;
+	return unValue;
+}
+
+static void SimSerialWrite(SimSerial *ptrS, SimReg *ptrReg, uint32_t unValue)
+{
+	Pdc *ptrPdc = ptrS->ptrPdc;
+
+	SimSerialUpdate(ptrS);
+	if (ptrReg == ptrS->ptrCR)
+	{
+		if (unValue & UART_CR_RSTRX)
+		{
+			ptrS->ptrSR->unValue &= ~(UART_SR_RXRDY | UART_SR_OVRE | UART_SR_FRAME | UART_SR_PARE);
+			ptrS->bRxEn = 0;
+		}
+		if (unValue & UART_CR_RSTTX)
+		{
+			ptrS->bHolding = 0;
+			ptrS->bShifting = 0;
+			ptrS->bTxEn = 0;
+		}
+		if (unValue & UART_CR_RXEN)		ptrS->bRxEn = 1;
+		if (unValue & UART_CR_RXDIS)	ptrS->bRxEn = 0;
+		if (unValue & UART_CR_TXEN)		ptrS->bTxEn = 1;
+		if (unValue & UART_CR_TXDIS)	ptrS->bTxEn = 0;
+		if (unValue & UART_CR_RSTSTA)
+		{
+			ptrS->ptrSR->unValue &= ~(UART_SR_OVRE | UART_SR_FRAME | UART_SR_PARE);
+		}
+		if (ptrS->bUsart && (unValue & US_CR_STTTO))
+		{
+			ptrS->ptrSR->unValue &= ~US_CSR_TIMEOUT;
+			ptrS->bTimeoutWait = 1;				// Wait for a character before counting.
+			ptrS->bTimeoutRun = 0;
+		}
+		if (ptrS->bUsart && (unValue & US_CR_RETTO) && ((ptrS->ptrRTOR->unValue & 0xFFFF) != 0))
+		{
+			ptrS->ptrSR->unValue &= ~US_CSR_TIMEOUT;
+			ptrS->bTimeoutWait = 0;				// Count from now.
+			ptrS->bTimeoutRun = 1;
+			ptrS->ullTimeout = gullSimTimePs + (ptrS->ptrRTOR->unValue & 0xFFFF) * SimSerialBitPs(ptrS);
+		}
+	}
+	else if (ptrReg == ptrS->ptrIER)
+	{
+		ptrS->ptrIMR->unValue |= unValue;
+	}
+	else if (ptrReg == ptrS->ptrIDR)
+	{
+		ptrS->ptrIMR->unValue &= ~unValue;
+	}
+	else if (ptrReg == ptrS->ptrTHR)
+	{
+		if (ptrS->bTxEn)
+		{
+			ptrS->bytHolding = (uint8_t) unValue;
+			ptrS->bHolding = 1;
+			ptrS->ullHoldTime = gullSimTimePs;
+		}
+	}
+	else if (ptrReg == &ptrPdc->PERIPH_PTCR)
+	{
+		if (unValue & PERIPH_PTCR_RXTEN)	ptrPdc->PERIPH_PTSR.unValue |= PERIPH_PTSR_RXTEN;
+		if (unValue & PERIPH_PTCR_RXTDIS)	ptrPdc->PERIPH_PTSR.unValue &= ~PERIPH_PTSR_RXTEN;
+		if (unValue & PERIPH_PTCR_TXTEN)	ptrPdc->PERIPH_PTSR.unValue |= PERIPH_PTSR_TXTEN;
+		if (unValue & PERIPH_PTCR_TXTDIS)	ptrPdc->PERIPH_PTSR.unValue &= ~PERIPH_PTSR_TXTEN;
+	}
+	else if ((ptrReg == ptrS->ptrSR) || (ptrReg == ptrS->ptrRHR) || (ptrReg == ptrS->ptrIMR) ||
+			 (ptrReg == &ptrPdc->PERIPH_PTSR))
+	{
+		return;									// Read-only.
+	}
+	else
+	{
+		if (((ptrReg == &ptrPdc->PERIPH_RCR) || (ptrReg == &ptrPdc->PERIPH_RNCR)) && (unValue != 0))
+		{
+			ptrS->bEndRx = 0;
+		}
+		ptrReg->unValue = unValue;
+	}
+	SimSerialUpdate(ptrS);
+}
+
+static void SimSerialInit(int nPort, int bUsart, int nIrq, SimReg *ptrFirst, Pdc *ptrPdc)
+{
+	SimSerial *ptrS = &gSimSerial[nPort];
+
+	ptrS->bUsart = bUsart;
+	ptrS->nIrq = nIrq;
+	ptrS->ptrCR = ptrFirst;						// CR, MR, IER, IDR, IMR, SR, RHR, THR, BRGR.
+	ptrS->ptrMR = ptrFirst + 1;
+	ptrS->ptrIER = ptrFirst + 2;
+	ptrS->ptrIDR = ptrFirst + 3;
+	ptrS->ptrIMR = ptrFirst + 4;
+	ptrS->ptrSR = ptrFirst + 5;
+	ptrS->ptrRHR = ptrFirst + 6;
+	ptrS->ptrTHR = ptrFirst + 7;
+	ptrS->ptrBRGR = ptrFirst + 8;
+	ptrS->ptrRTOR = bUsart ? ptrFirst + 9 : 0;
+	ptrS->ptrPdc = ptrPdc;
+	ptrS->bTxEn = 0;
+	ptrS->bRxEn = 0;
+	ptrS->bHolding = 0;
+	ptrS->bShifting = 0;
+	ptrS->ullTxFree = 0;
+	ptrS->vecTx.clear();
+	ptrS->unTxRead = 0;
+	ptrS->ullLastTx = 0;
+	ptrS->dqRx.clear();
+	ptrS->ullNextRx = 0;
+	ptrS->unOverrun = 0;
+	ptrS->bEndRx = 0;
+	ptrS->bTimeoutWait = 0;
+	ptrS->bTimeoutRun = 0;
+	ptrS->ullTimeout = 0;
+	ptrS->bCtsHigh = 0;
+	ptrS->bRtsHeld = 0;
+	ptrS->unRtsHold = 0;
+	ptrS->unTxGlitch = 0;
+	ptrS->dTxBaudMin = 0.0;
+	ptrS->dTxBaudMax = 0.0;
+	SimSerialStatus(ptrS);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  TWI   ////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define __SIM_TWI_OP_NONE		0
+#define __SIM_TWI_OP_ADDR		1				// START + slave address.
+#define __SIM_TWI_OP_IADR		2				// Internal address byte.
+#define __SIM_TWI_OP_ADDR_R		3				// Repeated START + slave address, read.
+#define __SIM_TWI_OP_TXDATA		4
+#define __SIM_TWI_OP_RXDATA		5
+#define __SIM_TWI_OP_STOP		6
+#define __SIM_TWI_OP_HOLD		7				// SCL held low by the slave, until SWRST.
+
+struct SimTwi
+{
+	Twi *ptrTwi;
+	int nIrq;
+	SIM_TWI_SLAVE *ptrSlave[__SIM_MAX_TWI_SLAVE];
+	int nSlave;
+	SIM_TWI_SLAVE *ptrCur;
+
+	int bMaster;
+	int bActive;								// Transfer in progress, between START and STOP.
+	int bRead;
+	int bPointerSet;							// Register pointer of slave has been written.
+	int nOp;
+	int nIadrLeft;
+	uint64_t ullOpDone;
+	int bHolding;
+	uint8_t bytHolding;
+	int bStopReq;
+	int bLast;									// Current received byte is the last one.
+	uint64_t ullBusyPs;
+};
+
+static SimTwi gSimTwi[2];
+
+static uint64_t SimTwiBitPs(SimTwi *ptrT)
+{
+	uint32_t unCWGR = ptrT->ptrTwi->TWI_CWGR.unValue;
+	uint32_t unCLDIV = unCWGR & 0xFF;
+	uint32_t unCHDIV = (unCWGR >> 8) & 0xFF;
+	uint32_t unCKDIV = (unCWGR >> 16) & 0x7;
+
+	return (uint64_t)(((unCLDIV << unCKDIV) + 4) + ((unCHDIV << unCKDIV) + 4)) * gullCyclePs;
+}
+
+static void SimTwiStartOp(SimTwi *ptrT, int nOp, int nBits, uint64_t ullStart)
+{
+	uint64_t ullDuration = nBits * SimTwiBitPs(ptrT);
+
+	ptrT->nOp = nOp;
+	ptrT->ullOpDone = ullStart + ullDuration;
+	ptrT->ullBusyPs += ullDuration;
+}
+
+static void SimTwiEnd(SimTwi *ptrT)
+{
+	ptrT->bActive = 0;
+	ptrT->nOp = __SIM_TWI_OP_NONE;
+	ptrT->bHolding = 0;
+	ptrT->bStopReq = 0;
+	ptrT->ptrTwi->TWI_SR.unValue |= TWI_SR_TXCOMP;
+}
+
+// Select the next operation once the previous one is completed at time ullTime.  The master
+// stretches the clock (no operation) while waiting for data to transmit, for the receive
+// holding register to be read or for the STOP command.
+static void SimTwiNext(SimTwi *ptrT, uint64_t ullTime)
+{
+	Twi *ptrTwi = ptrT->ptrTwi;
+	Pdc *ptrPdc = (Pdc *)&ptrTwi->TWI_RPR;
+
+	ptrT->nOp = __SIM_TWI_OP_NONE;
+	if (ptrT->bRead == 0)
+	{
+		if ((ptrT->bHolding == 0) && (ptrPdc->PERIPH_PTSR.unValue & PERIPH_PTSR_TXTEN) && (ptrPdc->PERIPH_TCR.unValue > 0))
+		{
+			ptrT->bytHolding = *(uint8_t *)(uintptr_t) SimPdcAddress(&ptrPdc->PERIPH_TPR);
+			ptrPdc->PERIPH_TPR.unValue++;
+			ptrPdc->PERIPH_TCR.unValue--;
+			if ((ptrPdc->PERIPH_TCR.unValue == 0) && (ptrPdc->PERIPH_TNCR.unValue > 0))
+			{
+				ptrPdc->PERIPH_TPR.unValue = ptrPdc->PERIPH_TNPR.unValue;
+				ptrPdc->PERIPH_TCR.unValue = ptrPdc->PERIPH_TNCR.unValue;
+				ptrPdc->PERIPH_TNCR.unValue = 0;
+			}
+			ptrT->bHolding = 1;
+		}
+		if (ptrT->bHolding)
+		{
+			ptrT->bHolding = 0;
+			SimTwiStartOp(ptrT, __SIM_TWI_OP_TXDATA, 9, ullTime);
+		}
+		else if (ptrT->bStopReq)
+		{
+			SimTwiStartOp(ptrT, __SIM_TWI_OP_STOP, 1, ullTime);
+		}
+	}
+	else
+	{
+		if ((ptrTwi->TWI_SR.unValue & TWI_SR_RXRDY) && (ptrPdc->PERIPH_PTSR.unValue & PERIPH_PTSR_RXTEN) &&
+			(ptrPdc->PERIPH_RCR.unValue > 0))
+		{
+			*(uint8_t *)(uintptr_t) SimPdcAddress(&ptrPdc->PERIPH_RPR) = (uint8_t) ptrTwi->TWI_RHR.unValue;
+			ptrPdc->PERIPH_RPR.unValue++;
+			ptrPdc->PERIPH_RCR.unValue--;
+			if ((ptrPdc->PERIPH_RCR.unValue == 0) && (ptrPdc->PERIPH_RNCR.unValue > 0))
+			{
+				ptrPdc->PERIPH_RPR.unValue = ptrPdc->PERIPH_RNPR.unValue;
+				ptrPdc->PERIPH_RCR.unValue = ptrPdc->PERIPH_RNCR.unValue;
+				ptrPdc->PERIPH_RNCR.unValue = 0;
+			}
+			ptrTwi->TWI_SR.unValue &= ~TWI_SR_RXRDY;
+		}
+		if ((ptrTwi->TWI_SR.unValue & TWI_SR_RXRDY) == 0)
+		{
+			ptrT->bLast = ptrT->bStopReq;
+			SimTwiStartOp(ptrT, __SIM_TWI_OP_RXDATA, 9, ullTime);
+		}
+	}
+}
+
+static void SimTwiComplete(SimTwi *ptrT)
+{
+	Twi *ptrTwi = ptrT->ptrTwi;
+	uint64_t ullTime = ptrT->ullOpDone;
+	uint32_t unDADR = (ptrTwi->TWI_MMR.unValue >> 16) & 0x7F;
+	uint8_t bytIadr;
+	int ni;
+
+	switch (ptrT->nOp)
+	{
+		case __SIM_TWI_OP_ADDR:
+			ptrT->ptrCur = NULL;
+			for (ni = 0; ni < ptrT->nSlave; ni++)
+			{
+				if (ptrT->ptrSlave[ni]->bytAddress == unDADR)
+				{
+					ptrT->ptrCur = ptrT->ptrSlave[ni];
+				}
+			}
+			if (ptrT->ptrCur == NULL)			// No slave acknowledge, the master sends STOP.
+			{
+				ptrTwi->TWI_SR.unValue |= TWI_SR_NACK;
+				SimTwiEnd(ptrT);
+				break;
+			}
+			if (ptrT->ptrCur->nHold > 0)		// Slave stuck, the transfer never ends.
+			{
+				ptrT->ptrCur->nHold--;
+				ptrT->nOp = __SIM_TWI_OP_HOLD;
+				ptrT->ullOpDone = UINT64_MAX;
+				break;
+			}
+			ptrT->bPointerSet = 0;
+			ptrT->nIadrLeft = (ptrTwi->TWI_MMR.unValue & TWI_MMR_IADRSZ_Msk) >> 8;
+			if (ptrT->nIadrLeft > 0)
+			{
+				SimTwiStartOp(ptrT, __SIM_TWI_OP_IADR, 9, ullTime);
+			}
+			else
+			{
+				SimTwiNext(ptrT, ullTime);
+			}
+			break;
+
+		case __SIM_TWI_OP_IADR:					// Most significant byte first, the first one
+			ptrT->nIadrLeft--;					// is the register pointer.
+			bytIadr = (uint8_t)(ptrTwi->TWI_IADR.unValue >> (8 * ptrT->nIadrLeft));
+			if (ptrT->bPointerSet == 0)
+			{
+				ptrT->ptrCur->bytPointer = bytIadr;
+				ptrT->bPointerSet = 1;
+			}
+			else
+			{
+				ptrT->ptrCur->bytRegister[ptrT->ptrCur->bytPointer++] = bytIadr;
+				ptrT->ptrCur->unWriteCount++;
+			}
+			if (ptrT->nIadrLeft > 0)
+			{
+				SimTwiStartOp(ptrT, __SIM_TWI_OP_IADR, 9, ullTime);
+				break;
+			}
+			if (ptrT->bRead)
+			{
+				SimTwiStartOp(ptrT, __SIM_TWI_OP_ADDR_R, 10, ullTime);
+			}
+			else
+			{
+				SimTwiNext(ptrT, ullTime);
+			}
+			break;
+
+		case __SIM_TWI_OP_ADDR_R:
+			SimTwiNext(ptrT, ullTime);
+			break;
+
+		case __SIM_TWI_OP_TXDATA:
+			if (ptrT->bPointerSet == 0)		// First byte is the register pointer.
+			{
+				ptrT->ptrCur->bytPointer = ptrT->bytHolding;
+				ptrT->bPointerSet = 1;
+			}
+			else
+			{
+				ptrT->ptrCur->bytRegister[ptrT->ptrCur->bytPointer++] = ptrT->bytHolding;
+				ptrT->ptrCur->unWriteCount++;
+			}
+			SimTwiNext(ptrT, ullTime);
+			break;
+
+		case __SIM_TWI_OP_RXDATA:
+			ptrTwi->TWI_RHR.unValue = ptrT->ptrCur->bytRegister[ptrT->ptrCur->bytPointer++];
+			ptrT->ptrCur->unReadCount++;
+			ptrTwi->TWI_SR.unValue |= TWI_SR_RXRDY;
+			if (ptrT->bLast)				// Master NAK the last byte and sends STOP.
+			{
+				SimTwiStartOp(ptrT, __SIM_TWI_OP_STOP, 1, ullTime);
+			}
+			else
+			{
+				SimTwiNext(ptrT, ullTime);
+			}
+			break;
+
+		case __SIM_TWI_OP_STOP:
+			SimTwiEnd(ptrT);
+			break;
+
+		default:
+			ptrT->nOp = __SIM_TWI_OP_NONE;
+			break;
+	}
+}
+
+static void SimTwiStatus(SimTwi *ptrT)
+{
+	Twi *ptrTwi = ptrT->ptrTwi;
+	Pdc *ptrPdc = (Pdc *)&ptrTwi->TWI_RPR;
+	uint32_t unSR = ptrTwi->TWI_SR.unValue & ~(TWI_SR_TXRDY | TWI_SR_ENDRX | TWI_SR_ENDTX | TWI_SR_RXBUFF | TWI_SR_TXBUFE);
+
+	if ((ptrT->bHolding == 0) && ((ptrT->bActive == 0) || (ptrT->bRead == 0)))
+	{
+		unSR |= TWI_SR_TXRDY;
+	}
+	if (ptrPdc->PERIPH_TCR.unValue == 0)
+	{
+		unSR |= TWI_SR_ENDTX | ((ptrPdc->PERIPH_TNCR.unValue == 0) ? TWI_SR_TXBUFE : 0);
+	}
+	if (ptrPdc->PERIPH_RCR.unValue == 0)
+	{
+		unSR |= TWI_SR_ENDRX | ((ptrPdc->PERIPH_RNCR.unValue == 0) ? TWI_SR_RXBUFF : 0);
+	}
+	ptrTwi->TWI_SR.unValue = unSR;
+	if (unSR & ptrTwi->TWI_IMR.unValue)
+	{
+		gunNvicPending |= 1u << ptrT->nIrq;		// Interrupt line asserted.
+	}
+}
+
+static void SimTwiUpdate(SimTwi *ptrT)
+{
+	while ((ptrT->nOp != __SIM_TWI_OP_NONE) && (ptrT->ullOpDone <= gullSimTimePs))
+	{
+		SimTwiComplete(ptrT);
+	}
+	if (ptrT->bActive && (ptrT->nOp == __SIM_TWI_OP_NONE))
+	{
+		SimTwiNext(ptrT, gullSimTimePs);		// Resume after clock stretching.
+	}
+	SimTwiStatus(ptrT);
+}
+
+static uint64_t SimTwiNextEvent(SimTwi *ptrT)
+{
+	return (ptrT->nOp != __SIM_TWI_OP_NONE) ? ptrT->ullOpDone : UINT64_MAX;
+}
+
+static void SimTwiStart(SimTwi *ptrT, int bRead)
+{
+	Twi *ptrTwi = ptrT->ptrTwi;
+
+	ptrT->bActive = 1;
+	ptrT->bRead = bRead;
+	ptrT->bStopReq = 0;
+	ptrTwi->TWI_SR.unValue &= ~TWI_SR_TXCOMP;
+	SimTwiStartOp(ptrT, __SIM_TWI_OP_ADDR, 10, gullSimTimePs);
+}
+
+static uint32_t SimTwiRead(SimTwi *ptrT, SimReg *ptrReg)
+{
+	Twi *ptrTwi = ptrT->ptrTwi;
+	uint32_t unValue;
+
+	SimTwiUpdate(ptrT);
+	if (ptrReg == &ptrTwi->TWI_RHR)
+	{
+		ptrTwi->TWI_SR.unValue &= ~TWI_SR_RXRDY;
+		unValue = ptrReg->unValue;
+		SimTwiUpdate(ptrT);
+		return unValue;
+	}
+	if (ptrReg == &ptrTwi->TWI_SR)
+	{
+		unValue = ptrReg->unValue;
+		ptrReg->unValue &= ~(TWI_SR_NACK | TWI_SR_OVRE | TWI_SR_ARBLST);	// Cleared on read.
+		return unValue;
+	}
+	if ((ptrReg == &ptrTwi->TWI_CR) || (ptrReg == &ptrTwi->TWI_THR) || (ptrReg == &ptrTwi->TWI_IER) ||
+		(ptrReg == &ptrTwi->TWI_IDR) || (ptrReg == &ptrTwi->TWI_PTCR))
+	{
+		return 0;								// Write-only.
+	}
+	return ptrReg->unValue;
+}
+
+static void SimTwiWrite(SimTwi *ptrT, SimReg *ptrReg, uint32_t unValue)
+{
+	Twi *ptrTwi = ptrT->ptrTwi;
+	Pdc *ptrPdc = (Pdc *)&ptrTwi->TWI_RPR;
+
+	SimTwiUpdate(ptrT);
+	if (ptrReg == &ptrTwi->TWI_CR)
+	{
+		if (unValue & TWI_CR_SWRST)
+		{
+			ptrT->bActive = 0;
+			ptrT->nOp = __SIM_TWI_OP_NONE;
+			ptrT->bHolding = 0;
+			ptrT->bMaster = 0;
+			ptrTwi->TWI_SR.unValue = TWI_SR_TXCOMP;
+		}
+		if (unValue & TWI_CR_MSEN)		ptrT->bMaster = 1;
+		if (unValue & TWI_CR_MSDIS)		ptrT->bMaster = 0;
+		if ((unValue & TWI_CR_START) && ptrT->bMaster && (ptrT->bActive == 0))
+		{
+			SimTwiStart(ptrT, (ptrTwi->TWI_MMR.unValue & TWI_MMR_MREAD) != 0);
+		}
+		if ((unValue & TWI_CR_STOP) && ptrT->bActive)
+		{
+			ptrT->bStopReq = 1;
+			if (ptrT->nOp == __SIM_TWI_OP_RXDATA)
+			{
+				ptrT->bLast = 1;				// Byte being received is the last one.
+			}
+		}
+	}
+	else if (ptrReg == &ptrTwi->TWI_THR)
+	{
+		ptrT->bytHolding = (uint8_t) unValue;
+		ptrT->bHolding = 1;
+		if (ptrT->bMaster && (ptrT->bActive == 0) && ((ptrTwi->TWI_MMR.unValue & TWI_MMR_MREAD) == 0))
+		{
+			SimTwiStart(ptrT, 0);				// Writing THR starts a master write.
+		}
+	}
+	else if (ptrReg == &ptrTwi->TWI_IER)
+	{
+		ptrTwi->TWI_IMR.unValue |= unValue;
+	}
+	else if (ptrReg == &ptrTwi->TWI_IDR)
+	{
+		ptrTwi->TWI_IMR.unValue &= ~unValue;
+	}
+	else if (ptrReg == &ptrPdc->PERIPH_PTCR)
+	{
+		if (unValue & PERIPH_PTCR_RXTEN)	ptrPdc->PERIPH_PTSR.unValue |= PERIPH_PTSR_RXTEN;
+		if (unValue & PERIPH_PTCR_RXTDIS)	ptrPdc->PERIPH_PTSR.unValue &= ~PERIPH_PTSR_RXTEN;
+		if (unValue & PERIPH_PTCR_TXTEN)	ptrPdc->PERIPH_PTSR.unValue |= PERIPH_PTSR_TXTEN;
+		if (unValue & PERIPH_PTCR_TXTDIS)	ptrPdc->PERIPH_PTSR.unValue &= ~PERIPH_PTSR_TXTEN;
+		if ((unValue & PERIPH_PTCR_TXTEN) && ptrT->bMaster && (ptrT->bActive == 0) &&
+			((ptrTwi->TWI_MMR.unValue & TWI_MMR_MREAD) == 0) && (ptrPdc->PERIPH_TCR.unValue > 0))
+		{
+			SimTwiStart(ptrT, 0);				// The first byte given by the PDC starts a master write.
+		}
+	}
+	else if ((ptrReg == &ptrTwi->TWI_SR) || (ptrReg == &ptrTwi->TWI_RHR) || (ptrReg == &ptrTwi->TWI_IMR) ||
+			 (ptrReg == &ptrPdc->PERIPH_PTSR))
+	{
+		return;									// Read-only.
+	}
+	else
+	{
+		ptrReg->unValue = unValue;
+	}
+	SimTwiUpdate(ptrT);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  TC   /////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+// Each channel counts n = 0, 1, 2 ... master clock/divider periods since the last trigger.  The
+// counter value is n modulo the period, 65536 or RC + 1 with RC compare trigger.  The compare 
+// and overflow events between two updates are found from n, so the counter costs nothing 
+// while no event is due.  Until n is incremented an update only re-evaluates the interrupt line.
+typedef struct
+{
+	TcChannel *ptrCh;
+	int nIrq;
+	int bRunning;
+	uint64_t ullStartPs;						// Virtual time when n = 0.
+	uint64_t ullCount;							// n at the last update.
+	uint64_t ullNextPs;							// Virtual time n is incremented, 0 to recompute.
+	unsigned int unTrigger;						// No. of RA compare events, i.e. TIOA rising edges.
+} SimTcChannel;
+
+static SimTcChannel gSimTc[6];
+static uint64_t gullTcNextEvent = UINT64_MAX;	// Virtual time of the next TC event with interrupt.
+
+static void SimDaccUpdate(void);
+static uint64_t SimDaccNextEvent(void);
+static void SimAdcUpdate(void);
+static uint64_t SimAdcNextEvent(void);
+
+static uint64_t SimTcClockPs(SimTcChannel *ptrT)
+{
+	static const unsigned int unDiv[4] = {2, 8, 32, 128};
+	uint32_t unClks = ptrT->ptrCh->TC_CMR.unValue & TC_CMR_TCCLKS_Msk;
+
+	if (unClks < 4)
+	{
+		return gullCyclePs * unDiv[unClks];
+	}
+	return (uint64_t)(1.0e12 / __SIM_SLCK_HZ);
+}
+
+static uint64_t SimTcPeriod(SimTcChannel *ptrT)
+{
+	uint32_t unCmr = ptrT->ptrCh->TC_CMR.unValue;
+
+	if (((unCmr & TC_CMR_WAVE) && ((unCmr & TC_CMR_WAVSEL_Msk) == TC_CMR_WAVSEL_UP_RC)) ||
+		(((unCmr & TC_CMR_WAVE) == 0) && (unCmr & TC_CMR_CPCTRG)))
+	{
+		return (uint64_t)(ptrT->ptrCh->TC_RC.unValue & 0xFFFF) + 1;
+	}
+	return 65536;
+}
+
+static uint64_t SimTcNow(SimTcChannel *ptrT)
+{
+	if (ptrT->bRunning == 0)
+	{
+		return ptrT->ullCount;
+	}
+	return (gullSimTimePs - ptrT->ullStartPs) / SimTcClockPs(ptrT);
+}
+
+// No. of k in [0, n] with k = r modulo P.
+static uint64_t SimTcMatch(uint64_t n, uint64_t r, uint64_t P)
+{
+	return (n >= r) ? (n - r) / P + 1 : 0;
+}
+
+// Smallest k > n with k = r modulo P.
+static uint64_t SimTcNextMatch(uint64_t n, uint64_t r, uint64_t P)
+{
+	return (n < r) ? r : r + ((n - r) / P + 1) * P;
+}
+
+static void SimTcLine(SimTcChannel *ptrT)
+{
+	if (ptrT->ptrCh->TC_SR.unValue & ptrT->ptrCh->TC_IMR.unValue & 0xFF)
+	{
+		gunNvicPending |= 1u << ptrT->nIrq;
+	}
+}
+
+static void SimTcUpdate(SimTcChannel *ptrT)
+{
+	TcChannel *ptrCh = ptrT->ptrCh;
+	uint64_t ullNow;
+	uint64_t ullPeriod;
+	uint64_t ullRA;
+	uint64_t ullRC;
+	uint64_t ullEvents;
+
+	if (ptrT->bRunning && (gullSimTimePs < ptrT->ullNextPs))
+	{
+		SimTcLine(ptrT);						// n and the counter value are unchanged.
+		return;
+	}
+	ullNow = SimTcNow(ptrT);
+	ullPeriod = SimTcPeriod(ptrT);
+	ullRA = ptrCh->TC_RA.unValue & 0xFFFF;
+	ullRC = ptrCh->TC_RC.unValue & 0xFFFF;
+	if (ullNow > ptrT->ullCount)
+	{
+		if ((ullPeriod == 65536) && (ullNow / 65536 > ptrT->ullCount / 65536))
+		{
+			ptrCh->TC_SR.unValue |= TC_SR_COVFS;
+		}
+		if ((ullRC < ullPeriod) && (SimTcMatch(ullNow, ullRC, ullPeriod) > SimTcMatch(ptrT->ullCount, ullRC, ullPeriod)))
+		{
+			ptrCh->TC_SR.unValue |= TC_SR_CPCS;
+		}
+		if (ullRA < ullPeriod)
+		{
+			ullEvents = SimTcMatch(ullNow, ullRA, ullPeriod) - SimTcMatch(ptrT->ullCount, ullRA, ullPeriod);
+			if (ullEvents > 0)
+			{
+				ptrCh->TC_SR.unValue |= TC_SR_CPAS;
+				ptrT->unTrigger += (unsigned int) ullEvents;
+			}
+		}
+		ptrT->ullCount = ullNow;
+	}
+	ptrCh->TC_CV.unValue = (uint32_t)(ullNow % ullPeriod);
+	if (ptrT->bRunning)
+	{
+		ptrT->ullNextPs = ptrT->ullStartPs + (ptrT->ullCount + 1) * SimTcClockPs(ptrT);
+	}
+	SimTcLine(ptrT);
+}
+
+// Time of the next event of a channel which has its interrupt enabled.
+static uint64_t SimTcNextEvent(SimTcChannel *ptrT)
+{
+	TcChannel *ptrCh = ptrT->ptrCh;
+	uint64_t ullPeriod;
+	uint64_t ullNext = UINT64_MAX;
+	uint64_t ullMatch;
+
+	if ((ptrT->bRunning == 0) || ((ptrCh->TC_IMR.unValue & (TC_SR_COVFS | TC_SR_CPAS | TC_SR_CPCS)) == 0))
+	{
+		return UINT64_MAX;
+	}
+	ullPeriod = SimTcPeriod(ptrT);
+	if ((ptrCh->TC_IMR.unValue & TC_SR_COVFS) && (ullPeriod == 65536))
+	{
+		ullNext = SimTcNextMatch(ptrT->ullCount, 0, 65536);
+	}
+	if ((ptrCh->TC_IMR.unValue & TC_SR_CPCS) && ((ptrCh->TC_RC.unValue & 0xFFFF) < ullPeriod))
+	{
+		ullMatch = SimTcNextMatch(ptrT->ullCount, ptrCh->TC_RC.unValue & 0xFFFF, ullPeriod);
+		ullNext = (ullMatch < ullNext) ? ullMatch : ullNext;
+	}
+	if ((ptrCh->TC_IMR.unValue & TC_SR_CPAS) && ((ptrCh->TC_RA.unValue & 0xFFFF) < ullPeriod))
+	{
+		ullMatch = SimTcNextMatch(ptrT->ullCount, ptrCh->TC_RA.unValue & 0xFFFF, ullPeriod);
+		ullNext = (ullMatch < ullNext) ? ullMatch : ullNext;
+	}
+	return ptrT->ullStartPs + ullNext * SimTcClockPs(ptrT);
+}
+
+static void SimTcSchedule(void)
+{
+	uint64_t ullEvent;
+	int ni;
+
+	gullTcNextEvent = UINT64_MAX;
+	for (ni = 0; ni < 6; ni++)
+	{
+		ullEvent = SimTcNextEvent(&gSimTc[ni]);
+		gullTcNextEvent = (ullEvent < gullTcNextEvent) ? ullEvent : gullTcNextEvent;
+	}
+	ullEvent = SimDaccNextEvent();				// The DACC and ADC are triggered by a TC channel.
+	gullTcNextEvent = (ullEvent < gullTcNextEvent) ? ullEvent : gullTcNextEvent;
+	ullEvent = SimAdcNextEvent();
+	gullTcNextEvent = (ullEvent < gullTcNextEvent) ? ullEvent : gullTcNextEvent;
+}
+
+static void SimTcUpdateAll(void)
+{
+	int ni;
+
+	for (ni = 0; ni < 6; ni++)
+	{
+		if (gSimTc[ni].bRunning)
+		{
+			SimTcUpdate(&gSimTc[ni]);
+		}
+	}
+	SimDaccUpdate();
+	SimAdcUpdate();
+	SimTcSchedule();
+}
+
+// Keep the counter value when the master clock changes.
+static void SimTcRebase(uint64_t ullOldCyclePs)
+{
+	static const unsigned int unDiv[4] = {2, 8, 32, 128};
+	SimTcChannel *ptrT;
+	uint32_t unClks;
+	int ni;
+
+	for (ni = 0; ni < 6; ni++)
+	{
+		ptrT = &gSimTc[ni];
+		ptrT->ullNextPs = 0;
+		unClks = ptrT->ptrCh->TC_CMR.unValue & TC_CMR_TCCLKS_Msk;
+		if ((ptrT->bRunning == 0) || (unClks >= 4) || (ullOldCyclePs == 0))
+		{
+			continue;
+		}
+		ptrT->ullCount = (gullSimTimePs - ptrT->ullStartPs) / (ullOldCyclePs * unDiv[unClks]);
+		ptrT->ullStartPs = gullSimTimePs - ptrT->ullCount * SimTcClockPs(ptrT);
+	}
+	SimTcSchedule();
+}
+
+static SimTcChannel *SimTcFind(SimReg *ptrReg)
+{
+	int ni;
+
+	for (ni = 0; ni < 6; ni++)
+	{
+		if (((char *)ptrReg >= (char *)gSimTc[ni].ptrCh) && ((char *)ptrReg < (char *)(gSimTc[ni].ptrCh + 1)))
+		{
+			return &gSimTc[ni];
+		}
+	}
+	return 0;
+}
+
+static uint32_t SimTcRead(SimReg *ptrReg)
+{
+	SimTcChannel *ptrT = SimTcFind(ptrReg);
+	uint32_t unValue;
+
+	if (ptrT == 0)
+	{
+		return ptrReg->unValue;					// Block registers.
+	}
+	SimTcUpdate(ptrT);
+	if (ptrReg == &ptrT->ptrCh->TC_SR)
+	{
+		unValue = ptrReg->unValue | (ptrT->bRunning ? TC_SR_CLKSTA : 0);
+		ptrReg->unValue = 0;					// Status flags are cleared on read.
+		return unValue;
+	}
+	if ((ptrReg == &ptrT->ptrCh->TC_CCR) || (ptrReg == &ptrT->ptrCh->TC_IER) || (ptrReg == &ptrT->ptrCh->TC_IDR))
+	{
+		return 0;
+	}
+	return ptrReg->unValue;
+}
+
+static void SimTcWrite(SimReg *ptrReg, uint32_t unValue)
+{
+	SimTcChannel *ptrT = SimTcFind(ptrReg);
+	TcChannel *ptrCh;
+
+	if (ptrT == 0)
+	{
+		ptrReg->unValue = unValue;
+		return;
+	}
+	ptrCh = ptrT->ptrCh;
+	SimTcUpdate(ptrT);
+	if (ptrReg == &ptrCh->TC_CCR)
+	{
+		if (unValue & TC_CCR_CLKDIS)
+		{
+			ptrT->bRunning = 0;
+		}
+		else if ((unValue & TC_CCR_CLKEN) && (ptrT->bRunning == 0))
+		{
+			ptrT->bRunning = 1;
+			ptrT->ullStartPs = gullSimTimePs - ptrT->ullCount * SimTcClockPs(ptrT);
+		}
+		if (unValue & TC_CCR_SWTRG)				// Reset the counter.
+		{
+			ptrT->ullCount = 0;
+			ptrT->ullStartPs = gullSimTimePs;
+			ptrCh->TC_CV.unValue = 0;
+		}
+	}
+	else if (ptrReg == &ptrCh->TC_IER)
+	{
+		ptrCh->TC_IMR.unValue |= unValue;
+	}
+	else if (ptrReg == &ptrCh->TC_IDR)
+	{
+		ptrCh->TC_IMR.unValue &= ~unValue;
+	}
+	else if ((ptrReg == &ptrCh->TC_CMR) || (ptrReg == &ptrCh->TC_RA) || (ptrReg == &ptrCh->TC_RB) ||
+		(ptrReg == &ptrCh->TC_RC))
+	{
+		ptrReg->unValue = unValue;
+	}
+	ptrT->ullNextPs = 0;						// The clock, the period or n may have changed.
+	SimTcLine(ptrT);
+	SimTcSchedule();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  DACC   ///////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+// With the external trigger (TRGEN) the DACC converts one sample of the PDC per rising edge of
+// TIOA of the TC channel selected by TRGSEL, 1 to 3 = TC0 channel 0 to 2.  The edges are counted
+// by the TC model, so the samples are consumed when the TC or the DACC is updated, and the TC
+// schedule has the edge on which the PDC buffer ends.  A trigger without sample is an underrun.
+typedef struct
+{
+	unsigned int unSeen;						// unTrigger of the TC channel already converted.
+	int bEndTx;									// ENDTX latched, TCR has reached 0.
+	unsigned int unUnderrun;					// Triggers without sample.
+	uint64_t ullFirstPs[2];						// Virtual time of the first and last conversions.
+	uint64_t ullLastPs[2];
+	std::deque<uint16_t> deqOut[2];				// Samples converted by each channel.
+} SimDacc;
+
+static SimDacc gSimDac;
+
+static void SimDaccConvert(uint32_t unData, uint64_t ullTime)
+{
+	uint32_t unMR = gSimDACC.DACC_MR.unValue;
+	int nChannel = (unMR & DACC_MR_TAG_EN) ? (int)((unData >> 12) & 0x3) : (int)((unMR & DACC_MR_USER_SEL_Msk) >> 16);
+
+	if ((nChannel > 1) || ((gSimDACC.DACC_CHSR.unValue & (1u << nChannel)) == 0))
+	{
+		return;
+	}
+	if (gSimDac.deqOut[nChannel].empty())
+	{
+		gSimDac.ullFirstPs[nChannel] = ullTime;
+	}
+	gSimDac.ullLastPs[nChannel] = ullTime;
+	gSimDac.deqOut[nChannel].push_back((uint16_t)(unData & 0x0FFF));
+}
+
+// The TC channel triggering the DACC, 0 if none.
+static SimTcChannel *SimDaccTrigger(void)
+{
+	uint32_t unMR = gSimDACC.DACC_MR.unValue;
+	uint32_t unSel = (unMR >> 1) & 0x7;
+
+	if (((unMR & DACC_MR_TRGEN_EN) == 0) || (unSel < 1) || (unSel > 3))
+	{
+		return 0;
+	}
+	return &gSimTc[unSel - 1];
+}
+
+static void SimDaccLine(void)
+{
+	Pdc *ptrPdc = PDC_DACC;
+	uint32_t unISR = DACC_ISR_TXRDY | DACC_ISR_EOC;
+
+	if (gSimDac.bEndTx || (ptrPdc->PERIPH_TCR.unValue == 0))
+	{
+		unISR |= DACC_ISR_ENDTX;
+	}
+	if ((ptrPdc->PERIPH_TCR.unValue == 0) && (ptrPdc->PERIPH_TNCR.unValue == 0))
+	{
+		unISR |= DACC_ISR_TXBUFE;
+	}
+	gSimDACC.DACC_ISR.unValue = unISR;
+	if (unISR & gSimDACC.DACC_IMR.unValue)
+	{
+		gunNvicPending |= 1u << DACC_IRQn;
+	}
+}
+
+static void SimDaccUpdate(void)
+{
+	SimTcChannel *ptrT = SimDaccTrigger();
+	Pdc *ptrPdc = PDC_DACC;
+	uint64_t ullPeriod;
+	uint64_t ullRA;
+	uint64_t ullEdge;
+	unsigned int unEdges;
+
+	if (ptrT != 0)
+	{
+		SimTcUpdate(ptrT);
+		unEdges = ptrT->unTrigger - gSimDac.unSeen;
+		gSimDac.unSeen = ptrT->unTrigger;
+		ullPeriod = SimTcPeriod(ptrT);
+		ullRA = ptrT->ptrCh->TC_RA.unValue & 0xFFFF;
+		ullEdge = gullSimTimePs;				// Time of the first edge not converted.
+		if ((ullRA < ullPeriod) && (ptrT->ullCount >= ullRA))
+		{
+			ullEdge = ptrT->ullStartPs + (ptrT->ullCount - (ptrT->ullCount - ullRA) % ullPeriod -
+					  (uint64_t)(unEdges - 1) * ullPeriod) * SimTcClockPs(ptrT);
+		}
+		while (unEdges > 0)
+		{
+			if (((ptrPdc->PERIPH_PTSR.unValue & PERIPH_PTSR_TXTEN) == 0) || (ptrPdc->PERIPH_TCR.unValue == 0))
+			{
+				gSimDac.unUnderrun += ((ptrPdc->PERIPH_PTSR.unValue & PERIPH_PTSR_TXTEN) != 0) ? unEdges : 0;
+				break;
+			}
+			SimDaccConvert(*(uint16_t *)(uintptr_t) SimPdcAddress(&ptrPdc->PERIPH_TPR), ullEdge);
+			ptrPdc->PERIPH_TPR.unValue += 2;
+			ptrPdc->PERIPH_TCR.unValue--;
+			if (ptrPdc->PERIPH_TCR.unValue == 0)
+			{
+				gSimDac.bEndTx = 1;
+				if (ptrPdc->PERIPH_TNCR.unValue > 0)
+				{
+					ptrPdc->PERIPH_TPR.unValue = ptrPdc->PERIPH_TNPR.unValue;
+					ptrPdc->PERIPH_TCR.unValue = ptrPdc->PERIPH_TNCR.unValue;
+					ptrPdc->PERIPH_TNCR.unValue = 0;
+				}
+			}
+			ullEdge += ullPeriod * SimTcClockPs(ptrT);
+			unEdges--;
+		}
+	}
+	SimDaccLine();
+}
+
+// Time of the trigger on which the PDC buffer ends, when the DACC has its interrupt enabled.
+static uint64_t SimDaccNextEvent(void)
+{
+	SimTcChannel *ptrT = SimDaccTrigger();
+	Pdc *ptrPdc = PDC_DACC;
+	uint64_t ullPeriod;
+	uint64_t ullRA;
+	uint64_t ullMatch;
+
+	if ((ptrT == 0) || (ptrT->bRunning == 0) || ((gSimDACC.DACC_IMR.unValue & (DACC_ISR_ENDTX | DACC_ISR_TXBUFE)) == 0) ||
+		((ptrPdc->PERIPH_PTSR.unValue & PERIPH_PTSR_TXTEN) == 0) || (ptrPdc->PERIPH_TCR.unValue == 0))
+	{
+		return UINT64_MAX;
+	}
+	ullPeriod = SimTcPeriod(ptrT);
+	ullRA = ptrT->ptrCh->TC_RA.unValue & 0xFFFF;
+	if (ullRA >= ullPeriod)
+	{
+		return UINT64_MAX;
+	}
+	ullMatch = SimTcNextMatch(ptrT->ullCount, ullRA, ullPeriod) + (ptrPdc->PERIPH_TCR.unValue - 1) * ullPeriod;
+	return ptrT->ullStartPs + ullMatch * SimTcClockPs(ptrT);
+}
+
+static uint32_t SimDaccRead(SimReg *ptrReg)
+{
+	SimDaccUpdate();
+	if (ptrReg == &gSimDACC.DACC_ISR)
+	{
+		return gSimDACC.DACC_ISR.unValue;		// Conversion is instantaneous.
+	}
+	return ptrReg->unValue;
+}
+
+static void SimDaccWrite(SimReg *ptrReg, uint32_t unValue)
+{
+	Pdc *ptrPdc = PDC_DACC;
+
+	SimDaccUpdate();
+	if (ptrReg == &gSimDACC.DACC_CHER)
+	{
+		gSimDACC.DACC_CHSR.unValue |= unValue;
+	}
+	else if (ptrReg == &gSimDACC.DACC_CHDR)
+	{
+		gSimDACC.DACC_CHSR.unValue &= ~unValue;
+	}
+	else if (ptrReg == &gSimDACC.DACC_IER)
+	{
+		gSimDACC.DACC_IMR.unValue |= unValue;
+	}
+	else if (ptrReg == &gSimDACC.DACC_IDR)
+	{
+		gSimDACC.DACC_IMR.unValue &= ~unValue;
+	}
+	else if (ptrReg == &gSimDACC.DACC_CDR)
+	{
+		if ((gSimDACC.DACC_MR.unValue & DACC_MR_TRGEN_EN) == 0)
+		{
+			SimDaccConvert(unValue, gullSimTimePs);		// Free running mode.
+		}
+	}
+	else if (ptrReg == &gSimDACC.DACC_CR)
+	{
+		if (unValue & DACC_CR_SWRST)
+		{
+			gSimDACC.DACC_MR.unValue = 0;
+			gSimDACC.DACC_CHSR.unValue = 0;
+			gSimDACC.DACC_IMR.unValue = 0;
+		}
+	}
+	else if (ptrReg == &gSimDACC.DACC_MR)
+	{
+		ptrReg->unValue = unValue;
+		if (SimDaccTrigger() != 0)
+		{
+			gSimDac.unSeen = SimDaccTrigger()->unTrigger;	// Only the triggers from now.
+		}
+	}
+	else if (ptrReg == &ptrPdc->PERIPH_PTCR)
+	{
+		if (unValue & PERIPH_PTCR_TXTEN)	ptrPdc->PERIPH_PTSR.unValue |= PERIPH_PTSR_TXTEN;
+		if (unValue & PERIPH_PTCR_TXTDIS)	ptrPdc->PERIPH_PTSR.unValue &= ~PERIPH_PTSR_TXTEN;
+	}
+	else if ((ptrReg == &gSimDACC.DACC_ISR) || (ptrReg == &gSimDACC.DACC_IMR) || (ptrReg == &gSimDACC.DACC_CHSR) ||
+			 (ptrReg == &ptrPdc->PERIPH_PTSR))
+	{
+		return;									// Read-only.
+	}
+	else
+	{
+		ptrReg->unValue = unValue;
+		if (((ptrReg == &ptrPdc->PERIPH_TCR) || (ptrReg == &ptrPdc->PERIPH_TNCR)) && (unValue > 0))
+		{
+			gSimDac.bEndTx = 0;
+		}
+	}
+	SimDaccLine();
+	SimTcSchedule();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  ADC   ////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+// With the external trigger (TRGEN) each rising edge of TIOA of the TC channel selected by
+// TRGSEL, 1 to 3 = TC0 channel 0 to 2, converts the enabled channels, lowest first, and the
+// PDC moves the results.  The conversion time is not modelled, the inputs are sampled at the
+// edge from the source given by SimAdcSource().  A result the PDC cannot take is lost (GOVRE).
+typedef struct
+{
+	unsigned int unSeen;						// unTrigger of the TC channel already converted.
+	int bEndRx;									// ENDRX latched, RCR has reached 0.
+	unsigned int unConvert;						// No. of conversions.
+	unsigned int unLost;						// No. of results not taken by the PDC.
+	int (*fptrSource)(int, double);				// Virtual analog inputs, 0 if none.
+} SimAdc;
+
+static SimAdc gSimAd;
+
+static int SimAdcChannels(void)
+{
+	uint32_t unCh = gSimADC.ADC_CHSR.unValue & 0xFFFF;
+	int nCount = 0;
+
+	while (unCh != 0)
+	{
+		nCount += unCh & 1;
+		unCh >>= 1;
+	}
+	return nCount;
+}
+
+// Convert the enabled channels.
+static void SimAdcScan(uint64_t ullTime)
+{
+	Pdc *ptrPdc = PDC_ADC;
+	uint32_t unData;
+	int ni;
+
+	for (ni = 0; ni < 16; ni++)
+	{
+		if ((gSimADC.ADC_CHSR.unValue & (1u << ni)) == 0)
+		{
+			continue;
+		}
+		unData = gSimAd.fptrSource ? (uint32_t) gSimAd.fptrSource(ni, (double) ullTime * 1.0e-12) & 0xFFF : 0;
+		gSimADC.ADC_CDR[ni].unValue = unData;
+		gSimADC.ADC_LCDR.unValue = unData | ((gSimADC.ADC_EMR.unValue & ADC_EMR_TAG) ? (uint32_t) ni << 12 : 0);
+		gSimAd.unConvert++;
+		if ((ptrPdc->PERIPH_PTSR.unValue & PERIPH_PTSR_RXTEN) && (ptrPdc->PERIPH_RCR.unValue > 0))
+		{
+			*(uint16_t *)(uintptr_t) SimPdcAddress(&ptrPdc->PERIPH_RPR) = (uint16_t) gSimADC.ADC_LCDR.unValue;
+			ptrPdc->PERIPH_RPR.unValue += 2;
+			ptrPdc->PERIPH_RCR.unValue--;
+			if (ptrPdc->PERIPH_RCR.unValue == 0)
+			{
+				gSimAd.bEndRx = 1;
+				if (ptrPdc->PERIPH_RNCR.unValue > 0)
+				{
+					ptrPdc->PERIPH_RPR.unValue = ptrPdc->PERIPH_RNPR.unValue;
+					ptrPdc->PERIPH_RCR.unValue = ptrPdc->PERIPH_RNCR.unValue;
+					ptrPdc->PERIPH_RNCR.unValue = 0;
+				}
+			}
+		}
+		else
+		{
+			gSimAd.unLost++;
+			gSimADC.ADC_ISR.unValue |= ADC_ISR_GOVRE;
+			gSimADC.ADC_OVER.unValue |= 1u << ni;
+		}
+	}
+}
+
+// The TC channel triggering the ADC, 0 if none.
+static SimTcChannel *SimAdcTrigger(void)
+{
+	uint32_t unMR = gSimADC.ADC_MR.unValue;
+	uint32_t unSel = (unMR >> 1) & 0x7;
+
+	if (((unMR & ADC_MR_TRGEN_EN) == 0) || (unSel < 1) || (unSel > 3))
+	{
+		return 0;
+	}
+	return &gSimTc[unSel - 1];
+}
+
+static void SimAdcLine(void)
+{
+	Pdc *ptrPdc = PDC_ADC;
+	uint32_t unISR = gSimADC.ADC_ISR.unValue & ADC_ISR_GOVRE;
+
+	if (gSimAd.bEndRx || (ptrPdc->PERIPH_RCR.unValue == 0))
+	{
+		unISR |= ADC_ISR_ENDRX;
+	}
+	if ((ptrPdc->PERIPH_RCR.unValue == 0) && (ptrPdc->PERIPH_RNCR.unValue == 0))
+	{
+		unISR |= ADC_ISR_RXBUFF;
+	}
+	gSimADC.ADC_ISR.unValue = unISR;
+	if (unISR & gSimADC.ADC_IMR.unValue)
+	{
+		gunNvicPending |= 1u << ADC_IRQn;
+	}
+}
+
+static void SimAdcUpdate(void)
+{
+	SimTcChannel *ptrT = SimAdcTrigger();
+	uint64_t ullPeriod;
+	uint64_t ullRA;
+	uint64_t ullEdge;
+	unsigned int unEdges;
+
+	if (ptrT != 0)
+	{
+		SimTcUpdate(ptrT);
+		unEdges = ptrT->unTrigger - gSimAd.unSeen;
+		gSimAd.unSeen = ptrT->unTrigger;
+		ullPeriod = SimTcPeriod(ptrT);
+		ullRA = ptrT->ptrCh->TC_RA.unValue & 0xFFFF;
+		ullEdge = gullSimTimePs;				// Time of the first edge not converted.
+		if ((ullRA < ullPeriod) && (ptrT->ullCount >= ullRA) && (unEdges > 0))
+		{
+			ullEdge = ptrT->ullStartPs + (ptrT->ullCount - (ptrT->ullCount - ullRA) % ullPeriod -
+					  (uint64_t)(unEdges - 1) * ullPeriod) * SimTcClockPs(ptrT);
+		}
+		while (unEdges > 0)
+		{
+			SimAdcScan(ullEdge);
+			ullEdge += ullPeriod * SimTcClockPs(ptrT);
+			unEdges--;
+		}
+	}
+	SimAdcLine();
+}
+
+// Time of the trigger on which the PDC buffer is full, when the ADC has its interrupt enabled.
+static uint64_t SimAdcNextEvent(void)
+{
+	SimTcChannel *ptrT = SimAdcTrigger();
+	Pdc *ptrPdc = PDC_ADC;
+	uint64_t ullPeriod;
+	uint64_t ullRA;
+	uint64_t ullMatch;
+	int nChannels = SimAdcChannels();
+
+	if ((ptrT == 0) || (ptrT->bRunning == 0) || (nChannels == 0) ||
+		((gSimADC.ADC_IMR.unValue & (ADC_ISR_ENDRX | ADC_ISR_RXBUFF)) == 0) ||
+		((ptrPdc->PERIPH_PTSR.unValue & PERIPH_PTSR_RXTEN) == 0) || (ptrPdc->PERIPH_RCR.unValue == 0))
+	{
+		return UINT64_MAX;
+	}
+	ullPeriod = SimTcPeriod(ptrT);
+	ullRA = ptrT->ptrCh->TC_RA.unValue & 0xFFFF;
+	if (ullRA >= ullPeriod)
+	{
+		return UINT64_MAX;
+	}
+	ullMatch = SimTcNextMatch(ptrT->ullCount, ullRA, ullPeriod) +
+			   (uint64_t)((ptrPdc->PERIPH_RCR.unValue + nChannels - 1) / nChannels - 1) * ullPeriod;
+	return ptrT->ullStartPs + ullMatch * SimTcClockPs(ptrT);
+}
+
+static uint32_t SimAdcRead(SimReg *ptrReg)
+{
+	uint32_t unValue;
+
+	SimAdcUpdate();
+	unValue = ptrReg->unValue;
+	if (ptrReg == &gSimADC.ADC_ISR)
+	{
+		gSimADC.ADC_ISR.unValue &= ~ADC_ISR_GOVRE;	// Cleared on read.
+	}
+	else if (ptrReg == &gSimADC.ADC_OVER)
+	{
+		gSimADC.ADC_OVER.unValue = 0;
+	}
+	else if ((ptrReg == &gSimADC.ADC_CR) || (ptrReg == &gSimADC.ADC_IER) || (ptrReg == &gSimADC.ADC_IDR))
+	{
+		return 0;
+	}
+	return unValue;
+}
+
+static void SimAdcWrite(SimReg *ptrReg, uint32_t unValue)
+{
+	Pdc *ptrPdc = PDC_ADC;
+
+	SimAdcUpdate();
+	if (ptrReg == &gSimADC.ADC_CHER)
+	{
+		gSimADC.ADC_CHSR.unValue |= unValue & 0xFFFF;
+	}
+	else if (ptrReg == &gSimADC.ADC_CHDR)
+	{
+		gSimADC.ADC_CHSR.unValue &= ~unValue;
+	}
+	else if (ptrReg == &gSimADC.ADC_IER)
+	{
+		gSimADC.ADC_IMR.unValue |= unValue;
+	}
+	else if (ptrReg == &gSimADC.ADC_IDR)
+	{
+		gSimADC.ADC_IMR.unValue &= ~unValue;
+	}
+	else if (ptrReg == &gSimADC.ADC_CR)
+	{
+		if (unValue & ADC_CR_SWRST)
+		{
+			gSimADC.ADC_MR.unValue = 0;
+			gSimADC.ADC_EMR.unValue = 0;
+			gSimADC.ADC_CHSR.unValue = 0;
+			gSimADC.ADC_IMR.unValue = 0;
+			gSimADC.ADC_ISR.unValue = 0;
+			gSimADC.ADC_OVER.unValue = 0;
+		}
+		else if (unValue & ADC_CR_START)
+		{
+			SimAdcScan(gullSimTimePs);			// Software trigger.
+		}
+	}
+	else if (ptrReg == &gSimADC.ADC_MR)
+	{
+		ptrReg->unValue = unValue;
+		if (SimAdcTrigger() != 0)
+		{
+			gSimAd.unSeen = SimAdcTrigger()->unTrigger;	// Only the triggers from now.
+		}
+	}
+	else if (ptrReg == &ptrPdc->PERIPH_PTCR)
+	{
+		if (unValue & PERIPH_PTCR_RXTEN)	ptrPdc->PERIPH_PTSR.unValue |= PERIPH_PTSR_RXTEN;
+		if (unValue & PERIPH_PTCR_RXTDIS)	ptrPdc->PERIPH_PTSR.unValue &= ~PERIPH_PTSR_RXTEN;
+	}
+	else if ((ptrReg == &gSimADC.ADC_ISR) || (ptrReg == &gSimADC.ADC_IMR) || (ptrReg == &gSimADC.ADC_CHSR) ||
+			 (ptrReg == &gSimADC.ADC_LCDR) || (ptrReg == &gSimADC.ADC_OVER) ||
+			 (((char *)ptrReg >= (char *)gSimADC.ADC_CDR) && ((char *)ptrReg < (char *)(gSimADC.ADC_CDR + 16))) ||
+			 (ptrReg == &ptrPdc->PERIPH_PTSR))
+	{
+		return;									// Read-only.
+	}
+	else
+	{
+		ptrReg->unValue = unValue;
+		if (((ptrReg == &ptrPdc->PERIPH_RCR) || (ptrReg == &ptrPdc->PERIPH_RNCR)) && (unValue > 0))
+		{
+			gSimAd.bEndRx = 0;
+		}
+	}
+	SimAdcLine();
+	SimTcSchedule();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  REGISTER ACCESS AND EXCEPTIONS   /////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#define SIM_IN(obj)	(((char *)ptrReg >= (char *)&(obj)) && ((char *)ptrReg < (char *)&(obj) + sizeof(obj)))
+
+// Advance the virtual clock by one master clock cycle and deliver any pending exception.
+static void SimAccess(void)
+{
+	gullSimTimePs += gullCyclePs;
+	gullSimAccessCount++;
+	if (gnInHandler)
+	{
+		if (++gullHandlerAccess > __SIM_HANDLER_LIMIT)
+		{
+			fprintf(stderr, "sim: firmware trapped in exception handler at t = %.6f s\n", SimTime());
+			exit(3);
+		}
+	}
+	if (gullSimTimePs - gullLastWatchdog > (uint64_t)(__SIM_WDT_TIMEOUT_S * 1.0e12))
+	{
+		fprintf(stderr, "sim: watchdog reset at t = %.6f s\n", SimTime());
+		exit(4);
+	}
+	if (gullSimTimePs >= gullSysTickZero)
+	{
+		SimSysTickUpdate();
+	}
+	if (gullSimTimePs >= gullTcNextEvent)
+	{
+		SimTcUpdateAll();
+	}
+	if (gullSimTimePs >= gullSerialNextEvent)
+	{
+		SimSerialUpdateAll();
+	}
+}
+
+uint32_t SimRead(SimReg *ptrReg)
+{
+	uint32_t unValue;
+
+	SimAccess();
+	if (SIM_IN(gSimTC0) || SIM_IN(gSimTC1))	unValue = SimTcRead(ptrReg);	// Most accessed first.
+	else if (SIM_IN(gSimDWT))		unValue = SimDwtRead(ptrReg);
+	else if (SIM_IN(gSimSysTick))	unValue = SimSysTickRead(ptrReg);
+	else if (SIM_IN(gSimWDT))		unValue = SimMiscRead(ptrReg);
+	else if (SIM_IN(gSimUART0))		unValue = SimSerialRead(&gSimSerial[__SIM_UART0], ptrReg);
+	else if (SIM_IN(gSimTWI0))		unValue = SimTwiRead(&gSimTwi[0], ptrReg);
+	else if (SIM_IN(gSimPIOB))		unValue = SimPioRead(&gSimPIOB, ptrReg);
+	else if (SIM_IN(gSimTWI1))		unValue = SimTwiRead(&gSimTwi[1], ptrReg);
+	else if (SIM_IN(gSimPMC))		unValue = SimPmcRead(ptrReg);
+	else if (SIM_IN(gSimUSART0))	unValue = SimSerialRead(&gSimSerial[__SIM_USART0], ptrReg);
+	else if (SIM_IN(gSimDACC))		unValue = SimDaccRead(ptrReg);
+	else if (SIM_IN(gSimUART1))		unValue = SimSerialRead(&gSimSerial[__SIM_UART1], ptrReg);
+	else if (SIM_IN(gSimUSART1))	unValue = SimSerialRead(&gSimSerial[__SIM_USART1], ptrReg);
+	else if (SIM_IN(gSimADC))		unValue = SimAdcRead(ptrReg);
+	else if (SIM_IN(gSimPIOA))		unValue = SimPioRead(&gSimPIOA, ptrReg);
+	else if (SIM_IN(gSimPIOC))		unValue = SimPioRead(&gSimPIOC, ptrReg);
+	else if (SIM_IN(gSimCoreDebug))	unValue = SimDwtRead(ptrReg);
+	else							unValue = SimMiscRead(ptrReg);
+	SimDeliver();
+	return unValue;
+}
+
+void SimWrite(SimReg *ptrReg, uint32_t unValue)
+{
+	SimAccess();
+	if (SIM_IN(gSimPIOB))			SimPioWrite(&gSimPIOB, ptrReg, unValue);	// Most accessed first.
+	else if (SIM_IN(gSimWDT))		SimMiscWrite(ptrReg, unValue);
+	else if (SIM_IN(gSimTWI0))		SimTwiWrite(&gSimTwi[0], ptrReg, unValue);
+	else if (SIM_IN(gSimTC0) || SIM_IN(gSimTC1))	SimTcWrite(ptrReg, unValue);
+	else if (SIM_IN(gSimTWI1))		SimTwiWrite(&gSimTwi[1], ptrReg, unValue);
+	else if (SIM_IN(gSimUART0))		SimSerialWrite(&gSimSerial[__SIM_UART0], ptrReg, unValue);
+	else if (SIM_IN(gSimDACC))		SimDaccWrite(ptrReg, unValue);
+	else if (SIM_IN(gSimUSART0))	SimSerialWrite(&gSimSerial[__SIM_USART0], ptrReg, unValue);
+	else if (SIM_IN(gSimUART1))		SimSerialWrite(&gSimSerial[__SIM_UART1], ptrReg, unValue);
+	else if (SIM_IN(gSimUSART1))	SimSerialWrite(&gSimSerial[__SIM_USART1], ptrReg, unValue);
+	else if (SIM_IN(gSimADC))		SimAdcWrite(ptrReg, unValue);
+	else if (SIM_IN(gSimPMC))		SimPmcWrite(ptrReg, unValue);
+	else if (SIM_IN(gSimPIOA))		SimPioWrite(&gSimPIOA, ptrReg, unValue);
+	else if (SIM_IN(gSimSysTick))	SimSysTickWrite(ptrReg, unValue);
+	else if (SIM_IN(gSimDWT))		SimDwtWrite(ptrReg, unValue);
+	else if (SIM_IN(gSimPIOC))		SimPioWrite(&gSimPIOC, ptrReg, unValue);
+	else if (SIM_IN(gSimCoreDebug))	SimDwtWrite(ptrReg, unValue);
+	else							SimMiscWrite(ptrReg, unValue);
+	SimDeliver();
+}
+
+static void SimCallHandler(void (*ptrHandler)(void))
+{
+	gnInHandler = 1;
+	gullHandlerAccess = 0;
+	ptrHandler();
+	gnInHandler = 0;
+}
+
+// Deliver the pending exceptions, only when PRIMASK is clear and not already in a handler.
+static void (*SimIrqHandler(int nIrq))(void)
+{
+	switch (nIrq)
+	{
+		case UART0_IRQn:	return UART0_Handler;
+		case UART1_IRQn:	return UART1_Handler;
+		case USART0_IRQn:	return USART0_Handler;
+		case USART1_IRQn:	return USART1_Handler;
+		case TWI0_IRQn:		return TWI0_Handler;
+		case TWI1_IRQn:		return TWI1_Handler;
+		case TC0_IRQn:		return TC0_Handler;
+		case TC1_IRQn:		return TC1_Handler;
+		case TC2_IRQn:		return TC2_Handler;
+		case TC3_IRQn:		return TC3_Handler;
+		case TC4_IRQn:		return TC4_Handler;
+		case TC5_IRQn:		return TC5_Handler;
+		case ADC_IRQn:		return ADC_Handler;
+		case DACC_IRQn:		return DACC_Handler;
+		default:			return 0;
+	}
+}
+
+// Re-evaluate the interrupt line of a level sensitive peripheral interrupt.
+static void SimIrqUpdate(int nIrq)
+{
+	if ((nIrq >= TC0_IRQn) && (nIrq <= TC5_IRQn))
+	{
+		SimTcUpdate(&gSimTc[nIrq - TC0_IRQn]);
+	}
+	else if (nIrq == UART0_IRQn)	SimSerialUpdate(&gSimSerial[__SIM_UART0]);
+	else if (nIrq == UART1_IRQn)	SimSerialUpdate(&gSimSerial[__SIM_UART1]);
+	else if (nIrq == USART0_IRQn)	SimSerialUpdate(&gSimSerial[__SIM_USART0]);
+	else if (nIrq == USART1_IRQn)	SimSerialUpdate(&gSimSerial[__SIM_USART1]);
+	else if (nIrq == TWI0_IRQn)		SimTwiUpdate(&gSimTwi[0]);
+	else if (nIrq == TWI1_IRQn)		SimTwiUpdate(&gSimTwi[1]);
+	else if (nIrq == DACC_IRQn)		SimDaccUpdate();
+	else if (nIrq == ADC_IRQn)		SimAdcUpdate();
+}
+
+static void SimDeliver(void)
+{
+	uint32_t unActive;
+	int nIrq;
+	void (*ptrHandler)(void);
+
+	if (gnPrimask || gnInHandler || (SimPending() == 0))
+	{
+		return;
+	}
+	while (SimPending())
+	{
+		if (gnSysTickPending)
+		{
+			gnSysTickPending = 0;
+			if (SysTick_Handler)
+			{
+				SimCallHandler(SysTick_Handler);
+			}
+			continue;
+		}
+		unActive = gunNvicPending & gunNvicEnable;
+		nIrq = __builtin_ctz(unActive);			// Lowest IRQ no. first.
+		gunNvicPending &= ~(1u << nIrq);
+		ptrHandler = SimIrqHandler(nIrq);
+		if (ptrHandler == 0)
+		{
+			fprintf(stderr, "sim: no handler for IRQ %d at t = %.6f s\n", nIrq, SimTime());
+			exit(6);
+		}
+		SimCallHandler(ptrHandler);
+		SimIrqUpdate(nIrq);						// Level sensitive, pending again if still asserted.
+	}
+}
+
+void SimDisableIRQ(void)
+{
+	gnPrimask = 1;
+}
+
+void SimEnableIRQ(void)
+{
+	gnPrimask = 0;
+	SimDeliver();
+}
+
+uint32_t SimGetPrimask(void)
+{
+	return (uint32_t) gnPrimask;
+}
+
+// WFI: advance the virtual clock to the next peripheral event until an exception is pending.
+void SimWaitForInterrupt(void)
+{
+	uint64_t ullNext;
+	uint64_t ullEvent;
+	int ni;
+
+	while (SimPending() == 0)
+	{
+		ullNext = UINT64_MAX;
+		if (SimSysTickRunning() && (gSimSysTick.CTRL.unValue & SysTick_CTRL_TICKINT_Msk))
+		{
+			ullNext = gullSysTickZero;
+		}
+		for (ni = 0; ni < 4; ni++)
+		{
+			ullEvent = SimSerialNextEvent(&gSimSerial[ni]);
+			ullNext = (ullEvent < ullNext) ? ullEvent : ullNext;
+		}
+		for (ni = 0; ni < 2; ni++)
+		{
+			ullEvent = SimTwiNextEvent(&gSimTwi[ni]);
+			ullNext = (ullEvent < ullNext) ? ullEvent : ullNext;
+		}
+		ullNext = (gullTcNextEvent < ullNext) ? gullTcNextEvent : ullNext;
+		if (ullNext == UINT64_MAX)
+		{
+			fprintf(stderr, "sim: WFI without any wake-up source at t = %.6f s\n", SimTime());
+			exit(5);
+		}
+		if (ullNext > gullSimTimePs)
+		{
+			gullSimTimePs = ullNext;
+		}
+		SimSysTickUpdate();
+		if (gullSimTimePs >= gullTcNextEvent)
+		{
+			SimTcUpdateAll();
+		}
+		for (ni = 0; ni < 4; ni++)
+		{
+			if (SimSerialNextEvent(&gSimSerial[ni]) <= gullSimTimePs)
+			{
+				SimSerialUpdate(&gSimSerial[ni]);
+			}
+		}
+		for (ni = 0; ni < 2; ni++)
+		{
+			if (SimTwiNextEvent(&gSimTwi[ni]) <= gullSimTimePs)
+			{
+				SimTwiUpdate(&gSimTwi[ni]);
+			}
+		}
+	}
+	if (gnPrimask == 0)
+	{
+		SimDeliver();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//  SIMULATION CONTROL   /////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+double SimTime(void)
+{
+	return (double) gullSimTimePs * 1.0e-12;
+}
+
+double SimMasterClockHz(void)
+{
+	return gdMCKHz;
+}
+
+void SimReset(void)
+{
+	int ni;
+
+	memset((void *)&gSimSysTick, 0, sizeof(gSimSysTick));
+	memset((void *)&gSimDWT, 0, sizeof(gSimDWT));
+	memset((void *)&gSimCoreDebug, 0, sizeof(gSimCoreDebug));
+	memset((void *)&gSimPMC, 0, sizeof(gSimPMC));
+	memset((void *)&gSimEFC0, 0, sizeof(gSimEFC0));
+	memset((void *)&gSimWDT, 0, sizeof(gSimWDT));
+	memset((void *)&gSimCMCC, 0, sizeof(gSimCMCC));
+	memset((void *)&gSimMATRIX, 0, sizeof(gSimMATRIX));
+	memset((void *)&gSimPIOA, 0, sizeof(gSimPIOA));
+	memset((void *)&gSimPIOB, 0, sizeof(gSimPIOB));
+	memset((void *)&gSimPIOC, 0, sizeof(gSimPIOC));
+	memset((void *)&gSimUART0, 0, sizeof(gSimUART0));
+	memset((void *)&gSimUART1, 0, sizeof(gSimUART1));
+	memset((void *)&gSimUSART0, 0, sizeof(gSimUSART0));
+	memset((void *)&gSimUSART1, 0, sizeof(gSimUSART1));
+	memset((void *)&gSimTWI0, 0, sizeof(gSimTWI0));
+	memset((void *)&gSimTWI1, 0, sizeof(gSimTWI1));
+	memset((void *)&gSimDACC, 0, sizeof(gSimDACC));
+	memset((void *)&gSimADC, 0, sizeof(gSimADC));
+	memset((void *)&gSimTC0, 0, sizeof(gSimTC0));
+	memset((void *)&gSimTC1, 0, sizeof(gSimTC1));
+	memset((void *)gSimTc, 0, sizeof(gSimTc));
+	for (ni = 0; ni < 6; ni++)
+	{
+		gSimTc[ni].ptrCh = (ni < 3) ? &gSimTC0.TC_CHANNEL[ni] : &gSimTC1.TC_CHANNEL[ni - 3];
+		gSimTc[ni].nIrq = TC0_IRQn + ni;
+	}
+	gullTcNextEvent = UINT64_MAX;
+	gunNvicEnable = 0;
+	gunNvicPending = 0;
+
+	gullSimTimePs = 0;
+	gullSimAccessCount = 0;
+	gullLastWatchdog = 0;
+	gnPrimask = 0;
+	gnInHandler = 0;
+	gnSysTickPending = 0;
+	gullSysTickZero = 0;
+	gullCyclePs = 0;
+	gullCycleBase = 0;
+	gullCycleBasePs = 0;
+
+	// Reset values.
+	gSimPMC.CKGR_MOR.unValue = CKGR_MOR_MOSCRCEN;			// Fast RC oscillator, MCK = MAINCK.
+	gSimPMC.PMC_MCKR.unValue = PMC_MCKR_CSS_MAIN_CLK;
+	gSimPMC.PMC_PCSR0.unValue = 0;
+	gSimPIOA.PIO_PSR.unValue = 0xFFFFFFFF;
+	gSimPIOB.PIO_PSR.unValue = 0xFFFFFFFF;
+	gSimPIOC.PIO_PSR.unValue = 0xFFFFFFFF;
+	gSimWDT.WDT_MR.unValue = 0x3FFF2FFF;
+	gSimTWI0.TWI_SR.unValue = TWI_SR_TXCOMP;
+	gSimTWI1.TWI_SR.unValue = TWI_SR_TXCOMP;
+	SimUpdateClock();
+
+	SimSerialInit(__SIM_UART0, 0, UART0_IRQn, &gSimUART0.UART_CR, PDC_UART0);
+	SimSerialInit(__SIM_UART1, 0, UART1_IRQn, &gSimUART1.UART_CR, PDC_UART1);
+	SimSerialInit(__SIM_USART0, 1, USART0_IRQn, &gSimUSART0.US_CR, PDC_USART0);
+	SimSerialInit(__SIM_USART1, 1, USART1_IRQn, &gSimUSART1.US_CR, PDC_USART1);
+	gullSerialNextEvent = UINT64_MAX;
+
+	for (ni = 0; ni < 2; ni++)
+	{
+		memset((void *)&gSimTwi[ni], 0, sizeof(gSimTwi[ni]));
+	}
+	gSimTwi[0].ptrTwi = &gSimTWI0;
+	gSimTwi[1].ptrTwi = &gSimTWI1;
+	gSimTwi[0].nIrq = TWI0_IRQn;
+	gSimTwi[1].nIrq = TWI1_IRQn;
+	gSimDac.unSeen = 0;
+	gSimDac.bEndTx = 0;
+	gSimDac.unUnderrun = 0;
+	memset(gSimDac.ullFirstPs, 0, sizeof(gSimDac.ullFirstPs));
+	memset(gSimDac.ullLastPs, 0, sizeof(gSimDac.ullLastPs));
+	gSimDac.deqOut[0].clear();
+	gSimDac.deqOut[1].clear();
+	memset(&gSimAd, 0, sizeof(gSimAd));
+
+	gnTracePort = -1;
+	gunTraceMask = 0;
+	gvecTraceEdge.clear();
+}
+
+void SimSerialInject(int nPort, const uint8_t *ptrData, int nLength)
+{
+	SimSerial *ptrS = &gSimSerial[nPort];
+	int ni;
+
+	SimSerialUpdate(ptrS);
+	if (ptrS->dqRx.empty())
+	{
+		ptrS->ullNextRx = gullSimTimePs + SimSerialFramePs(ptrS);
+	}
+	for (ni = 0; ni < nLength; ni++)
+	{
+		ptrS->dqRx.push_back(ptrData[ni]);
+	}
+}
+
+unsigned int SimSerialTxCount(int nPort)
+{
+	SimSerialUpdate(&gSimSerial[nPort]);
+	return (unsigned int) gSimSerial[nPort].vecTx.size();
+}
+
+int SimSerialTxRead(int nPort, uint8_t *ptrData, int nMax)
+{
+	SimSerial *ptrS = &gSimSerial[nPort];
+	int nCount = 0;
+
+	SimSerialUpdate(ptrS);
+	while ((nCount < nMax) && (ptrS->unTxRead < ptrS->vecTx.size()))
+	{
+		ptrData[nCount++] = ptrS->vecTx[ptrS->unTxRead++];
+	}
+	return nCount;
+}
+
+double SimSerialTxLastTime(int nPort)
+{
+	return (double) gSimSerial[nPort].ullLastTx * 1.0e-12;
+}
+
+unsigned int SimSerialRxOverrun(int nPort)
+{
+	return gSimSerial[nPort].unOverrun;
+}
+
+void SimSerialCts(int nPort, int bHigh)
+{
+	SimSerial *ptrS = &gSimSerial[nPort];
+
+	SimSerialUpdate(ptrS);
+	ptrS->bCtsHigh = bHigh;
+	SimSerialUpdate(ptrS);
+}
+
+unsigned int SimSerialRtsHold(int nPort)
+{
+	return gSimSerial[nPort].unRtsHold;
+}
+
+unsigned int SimSerialTxGlitch(int nPort)
+{
+	return gSimSerial[nPort].unTxGlitch;
+}
+
+void SimSerialTxBaud(int nPort, double *ptrMin, double *ptrMax)
+{
+	*ptrMin = gSimSerial[nPort].dTxBaudMin;
+	*ptrMax = gSimSerial[nPort].dTxBaudMax;
+}
+
+unsigned int SimSerialRxPending(int nPort)
+{
+	SimSerialUpdate(&gSimSerial[nPort]);
+	return (unsigned int) gSimSerial[nPort].dqRx.size();
+}
+
+void SimTwiAttach(int nBus, SIM_TWI_SLAVE *ptrSlave)
+{
+	SimTwi *ptrT = &gSimTwi[nBus];
+
+	if (ptrT->nSlave < __SIM_MAX_TWI_SLAVE)
+	{
+		ptrT->ptrSlave[ptrT->nSlave++] = ptrSlave;
+	}
+}
+
+double SimTwiBusTime(int nBus)
+{
+	return (double) gSimTwi[nBus].ullBusyPs * 1.0e-12;
+}
+
+void SimPioTrace(int nPort, int nPin)
+{
+	gnTracePort = nPort;
+	gunTraceMask = 1u << nPin;
+	gvecTraceEdge.clear();
+}
+
+unsigned int SimPioEdgeCount(void)
+{
+	return (unsigned int) gvecTraceEdge.size();
+}
+
+double SimPioEdgeTime(unsigned int unIndex)
+{
+	return (unIndex < gvecTraceEdge.size()) ? (double) gvecTraceEdge[unIndex] * 1.0e-12 : 0.0;
+}
+
+unsigned int SimDaccCount(int nChannel)
+{
+	SimDaccUpdate();
+	return (unsigned int) gSimDac.deqOut[nChannel].size();
+}
+
+int SimDaccOutput(int nChannel, uint16_t *ptrData, int nMax)
+{
+	int nCount = 0;
+
+	SimDaccUpdate();
+	while ((nCount < nMax) && (gSimDac.deqOut[nChannel].empty() == 0))
+	{
+		ptrData[nCount++] = gSimDac.deqOut[nChannel].front();
+		gSimDac.deqOut[nChannel].pop_front();
+	}
+	return nCount;
+}
+
+unsigned int SimDaccUnderrun(void)
+{
+	return gSimDac.unUnderrun;
+}
+
+void SimDaccTime(int nChannel, double *ptrFirst, double *ptrLast)
+{
+	*ptrFirst = (double) gSimDac.ullFirstPs[nChannel] * 1.0e-12;
+	*ptrLast = (double) gSimDac.ullLastPs[nChannel] * 1.0e-12;
+}
+
+void SimAdcSource(int (*fptrSource)(int nChannel, double dTime))
+{
+	gSimAd.fptrSource = fptrSource;
+}
+
+unsigned int SimAdcConversions(void)
+{
+	SimAdcUpdate();
+	return gSimAd.unConvert;
+}
+
+unsigned int SimAdcLost(void)
+{
+	return gSimAd.unLost;
+}
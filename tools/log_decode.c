@@ -0,0 +1,395 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TOKENIZED LOG DECODER (HOST PROGRAM)
+//
+//  (c) Copyright 2026, Fabian Kung Wai Lee, Selangor, MALAYSIA
+//  All Rights Reserved
+//
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File				: log_decode.c
+// Author(s)		: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Toolsuites		: GCC C-Compiler (host)
+// Description		: Formats the messages of the tokenized log captured from the UART0 TX pin,
+//                    see __OS_LOG_MSG() and OSLogWrite() in "os_APIs.c".  The target only sends
+//                    the offset of the format string in the section ".os_log" and the arguments,
+//                    the format strings are read from the ELF file of the firmware (32 or 64
+//                    bits, little endian), which must be the one running on the target.
+//                    The log is sent in chunks, each chunk is an 8 bytes header followed by the
+//                    records, see OSLogChunk().  Chunks are picked out by the header magic and
+//                    checksum, the trace chunks and the other data sent on the same line are
+//                    skipped.  Each message is printed with the time in msec since the first
+//                    one, from the clock ticks recorded.
+//                    Usage: log_decode [-s] firmware.elf log.bin
+//                    -s prints the summary only.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define _HEADER_LENGTH			8
+#define _MAX_ARGUMENTS			4
+#define _SECTION_NAME			".os_log"
+#define _SECTION_MAX			0xFFFF		// __OS_LOG_SECTION_MAX, the offsets are sent in 16 bits.
+
+static uint8_t *gptrString;				// Contents of the section of the format strings.
+static size_t gunStringLength;
+
+static uint8_t *DecodeReadFile(const char *ptrFile, size_t *ptrLength)
+{
+	FILE *fp;
+	uint8_t *ptrData;
+	long lLength;
+
+	fp = fopen(ptrFile, "rb");
+	if (fp == 0)
+	{
+		perror(ptrFile);
+		return 0;
+	}
+	fseek(fp, 0, SEEK_END);
+	lLength = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	ptrData = (uint8_t *) malloc((lLength > 0) ? lLength : 1);
+	if ((ptrData == 0) || (fread(ptrData, 1, lLength, fp) != (size_t) lLength))
+	{
+		fprintf(stderr, "%s: read error\n", ptrFile);
+		fclose(fp);
+		free(ptrData);
+		return 0;
+	}
+	fclose(fp);
+	*ptrLength = (size_t) lLength;
+	return ptrData;
+}
+
+static uint64_t DecodeGet(const uint8_t *ptrData, int nBytes)
+{
+	uint64_t ulValue = 0;
+
+	while (nBytes-- > 0)
+	{
+		ulValue = (ulValue << 8) | ptrData[nBytes];	// Little endian.
+	}
+	return ulValue;
+}
+
+// Locate the section of the format strings in the ELF file, from the section header table.
+static int DecodeElf(const uint8_t *ptrElf, size_t unLength)
+{
+	int n64;
+	uint64_t ulShoff;
+	unsigned int unShentsize;
+	unsigned int unShnum;
+	unsigned int unShstrndx;
+	const uint8_t *ptrSection;
+	const uint8_t *ptrNames;
+	uint64_t ulNamesOffset;
+	uint64_t ulOffset;
+	uint64_t ulSize;
+	unsigned int ni;
+
+	if ((unLength < 64) || (memcmp(ptrElf, "\x7F" "ELF", 4) != 0) || (ptrElf[5] != 1))
+	{
+		fprintf(stderr, "not a little endian ELF file\n");
+		return 0;
+	}
+	n64 = (ptrElf[4] == 2);
+	ulShoff = n64 ? DecodeGet(ptrElf + 0x28, 8) : DecodeGet(ptrElf + 0x20, 4);
+	unShentsize = (unsigned int) DecodeGet(ptrElf + (n64 ? 0x3A : 0x2E), 2);
+	unShnum = (unsigned int) DecodeGet(ptrElf + (n64 ? 0x3C : 0x30), 2);
+	unShstrndx = (unsigned int) DecodeGet(ptrElf + (n64 ? 0x3E : 0x32), 2);
+	if ((unShstrndx >= unShnum) || (ulShoff + (uint64_t) unShnum * unShentsize > unLength))
+	{
+		fprintf(stderr, "no section header table\n");
+		return 0;
+	}
+	ptrSection = ptrElf + ulShoff + (uint64_t) unShstrndx * unShentsize;
+	ulNamesOffset = n64 ? DecodeGet(ptrSection + 0x18, 8) : DecodeGet(ptrSection + 0x10, 4);
+	ptrNames = ptrElf + ulNamesOffset;
+	for (ni = 0; ni < unShnum; ni++)
+	{
+		ptrSection = ptrElf + ulShoff + (uint64_t) ni * unShentsize;
+		if (ulNamesOffset + DecodeGet(ptrSection, 4) + sizeof(_SECTION_NAME) > unLength)
+		{
+			continue;
+		}
+		if (strcmp((const char *) ptrNames + DecodeGet(ptrSection, 4), _SECTION_NAME) != 0)
+		{
+			continue;
+		}
+		ulOffset = n64 ? DecodeGet(ptrSection + 0x18, 8) : DecodeGet(ptrSection + 0x10, 4);
+		ulSize = n64 ? DecodeGet(ptrSection + 0x20, 8) : DecodeGet(ptrSection + 0x14, 4);
+		if (ulOffset + ulSize > unLength)
+		{
+			break;
+		}
+		if (ulSize > _SECTION_MAX)
+		{
+			fprintf(stderr, "section %s is %lu bytes, max. %u: the offsets sent by the target are 16 bits\n",
+				_SECTION_NAME, (unsigned long) ulSize, _SECTION_MAX);
+			return 0;
+		}
+		gptrString = (uint8_t *) ptrElf + ulOffset;
+		gunStringLength = (size_t) ulSize;
+		return 1;
+	}
+	fprintf(stderr, "section %s not found, no __OS_LOG_MSG() in the firmware?\n", _SECTION_NAME);
+	return 0;
+}
+
+static int DecodeHeaderValid(const uint8_t *ptrData, size_t unRemain)
+{
+	unsigned int unSum = 0;
+	int ni;
+
+	if ((unRemain < _HEADER_LENGTH) || (ptrData[0] != 0xA5) || (ptrData[1] != 0x5B))
+	{
+		return 0;
+	}
+	for (ni = 0; ni < 7; ni++)
+	{
+		unSum += ptrData[ni];
+	}
+	if ((uint8_t) ~unSum != ptrData[7])
+	{
+		return 0;
+	}
+	return (ptrData[2] > 0) && (unRemain >= _HEADER_LENGTH + (size_t) ptrData[2]);
+}
+
+// Get an integer stored in 7-bits groups, see OSLogVarint().  Returns the no. of bytes used,
+// 0 if the integer runs past the end or is longer than 5 bytes.
+static unsigned int DecodeVarint(const uint8_t *ptrData, unsigned int unRemain, uint32_t *ptrValue)
+{
+	uint32_t unValue = 0;
+	unsigned int ni;
+
+	for (ni = 0; (ni < unRemain) && (ni < 5); ni++)
+	{
+		unValue |= (uint32_t)(ptrData[ni] & 0x7F) << (7 * ni);
+		if ((ptrData[ni] & 0x80) == 0)
+		{
+			*ptrValue = unValue;
+			return ni + 1;
+		}
+	}
+	return 0;
+}
+
+// Print the message with the arguments as in printf(), the length modifiers are ignored as
+// every argument is 32 bits on the target.
+static void DecodePrint(const char *ptrFormat, const uint32_t *ptrArg, unsigned int unCount)
+{
+	char chrSpec[32];
+	unsigned int unArg = 0;
+	size_t unSpec;
+	float fValue;
+
+	while (*ptrFormat != 0)
+	{
+		if (*ptrFormat != '%')
+		{
+			putchar(*ptrFormat++);
+			continue;
+		}
+		if (ptrFormat[1] == '%')
+		{
+			putchar('%');
+			ptrFormat += 2;
+			continue;
+		}
+		unSpec = 0;
+		chrSpec[unSpec++] = *ptrFormat++;
+		while ((*ptrFormat != 0) && (strchr("-+ #0123456789.", *ptrFormat) != 0) && (unSpec < sizeof(chrSpec) - 2))
+		{
+			chrSpec[unSpec++] = *ptrFormat++;
+		}
+		while ((*ptrFormat != 0) && (strchr("hlLqjzt", *ptrFormat) != 0))
+		{
+			ptrFormat++;
+		}
+		if (*ptrFormat == 0)
+		{
+			break;
+		}
+		chrSpec[unSpec++] = *ptrFormat;
+		chrSpec[unSpec] = 0;
+		if (unArg >= unCount)
+		{
+			printf("<?>");
+		}
+		else if (strchr("di", *ptrFormat) != 0)
+		{
+			printf(chrSpec, (int)(int32_t) ptrArg[unArg]);
+		}
+		else if (strchr("uoxXc", *ptrFormat) != 0)
+		{
+			printf(chrSpec, (unsigned int) ptrArg[unArg]);
+		}
+		else if (strchr("eEfFgGaA", *ptrFormat) != 0)
+		{
+			memcpy(&fValue, &ptrArg[unArg], sizeof(fValue));	// See OSLogFloat().
+			printf(chrSpec, (double) fValue);
+		}
+		else if (*ptrFormat == 'p')
+		{
+			printf("0x%08X", (unsigned int) ptrArg[unArg]);
+		}
+		else
+		{
+			printf("<%%%c 0x%08X>", *ptrFormat, (unsigned int) ptrArg[unArg]);	// e.g. %s.
+		}
+		unArg++;
+		ptrFormat++;
+	}
+	putchar('\n');
+}
+
+int main(int argc, char *argv[])
+{
+	uint8_t *ptrElf;
+	uint8_t *ptrData;
+	const uint8_t *ptrRecord;
+	const char *ptrFile[2] = {0, 0};
+	size_t unElfLength;
+	size_t unLength;
+	size_t unPos = 0;
+	size_t unSkipped = 0;
+	int nSummary = 0;
+	int nFiles = 0;
+	int nFirst = 1;
+	int ni;
+	unsigned int unChunk = 0;
+	unsigned int unMessages = 0;
+	unsigned int unBad = 0;
+	unsigned int unSeqGap = 0;
+	unsigned int unLost = 0;
+	unsigned int unLostLast = 0;
+	uint8_t bytSeqLast = 0;
+	unsigned int unCount;
+	unsigned int unRemain;
+	unsigned int unUsed;
+	unsigned int unStep;
+	unsigned int unFormat;
+	unsigned int unArgs;
+	uint32_t unTick;
+	uint32_t unArg[_MAX_ARGUMENTS];
+	double dTickMs = 1.0;
+	double dTime = 0.0;						// Time since the first message in msec.
+
+	for (ni = 1; ni < argc; ni++)
+	{
+		if (strcmp(argv[ni], "-s") == 0)
+		{
+			nSummary = 1;
+		}
+		else if (nFiles < 2)
+		{
+			ptrFile[nFiles++] = argv[ni];
+		}
+	}
+	if (nFiles < 2)
+	{
+		fprintf(stderr, "usage: log_decode [-s] firmware.elf log.bin\n");
+		return 1;
+	}
+	ptrElf = DecodeReadFile(ptrFile[0], &unElfLength);
+	if ((ptrElf == 0) || (DecodeElf(ptrElf, unElfLength) == 0))
+	{
+		return 1;
+	}
+	ptrData = DecodeReadFile(ptrFile[1], &unLength);
+	if (ptrData == 0)
+	{
+		return 1;
+	}
+
+	while (unPos < unLength)
+	{
+		if (DecodeHeaderValid(ptrData + unPos, unLength - unPos) == 0)
+		{
+			unPos++;						// Not a chunk, other data on the line.
+			unSkipped++;
+			continue;
+		}
+		unCount = ptrData[unPos + 2];
+		unLost = ptrData[unPos + 4] | (ptrData[unPos + 5] << 8);
+		if (ptrData[unPos + 3] > 0)
+		{
+			dTickMs = 1.0 / ptrData[unPos + 3];	// __NUM_SYSTEMTICK_MSEC of the target.
+		}
+		if (nFirst)
+		{
+			unLostLast = unLost;
+		}
+		else
+		{
+			if ((uint8_t)(bytSeqLast + 1) != ptrData[unPos + 6])
+			{
+				unSeqGap++;
+				if (nSummary == 0)
+				{
+					printf("--- chunk %u to %u missing, time is not continuous ---\n", (uint8_t)(bytSeqLast + 1), ptrData[unPos + 6]);
+				}
+			}
+			if (((unLost - unLostLast) & 0xFFFF) != 0)
+			{
+				if (nSummary == 0)
+				{
+					printf("--- %u messages lost, log buffer full ---\n", (unLost - unLostLast) & 0xFFFF);
+				}
+			}
+		}
+		bytSeqLast = ptrData[unPos + 6];
+		ptrRecord = ptrData + unPos + _HEADER_LENGTH;
+		unRemain = unCount;
+		while (unRemain > 0)
+		{
+			unArgs = ptrRecord[0];
+			if ((unArgs > _MAX_ARGUMENTS) || (unRemain < 4))
+			{
+				unBad++;					// Corrupted, skip the rest of the chunk.
+				break;
+			}
+			unFormat = ptrRecord[1] | (ptrRecord[2] << 8);
+			unUsed = 3;
+			unStep = DecodeVarint(ptrRecord + 3, unRemain - 3, &unTick);
+			for (ni = 0; (ni < (int) unArgs) && (unStep > 0); ni++)
+			{
+				unUsed += unStep;
+				unStep = DecodeVarint(ptrRecord + unUsed, unRemain - unUsed, &unArg[ni]);
+			}
+			if ((unStep == 0) || (unFormat >= gunStringLength))
+			{
+				unBad++;
+				break;
+			}
+			unUsed += unStep;
+			if (nFirst == 0)
+			{
+				dTime += unTick * dTickMs;
+			}
+			nFirst = 0;
+			unMessages++;
+			if (nSummary == 0)
+			{
+				printf("%12.3f ms  ", dTime);
+				DecodePrint((const char *) gptrString + unFormat, unArg, unArgs);
+			}
+			ptrRecord += unUsed;
+			unRemain -= unUsed;
+		}
+		unLostLast = unLost;
+		unPos += _HEADER_LENGTH + unCount;
+		unChunk++;
+	}
+
+	printf("log: %u chunks, %u messages over %.3f ms, %u lost, %u chunks missing, %u bad records, %lu other bytes\n",
+		unChunk, unMessages, dTime, (unChunk > 0) ? unLost : 0, unSeqGap, unBad, (unsigned long) unSkipped);
+	free(ptrData);
+	free(ptrElf);
+	return 0;
+}
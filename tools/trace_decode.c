@@ -0,0 +1,354 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	EXECUTION TRACE DECODER (HOST PROGRAM)
+//
+//  (c) Copyright 2026, Fabian Kung Wai Lee, Selangor, MALAYSIA
+//  All Rights Reserved
+//
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File				: trace_decode.c
+// Author(s)		: Fabian Kung
+// Last modified	: 16 Oct 2026
+// Toolsuites		: GCC C-Compiler (host)
+// Description		: Rebuilds the timeline of the Kernel execution trace captured from the
+//                    UART0 TX pin, e.g. with a USB-to-serial converter and
+//                    "cat /dev/ttyUSB0 > trace.bin".  The trace is sent in chunks, each chunk
+//                    is an 8 bytes header followed by the 8 bytes records, see OSTraceChunk()
+//                    and OS_TRACE_RECORD in "osmain.h".  Chunks are picked out by the header
+//                    magic and checksum, the other data sent on the same line are skipped.
+//                    The 32-bits cycle counter time stamps are extended across wrap-around
+//                    and converted to microseconds with the MCK frequency of the chunk header,
+//                    then of the __TRACE_CLOCK events.
+//                    Usage: trace_decode [-s] trace.bin
+//                    -s prints the summary only.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Event codes, same as in "osmain.h".
+#define __TRACE_TASK_ENTER		1
+#define __TRACE_TASK_EXIT		2
+#define __TRACE_ISR_ENTER		3
+#define __TRACE_ISR_EXIT		4
+#define __TRACE_QUEUE_PUT		5
+#define __TRACE_QUEUE_GET		6
+#define __TRACE_EVENT_SIGNAL	7
+#define __TRACE_EVENT_WAIT		8
+#define __TRACE_TICK			9
+#define __TRACE_CLOCK			10
+#define __TRACE_OVERRUN			11
+#define __TRACE_USER			16
+
+#define _HEADER_LENGTH			8
+#define _RECORD_LENGTH			8
+#define _MAX_SLOT				1024		// __MAXTASK of the Kernel, up to 1024.
+#define _MAX_EXCEPTION			256
+
+// Statistic of a task slot or an exception handler.
+typedef struct StructDecodeStat
+{
+	unsigned int unCount;		// No. of executions.
+	unsigned int unPaired;		// No. of executions with both the entry and the return recorded.
+	double dSum;				// Total execution time in usec.
+	double dMax;				// Max. execution time in usec.
+	double dEnter;				// Time of the last entry in usec, < 0 if none.
+} DECODE_STAT;
+
+static DECODE_STAT gstrcTask[_MAX_SLOT];
+static DECODE_STAT gstrcIsr[_MAX_EXCEPTION];
+static unsigned int gunEventCount[32];
+
+static const char *gptrEventName[] =
+{
+	"?", "task enter", "task exit", "isr enter", "isr exit", "queue put", "queue get",
+	"signal", "wait", "tick", "clock", "overrun"
+};
+
+static const char *DecodeIsrName(unsigned int unException)
+{
+	switch (unException)
+	{
+		case 15: return "SysTick";
+		case 24: return "UART0";
+		case 25: return "UART1";
+		case 30: return "USART0";
+		case 31: return "USART1";
+		case 35: return "TWI0";
+		case 36: return "TWI1";
+		case 39: return "TC0";
+		case 45: return "ADC";
+		case 46: return "DACC";
+		default: return "IRQ";
+	}
+}
+
+static void DecodeStatEnter(DECODE_STAT *ptrStat, double dTime)
+{
+	ptrStat->unCount++;
+	ptrStat->dEnter = dTime;
+}
+
+static void DecodeStatExit(DECODE_STAT *ptrStat, double dTime)
+{
+	double dDuration;
+
+	if (ptrStat->dEnter < 0.0)
+	{
+		return;								// Entry not recorded, e.g. lost or before the capture.
+	}
+	dDuration = dTime - ptrStat->dEnter;
+	ptrStat->unPaired++;
+	ptrStat->dSum += dDuration;
+	if (dDuration > ptrStat->dMax)
+	{
+		ptrStat->dMax = dDuration;
+	}
+	ptrStat->dEnter = -1.0;
+}
+
+static int DecodeHeaderValid(const uint8_t *ptrData, size_t unRemain)
+{
+	unsigned int unSum = 0;
+	int ni;
+
+	if ((unRemain < _HEADER_LENGTH) || (ptrData[0] != 0xA5) || (ptrData[1] != 0x5A))
+	{
+		return 0;
+	}
+	for (ni = 0; ni < 7; ni++)
+	{
+		unSum += ptrData[ni];
+	}
+	if ((uint8_t) ~unSum != ptrData[7])
+	{
+		return 0;
+	}
+	return (ptrData[2] > 0) && (unRemain >= _HEADER_LENGTH + (size_t) ptrData[2] * _RECORD_LENGTH);
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *fp;
+	uint8_t *ptrData;
+	const uint8_t *ptrRecord;
+	const char *ptrFile = 0;
+	long lLength;
+	size_t unPos = 0;
+	size_t unSkipped = 0;
+	int nSummary = 0;
+	int nFirst = 1;
+	int ni;
+	unsigned int unChunk = 0;
+	unsigned int unRecords = 0;
+	unsigned int unSeqGap = 0;
+	unsigned int unLost = 0;
+	unsigned int unLostLast = 0;
+	uint8_t bytSeqLast = 0;
+	unsigned int unCount;
+	uint32_t unTime;
+	uint32_t unTimeLast = 0;
+	unsigned int unEvent;
+	unsigned int unData8;
+	unsigned int unData16;
+	double dMHz = 0.0;
+	double dTime = 0.0;						// Time since the first record in usec.
+	double dDelta;
+
+	for (ni = 1; ni < argc; ni++)
+	{
+		if (strcmp(argv[ni], "-s") == 0)
+		{
+			nSummary = 1;
+		}
+		else
+		{
+			ptrFile = argv[ni];
+		}
+	}
+	if (ptrFile == 0)
+	{
+		fprintf(stderr, "usage: trace_decode [-s] trace.bin\n");
+		return 1;
+	}
+	fp = fopen(ptrFile, "rb");
+	if (fp == 0)
+	{
+		perror(ptrFile);
+		return 1;
+	}
+	fseek(fp, 0, SEEK_END);
+	lLength = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	ptrData = (uint8_t *) malloc((lLength > 0) ? lLength : 1);
+	if ((ptrData == 0) || (fread(ptrData, 1, lLength, fp) != (size_t) lLength))
+	{
+		fprintf(stderr, "%s: read error\n", ptrFile);
+		return 1;
+	}
+	fclose(fp);
+	for (ni = 0; ni < _MAX_SLOT; ni++)
+	{
+		gstrcTask[ni].dEnter = -1.0;
+	}
+	for (ni = 0; ni < _MAX_EXCEPTION; ni++)
+	{
+		gstrcIsr[ni].dEnter = -1.0;
+	}
+
+	while (unPos < (size_t) lLength)
+	{
+		if (DecodeHeaderValid(ptrData + unPos, lLength - unPos) == 0)
+		{
+			unPos++;						// Not a chunk, other data on the line.
+			unSkipped++;
+			continue;
+		}
+		unCount = ptrData[unPos + 2];
+		unLost = ptrData[unPos + 4] | (ptrData[unPos + 5] << 8);
+		if (nFirst)
+		{
+			dMHz = ptrData[unPos + 3];
+			unLostLast = unLost;
+		}
+		else
+		{
+			if ((uint8_t)(bytSeqLast + 1) != ptrData[unPos + 6])
+			{
+				unSeqGap++;
+				if (nSummary == 0)
+				{
+					printf("--- chunk %u to %u missing ---\n", (uint8_t)(bytSeqLast + 1), ptrData[unPos + 6]);
+				}
+			}
+			if (((unLost - unLostLast) & 0xFFFF) != 0)
+			{
+				if (nSummary == 0)
+				{
+					printf("--- %u events lost, trace buffer full ---\n", (unLost - unLostLast) & 0xFFFF);
+				}
+			}
+		}
+		bytSeqLast = ptrData[unPos + 6];
+		ptrRecord = ptrData + unPos + _HEADER_LENGTH;
+		for (ni = 0; ni < (int) unCount; ni++, ptrRecord += _RECORD_LENGTH)
+		{
+			unTime = ptrRecord[0] | (ptrRecord[1] << 8) | (ptrRecord[2] << 16) | ((uint32_t) ptrRecord[3] << 24);
+			unEvent = ptrRecord[4];
+			unData8 = ptrRecord[5];
+			unData16 = ptrRecord[6] | (ptrRecord[7] << 8);
+			dDelta = 0.0;
+			if (nFirst == 0)
+			{
+				dDelta = (double)(uint32_t)(unTime - unTimeLast) / dMHz;	// Cycle counter wraps around.
+				dTime += dDelta;
+			}
+			nFirst = 0;
+			unTimeLast = unTime;
+			gunEventCount[unEvent & 31]++;
+			unRecords++;
+
+			switch (unEvent)
+			{
+				case __TRACE_TASK_ENTER:
+					DecodeStatEnter(&gstrcTask[unData16 % _MAX_SLOT], dTime);
+				break;
+				case __TRACE_TASK_EXIT:
+					DecodeStatExit(&gstrcTask[unData16 % _MAX_SLOT], dTime);
+				break;
+				case __TRACE_ISR_ENTER:
+					DecodeStatEnter(&gstrcIsr[unData8], dTime);
+				break;
+				case __TRACE_ISR_EXIT:
+					DecodeStatExit(&gstrcIsr[unData8], dTime);
+				break;
+				case __TRACE_CLOCK:
+					dMHz = unData16 * 0.01;		// Following time stamps are in the new clock.
+				break;
+				default:
+				break;
+			}
+			if (nSummary)
+			{
+				continue;
+			}
+			printf("%14.3f us %+11.3f  ", dTime, dDelta);
+			if ((unEvent == __TRACE_ISR_ENTER) || (unEvent == __TRACE_ISR_EXIT))
+			{
+				printf("%-10s %s (%u)\n", gptrEventName[unEvent], DecodeIsrName(unData8), unData8);
+			}
+			else if ((unEvent == __TRACE_TASK_ENTER) || (unEvent == __TRACE_TASK_EXIT))
+			{
+				printf("%-10s slot %u, state %u\n", gptrEventName[unEvent], unData16, unData8);
+			}
+			else if ((unEvent == __TRACE_QUEUE_PUT) || (unEvent == __TRACE_QUEUE_GET))
+			{
+				printf("%-10s queue ..%04X, %u items\n", gptrEventName[unEvent], unData16, unData8);
+			}
+			else if (unEvent == __TRACE_EVENT_SIGNAL)
+			{
+				printf("%-10s slot %u, flags 0x%02X\n", gptrEventName[unEvent], unData16, unData8);
+			}
+			else if (unEvent == __TRACE_EVENT_WAIT)
+			{
+				printf("%-10s flags 0x%02X, timeout %u ticks\n", gptrEventName[unEvent], unData8, unData16);
+			}
+			else if (unEvent == __TRACE_TICK)
+			{
+				printf("%-10s %u\n", gptrEventName[unEvent], unData16);
+			}
+			else if (unEvent == __TRACE_CLOCK)
+			{
+				printf("%-10s MCK = %.2f MHz\n", gptrEventName[unEvent], unData16 * 0.01);
+			}
+			else if (unEvent == __TRACE_OVERRUN)
+			{
+				printf("%-10s slot %d running\n", gptrEventName[unEvent], (int16_t) unData16);
+			}
+			else
+			{
+				printf("user %-5u 0x%02X 0x%04X\n", unEvent, unData8, unData16);
+			}
+		}
+		unLostLast = unLost;
+		unPos += _HEADER_LENGTH + unCount * _RECORD_LENGTH;
+		unChunk++;
+	}
+
+	printf("trace: %u chunks, %u records over %.3f ms, %u events lost, %u chunks missing, %lu other bytes\n",
+		unChunk, unRecords, dTime * 1.0e-3, (unChunk > 0) ? unLost : 0, unSeqGap, (unsigned long) unSkipped);
+	for (ni = 0; ni < _MAX_SLOT; ni++)
+	{
+		if (gstrcTask[ni].unCount > 0)
+		{
+			printf("task slot %4d: %6u runs, mean %9.3f us, max %9.3f us\n", ni, gstrcTask[ni].unCount,
+				(gstrcTask[ni].unPaired > 0) ? gstrcTask[ni].dSum / gstrcTask[ni].unPaired : 0.0, gstrcTask[ni].dMax);
+		}
+	}
+	for (ni = 0; ni < _MAX_EXCEPTION; ni++)
+	{
+		if (gstrcIsr[ni].unCount > 0)
+		{
+			printf("isr %-7s%3d: %6u runs, mean %9.3f us, max %9.3f us\n", DecodeIsrName(ni), ni, gstrcIsr[ni].unCount,
+				(gstrcIsr[ni].unPaired > 0) ? gstrcIsr[ni].dSum / gstrcIsr[ni].unPaired : 0.0, gstrcIsr[ni].dMax);
+		}
+	}
+	for (ni = __TRACE_QUEUE_PUT; ni < 32; ni++)
+	{
+		if (gunEventCount[ni] > 0)
+		{
+			if (ni < __TRACE_USER)
+			{
+				printf("%-10s: %u events\n", (ni <= __TRACE_OVERRUN) ? gptrEventName[ni] : "?", gunEventCount[ni]);
+			}
+			else
+			{
+				printf("user %-5d: %u events\n", ni, gunEventCount[ni]);
+			}
+		}
+	}
+	free(ptrData);
+	return 0;
+}